@@ -0,0 +1,74 @@
+/**
+ *  @example serial_capture_replay.cpp
+ */
+
+#include <libserial/SerialCapture.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief This example replays the data received from a device, recorded
+ *        by SerialPort::SetCapture(), into a pseudo terminal. An application
+ *        opens the printed device path as its serial port and receives the
+ *        recorded traffic with its original timing.
+ *
+ *        Usage: serial_capture_replay CAPTURE [SPEED [PORT_ID]]
+ *
+ *        SPEED is a multiple of the original speed, 1 by default, or 0 to
+ *        replay as fast as possible. PORT_ID selects the records of a
+ *        single serial port.
+ */
+int main(int argc, char* argv[])
+{
+    using namespace LibSerial ;
+
+    if ((argc < 2) or (argc > 4))
+    {
+        std::cerr << "Usage: " << argv[0] << " CAPTURE [SPEED [PORT_ID]]" << std::endl ;
+        return EXIT_FAILURE ;
+    }
+
+    try
+    {
+        // Open the capture written by a SerialCaptureWriter.
+        SerialCaptureReplayer serial_capture_replayer {argv[1]} ;
+
+        // Set the replay speed, e.g. 10 for ten times faster.
+        if (argc > 2)
+        {
+            serial_capture_replayer.SetSpeed(std::stod(argv[2])) ;
+        }
+
+        // Replay only the data received by one of the recorded ports.
+        if (argc > 3)
+        {
+            serial_capture_replayer.SetFilter(CaptureDirection::RECEIVED,
+                                              static_cast<uint32_t>(std::stoul(argv[3]))) ;
+        }
+
+        // Create the pseudo terminal the application connects to.
+        std::cout << "Replaying on " << serial_capture_replayer.OpenPseudoTerminal() << std::endl ;
+        std::cout << "Press Enter once the application has opened the port." << std::endl ;
+
+        std::string line ;
+        std::getline(std::cin, line) ;
+
+        const auto replay_statistics = serial_capture_replayer.Replay() ;
+
+        std::cout << "Replayed " << replay_statistics.recordCount << " records, "
+                  << replay_statistics.byteCount << " bytes in "
+                  << replay_statistics.durationUs << " us, maximum lateness "
+                  << replay_statistics.maximumLatenessUs << " us." << std::endl ;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << "The replay failed: " << exception.what() << std::endl ;
+        return EXIT_FAILURE ;
+    }
+
+    // Successful program completion.
+    return EXIT_SUCCESS ;
+}
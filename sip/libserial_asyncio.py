@@ -0,0 +1,296 @@
+"""asyncio support for the libserial Python module.
+
+The serial port's file descriptor is registered with the event loop using
+add_reader() and add_writer(), so any number of ports can share one event
+loop without threads or executors.
+
+Low level API::
+
+    transport, protocol = await create_serial_connection(loop, MyProtocol, "/dev/ttyUSB0")
+
+High level API::
+
+    port = await AsyncSerialPort.open("/dev/ttyUSB0", SerialPort.BAUD_115200)
+    await port.write(b"AT\\r")
+    line = await port.readline()
+    port.close()
+"""
+
+from libserial import SerialPort
+import asyncio
+
+__all__ = [ "SerialTransport",
+            "create_serial_connection",
+            "open_serial_connection",
+            "AsyncSerialPort" ]
+
+# Size of the buffer data is read into when the port becomes readable.
+READ_BUFFER_SIZE = 65536
+
+
+class SerialTransport(asyncio.Transport):
+    """An asyncio transport reading from and writing to a libserial SerialPort.
+
+    Data is read with SerialPort.readinto() only when the event loop reports
+    the port as readable, and never more than is available, so reads do not
+    block. Writes go through SerialPort.TryWrite(), so that they observe
+    write pacing, write coalescing, capture and the flight recorder like
+    SerialPort.Write() does. Data that the port does not accept immediately
+    is buffered and written once the port becomes writable, or once write
+    pacing allows it.
+    """
+
+    def __init__(self, loop, protocol, serial_port):
+        super().__init__()
+        self._loop = loop
+        self._protocol = protocol
+        self._serial_port = serial_port
+        self._file_descriptor = serial_port.GetFileDescriptor()
+        self._read_buffer = bytearray( READ_BUFFER_SIZE )
+        self._write_buffer = bytearray()
+        self._write_handle = None
+        self._closing = False
+        self._reading = True
+        self._protocol_paused = False
+        self._high_water = 64 * 1024
+        self._low_water = 16 * 1024
+        self._loop.call_soon( self._protocol.connection_made, self )
+        self._loop.call_soon( self._start_reading )
+
+    @property
+    def serial_port(self):
+        """The underlying libserial SerialPort."""
+        return self._serial_port
+
+    def get_extra_info(self, name, default=None):
+        if name == "serial_port":
+            return self._serial_port
+        return default
+
+    def _start_reading(self):
+        if self.is_reading():
+            self._loop.add_reader( self._file_descriptor, self._read_ready )
+
+    def _read_ready(self):
+        try:
+            number_of_bytes = max( self._serial_port.GetNumberOfBytesAvailable(), 1 )
+            view = memoryview( self._read_buffer )[:min( number_of_bytes, len( self._read_buffer ) )]
+            # A readable port without data, e.g. after a hang-up, is checked
+            # with the shortest possible timeout.
+            number_of_bytes_read = self._serial_port.readinto( view, 1 )
+        except Exception as exception:
+            self._fatal_error( exception )
+            return
+        if number_of_bytes_read:
+            self._protocol.data_received( bytes( self._read_buffer[:number_of_bytes_read] ) )
+
+    def write(self, data):
+        if self._closing:
+            return
+        if not data:
+            return
+        if not self._write_buffer:
+            try:
+                number_of_bytes_written = self._serial_port.TryWrite( data )
+            except Exception as exception:
+                self._fatal_error( exception )
+                return
+            data = memoryview( data )[number_of_bytes_written:]
+            if not data:
+                return
+            self._write_buffer += data
+            self._schedule_write()
+        else:
+            self._write_buffer += data
+        self._maybe_pause_protocol()
+
+    def _schedule_write(self):
+        # A port that is writable while write pacing holds the data back is
+        # retried after the pacing delay rather than whenever it is writable.
+        pacing_delay_us = self._serial_port.GetWritePacingDelay( len( self._write_buffer ) )
+        if pacing_delay_us:
+            self._loop.remove_writer( self._file_descriptor )
+            self._write_handle = self._loop.call_later( pacing_delay_us / 1e6, self._write_ready )
+        else:
+            self._loop.add_writer( self._file_descriptor, self._write_ready )
+
+    def _cancel_write(self):
+        self._loop.remove_writer( self._file_descriptor )
+        if self._write_handle is not None:
+            self._write_handle.cancel()
+            self._write_handle = None
+
+    def _write_ready(self):
+        self._write_handle = None
+        try:
+            number_of_bytes_written = self._serial_port.TryWrite( self._write_buffer )
+            del self._write_buffer[:number_of_bytes_written]
+            if self._write_buffer:
+                self._schedule_write()
+        except Exception as exception:
+            self._fatal_error( exception )
+            return
+        self._maybe_resume_protocol()
+        if not self._write_buffer:
+            self._loop.remove_writer( self._file_descriptor )
+            if self._closing:
+                self._call_connection_lost( None )
+
+    def can_write_eof(self):
+        return False
+
+    def get_write_buffer_size(self):
+        return len( self._write_buffer )
+
+    def get_write_buffer_limits(self):
+        return ( self._low_water, self._high_water )
+
+    def set_write_buffer_limits(self, high=None, low=None):
+        if high is None:
+            high = 64 * 1024 if low is None else 4 * low
+        if low is None:
+            low = high // 4
+        if not high >= low >= 0:
+            raise ValueError( "high (%r) must be >= low (%r) must be >= 0" % ( high, low ) )
+        self._high_water = high
+        self._low_water = low
+        self._maybe_pause_protocol()
+
+    def _maybe_pause_protocol(self):
+        if ( not self._protocol_paused ) and ( self.get_write_buffer_size() > self._high_water ):
+            self._protocol_paused = True
+            self._protocol.pause_writing()
+
+    def _maybe_resume_protocol(self):
+        if self._protocol_paused and ( self.get_write_buffer_size() <= self._low_water ):
+            self._protocol_paused = False
+            self._protocol.resume_writing()
+
+    def is_reading(self):
+        return self._reading and not self._closing
+
+    def pause_reading(self):
+        if self.is_reading():
+            self._reading = False
+            self._loop.remove_reader( self._file_descriptor )
+
+    def resume_reading(self):
+        if ( not self._reading ) and ( not self._closing ):
+            self._reading = True
+            self._loop.add_reader( self._file_descriptor, self._read_ready )
+
+    def is_closing(self):
+        return self._closing
+
+    def close(self):
+        """Close the transport once the buffered data has been written."""
+        if self._closing:
+            return
+        self._closing = True
+        self._loop.remove_reader( self._file_descriptor )
+        if not self._write_buffer:
+            self._loop.call_soon( self._call_connection_lost, None )
+
+    def abort(self):
+        """Close the transport immediately, discarding buffered data."""
+        self._closing = True
+        self._write_buffer.clear()
+        self._cancel_write()
+        self._loop.remove_reader( self._file_descriptor )
+        self._loop.call_soon( self._call_connection_lost, None )
+
+    def _fatal_error(self, exception):
+        self._closing = True
+        self._write_buffer.clear()
+        self._cancel_write()
+        self._loop.remove_reader( self._file_descriptor )
+        self._loop.call_soon( self._call_connection_lost, exception )
+
+    def _call_connection_lost(self, exception):
+        if self._serial_port is None:
+            return
+        self._loop.remove_reader( self._file_descriptor )
+        self._cancel_write()
+        try:
+            self._protocol.connection_lost( exception )
+        finally:
+            self._serial_port.Close()
+            self._serial_port = None
+            self._protocol = None
+            self._loop = None
+
+
+def _open_serial_port(device, baud_rate):
+    serial_port = SerialPort()
+    serial_port.Open( device )
+    if baud_rate is not None:
+        serial_port.SetBaudRate( baud_rate )
+    return serial_port
+
+
+async def create_serial_connection(loop, protocol_factory, device, baud_rate=None):
+    """Open a serial port and connect it to a protocol.
+
+    Returns a (transport, protocol) pair, like loop.create_connection().
+    """
+    serial_port = _open_serial_port( device, baud_rate )
+    protocol = protocol_factory()
+    transport = SerialTransport( loop, protocol, serial_port )
+    return ( transport, protocol )
+
+
+async def open_serial_connection(device, baud_rate=None, limit=2 ** 16):
+    """Open a serial port and return a (StreamReader, StreamWriter) pair."""
+    loop = asyncio.get_running_loop()
+    reader = asyncio.StreamReader( limit = limit, loop = loop )
+    protocol = asyncio.StreamReaderProtocol( reader, loop = loop )
+    transport, _ = await create_serial_connection( loop,
+                                                   lambda: protocol,
+                                                   device,
+                                                   baud_rate )
+    writer = asyncio.StreamWriter( transport, protocol, reader, loop )
+    return ( reader, writer )
+
+
+class AsyncSerialPort:
+    """A serial port with coroutine read(), readline() and write() methods."""
+
+    def __init__(self, reader, writer):
+        self._reader = reader
+        self._writer = writer
+
+    @classmethod
+    async def open(cls, device, baud_rate=None):
+        """Open a serial port for use from the running event loop."""
+        reader, writer = await open_serial_connection( device, baud_rate )
+        return cls( reader, writer )
+
+    @property
+    def serial_port(self):
+        """The underlying libserial SerialPort, for configuration."""
+        return self._writer.get_extra_info( "serial_port" )
+
+    async def read(self, number_of_bytes):
+        """Read exactly number_of_bytes bytes."""
+        return await self._reader.readexactly( number_of_bytes )
+
+    async def read_some(self, maximum_number_of_bytes=-1):
+        """Read the data available, waiting for at least one byte."""
+        return await self._reader.read( maximum_number_of_bytes )
+
+    async def readline(self, line_terminator=b"\n"):
+        """Read up to and including line_terminator."""
+        return await self._reader.readuntil( line_terminator )
+
+    async def write(self, data):
+        """Write data, waiting while the write buffer is above its limit."""
+        self._writer.write( data )
+        await self._writer.drain()
+
+    def close(self):
+        """Close the serial port."""
+        self._writer.close()
+
+    async def wait_closed(self):
+        """Wait until the serial port has been closed."""
+        await self._writer.wait_closed()
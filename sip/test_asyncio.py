@@ -0,0 +1,89 @@
+#! /usr/bin/env python3
+from libserial_asyncio import AsyncSerialPort
+import asyncio
+import optparse
+import logging
+import os
+
+def create_options_parser():
+    """Create a parser to extract value from command line options."""
+    parser = optparse.OptionParser( usage = "%prog [opts]" )
+    parser.add_option( "-p", "--ports",
+                       action  = "store",
+                       type    = "int",
+                       help    = "Number of pseudo terminal pairs",
+                       default = 100 )
+    parser.add_option( "-l", "--lines",
+                       action  = "store",
+                       type    = "int",
+                       help    = "Number of lines exchanged with each port",
+                       default = 20 )
+    return parser
+
+
+class EchoDevice(asyncio.Protocol):
+    """Emulates a device on the master side that echoes each line in upper case."""
+
+    def __init__(self, master_fd):
+        self._master_fd = master_fd
+        self._buffer = b""
+
+    def data_received(self, data):
+        self._buffer += data
+        while b"\n" in self._buffer:
+            line, self._buffer = self._buffer.split( b"\n", 1 )
+            os.write( self._master_fd, line.upper() + b"\n" )
+
+
+async def exchange(options, index):
+    """Exchange lines with one emulated device."""
+    loop = asyncio.get_running_loop()
+    master_fd, slave_fd = os.openpty()
+    device = os.ttyname( slave_fd )
+    os.set_blocking( master_fd, False )
+    echo_device = EchoDevice( master_fd )
+    loop.add_reader( master_fd,
+                     lambda: echo_device.data_received( os.read( master_fd, 4096 ) ) )
+    port = await AsyncSerialPort.open( device )
+    os.close( slave_fd )
+    try:
+        for line in range( options.lines ):
+            request = ( "port %d line %d\n" % ( index, line ) ).encode()
+            await port.write( request )
+            reply = await asyncio.wait_for( port.readline(), 5 )
+            assert reply == request.upper(), reply
+        await port.write( b"ab\n" )
+        assert await asyncio.wait_for( port.read( 3 ), 5 ) == b"AB\n"
+    finally:
+        port.close()
+        await port.wait_closed()
+        loop.remove_reader( master_fd )
+        os.close( master_fd )
+
+
+async def run(options):
+    await asyncio.gather( *[ exchange( options, index ) for index in range( options.ports ) ] )
+
+
+def main():
+    #
+    # Parse the command line options specified by the user.
+    #
+    parser = create_options_parser()
+    (options, arguments) = parser.parse_args()
+    #
+    # All ports are served by a single thread running one event loop.
+    #
+    loop = asyncio.new_event_loop()
+    loop.run_until_complete( run( options ) )
+    loop.close()
+    logging.info( "Exchanged %d lines with each of %d ports." % ( options.lines, options.ports ) )
+
+###############################################################################
+# The script starts here.
+###############################################################################
+
+if __name__ == "__main__":
+    logging.basicConfig( level  = logging.DEBUG,
+                         format = '%(asctime)s %(levelname)s %(message)s' )
+    main()
@@ -0,0 +1,110 @@
+#! /usr/bin/env python3
+from libserial import SerialPort
+import optparse
+import logging
+import os
+import threading
+import time
+
+def create_options_parser():
+    """Create a parser to extract value from command line options."""
+    parser = optparse.OptionParser( usage = "%prog [opts]" )
+    parser.add_option( "-p", "--ports",
+                       action  = "store",
+                       type    = "int",
+                       help    = "Number of pseudo terminal pairs",
+                       default = 4 )
+    parser.add_option( "-c", "--chunks",
+                       action  = "store",
+                       type    = "int",
+                       help    = "Number of chunks sent to each port",
+                       default = 50 )
+    parser.add_option( "-s", "--chunk-size",
+                       action  = "store",
+                       type    = "int",
+                       help    = "Size of each chunk in bytes",
+                       default = 4096 )
+    parser.add_option( "-i", "--interval",
+                       action  = "store",
+                       type    = "float",
+                       help    = "Seconds between chunks, emulating a slow device",
+                       default = 0.01 )
+    return parser
+
+
+def emulate_device(master_fd, options):
+    """Write chunks to the master side of a pseudo terminal at a fixed pace."""
+    chunk = bytes( range( 256 ) ) * ( options.chunk_size // 256 + 1 )
+    chunk = chunk[:options.chunk_size]
+    for _ in range( options.chunks ):
+        time.sleep( options.interval )
+        view = memoryview( chunk )
+        while view:
+            view = view[os.write( master_fd, view ):]
+
+
+def receive(serial_port, options, results, index):
+    """Receive all chunks sent to a port, blocking in the extension module."""
+    buffer = bytearray( options.chunk_size )
+    remaining = options.chunks * options.chunk_size
+    while remaining > 0:
+        remaining -= serial_port.readinto( memoryview( buffer )[:min( remaining, len( buffer ) )] )
+    results[index] = options.chunks * options.chunk_size
+
+
+def run(options, number_of_ports):
+    """Receive from number_of_ports ports concurrently and return the elapsed time."""
+    ports = []
+    threads = []
+    results = [0] * number_of_ports
+    for index in range( number_of_ports ):
+        master_fd, slave_fd = os.openpty()
+        serial_port = SerialPort()
+        serial_port.Open( os.ttyname( slave_fd ) )
+        os.close( slave_fd )
+        ports.append( ( master_fd, serial_port ) )
+        threads.append( threading.Thread( target = emulate_device,
+                                          args   = ( master_fd, options ) ) )
+        threads.append( threading.Thread( target = receive,
+                                          args   = ( serial_port, options, results, index ) ) )
+    start_time = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed_time = time.monotonic() - start_time
+    for master_fd, serial_port in ports:
+        serial_port.Close()
+        os.close( master_fd )
+    assert sum( results ) == number_of_ports * options.chunks * options.chunk_size
+    return elapsed_time
+
+
+def main():
+    #
+    # Parse the command line options specified by the user.
+    #
+    parser = create_options_parser()
+    (options, arguments) = parser.parse_args()
+    #
+    # Every device needs options.chunks * options.interval seconds to send
+    # its data. While the GIL is released during blocking reads, the ports
+    # are served in parallel and the total time stays close to that of a
+    # single port instead of growing with the number of ports.
+    #
+    single_time = run( options, 1 )
+    multiple_time = run( options, options.ports )
+    total_bytes = options.ports * options.chunks * options.chunk_size
+    logging.info( "1 port: %.3f s" % single_time )
+    logging.info( "%d ports: %.3f s, %.1f KiB/s" %
+                  ( options.ports, multiple_time, total_bytes / 1024.0 / multiple_time ) )
+    assert multiple_time < single_time * 2, "Blocking reads serialize the Python threads."
+
+###############################################################################
+# The script starts here.
+###############################################################################
+
+if __name__ == "__main__":
+    logging.basicConfig( level  = logging.DEBUG,
+                         format = '%(asctime)s %(levelname)s %(message)s' )
+    main()
@@ -0,0 +1,1687 @@
+/******************************************************************************
+ * @file SerialCapture.cpp                                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialCapture.h"
+#include "libserial/SerialPort.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace LibSerial
+{
+    namespace
+    {
+        /**
+         * @brief Identifies a capture segment file.
+         */
+        constexpr char CAPTURE_SEGMENT_MAGIC[8] = {'L', 'S', 'C', 'A', 'P', 'T', 'U', 'R'} ;
+
+        /**
+         * @brief Version of the capture segment format.
+         */
+        constexpr uint32_t CAPTURE_FORMAT_VERSION = 1 ;
+
+        /**
+         * @brief Marks a complete record. It is stored last, so a record
+         *        that is being appended is not yet visible to readers.
+         */
+        constexpr uint32_t CAPTURE_RECORD_MAGIC = 0x5243534c ;
+
+        /**
+         * @brief Records start at multiples of this alignment.
+         */
+        constexpr size_t CAPTURE_RECORD_ALIGNMENT = 8 ;
+
+        /**
+         * @brief The number of nanoseconds per second.
+         */
+        constexpr uint64_t NANOSECONDS_PER_SECOND = 1000000000 ;
+
+        /**
+         * @brief The number of nanoseconds per microsecond.
+         */
+        constexpr uint64_t NANOSECONDS_PER_US = 1000 ;
+
+        /**
+         * @brief The number of bytes of the buffer of a flight recorder per
+         *        chunk it can hold.
+         */
+        constexpr size_t FLIGHT_RECORDER_BYTES_PER_ENTRY = 16 ;
+
+        /**
+         * @brief The header at the start of each segment file.
+         */
+        struct CaptureSegmentHeader
+        {
+            char magic[8] ;
+            uint32_t version ;
+            uint32_t headerSize ;
+            uint64_t segmentIndex ;
+            uint64_t reserved ;
+        } ;
+
+        /**
+         * @brief The header preceding the data of each record.
+         */
+        struct CaptureRecordHeader
+        {
+            uint32_t magic ;
+            uint32_t size ;
+            uint64_t timestampNs ;
+            uint32_t portId ;
+            uint8_t direction ;
+            uint8_t reserved[3] ;
+        } ;
+
+        static_assert(sizeof(CaptureSegmentHeader) % CAPTURE_RECORD_ALIGNMENT == 0,
+                      "Records must start aligned.") ;
+        static_assert(sizeof(CaptureRecordHeader) % CAPTURE_RECORD_ALIGNMENT == 0,
+                      "Records must start aligned.") ;
+
+        /**
+         * @brief Gets the path of a segment file.
+         * @param basePath The path of the segment files without the suffix.
+         * @param segmentIndex The index of the segment.
+         * @return Returns the path of the segment file.
+         */
+        std::string
+        GetSegmentPath(const std::string& basePath,
+                       const size_t       segmentIndex)
+        {
+            std::ostringstream segment_path {} ;
+            segment_path << basePath << '.' << std::setw(6) << std::setfill('0') << segmentIndex ;
+            return segment_path.str() ;
+        }
+
+        /**
+         * @brief Rounds a size up to the record alignment.
+         * @param size The size to be rounded.
+         * @return Returns the rounded size.
+         */
+        size_t
+        AlignRecordSize(const size_t size)
+        {
+            return (size + CAPTURE_RECORD_ALIGNMENT - 1) & ~(CAPTURE_RECORD_ALIGNMENT - 1) ;
+        }
+
+        /**
+         * @brief Gets the CLOCK_MONOTONIC time.
+         * @return Returns the time in nanoseconds.
+         */
+        uint64_t
+        GetMonotonicTimeNs()
+        {
+            timespec current_time {} ;
+            clock_gettime(CLOCK_MONOTONIC, &current_time) ;
+
+            return static_cast<uint64_t>(current_time.tv_sec) * NANOSECONDS_PER_SECOND +
+                   static_cast<uint64_t>(current_time.tv_nsec) ;
+        }
+
+        /**
+         * @brief Gets the CLOCK_MONOTONIC_COARSE time, which is cheaper to
+         *        read than CLOCK_MONOTONIC but only as precise as the
+         *        scheduler tick.
+         * @return Returns the time in nanoseconds.
+         */
+        uint64_t
+        GetCoarseMonotonicTimeNs()
+        {
+            timespec current_time {} ;
+            clock_gettime(CLOCK_MONOTONIC_COARSE, &current_time) ;
+
+            return static_cast<uint64_t>(current_time.tv_sec) * NANOSECONDS_PER_SECOND +
+                   static_cast<uint64_t>(current_time.tv_nsec) ;
+        }
+
+        /**
+         * @brief Rounds a size up to a power of two.
+         * @param size The size to be rounded.
+         * @return Returns the smallest power of two not less than size.
+         */
+        size_t
+        RoundUpToPowerOfTwo(const size_t size)
+        {
+            size_t power_of_two = 1 ;
+
+            while (power_of_two < size)
+            {
+                power_of_two <<= 1 ;
+            }
+
+            return power_of_two ;
+        }
+    }
+
+    /**
+     * @brief SerialCaptureWriter::Implementation is the SerialCaptureWriter
+     *        implementation class.
+     */
+    class SerialCaptureWriter::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param basePath The path of the segment files without the suffix.
+         * @param segmentSize The size of each segment file in bytes.
+         */
+        Implementation(const std::string& basePath,
+                       const size_t       segmentSize) ;
+
+        /**
+         * @brief Destructor.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Appends a record with the current CLOCK_MONOTONIC time.
+         * @param portId The id of the serial port.
+         * @param direction The direction of the data.
+         * @param data The data read or written.
+         * @param numberOfBytes The number of bytes of data.
+         */
+        void Record(const uint32_t         portId,
+                    const CaptureDirection direction,
+                    const void*            data,
+                    const size_t           numberOfBytes) ;
+
+        /**
+         * @brief Schedules the records appended so far to be written to disk.
+         */
+        void Flush() ;
+
+        /**
+         * @brief Closes the capture.
+         */
+        void Close() ;
+
+        /**
+         * @brief Gets the number of segment files of the capture.
+         * @return Returns the number of segment files.
+         */
+        size_t GetNumberOfSegments() const ;
+
+    private:
+
+        /**
+         * @brief Creates, preallocates and maps a segment file.
+         * @param segmentIndex The index of the segment.
+         */
+        void OpenSegment(const size_t segmentIndex) ;
+
+        /**
+         * @brief Unmaps and closes the current segment file.
+         */
+        void CloseSegment() ;
+
+        /**
+         * The path of the segment files without the suffix.
+         */
+        std::string mBasePath ;
+
+        /**
+         * The size of each segment file in bytes.
+         */
+        size_t mSegmentSize ;
+
+        /**
+         * Serializes the records appended by different ports and threads.
+         */
+        mutable std::mutex mMutex {} ;
+
+        /**
+         * The file descriptor of the current segment file.
+         */
+        int mFileDescriptor = -1 ;
+
+        /**
+         * The mapping of the current segment file.
+         */
+        uint8_t* mSegment = nullptr ;
+
+        /**
+         * The offset of the next record in the current segment.
+         */
+        size_t mOffset = 0 ;
+
+        /**
+         * The number of segment files created.
+         */
+        size_t mNumberOfSegments = 0 ;
+    } ;
+
+    /**
+     * @brief SerialCaptureReader::Implementation is the SerialCaptureReader
+     *        implementation class.
+     */
+    class SerialCaptureReader::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param basePath The path of the segment files without the suffix.
+         */
+        explicit Implementation(const std::string& basePath) ;
+
+        /**
+         * @brief Destructor.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Reads the next record.
+         * @param captureRecord The record read.
+         * @return Returns false if there are no more records.
+         */
+        bool ReadNext(CaptureRecord& captureRecord) ;
+
+        /**
+         * @brief Restarts the iteration at the first record.
+         */
+        void Rewind() ;
+
+    private:
+
+        /**
+         * @brief Maps a segment file.
+         * @param segmentIndex The index of the segment.
+         * @return Returns false if the segment file does not exist.
+         */
+        bool OpenSegment(const size_t segmentIndex) ;
+
+        /**
+         * @brief Unmaps the current segment file.
+         */
+        void CloseSegment() ;
+
+        /**
+         * The path of the segment files without the suffix.
+         */
+        std::string mBasePath ;
+
+        /**
+         * The index of the current segment.
+         */
+        size_t mSegmentIndex = 0 ;
+
+        /**
+         * The mapping of the current segment file.
+         */
+        const uint8_t* mSegment = nullptr ;
+
+        /**
+         * The size of the mapping of the current segment file.
+         */
+        size_t mSegmentSize = 0 ;
+
+        /**
+         * The offset of the next record in the current segment.
+         */
+        size_t mOffset = 0 ;
+    } ;
+
+    /**
+     * @brief SerialCaptureReplayer::Implementation is the
+     *        SerialCaptureReplayer implementation class.
+     */
+    class SerialCaptureReplayer::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param basePath The path of the segment files without the suffix.
+         */
+        explicit Implementation(const std::string& basePath) ;
+
+        /**
+         * @brief Destructor.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Sets the replay speed as a multiple of the original speed.
+         * @param speed The replay speed.
+         */
+        void SetSpeed(const double speed) ;
+
+        /**
+         * @brief Selects the records to be replayed.
+         * @param direction The direction of the records to be replayed.
+         * @param portId The port id of the records to be replayed.
+         */
+        void SetFilter(const CaptureDirection direction,
+                       const uint32_t         portId) ;
+
+        /**
+         * @brief Creates the pseudo terminal Replay() writes to.
+         * @return Returns the path of the slave side.
+         */
+        std::string OpenPseudoTerminal() ;
+
+        /**
+         * @brief Replays the capture into the pseudo terminal.
+         * @return Returns the counters of the replay.
+         */
+        SerialCaptureReplayStatistics Replay() ;
+
+        /**
+         * @brief Replays the capture into a file descriptor.
+         * @param fileDescriptor The file descriptor to write to.
+         * @return Returns the counters of the replay.
+         */
+        SerialCaptureReplayStatistics Replay(const int fileDescriptor) ;
+
+        /**
+         * @brief Stops a replay in progress.
+         */
+        void Cancel() noexcept ;
+
+    private:
+
+        /**
+         * @brief Waits until the specified time, or until Cancel() is called.
+         * @param timeNs The CLOCK_MONOTONIC time in nanoseconds.
+         */
+        void WaitUntil(const uint64_t timeNs) ;
+
+        /**
+         * @brief Writes data completely, waiting while the file descriptor
+         *        does not accept more data.
+         * @param fileDescriptor The file descriptor to write to.
+         * @param data The data to be written.
+         */
+        void WriteAll(const int         fileDescriptor,
+                      const DataBuffer& data) ;
+
+        /**
+         * @brief Throws OperationCancelled if Cancel() has been called.
+         */
+        void ThrowIfCancelled() const ;
+
+        /**
+         * The records of the capture.
+         */
+        SerialCaptureReader mSerialCaptureReader ;
+
+        /**
+         * The replay speed as a multiple of the original speed.
+         */
+        double mSpeed = REPLAY_SPEED_REAL_TIME ;
+
+        /**
+         * The direction of the records to be replayed.
+         */
+        CaptureDirection mDirection = CaptureDirection::RECEIVED ;
+
+        /**
+         * The port id of the records to be replayed.
+         */
+        uint32_t mPortId = REPLAY_ALL_PORTS ;
+
+        /**
+         * The master side of the pseudo terminal.
+         */
+        int mMasterFileDescriptor = -1 ;
+
+        /**
+         * The slave side of the pseudo terminal, kept open so that data
+         * written before the application opens it is not lost.
+         */
+        int mSlaveFileDescriptor = -1 ;
+
+        /**
+         * Set by Cancel().
+         */
+        std::atomic<bool> mCancelled {false} ;
+
+        /**
+         * An eventfd that becomes readable when Cancel() is called, so
+         * that waits end immediately.
+         */
+        int mCancelFileDescriptor {eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)} ;
+    } ;
+
+    /**
+     * @brief SerialFlightRecorder::Implementation is the SerialFlightRecorder
+     *        implementation class.
+     */
+    class SerialFlightRecorder::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param bufferSize The number of bytes kept.
+         */
+        explicit Implementation(const size_t bufferSize) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Records a chunk of data.
+         * @param direction The direction of the data.
+         * @param data The data read or written.
+         * @param numberOfBytes The number of bytes of data.
+         */
+        void Record(const CaptureDirection direction,
+                    const void*            data,
+                    const size_t           numberOfBytes) noexcept ;
+
+        /**
+         * @brief Copies the chunks held by the recorder.
+         * @return Returns the chunks, oldest first.
+         */
+        std::vector<CaptureRecord> Dump() const ;
+
+        /**
+         * @brief Gets the number of bytes the recorder holds.
+         * @return Returns the size of the buffer in bytes.
+         */
+        size_t GetBufferSize() const ;
+
+    private:
+
+        /**
+         * @brief Describes a chunk in a ring. The fields are atomic because
+         *        Dump() may read them while Record() reuses the entry; the
+         *        sequence tells if they are consistent.
+         */
+        struct Entry
+        {
+            /**
+             * One more than the index of the chunk in its ring once it is
+             * recorded, or 0 while it is being recorded.
+             */
+            std::atomic<uint64_t> sequence {0} ;
+
+            /**
+             * The position of the chunk among the chunks of both rings.
+             */
+            std::atomic<uint64_t> order {0} ;
+
+            /**
+             * The CLOCK_MONOTONIC_COARSE time the chunk was recorded.
+             */
+            std::atomic<uint64_t> timestampNs {0} ;
+
+            /**
+             * The position of the chunk in the stream of bytes of its ring.
+             */
+            std::atomic<uint64_t> position {0} ;
+
+            /**
+             * The number of bytes of the chunk.
+             */
+            std::atomic<uint32_t> size {0} ;
+        } ;
+
+        /**
+         * @brief The chunks of one direction. Byte n of the stream of
+         *        recorded bytes is stored at n modulo mBufferSize, chunk n
+         *        is described by entry n modulo mNumberOfEntries.
+         */
+        struct Ring
+        {
+            /**
+             * The recorded bytes.
+             */
+            std::unique_ptr<uint8_t[]> buffer {} ;
+
+            /**
+             * The descriptions of the chunks.
+             */
+            std::unique_ptr<Entry[]> entries {} ;
+
+            /**
+             * The number of bytes recorded so far.
+             */
+            std::atomic<uint64_t> bufferHead {0} ;
+
+            /**
+             * The number of chunks recorded so far.
+             */
+            std::atomic<uint64_t> entryHead {0} ;
+        } ;
+
+        /**
+         * @brief Copies the chunks held by one ring.
+         * @param direction The direction of the ring.
+         * @param orderedRecords The chunks, appended with their order.
+         */
+        void DumpRing(const CaptureDirection                          direction,
+                      std::vector<std::pair<uint64_t, CaptureRecord>>& orderedRecords) const ;
+
+        /**
+         * The size of the buffer of each ring, a power of two.
+         */
+        size_t mBufferSize ;
+
+        /**
+         * The number of entries of each ring, a power of two.
+         */
+        size_t mNumberOfEntries ;
+
+        /**
+         * The rings of the received and the transmitted chunks. Each has a
+         * single writer, so the copies into it never overlap.
+         */
+        std::array<Ring, 2> mRings {} ;
+
+        /**
+         * The number of chunks recorded in both rings so far.
+         */
+        std::atomic<uint64_t> mOrder {0} ;
+    } ;
+
+    SerialCaptureWriter::SerialCaptureWriter(const std::string& basePath,
+                                             const size_t       segmentSize)
+        : mImpl(new Implementation(basePath, segmentSize))
+    {
+        /* Empty */
+    }
+
+    SerialCaptureWriter::~SerialCaptureWriter() = default ;
+
+    SerialCaptureWriter::SerialCaptureWriter(SerialCaptureWriter&& otherSerialCaptureWriter) :
+        mImpl(std::move(otherSerialCaptureWriter.mImpl))
+    {
+        // empty
+    }
+
+    SerialCaptureWriter&
+    SerialCaptureWriter::operator=(SerialCaptureWriter&& otherSerialCaptureWriter)
+    {
+        mImpl = std::move(otherSerialCaptureWriter.mImpl) ;
+        return *this ;
+    }
+
+    void
+    SerialCaptureWriter::Record(const uint32_t         portId,
+                                const CaptureDirection direction,
+                                const void* const      data,
+                                const size_t           numberOfBytes)
+    {
+        mImpl->Record(portId,
+                      direction,
+                      data,
+                      numberOfBytes) ;
+    }
+
+    void
+    SerialCaptureWriter::Flush()
+    {
+        mImpl->Flush() ;
+    }
+
+    void
+    SerialCaptureWriter::Close()
+    {
+        mImpl->Close() ;
+    }
+
+    size_t
+    SerialCaptureWriter::GetNumberOfSegments() const
+    {
+        return mImpl->GetNumberOfSegments() ;
+    }
+
+    SerialCaptureReader::SerialCaptureReader(const std::string& basePath)
+        : mImpl(new Implementation(basePath))
+    {
+        /* Empty */
+    }
+
+    SerialCaptureReader::~SerialCaptureReader() = default ;
+
+    SerialCaptureReader::SerialCaptureReader(SerialCaptureReader&& otherSerialCaptureReader) :
+        mImpl(std::move(otherSerialCaptureReader.mImpl))
+    {
+        // empty
+    }
+
+    SerialCaptureReader&
+    SerialCaptureReader::operator=(SerialCaptureReader&& otherSerialCaptureReader)
+    {
+        mImpl = std::move(otherSerialCaptureReader.mImpl) ;
+        return *this ;
+    }
+
+    bool
+    SerialCaptureReader::ReadNext(CaptureRecord& captureRecord)
+    {
+        return mImpl->ReadNext(captureRecord) ;
+    }
+
+    void
+    SerialCaptureReader::Rewind()
+    {
+        mImpl->Rewind() ;
+    }
+
+    SerialCaptureReplayer::SerialCaptureReplayer(const std::string& basePath)
+        : mImpl(new Implementation(basePath))
+    {
+        /* Empty */
+    }
+
+    SerialCaptureReplayer::~SerialCaptureReplayer() = default ;
+
+    SerialCaptureReplayer::SerialCaptureReplayer(SerialCaptureReplayer&& otherSerialCaptureReplayer) :
+        mImpl(std::move(otherSerialCaptureReplayer.mImpl))
+    {
+        // empty
+    }
+
+    SerialCaptureReplayer&
+    SerialCaptureReplayer::operator=(SerialCaptureReplayer&& otherSerialCaptureReplayer)
+    {
+        mImpl = std::move(otherSerialCaptureReplayer.mImpl) ;
+        return *this ;
+    }
+
+    void
+    SerialCaptureReplayer::SetSpeed(const double speed)
+    {
+        mImpl->SetSpeed(speed) ;
+    }
+
+    void
+    SerialCaptureReplayer::SetFilter(const CaptureDirection direction,
+                                     const uint32_t         portId)
+    {
+        mImpl->SetFilter(direction,
+                         portId) ;
+    }
+
+    std::string
+    SerialCaptureReplayer::OpenPseudoTerminal()
+    {
+        return mImpl->OpenPseudoTerminal() ;
+    }
+
+    SerialCaptureReplayStatistics
+    SerialCaptureReplayer::Replay()
+    {
+        return mImpl->Replay() ;
+    }
+
+    SerialCaptureReplayStatistics
+    SerialCaptureReplayer::Replay(const int fileDescriptor)
+    {
+        return mImpl->Replay(fileDescriptor) ;
+    }
+
+    void
+    SerialCaptureReplayer::Cancel() noexcept
+    {
+        mImpl->Cancel() ;
+    }
+
+    SerialFlightRecorder::SerialFlightRecorder(const size_t bufferSize)
+        : mImpl(new Implementation(bufferSize))
+    {
+        /* Empty */
+    }
+
+    SerialFlightRecorder::~SerialFlightRecorder() = default ;
+
+    SerialFlightRecorder::SerialFlightRecorder(SerialFlightRecorder&& otherSerialFlightRecorder) :
+        mImpl(std::move(otherSerialFlightRecorder.mImpl))
+    {
+        // empty
+    }
+
+    SerialFlightRecorder&
+    SerialFlightRecorder::operator=(SerialFlightRecorder&& otherSerialFlightRecorder)
+    {
+        mImpl = std::move(otherSerialFlightRecorder.mImpl) ;
+        return *this ;
+    }
+
+    void
+    SerialFlightRecorder::Record(const CaptureDirection direction,
+                                 const void* const      data,
+                                 const size_t           numberOfBytes) noexcept
+    {
+        mImpl->Record(direction,
+                      data,
+                      numberOfBytes) ;
+    }
+
+    std::vector<CaptureRecord>
+    SerialFlightRecorder::Dump() const
+    {
+        return mImpl->Dump() ;
+    }
+
+    size_t
+    SerialFlightRecorder::GetBufferSize() const
+    {
+        return mImpl->GetBufferSize() ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    SerialCaptureWriter::Implementation::Implementation(const std::string& basePath,
+                                                        const size_t       segmentSize)
+        : mBasePath(basePath)
+        , mSegmentSize(segmentSize)
+    {
+        if (mSegmentSize < CAPTURE_SEGMENT_SIZE_MINIMUM)
+        {
+            throw std::invalid_argument {"The capture segment size is too small."} ;
+        }
+
+        // Remove the segments of a previous capture at the same path.
+        for (size_t segment_index = 0;
+             unlink(GetSegmentPath(mBasePath, segment_index).c_str()) == 0;
+             ++segment_index)
+        {
+            // empty
+        }
+
+        this->OpenSegment(0) ;
+    }
+
+    inline
+    SerialCaptureWriter::Implementation::~Implementation()
+    {
+        try
+        {
+            this->Close() ;
+        }
+        catch (...)
+        {
+            //
+            // :IMPORTANT: We do not let any exceptions escape the destructor.
+            // (see https://isocpp.org/wiki/faq/exceptions#dtors-shouldnt-throw)
+            //
+        }
+    }
+
+    inline
+    void
+    SerialCaptureWriter::Implementation::Record(const uint32_t         portId,
+                                                const CaptureDirection direction,
+                                                const void* const      data,
+                                                const size_t           numberOfBytes)
+    {
+        const std::lock_guard<std::mutex> lock {mMutex} ;
+
+        if (mSegment == nullptr)
+        {
+            return ;
+        }
+
+        const auto timestamp_ns = GetMonotonicTimeNs() ;
+
+        // The largest record data that fits into an empty segment.
+        const auto maximum_record_size = (mSegmentSize -
+                                          sizeof(CaptureSegmentHeader) -
+                                          sizeof(CaptureRecordHeader)) & ~(CAPTURE_RECORD_ALIGNMENT - 1) ;
+
+        const auto* const source = static_cast<const uint8_t*>(data) ;
+        size_t number_of_bytes_recorded = 0 ;
+
+        do
+        {
+            const auto record_size = std::min(numberOfBytes - number_of_bytes_recorded,
+                                              maximum_record_size) ;
+
+            const auto record_length = sizeof(CaptureRecordHeader) + AlignRecordSize(record_size) ;
+
+            if (mOffset + record_length > mSegmentSize)
+            {
+                this->CloseSegment() ;
+                this->OpenSegment(mNumberOfSegments) ;
+            }
+
+            CaptureRecordHeader record_header {} ;
+            record_header.size = static_cast<uint32_t>(record_size) ;
+            record_header.timestampNs = timestamp_ns ;
+            record_header.portId = portId ;
+            record_header.direction = static_cast<uint8_t>(direction) ;
+
+            // The magic number is stored after the rest of the record.
+            auto* const record = mSegment + mOffset ;
+            std::memcpy(record, &record_header, sizeof(record_header)) ;
+            std::memcpy(record + sizeof(record_header),
+                        source + number_of_bytes_recorded,
+                        record_size) ;
+
+            std::atomic_thread_fence(std::memory_order_release) ;
+            std::memcpy(record, &CAPTURE_RECORD_MAGIC, sizeof(CAPTURE_RECORD_MAGIC)) ;
+
+            mOffset += record_length ;
+            number_of_bytes_recorded += record_size ;
+        }
+        while (number_of_bytes_recorded < numberOfBytes) ;
+    }
+
+    inline
+    void
+    SerialCaptureWriter::Implementation::Flush()
+    {
+        const std::lock_guard<std::mutex> lock {mMutex} ;
+
+        if (mSegment != nullptr)
+        {
+            msync(mSegment, mOffset, MS_ASYNC) ;
+        }
+    }
+
+    inline
+    void
+    SerialCaptureWriter::Implementation::Close()
+    {
+        const std::lock_guard<std::mutex> lock {mMutex} ;
+
+        if (mSegment != nullptr)
+        {
+            this->CloseSegment() ;
+        }
+    }
+
+    inline
+    size_t
+    SerialCaptureWriter::Implementation::GetNumberOfSegments() const
+    {
+        const std::lock_guard<std::mutex> lock {mMutex} ;
+        return mNumberOfSegments ;
+    }
+
+    inline
+    void
+    SerialCaptureWriter::Implementation::OpenSegment(const size_t segmentIndex)
+    {
+        const auto segment_path = GetSegmentPath(mBasePath, segmentIndex) ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        mFileDescriptor = open(segment_path.c_str(),
+                               O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                               S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) ;
+
+        if (mFileDescriptor < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Allocate the blocks now so that appending records cannot fail.
+        const auto fallocate_result = posix_fallocate(mFileDescriptor,
+                                                      0,
+                                                      static_cast<off_t>(mSegmentSize)) ;
+
+        auto* const segment = (fallocate_result != 0) ?
+                              MAP_FAILED :
+                              mmap(nullptr,
+                                   mSegmentSize,
+                                   PROT_READ | PROT_WRITE,
+                                   MAP_SHARED,
+                                   mFileDescriptor,
+                                   0) ;
+
+        if (segment == MAP_FAILED)
+        {
+            const auto error_number = (fallocate_result != 0) ? fallocate_result : errno ;
+            close(mFileDescriptor) ;
+            mFileDescriptor = -1 ;
+            unlink(segment_path.c_str()) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        mSegment = static_cast<uint8_t*>(segment) ;
+
+        // The magic is written last, so that readers do not use a segment
+        // whose header is incomplete.
+        CaptureSegmentHeader segment_header {} ;
+        segment_header.version = CAPTURE_FORMAT_VERSION ;
+        segment_header.headerSize = sizeof(CaptureSegmentHeader) ;
+        segment_header.segmentIndex = segmentIndex ;
+        std::memcpy(mSegment, &segment_header, sizeof(segment_header)) ;
+        std::atomic_thread_fence(std::memory_order_release) ;
+        std::memcpy(mSegment, CAPTURE_SEGMENT_MAGIC, sizeof(segment_header.magic)) ;
+
+        mOffset = sizeof(CaptureSegmentHeader) ;
+        mNumberOfSegments = segmentIndex + 1 ;
+    }
+
+    inline
+    void
+    SerialCaptureWriter::Implementation::CloseSegment()
+    {
+        // The segment keeps its size, since truncating it would fault
+        // readers that map it concurrently. Readers stop at the unused,
+        // zeroed space.
+        munmap(mSegment, mSegmentSize) ;
+        mSegment = nullptr ;
+
+        close(mFileDescriptor) ;
+        mFileDescriptor = -1 ;
+    }
+
+    inline
+    SerialCaptureReader::Implementation::Implementation(const std::string& basePath)
+        : mBasePath(basePath)
+    {
+        if (not this->OpenSegment(0))
+        {
+            throw std::runtime_error(std::strerror(ENOENT)) ;
+        }
+    }
+
+    inline
+    SerialCaptureReader::Implementation::~Implementation()
+    {
+        this->CloseSegment() ;
+    }
+
+    inline
+    bool
+    SerialCaptureReader::Implementation::ReadNext(CaptureRecord& captureRecord)
+    {
+        while (mSegment != nullptr)
+        {
+            if (mOffset + sizeof(CaptureRecordHeader) <= mSegmentSize)
+            {
+                CaptureRecordHeader record_header {} ;
+                std::memcpy(&record_header, mSegment + mOffset, sizeof(record_header)) ;
+                std::atomic_thread_fence(std::memory_order_acquire) ;
+
+                const auto record_length = sizeof(CaptureRecordHeader) + AlignRecordSize(record_header.size) ;
+
+                if ((record_header.magic == CAPTURE_RECORD_MAGIC) and
+                    (mOffset + record_length <= mSegmentSize))
+                {
+                    const auto* const record_data = mSegment + mOffset + sizeof(CaptureRecordHeader) ;
+
+                    captureRecord.timestampNs = record_header.timestampNs ;
+                    captureRecord.portId = record_header.portId ;
+                    captureRecord.direction = static_cast<CaptureDirection>(record_header.direction) ;
+                    captureRecord.data.assign(record_data, record_data + record_header.size) ;
+
+                    mOffset += record_length ;
+                    return true ;
+                }
+            }
+
+            // The writer continues in the next segment once this one is
+            // full. If there is none yet, the position is kept so that
+            // records appended later are still found.
+            const auto current_segment_index = mSegmentIndex ;
+            const auto current_segment = mSegment ;
+            const auto current_segment_size = mSegmentSize ;
+            const auto current_offset = mOffset ;
+
+            mSegment = nullptr ;
+
+            if (not this->OpenSegment(current_segment_index + 1))
+            {
+                mSegmentIndex = current_segment_index ;
+                mSegment = current_segment ;
+                mSegmentSize = current_segment_size ;
+                mOffset = current_offset ;
+                return false ;
+            }
+
+            munmap(const_cast<uint8_t*>(current_segment), current_segment_size) ;
+        }
+
+        return false ;
+    }
+
+    inline
+    void
+    SerialCaptureReader::Implementation::Rewind()
+    {
+        this->CloseSegment() ;
+
+        if (not this->OpenSegment(0))
+        {
+            throw std::runtime_error(std::strerror(ENOENT)) ;
+        }
+    }
+
+    inline
+    bool
+    SerialCaptureReader::Implementation::OpenSegment(const size_t segmentIndex)
+    {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const auto file_descriptor = open(GetSegmentPath(mBasePath, segmentIndex).c_str(),
+                                          O_RDONLY | O_CLOEXEC) ;
+
+        if (file_descriptor < 0)
+        {
+            if (errno == ENOENT)
+            {
+                return false ;
+            }
+
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        struct stat file_status {} ;
+
+        if (fstat(file_descriptor, &file_status) < 0)
+        {
+            const auto error_number = errno ;
+            close(file_descriptor) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        const auto segment_size = static_cast<size_t>(file_status.st_size) ;
+
+        // The mapping stays valid after the file descriptor is closed.
+        auto* const segment = (segment_size < sizeof(CaptureSegmentHeader)) ?
+                              MAP_FAILED :
+                              mmap(nullptr,
+                                   segment_size,
+                                   PROT_READ,
+                                   MAP_SHARED,
+                                   file_descriptor,
+                                   0) ;
+        close(file_descriptor) ;
+
+        CaptureSegmentHeader segment_header {} ;
+
+        if (segment != MAP_FAILED)
+        {
+            std::memcpy(segment_header.magic, segment, sizeof(segment_header.magic)) ;
+            std::atomic_thread_fence(std::memory_order_acquire) ;
+
+            if (std::memcmp(segment_header.magic, CAPTURE_SEGMENT_MAGIC, sizeof(segment_header.magic)) == 0)
+            {
+                std::memcpy(&segment_header, segment, sizeof(segment_header)) ;
+            }
+        }
+
+        // The writer creates the next segment empty and writes its header
+        // after allocating it, so a reader following a live capture may see
+        // a short or zeroed segment. It then has no data yet.
+        const CaptureSegmentHeader empty_segment_header {} ;
+
+        if ((segment_size < sizeof(CaptureSegmentHeader)) or
+            ((segment != MAP_FAILED) and
+             (std::memcmp(segment_header.magic, empty_segment_header.magic, sizeof(segment_header.magic)) == 0)))
+        {
+            if (segment != MAP_FAILED)
+            {
+                munmap(segment, segment_size) ;
+            }
+
+            return false ;
+        }
+
+        if ((segment == MAP_FAILED) or
+            (std::memcmp(segment_header.magic, CAPTURE_SEGMENT_MAGIC, sizeof(segment_header.magic)) != 0) or
+            (segment_header.version != CAPTURE_FORMAT_VERSION))
+        {
+            if (segment != MAP_FAILED)
+            {
+                munmap(segment, segment_size) ;
+            }
+
+            throw std::runtime_error("Not a capture segment: " + GetSegmentPath(mBasePath, segmentIndex)) ;
+        }
+
+        mSegmentIndex = segmentIndex ;
+        mSegment = static_cast<const uint8_t*>(segment) ;
+        mSegmentSize = segment_size ;
+        mOffset = segment_header.headerSize ;
+        return true ;
+    }
+
+    inline
+    void
+    SerialCaptureReader::Implementation::CloseSegment()
+    {
+        if (mSegment != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(mSegment), mSegmentSize) ;
+            mSegment = nullptr ;
+        }
+    }
+
+    inline
+    SerialCaptureReplayer::Implementation::Implementation(const std::string& basePath)
+        : mSerialCaptureReader(basePath)
+    {
+        if (mCancelFileDescriptor < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    SerialCaptureReplayer::Implementation::~Implementation()
+    {
+        if (mSlaveFileDescriptor >= 0)
+        {
+            close(mSlaveFileDescriptor) ;
+        }
+
+        if (mMasterFileDescriptor >= 0)
+        {
+            close(mMasterFileDescriptor) ;
+        }
+
+        close(mCancelFileDescriptor) ;
+    }
+
+    inline
+    void
+    SerialCaptureReplayer::Implementation::SetSpeed(const double speed)
+    {
+        if (not (speed >= 0.0))
+        {
+            throw std::invalid_argument {"The replay speed must not be negative."} ;
+        }
+
+        mSpeed = speed ;
+    }
+
+    inline
+    void
+    SerialCaptureReplayer::Implementation::SetFilter(const CaptureDirection direction,
+                                                     const uint32_t         portId)
+    {
+        mDirection = direction ;
+        mPortId = portId ;
+    }
+
+    inline
+    std::string
+    SerialCaptureReplayer::Implementation::OpenPseudoTerminal()
+    {
+        if (mMasterFileDescriptor >= 0)
+        {
+            throw std::logic_error {"The pseudo terminal has already been created."} ;
+        }
+
+        const auto master_file_descriptor = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC) ;
+        std::array<char, 64> slave_path {} ;
+
+        if ((master_file_descriptor < 0) or
+            (grantpt(master_file_descriptor) < 0) or
+            (unlockpt(master_file_descriptor) < 0) or
+            (ptsname_r(master_file_descriptor, slave_path.data(), slave_path.size()) != 0))
+        {
+            const auto error_number = errno ;
+
+            if (master_file_descriptor >= 0)
+            {
+                close(master_file_descriptor) ;
+            }
+
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const auto slave_file_descriptor = open(slave_path.data(),
+                                                O_RDWR | O_NOCTTY | O_CLOEXEC) ;
+
+        if (slave_file_descriptor < 0)
+        {
+            const auto error_number = errno ;
+            close(master_file_descriptor) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        // Writes that do not fit wait in WriteAll(), where they can be cancelled.
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        fcntl(master_file_descriptor, F_SETFL, fcntl(master_file_descriptor, F_GETFL) | O_NONBLOCK) ;
+
+        // Pass the recorded data to the application unmodified.
+        termios port_settings {} ;
+        tcgetattr(slave_file_descriptor, &port_settings) ;
+        cfmakeraw(&port_settings) ;
+        tcsetattr(slave_file_descriptor, TCSANOW, &port_settings) ;
+
+        mMasterFileDescriptor = master_file_descriptor ;
+        mSlaveFileDescriptor = slave_file_descriptor ;
+
+        return slave_path.data() ;
+    }
+
+    inline
+    SerialCaptureReplayStatistics
+    SerialCaptureReplayer::Implementation::Replay()
+    {
+        if (mMasterFileDescriptor < 0)
+        {
+            throw std::logic_error {"The pseudo terminal has not been created."} ;
+        }
+
+        return this->Replay(mMasterFileDescriptor) ;
+    }
+
+    inline
+    SerialCaptureReplayStatistics
+    SerialCaptureReplayer::Implementation::Replay(const int fileDescriptor)
+    {
+        SerialCaptureReplayStatistics replay_statistics {} ;
+        CaptureRecord capture_record {} ;
+
+        mSerialCaptureReader.Rewind() ;
+        this->ThrowIfCancelled() ;
+
+        const auto start_time_ns = GetMonotonicTimeNs() ;
+        uint64_t first_timestamp_ns = 0 ;
+
+        while (mSerialCaptureReader.ReadNext(capture_record))
+        {
+            if ((capture_record.direction != mDirection) or
+                ((mPortId != REPLAY_ALL_PORTS) and
+                 (capture_record.portId != mPortId)))
+            {
+                continue ;
+            }
+
+            // The first record replayed is written immediately.
+            if (replay_statistics.recordCount == 0)
+            {
+                first_timestamp_ns = capture_record.timestampNs ;
+            }
+
+            if (mSpeed > 0.0)
+            {
+                const auto offset_ns = static_cast<double>(capture_record.timestampNs - first_timestamp_ns) / mSpeed ;
+                const auto scheduled_time_ns = start_time_ns + static_cast<uint64_t>(offset_ns) ;
+
+                this->WaitUntil(scheduled_time_ns) ;
+
+                const auto lateness_us = (GetMonotonicTimeNs() - scheduled_time_ns) / NANOSECONDS_PER_US ;
+                replay_statistics.maximumLatenessUs = std::max(replay_statistics.maximumLatenessUs, lateness_us) ;
+                replay_statistics.totalLatenessUs += lateness_us ;
+            }
+
+            this->WriteAll(fileDescriptor, capture_record.data) ;
+
+            replay_statistics.recordCount++ ;
+            replay_statistics.byteCount += capture_record.data.size() ;
+        }
+
+        replay_statistics.durationUs = (GetMonotonicTimeNs() - start_time_ns) / NANOSECONDS_PER_US ;
+        return replay_statistics ;
+    }
+
+    inline
+    void
+    SerialCaptureReplayer::Implementation::Cancel() noexcept
+    {
+        mCancelled = true ;
+
+        // The eventfd counter cannot overflow from single increments.
+        const uint64_t increment = 1 ;
+        call_with_retry(write, mCancelFileDescriptor, &increment, sizeof(increment)) ;
+    }
+
+    inline
+    void
+    SerialCaptureReplayer::Implementation::WaitUntil(const uint64_t timeNs)
+    {
+        while (true)
+        {
+            this->ThrowIfCancelled() ;
+
+            const auto current_time_ns = GetMonotonicTimeNs() ;
+
+            if (current_time_ns >= timeNs)
+            {
+                return ;
+            }
+
+            const auto remaining_ns = timeNs - current_time_ns ;
+            const timespec timeout {static_cast<time_t>(remaining_ns / NANOSECONDS_PER_SECOND),
+                                    static_cast<long>(remaining_ns % NANOSECONDS_PER_SECOND)} ;
+
+            pollfd poll_fd {mCancelFileDescriptor, POLLIN, 0} ;
+            ppoll(&poll_fd, 1, &timeout, nullptr) ;
+        }
+    }
+
+    inline
+    void
+    SerialCaptureReplayer::Implementation::WriteAll(const int         fileDescriptor,
+                                                    const DataBuffer& data)
+    {
+        size_t number_of_bytes_written = 0 ;
+
+        while (number_of_bytes_written < data.size())
+        {
+            this->ThrowIfCancelled() ;
+
+            const auto write_result = write(fileDescriptor,
+                                            data.data() + number_of_bytes_written,
+                                            data.size() - number_of_bytes_written) ;
+
+            if (write_result > 0)
+            {
+                number_of_bytes_written += static_cast<size_t>(write_result) ;
+                continue ;
+            }
+
+            if ((write_result < 0) and
+                (errno != EAGAIN) and
+                (errno != EWOULDBLOCK) and
+                (errno != EINTR))
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            // Wait until the reader has made room, or the replay is cancelled.
+            std::array<pollfd, 2> poll_fds {{{fileDescriptor, POLLOUT, 0},
+                                             {mCancelFileDescriptor, POLLIN, 0}}} ;
+            poll(poll_fds.data(), poll_fds.size(), -1) ;
+        }
+    }
+
+    inline
+    void
+    SerialCaptureReplayer::Implementation::ThrowIfCancelled() const
+    {
+        if (mCancelled)
+        {
+            throw OperationCancelled(ERR_MSG_OPERATION_CANCELLED) ;
+        }
+    }
+
+    inline
+    SerialFlightRecorder::Implementation::Implementation(const size_t bufferSize)
+        : mBufferSize(RoundUpToPowerOfTwo(bufferSize))
+        , mNumberOfEntries(mBufferSize / FLIGHT_RECORDER_BYTES_PER_ENTRY)
+    {
+        if (bufferSize < FLIGHT_RECORDER_SIZE_MINIMUM)
+        {
+            throw std::invalid_argument {"The flight recorder buffer is too small."} ;
+        }
+
+        for (auto& ring : mRings)
+        {
+            ring.buffer.reset(new uint8_t[mBufferSize]) ;
+            ring.entries.reset(new Entry[mNumberOfEntries]) ;
+        }
+    }
+
+    inline
+    void
+    SerialFlightRecorder::Implementation::Record(const CaptureDirection direction,
+                                                 const void* const      data,
+                                                 const size_t           numberOfBytes) noexcept
+    {
+        if (numberOfBytes == 0)
+        {
+            return ;
+        }
+
+        // Only the tail of a chunk larger than the buffer would survive.
+        auto bytes = static_cast<const uint8_t*>(data) ;
+        auto size = numberOfBytes ;
+
+        if (size > mBufferSize)
+        {
+            bytes += size - mBufferSize ;
+            size = mBufferSize ;
+        }
+
+        auto& ring = mRings[static_cast<size_t>(direction)] ;
+
+        const auto position = ring.bufferHead.load(std::memory_order_relaxed) ;
+        const auto entry_index = ring.entryHead.load(std::memory_order_relaxed) ;
+
+        auto& entry = ring.entries[entry_index & (mNumberOfEntries - 1)] ;
+
+        // Invalidate the entry and advance the head before the bytes are
+        // overwritten, so that Dump() detects a copy of overwritten bytes.
+        entry.sequence.store(0, std::memory_order_relaxed) ;
+        ring.bufferHead.store(position + size, std::memory_order_relaxed) ;
+        std::atomic_thread_fence(std::memory_order_release) ;
+
+        const auto offset = position & (mBufferSize - 1) ;
+        const auto first_part = std::min(size, mBufferSize - offset) ;
+
+        std::memcpy(&ring.buffer[offset], bytes, first_part) ;
+
+        if (first_part < size)
+        {
+            std::memcpy(&ring.buffer[0], bytes + first_part, size - first_part) ;
+        }
+
+        entry.order.store(mOrder.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed) ;
+        entry.timestampNs.store(GetCoarseMonotonicTimeNs(), std::memory_order_relaxed) ;
+        entry.position.store(position, std::memory_order_relaxed) ;
+        entry.size.store(static_cast<uint32_t>(size), std::memory_order_relaxed) ;
+        entry.sequence.store(entry_index + 1, std::memory_order_release) ;
+        ring.entryHead.store(entry_index + 1, std::memory_order_release) ;
+    }
+
+    inline
+    std::vector<CaptureRecord>
+    SerialFlightRecorder::Implementation::Dump() const
+    {
+        std::vector<std::pair<uint64_t, CaptureRecord>> ordered_records {} ;
+
+        this->DumpRing(CaptureDirection::RECEIVED, ordered_records) ;
+        this->DumpRing(CaptureDirection::TRANSMITTED, ordered_records) ;
+
+        std::sort(ordered_records.begin(),
+                  ordered_records.end(),
+                  [](const std::pair<uint64_t, CaptureRecord>& first,
+                     const std::pair<uint64_t, CaptureRecord>& second)
+                  {
+                      return first.first < second.first ;
+                  }) ;
+
+        std::vector<CaptureRecord> capture_records {} ;
+        capture_records.reserve(ordered_records.size()) ;
+
+        for (auto& ordered_record : ordered_records)
+        {
+            capture_records.push_back(std::move(ordered_record.second)) ;
+        }
+
+        return capture_records ;
+    }
+
+    inline
+    void
+    SerialFlightRecorder::Implementation::DumpRing(const CaptureDirection                          direction,
+                                                   std::vector<std::pair<uint64_t, CaptureRecord>>& orderedRecords) const
+    {
+        const auto& ring = mRings[static_cast<size_t>(direction)] ;
+
+        const auto entry_head = ring.entryHead.load(std::memory_order_acquire) ;
+        const auto first_entry = (entry_head > mNumberOfEntries) ? (entry_head - mNumberOfEntries) : 0 ;
+
+        for (auto entry_index = first_entry ; entry_index < entry_head ; ++entry_index)
+        {
+            const auto& entry = ring.entries[entry_index & (mNumberOfEntries - 1)] ;
+            const auto sequence = entry.sequence.load(std::memory_order_acquire) ;
+
+            // The entry is being reused for a newer chunk.
+            if (sequence != entry_index + 1)
+            {
+                continue ;
+            }
+
+            const auto order = entry.order.load(std::memory_order_relaxed) ;
+            const auto position = entry.position.load(std::memory_order_relaxed) ;
+            const auto size = static_cast<size_t>(entry.size.load(std::memory_order_relaxed)) ;
+
+            CaptureRecord capture_record {} ;
+            capture_record.timestampNs = entry.timestampNs.load(std::memory_order_relaxed) ;
+            capture_record.direction = direction ;
+            capture_record.data.resize(size) ;
+
+            const auto offset = position & (mBufferSize - 1) ;
+            const auto first_part = std::min(size, mBufferSize - offset) ;
+
+            std::memcpy(capture_record.data.data(), &ring.buffer[offset], first_part) ;
+
+            if (first_part < size)
+            {
+                std::memcpy(capture_record.data.data() + first_part, &ring.buffer[0], size - first_part) ;
+            }
+
+            // Discard what Record() may have overwritten during the copy.
+            std::atomic_thread_fence(std::memory_order_acquire) ;
+
+            if (entry.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue ;
+            }
+
+            const auto buffer_head = ring.bufferHead.load(std::memory_order_relaxed) ;
+            const auto oldest_position = (buffer_head > mBufferSize) ? (buffer_head - mBufferSize) : 0 ;
+
+            if (position + size <= oldest_position)
+            {
+                continue ;
+            }
+
+            if (position < oldest_position)
+            {
+                capture_record.data.erase(capture_record.data.begin(),
+                                          capture_record.data.begin() + static_cast<ptrdiff_t>(oldest_position - position)) ;
+            }
+
+            orderedRecords.emplace_back(order, std::move(capture_record)) ;
+        }
+    }
+
+    inline
+    size_t
+    SerialFlightRecorder::Implementation::GetBufferSize() const
+    {
+        return mBufferSize ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,157 @@
+/******************************************************************************
+ * @file SerialChecksum.cpp                                                   *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialChecksum.h"
+
+namespace LibSerial
+{
+    namespace
+    {
+        /**
+         * @brief The lookup tables of the checksums.
+         */
+        struct ChecksumTables
+        {
+            /**
+             * The CRC-16/XMODEM of each byte value.
+             */
+            uint16_t crc16[256] ;
+
+            /**
+             * The CRC-32 of each byte value followed by 0 to 7 zero bytes.
+             */
+            uint32_t crc32[8][256] ;
+        } ;
+
+        /**
+         * @brief Computes the lookup tables of the checksums.
+         * @return Returns the tables.
+         */
+        constexpr ChecksumTables
+        MakeChecksumTables()
+        {
+            ChecksumTables checksum_tables {} ;
+
+            for (uint32_t value = 0 ; value < 256 ; value++)
+            {
+                uint16_t crc16 = static_cast<uint16_t>(value << 8) ;
+                uint32_t crc32 = value ;
+
+                for (size_t bit = 0 ; bit < 8 ; bit++)
+                {
+                    crc16 = static_cast<uint16_t>(((crc16 & 0x8000) != 0) ? ((crc16 << 1) ^ 0x1021) : (crc16 << 1)) ;
+                    crc32 = ((crc32 & 1) != 0) ? ((crc32 >> 1) ^ 0xEDB88320) : (crc32 >> 1) ;
+                }
+
+                checksum_tables.crc16[value] = crc16 ;
+                checksum_tables.crc32[0][value] = crc32 ;
+            }
+
+            for (size_t slice = 1 ; slice < 8 ; slice++)
+            {
+                for (size_t value = 0 ; value < 256 ; value++)
+                {
+                    const auto previous = checksum_tables.crc32[slice - 1][value] ;
+                    checksum_tables.crc32[slice][value] = (previous >> 8) ^ checksum_tables.crc32[0][previous & 0xFF] ;
+                }
+            }
+
+            return checksum_tables ;
+        }
+
+        /**
+         * @brief The lookup tables, computed at compile time.
+         */
+        constexpr ChecksumTables CHECKSUM_TABLES = MakeChecksumTables() ;
+    } // namespace
+
+    uint16_t
+    ComputeCrc16(const void* const data,
+                 const size_t      numberOfBytes,
+                 const uint16_t    crc)
+    {
+        const auto bytes = static_cast<const uint8_t*>(data) ;
+        auto result = crc ;
+
+        for (size_t i = 0 ; i < numberOfBytes ; i++)
+        {
+            result = static_cast<uint16_t>((result << 8) ^ CHECKSUM_TABLES.crc16[((result >> 8) ^ bytes[i]) & 0xFF]) ;
+        }
+
+        return result ;
+    }
+
+    uint32_t
+    ComputeCrc32(const void* const data,
+                 const size_t      numberOfBytes,
+                 const uint32_t    crc)
+    {
+        const auto& table = CHECKSUM_TABLES.crc32 ;
+
+        auto bytes = static_cast<const uint8_t*>(data) ;
+        auto remaining = numberOfBytes ;
+        auto result = ~crc ;
+
+        // The bytes are combined explicitly, so the result does not depend
+        // on the byte order or alignment of the data.
+        while (remaining >= 8)
+        {
+            const uint32_t low = result ^ (static_cast<uint32_t>(bytes[0]) |
+                                           static_cast<uint32_t>(bytes[1]) << 8 |
+                                           static_cast<uint32_t>(bytes[2]) << 16 |
+                                           static_cast<uint32_t>(bytes[3]) << 24) ;
+
+            result = table[7][low & 0xFF] ^
+                     table[6][(low >> 8) & 0xFF] ^
+                     table[5][(low >> 16) & 0xFF] ^
+                     table[4][low >> 24] ^
+                     table[3][bytes[4]] ^
+                     table[2][bytes[5]] ^
+                     table[1][bytes[6]] ^
+                     table[0][bytes[7]] ;
+
+            bytes += 8 ;
+            remaining -= 8 ;
+        }
+
+        while (remaining > 0)
+        {
+            result = (result >> 8) ^ table[0][(result ^ *bytes) & 0xFF] ;
+            bytes++ ;
+            remaining-- ;
+        }
+
+        return ~result ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,736 @@
+/******************************************************************************
+ * @file SerialDeviceMonitor.cpp                                              *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialDeviceMonitor.h"
+#include "libserial/SerialPort.h"
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/netlink.h>
+#endif
+
+namespace LibSerial
+{
+    namespace
+    {
+        /**
+         * @brief The size of the buffer used to receive notifications. This
+         *        is larger than the largest uevent message, (8 KiB).
+         */
+        constexpr size_t NOTIFICATION_BUFFER_SIZE = 16384 ;
+
+        /**
+         * @brief The netlink multicast group of uevents sent by the kernel,
+         *        as opposed to the events re-broadcast by udev.
+         */
+        constexpr unsigned int UEVENT_KERNEL_GROUP = 1 ;
+
+        /**
+         * @brief The header of uevent messages re-broadcast by udev.
+         */
+        constexpr char UDEV_MESSAGE_PREFIX[] = "libudev" ;
+    } // namespace
+
+    /**
+     * @brief SerialDeviceMonitor::Implementation is the
+     *        SerialDeviceMonitor implementation class.
+     */
+    class SerialDeviceMonitor::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param sysfsRoot The mount point of the sysfs file system.
+         * @param devRoot The directory containing the device files.
+         */
+        Implementation(const std::string& sysfsRoot,
+                       const std::string& devRoot) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Starts monitoring.
+         * @param useNetlink If false, the inotify fallback is always used.
+         */
+        void Open(const bool useNetlink) ;
+
+        /**
+         * @brief Stops monitoring.
+         */
+        void Close() ;
+
+        /**
+         * @brief Determines if the monitor is open.
+         * @return Returns true iff the monitor is open.
+         */
+        bool IsOpen() const ;
+
+        /**
+         * @brief Determines if kernel uevents are being used.
+         * @return Returns true iff the monitor uses a netlink socket.
+         */
+        bool IsUsingNetlink() const ;
+
+        /**
+         * @brief Gets the file descriptor to be watched for readability.
+         * @return Returns the file descriptor of the monitor.
+         */
+        int GetFileDescriptor() const ;
+
+        /**
+         * @brief Enables resolution of the /dev/serial/by-id paths.
+         * @param resolveByIdPaths True to resolve by-id paths.
+         */
+        void SetResolveByIdPaths(const bool resolveByIdPaths) ;
+
+        /**
+         * @brief Reads all pending notifications without blocking.
+         * @return Returns the serial device events.
+         */
+        std::vector<SerialDeviceEvent> ProcessEvents() ;
+
+        /**
+         * @brief Processes a single kernel uevent message.
+         * @param message The uevent message.
+         * @param messageSize The size of the message in bytes.
+         * @return Returns the resulting serial device events.
+         */
+        std::vector<SerialDeviceEvent> ProcessUeventMessage(const char*  message,
+                                                            const size_t messageSize) ;
+
+    private:
+
+        /**
+         * @brief Opens and binds the netlink uevent socket.
+         * @return Returns true iff the socket could be opened.
+         */
+        bool OpenNetlinkSocket() ;
+
+        /**
+         * @brief Opens the inotify instance watching the /dev directory.
+         */
+        void OpenInotify() ;
+
+        /**
+         * @brief Drains the netlink socket.
+         * @param serialDeviceEvents The events are appended here.
+         */
+        void ReadNetlinkMessages(std::vector<SerialDeviceEvent>& serialDeviceEvents) ;
+
+        /**
+         * @brief Drains the inotify instance.
+         * @param serialDeviceEvents The events are appended here.
+         */
+        void ReadInotifyEvents(std::vector<SerialDeviceEvent>& serialDeviceEvents) ;
+
+        /**
+         * @brief Records a device that has appeared.
+         * @param name The kernel name of the device.
+         * @param serialDeviceEvents The event is appended here if name
+         *        refers to a serial port.
+         */
+        void DeviceAdded(const std::string&              name,
+                         std::vector<SerialDeviceEvent>& serialDeviceEvents) ;
+
+        /**
+         * @brief Records a device that has disappeared.
+         * @param name The kernel name of the device.
+         * @param serialDeviceEvents The event is appended here if name
+         *        refers to a known serial port.
+         */
+        void DeviceRemoved(const std::string&              name,
+                           std::vector<SerialDeviceEvent>& serialDeviceEvents) ;
+
+        /**
+         * @brief Compares the known devices against a fresh enumeration
+         *        after notifications have been lost.
+         * @param serialDeviceEvents The differences are appended here.
+         */
+        void Resynchronize(std::vector<SerialDeviceEvent>& serialDeviceEvents) ;
+
+        /**
+         * @brief Used to look up the metadata of added devices.
+         */
+        SerialPortEnumerator mSerialPortEnumerator ;
+
+        /**
+         * @brief The directory containing the device files.
+         */
+        std::string mDevRoot {} ;
+
+        /**
+         * @brief The metadata of the serial devices currently present,
+         *        indexed by kernel name.
+         */
+        std::map<std::string, SerialPortInfo> mKnownDevices {} ;
+
+        /**
+         * @brief The file descriptor of the netlink socket or the inotify
+         *        instance.
+         */
+        int mFileDescriptor = -1 ;
+
+        /**
+         * @brief True iff mFileDescriptor is a netlink socket.
+         */
+        bool mUsingNetlink = false ;
+    } ;
+
+    SerialDeviceMonitor::SerialDeviceMonitor(const std::string& sysfsRoot,
+                                             const std::string& devRoot)
+        : mImpl(new Implementation(sysfsRoot, devRoot))
+    {
+        /* Empty */
+    }
+
+    SerialDeviceMonitor::~SerialDeviceMonitor() = default ;
+
+    SerialDeviceMonitor::SerialDeviceMonitor(SerialDeviceMonitor&& otherSerialDeviceMonitor) :
+        mImpl(std::move(otherSerialDeviceMonitor.mImpl))
+    {
+        // empty
+    }
+
+    SerialDeviceMonitor&
+    SerialDeviceMonitor::operator=(SerialDeviceMonitor&& otherSerialDeviceMonitor)
+    {
+        mImpl = std::move(otherSerialDeviceMonitor.mImpl) ;
+        return *this ;
+    }
+
+    void
+    SerialDeviceMonitor::Open(const bool useNetlink)
+    {
+        mImpl->Open(useNetlink) ;
+    }
+
+    void
+    SerialDeviceMonitor::Close()
+    {
+        mImpl->Close() ;
+    }
+
+    bool
+    SerialDeviceMonitor::IsOpen() const
+    {
+        return mImpl->IsOpen() ;
+    }
+
+    bool
+    SerialDeviceMonitor::IsUsingNetlink() const
+    {
+        return mImpl->IsUsingNetlink() ;
+    }
+
+    int
+    SerialDeviceMonitor::GetFileDescriptor() const
+    {
+        return mImpl->GetFileDescriptor() ;
+    }
+
+    void
+    SerialDeviceMonitor::SetResolveByIdPaths(const bool resolveByIdPaths)
+    {
+        mImpl->SetResolveByIdPaths(resolveByIdPaths) ;
+    }
+
+    std::vector<SerialDeviceEvent>
+    SerialDeviceMonitor::ProcessEvents()
+    {
+        return mImpl->ProcessEvents() ;
+    }
+
+    std::vector<SerialDeviceEvent>
+    SerialDeviceMonitor::ProcessUeventMessage(const char*  message,
+                                              const size_t messageSize)
+    {
+        return mImpl->ProcessUeventMessage(message, messageSize) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    SerialDeviceMonitor::Implementation::Implementation(const std::string& sysfsRoot,
+                                                        const std::string& devRoot)
+        : mSerialPortEnumerator(sysfsRoot, devRoot)
+        , mDevRoot(devRoot)
+    {
+        /* Empty */
+    }
+
+    inline
+    SerialDeviceMonitor::Implementation::~Implementation()
+    {
+        // Close the monitor if it is open.
+        if (this->IsOpen())
+        {
+            this->Close() ;
+        }
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::Open(const bool useNetlink)
+    {
+        // Throw an exception if the monitor is already open.
+        if (this->IsOpen())
+        {
+            throw AlreadyOpen(ERR_MSG_MONITOR_ALREADY_OPEN) ;
+        }
+
+        if (not (useNetlink and this->OpenNetlinkSocket()))
+        {
+            this->OpenInotify() ;
+        }
+
+        // Record the devices already present. This is done after the
+        // subscription so that no device can slip in between.
+        mKnownDevices.clear() ;
+
+        for (const auto& serial_port_info : mSerialPortEnumerator.GetSerialPorts())
+        {
+            mKnownDevices[serial_port_info.name] = serial_port_info ;
+        }
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::Close()
+    {
+        // Throw an exception if the monitor is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_MONITOR_NOT_OPEN) ;
+        }
+
+        close(mFileDescriptor) ;
+        mFileDescriptor = -1 ;
+        mUsingNetlink = false ;
+    }
+
+    inline
+    bool
+    SerialDeviceMonitor::Implementation::IsOpen() const
+    {
+        return (mFileDescriptor != -1) ;
+    }
+
+    inline
+    bool
+    SerialDeviceMonitor::Implementation::IsUsingNetlink() const
+    {
+        return mUsingNetlink ;
+    }
+
+    inline
+    int
+    SerialDeviceMonitor::Implementation::GetFileDescriptor() const
+    {
+        // Throw an exception if the monitor is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_MONITOR_NOT_OPEN) ;
+        }
+
+        return mFileDescriptor ;
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::SetResolveByIdPaths(const bool resolveByIdPaths)
+    {
+        mSerialPortEnumerator.SetResolveByIdPaths(resolveByIdPaths) ;
+    }
+
+    inline
+    std::vector<SerialDeviceEvent>
+    SerialDeviceMonitor::Implementation::ProcessEvents()
+    {
+        // Throw an exception if the monitor is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_MONITOR_NOT_OPEN) ;
+        }
+
+        std::vector<SerialDeviceEvent> serial_device_events {} ;
+
+        if (mUsingNetlink)
+        {
+            this->ReadNetlinkMessages(serial_device_events) ;
+        }
+        else
+        {
+            this->ReadInotifyEvents(serial_device_events) ;
+        }
+
+        return serial_device_events ;
+    }
+
+    inline
+    std::vector<SerialDeviceEvent>
+    SerialDeviceMonitor::Implementation::ProcessUeventMessage(const char*  message,
+                                                              const size_t messageSize)
+    {
+        std::vector<SerialDeviceEvent> serial_device_events {} ;
+
+        // Messages re-broadcast by udev carry a binary header and are not
+        // handled here.
+        if ((message == nullptr) or
+            ((messageSize >= sizeof(UDEV_MESSAGE_PREFIX)) and
+             (std::memcmp(message, UDEV_MESSAGE_PREFIX, sizeof(UDEV_MESSAGE_PREFIX)) == 0)))
+        {
+            return serial_device_events ;
+        }
+
+        // The message is a "ACTION@DEVPATH" header followed by
+        // null-terminated KEY=VALUE pairs.
+        std::string action {} ;
+        std::string subsystem {} ;
+        std::string device_name {} ;
+
+        size_t offset = strnlen(message, messageSize) + 1 ;
+
+        while (offset < messageSize)
+        {
+            const std::string field(message + offset,
+                                    strnlen(message + offset, messageSize - offset)) ;
+            offset += field.size() + 1 ;
+
+            const auto separator = field.find('=') ;
+
+            if (separator == std::string::npos)
+            {
+                continue ;
+            }
+
+            const auto key = field.substr(0, separator) ;
+            const auto value = field.substr(separator + 1) ;
+
+            if (key == "ACTION")
+            {
+                action = value ;
+            }
+            else if (key == "SUBSYSTEM")
+            {
+                subsystem = value ;
+            }
+            else if (key == "DEVNAME")
+            {
+                device_name = value ;
+            }
+        }
+
+        if ((subsystem != "tty") or
+            device_name.empty() or
+            (device_name.find('/') != std::string::npos))
+        {
+            return serial_device_events ;
+        }
+
+        if (action == "add")
+        {
+            this->DeviceAdded(device_name, serial_device_events) ;
+        }
+        else if (action == "remove")
+        {
+            this->DeviceRemoved(device_name, serial_device_events) ;
+        }
+
+        return serial_device_events ;
+    }
+
+    inline
+    bool
+    SerialDeviceMonitor::Implementation::OpenNetlinkSocket()
+    {
+#ifdef __linux__
+        const auto file_desc = socket(AF_NETLINK,
+                                      SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                                      NETLINK_KOBJECT_UEVENT) ;
+
+        if (file_desc < 0)
+        {
+            return false ;
+        }
+
+        sockaddr_nl socket_address {} ;
+        socket_address.nl_family = AF_NETLINK ;
+        socket_address.nl_groups = UEVENT_KERNEL_GROUP ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        if (bind(file_desc,
+                 reinterpret_cast<sockaddr*>(&socket_address),
+                 sizeof(socket_address)) < 0)
+        {
+            close(file_desc) ;
+            return false ;
+        }
+
+        mFileDescriptor = file_desc ;
+        mUsingNetlink = true ;
+        return true ;
+#else
+        return false ;
+#endif
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::OpenInotify()
+    {
+        const auto file_desc = inotify_init1(IN_NONBLOCK | IN_CLOEXEC) ;
+
+        if (file_desc < 0)
+        {
+            throw OpenFailed(std::strerror(errno)) ;
+        }
+
+        if (inotify_add_watch(file_desc,
+                              mDevRoot.c_str(),
+                              IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM) < 0)
+        {
+            const auto error_number = errno ;
+            close(file_desc) ;
+            throw OpenFailed(std::strerror(error_number)) ;
+        }
+
+        mFileDescriptor = file_desc ;
+        mUsingNetlink = false ;
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::ReadNetlinkMessages(std::vector<SerialDeviceEvent>& serialDeviceEvents)
+    {
+#ifdef __linux__
+        char buffer[NOTIFICATION_BUFFER_SIZE] {} ;
+
+        while (true)
+        {
+            sockaddr_nl sender_address {} ;
+            socklen_t sender_address_size = sizeof(sender_address) ;
+
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto message_size = call_with_retry(recvfrom,
+                                                      mFileDescriptor,
+                                                      buffer,
+                                                      sizeof(buffer) - 1,
+                                                      0,
+                                                      reinterpret_cast<sockaddr*>(&sender_address),
+                                                      &sender_address_size) ;
+
+            if (message_size < 0)
+            {
+                if (errno == EAGAIN)
+                {
+                    return ;
+                }
+
+                // The socket receive buffer overflowed and uevents were lost.
+                if (errno == ENOBUFS)
+                {
+                    this->Resynchronize(serialDeviceEvents) ;
+                    continue ;
+                }
+
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            // Only trust messages sent by the kernel.
+            if (sender_address.nl_pid != 0)
+            {
+                continue ;
+            }
+
+            buffer[message_size] = '\0' ;
+
+            const auto message_events = this->ProcessUeventMessage(buffer,
+                                                                   static_cast<size_t>(message_size)) ;
+            serialDeviceEvents.insert(serialDeviceEvents.end(),
+                                      message_events.begin(),
+                                      message_events.end()) ;
+        }
+#endif
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::ReadInotifyEvents(std::vector<SerialDeviceEvent>& serialDeviceEvents)
+    {
+        alignas(inotify_event) char buffer[NOTIFICATION_BUFFER_SIZE] {} ;
+
+        while (true)
+        {
+            const auto read_size = call_with_retry(read,
+                                                   mFileDescriptor,
+                                                   buffer,
+                                                   sizeof(buffer)) ;
+
+            if (read_size < 0)
+            {
+                if (errno == EAGAIN)
+                {
+                    return ;
+                }
+
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            size_t offset = 0 ;
+
+            while (offset < static_cast<size_t>(read_size))
+            {
+                // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset) ;
+                offset += sizeof(inotify_event) + event->len ;
+
+                if ((event->mask & IN_Q_OVERFLOW) != 0)
+                {
+                    this->Resynchronize(serialDeviceEvents) ;
+                }
+                else if ((event->len == 0) or
+                         ((event->mask & IN_ISDIR) != 0))
+                {
+                    continue ;
+                }
+                else if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                {
+                    this->DeviceAdded(event->name, serialDeviceEvents) ;
+                }
+                else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+                {
+                    this->DeviceRemoved(event->name, serialDeviceEvents) ;
+                }
+            }
+        }
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::DeviceAdded(const std::string&              name,
+                                                     std::vector<SerialDeviceEvent>& serialDeviceEvents)
+    {
+        SerialDeviceEvent serial_device_event {} ;
+        serial_device_event.eventType = SerialDeviceEventType::DEVICE_ADDED ;
+
+        if (not mSerialPortEnumerator.GetSerialPortInfo(name,
+                                                        serial_device_event.serialPortInfo))
+        {
+            return ;
+        }
+
+        mKnownDevices[name] = serial_device_event.serialPortInfo ;
+        serialDeviceEvents.push_back(serial_device_event) ;
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::DeviceRemoved(const std::string&              name,
+                                                       std::vector<SerialDeviceEvent>& serialDeviceEvents)
+    {
+        // The sysfs entries are already gone, so the removal is reported
+        // with the metadata recorded when the device was added.
+        const auto known_device = mKnownDevices.find(name) ;
+
+        if (known_device == mKnownDevices.end())
+        {
+            return ;
+        }
+
+        SerialDeviceEvent serial_device_event {} ;
+        serial_device_event.eventType = SerialDeviceEventType::DEVICE_REMOVED ;
+        serial_device_event.serialPortInfo = known_device->second ;
+
+        mKnownDevices.erase(known_device) ;
+        serialDeviceEvents.push_back(serial_device_event) ;
+    }
+
+    inline
+    void
+    SerialDeviceMonitor::Implementation::Resynchronize(std::vector<SerialDeviceEvent>& serialDeviceEvents)
+    {
+        std::map<std::string, SerialPortInfo> present_devices {} ;
+
+        for (const auto& serial_port_info : mSerialPortEnumerator.GetSerialPorts())
+        {
+            present_devices[serial_port_info.name] = serial_port_info ;
+        }
+
+        for (auto known_device = mKnownDevices.begin() ; known_device != mKnownDevices.end() ; )
+        {
+            const auto name = (known_device++)->first ;
+
+            if (present_devices.find(name) == present_devices.end())
+            {
+                this->DeviceRemoved(name, serialDeviceEvents) ;
+            }
+        }
+
+        for (const auto& present_device : present_devices)
+        {
+            if (mKnownDevices.find(present_device.first) == mKnownDevices.end())
+            {
+                this->DeviceAdded(present_device.first, serialDeviceEvents) ;
+            }
+        }
+    }
+
+} // namespace LibSerial
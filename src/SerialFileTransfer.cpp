@@ -0,0 +1,2415 @@
+/******************************************************************************
+ * @file SerialFileTransfer.cpp                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialFileTransfer.h"
+#include "libserial/SerialChecksum.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace LibSerial
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock ;
+
+        /**
+         * @brief The data bytes of a ZMODEM header, ZP0 to ZP3 or ZF3 to ZF0.
+         */
+        using ZmodemHeaderData = std::array<uint8_t, 4> ;
+
+        /**
+         * @brief Returned by the read methods when no data arrived in time.
+         */
+        constexpr int READ_TIMEOUT = -1 ;
+
+        /**
+         * @brief Returned by the read methods when a corrupted block, header
+         *        or subpacket was received.
+         */
+        constexpr int READ_ERROR = -2 ;
+
+        /**
+         * @brief Returned by ReceiveBlock() when a character that does not
+         *        start a block was received.
+         */
+        constexpr int READ_GARBAGE = -3 ;
+
+        /**
+         * @brief The number of bytes read from the serial port at once.
+         */
+        constexpr size_t READ_BUFFER_SIZE = 4096 ;
+
+        /**
+         * @brief The time in milliseconds without input after which the
+         *        remainder of a corrupted block is considered discarded.
+         */
+        constexpr size_t PURGE_TIMEOUT_MS = 200 ;
+
+        /**
+         * @brief The interval in milliseconds at which an XMODEM receiver
+         *        asks the sender to start.
+         */
+        constexpr size_t XMODEM_START_INTERVAL_MS = 3000 ;
+
+        /**
+         * @brief The number of CAN characters sent to abort a transfer.
+         */
+        constexpr size_t ABORT_LENGTH = 8 ;
+
+        /**
+         * @brief XMODEM and YMODEM control characters.
+         */
+        constexpr uint8_t SOH = 0x01 ;
+        constexpr uint8_t STX = 0x02 ;
+        constexpr uint8_t EOT = 0x04 ;
+        constexpr uint8_t ACK = 0x06 ;
+        constexpr uint8_t NAK = 0x15 ;
+        constexpr uint8_t CAN = 0x18 ;
+        constexpr uint8_t CRC_REQUEST = 'C' ;
+        constexpr uint8_t CPMEOF = 0x1A ;
+
+        /**
+         * @brief The XMODEM block sizes.
+         */
+        constexpr size_t XMODEM_BLOCK_SIZE = 128 ;
+        constexpr size_t XMODEM_1K_BLOCK_SIZE = 1024 ;
+
+        /**
+         * @brief ZMODEM framing characters.
+         */
+        constexpr uint8_t ZPAD = '*' ;
+        constexpr uint8_t ZDLE = 0x18 ;
+        constexpr uint8_t ZBIN = 'A' ;
+        constexpr uint8_t ZHEX = 'B' ;
+        constexpr uint8_t ZBIN32 = 'C' ;
+        constexpr uint8_t XON = 0x11 ;
+        constexpr uint8_t XOFF = 0x13 ;
+
+        /**
+         * @brief ZMODEM frame types.
+         */
+        constexpr int ZRQINIT = 0 ;
+        constexpr int ZRINIT = 1 ;
+        constexpr int ZSINIT = 2 ;
+        constexpr int ZACK = 3 ;
+        constexpr int ZFILE = 4 ;
+        constexpr int ZSKIP = 5 ;
+        constexpr int ZNAK = 6 ;
+        constexpr int ZFIN = 8 ;
+        constexpr int ZRPOS = 9 ;
+        constexpr int ZDATA = 10 ;
+        constexpr int ZEOF = 11 ;
+        constexpr int ZCHALLENGE = 14 ;
+
+        /**
+         * @brief ZMODEM subpacket frame ends and escapes following ZDLE.
+         */
+        constexpr uint8_t ZCRCE = 'h' ;
+        constexpr uint8_t ZCRCG = 'i' ;
+        constexpr uint8_t ZCRCQ = 'j' ;
+        constexpr uint8_t ZCRCW = 'k' ;
+        constexpr uint8_t ZRUB0 = 'l' ;
+        constexpr uint8_t ZRUB1 = 'm' ;
+
+        /**
+         * @brief Marks a frame end returned by ReadZdleByte().
+         */
+        constexpr int GOT_FRAME_END = 0x100 ;
+
+        /**
+         * @brief ZRINIT capability flags in ZF0.
+         */
+        constexpr uint8_t CANFDX = 0x01 ;
+        constexpr uint8_t CANOVIO = 0x02 ;
+        constexpr uint8_t CANFC32 = 0x20 ;
+
+        /**
+         * @brief ZFILE conversion option in ZF0 requesting a binary transfer.
+         */
+        constexpr uint8_t ZCBIN = 1 ;
+
+        /**
+         * @brief The indexes of the ZP0 and ZF0 bytes of a header.
+         */
+        constexpr size_t ZP0 = 0 ;
+        constexpr size_t ZF0 = 3 ;
+
+        /**
+         * @brief The number of bytes of file data in a ZMODEM subpacket.
+         */
+        constexpr size_t ZMODEM_SUBPACKET_SIZE = 1024 ;
+
+        /**
+         * @brief The largest subpacket accepted by the ZMODEM receiver.
+         */
+        constexpr size_t ZMODEM_MAXIMUM_SUBPACKET_SIZE = 8192 ;
+
+        const std::string ERR_MSG_TRANSFER_CANCELLED = "The file transfer was cancelled by the remote side." ;
+        const std::string ERR_MSG_TOO_MANY_ERRORS    = "The file transfer failed after too many errors." ;
+        const std::string ERR_MSG_OUT_OF_SEQUENCE    = "A block was received out of sequence." ;
+        const std::string ERR_MSG_INVALID_FILE_NAME  = "The sender sent an invalid file name." ;
+        const std::string ERR_MSG_NO_FILE            = "The sender ended the session without sending a file." ;
+        const std::string ERR_MSG_FILE_DECLINED      = "The receiver declined the file." ;
+        const std::string ERR_MSG_INVALID_POSITION   = "The receiver requested an invalid file position." ;
+
+        /**
+         * @brief An open file that is closed when the object goes out of
+         *        scope.
+         */
+        class TransferFile
+        {
+        public:
+
+            /**
+             * @brief Opens a file.
+             * @param filePath The path of the file.
+             * @param flags The flags passed to open().
+             */
+            TransferFile(const std::string& filePath,
+                         const int          flags)
+            {
+                // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+                mFileDescriptor = call_with_retry(open, filePath.c_str(), flags | O_CLOEXEC, 0666) ;
+
+                if (mFileDescriptor < 0)
+                {
+                    throw std::runtime_error(std::strerror(errno)) ;
+                }
+            }
+
+            /**
+             * @brief Closes the file.
+             */
+            ~TransferFile()
+            {
+                call_with_retry(close, mFileDescriptor) ;
+            }
+
+            TransferFile(const TransferFile& otherTransferFile) = delete ;
+            TransferFile& operator=(const TransferFile& otherTransferFile) = delete ;
+
+            /**
+             * @brief Gets the status of the file.
+             * @return Returns the status of the file.
+             */
+            struct stat GetStatus() const
+            {
+                struct stat file_status {} ;
+
+                if (fstat(mFileDescriptor, &file_status) < 0)
+                {
+                    throw std::runtime_error(std::strerror(errno)) ;
+                }
+
+                return file_status ;
+            }
+
+            /**
+             * @brief Reads data at a position, which does not move the file
+             *        offset.
+             * @param offset The position of the data in the file.
+             * @param data The buffer the data is read into.
+             * @param numberOfBytes The number of bytes to read.
+             * @return Returns the number of bytes read, which is less than
+             *         numberOfBytes only at the end of the file.
+             */
+            size_t Read(const size_t   offset,
+                        uint8_t* const data,
+                        const size_t   numberOfBytes) const
+            {
+                size_t number_of_bytes_read = 0 ;
+
+                while (number_of_bytes_read < numberOfBytes)
+                {
+                    const auto read_result = call_with_retry(pread,
+                                                             mFileDescriptor,
+                                                             data + number_of_bytes_read,
+                                                             numberOfBytes - number_of_bytes_read,
+                                                             static_cast<off_t>(offset + number_of_bytes_read)) ;
+
+                    if (read_result < 0)
+                    {
+                        throw std::runtime_error(std::strerror(errno)) ;
+                    }
+
+                    if (read_result == 0)
+                    {
+                        break ;
+                    }
+
+                    number_of_bytes_read += static_cast<size_t>(read_result) ;
+                }
+
+                return number_of_bytes_read ;
+            }
+
+            /**
+             * @brief Writes data at a position.
+             * @param offset The position of the data in the file.
+             * @param data The data to be written.
+             * @param numberOfBytes The number of bytes to write.
+             */
+            void Write(const size_t         offset,
+                       const uint8_t* const data,
+                       const size_t         numberOfBytes) const
+            {
+                size_t number_of_bytes_written = 0 ;
+
+                while (number_of_bytes_written < numberOfBytes)
+                {
+                    const auto write_result = call_with_retry(pwrite,
+                                                              mFileDescriptor,
+                                                              data + number_of_bytes_written,
+                                                              numberOfBytes - number_of_bytes_written,
+                                                              static_cast<off_t>(offset + number_of_bytes_written)) ;
+
+                    if (write_result < 0)
+                    {
+                        throw std::runtime_error(std::strerror(errno)) ;
+                    }
+
+                    number_of_bytes_written += static_cast<size_t>(write_result) ;
+                }
+            }
+
+        private:
+
+            /**
+             * @brief The file descriptor of the open file.
+             */
+            int mFileDescriptor {-1} ;
+        } ;
+
+        /**
+         * @brief Gets the name of a file without its directory.
+         * @param filePath The path of the file.
+         * @return Returns the name of the file.
+         */
+        std::string
+        GetFileName(const std::string& filePath)
+        {
+            const auto separator = filePath.find_last_of('/') ;
+
+            if (separator == std::string::npos)
+            {
+                return filePath ;
+            }
+
+            return filePath.substr(separator + 1) ;
+        }
+
+        /**
+         * @brief Builds the path of a received file from the directory and
+         *        the file name sent by the sender, which must not lead out
+         *        of the directory.
+         * @param directory The directory the file is written to.
+         * @param fileName The file name sent by the sender.
+         * @return Returns the path of the file.
+         */
+        std::string
+        MakeReceivedFilePath(const std::string& directory,
+                             const std::string& fileName)
+        {
+            const auto file_name = GetFileName(fileName) ;
+
+            if (file_name.empty() or
+                (file_name == ".") or
+                (file_name == ".."))
+            {
+                throw std::runtime_error(ERR_MSG_INVALID_FILE_NAME) ;
+            }
+
+            if (directory.empty() or
+                (directory.back() == '/'))
+            {
+                return directory + file_name ;
+            }
+
+            return directory + "/" + file_name ;
+        }
+
+        /**
+         * @brief Builds the file information sent by YMODEM and ZMODEM
+         *        senders: the file name, a null character, and the decimal
+         *        size, octal modification time and octal mode of the file.
+         * @param filePath The path of the file.
+         * @param fileStatus The status of the file.
+         * @return Returns the file information.
+         */
+        DataBuffer
+        MakeFileInformation(const std::string& filePath,
+                            const struct stat& fileStatus)
+        {
+            std::ostringstream file_information {} ;
+
+            file_information << GetFileName(filePath) << '\0'
+                             << fileStatus.st_size << ' '
+                             << std::oct << fileStatus.st_mtime << ' '
+                             << (fileStatus.st_mode & 07777) << '\0' ;
+
+            const auto file_information_string = file_information.str() ;
+            return DataBuffer(file_information_string.begin(),
+                              file_information_string.end()) ;
+        }
+
+        /**
+         * @brief Extracts the file name and size from file information.
+         * @param fileInformation The file information sent by the sender.
+         * @param fileSize Set to the size of the file, or 0 if it is not
+         *        included.
+         * @return Returns the file name, which is empty if the sender has
+         *         no further files.
+         */
+        std::string
+        ParseFileInformation(const DataBuffer& fileInformation,
+                             size_t&           fileSize)
+        {
+            const auto name_end = std::find(fileInformation.begin(),
+                                            fileInformation.end(),
+                                            0) ;
+
+            const std::string file_name(fileInformation.begin(), name_end) ;
+
+            fileSize = 0 ;
+
+            if (name_end != fileInformation.end())
+            {
+                const auto size_end = std::find(name_end + 1,
+                                                fileInformation.end(),
+                                                0) ;
+
+                const std::string size_string(name_end + 1, size_end) ;
+                fileSize = static_cast<size_t>(std::strtoull(size_string.c_str(), nullptr, 10)) ;
+            }
+
+            return file_name ;
+        }
+
+        /**
+         * @brief Makes the data of a ZMODEM header carrying a file position.
+         * @param position The file position.
+         * @return Returns the header data with the position in ZP0 to ZP3.
+         */
+        ZmodemHeaderData
+        MakePositionHeader(const size_t position)
+        {
+            return {{static_cast<uint8_t>(position),
+                     static_cast<uint8_t>(position >> 8),
+                     static_cast<uint8_t>(position >> 16),
+                     static_cast<uint8_t>(position >> 24)}} ;
+        }
+
+        /**
+         * @brief Gets the file position carried by a ZMODEM header.
+         * @param headerData The data of the header.
+         * @return Returns the file position in ZP0 to ZP3.
+         */
+        size_t
+        GetPosition(const ZmodemHeaderData& headerData)
+        {
+            return static_cast<size_t>(headerData[0]) |
+                   static_cast<size_t>(headerData[1]) << 8 |
+                   static_cast<size_t>(headerData[2]) << 16 |
+                   static_cast<size_t>(headerData[3]) << 24 ;
+        }
+
+        /**
+         * @brief Gets the value of a hexadecimal digit.
+         * @param digit The digit.
+         * @return Returns the value, or -1 if the character is no digit.
+         */
+        int
+        GetHexValue(const int digit)
+        {
+            if ((digit >= '0') and (digit <= '9'))
+            {
+                return digit - '0' ;
+            }
+
+            if ((digit >= 'a') and (digit <= 'f'))
+            {
+                return digit - 'a' + 10 ;
+            }
+
+            if ((digit >= 'A') and (digit <= 'F'))
+            {
+                return digit - 'A' + 10 ;
+            }
+
+            return -1 ;
+        }
+    } // namespace
+
+    /**
+     * @brief SerialFileTransfer::Implementation is the SerialFileTransfer
+     *        implementation class.
+     */
+    class SerialFileTransfer::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param serialPort The serial port used for the transfers.
+         * @param fileTransferProtocol The protocol of the transfers.
+         * @param fileTransferOptions The options of the transfers.
+         */
+        Implementation(SerialPort&                serialPort,
+                       const FileTransferProtocol fileTransferProtocol,
+                       const FileTransferOptions& fileTransferOptions) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Sends a file.
+         * @param filePath The path of the file to be sent.
+         * @return Returns the description of the transfer.
+         */
+        FileTransferResult Send(const std::string& filePath) ;
+
+        /**
+         * @brief Receives a file.
+         * @param path The path of the file or directory.
+         * @return Returns the description of the transfer.
+         */
+        FileTransferResult Receive(const std::string& path) ;
+
+    private:
+
+        /**
+         * @brief Sends a file with XMODEM or YMODEM.
+         * @param filePath The path of the file to be sent.
+         * @param fileTransferResult The description of the transfer.
+         */
+        void SendXmodem(const std::string&  filePath,
+                        FileTransferResult& fileTransferResult) ;
+
+        /**
+         * @brief Receives a file with XMODEM or YMODEM.
+         * @param path The path of the file or directory.
+         * @param fileTransferResult The description of the transfer.
+         */
+        void ReceiveXmodem(const std::string&  path,
+                           FileTransferResult& fileTransferResult) ;
+
+        /**
+         * @brief Sends a file with ZMODEM.
+         * @param filePath The path of the file to be sent.
+         * @param fileTransferResult The description of the transfer.
+         */
+        void SendZmodem(const std::string&  filePath,
+                        FileTransferResult& fileTransferResult) ;
+
+        /**
+         * @brief Receives a file with ZMODEM.
+         * @param directory The directory the file is written to.
+         * @param fileTransferResult The description of the transfer.
+         */
+        void ReceiveZmodem(const std::string&  directory,
+                           FileTransferResult& fileTransferResult) ;
+
+        /**
+         * @brief Waits for an XMODEM receiver to request the next transfer.
+         */
+        void WaitForReceiver() ;
+
+        /**
+         * @brief Waits for the acknowledgement of an XMODEM block.
+         * @return Returns ACK, NAK or READ_TIMEOUT.
+         */
+        int WaitForAcknowledgement() ;
+
+        /**
+         * @brief Sends an XMODEM block until it is acknowledged.
+         * @param blockNumber The number of the block.
+         * @param data The data of the block.
+         * @param numberOfBytes The size of the data.
+         * @param blockSize The size of the block, which is padded.
+         * @param padding The character used for padding.
+         */
+        void SendBlock(const uint8_t        blockNumber,
+                       const uint8_t* const data,
+                       const size_t         numberOfBytes,
+                       const size_t         blockSize,
+                       const uint8_t        padding) ;
+
+        /**
+         * @brief Sends EOT until it is acknowledged.
+         */
+        void SendEndOfTransmission() ;
+
+        /**
+         * @brief Receives an XMODEM block.
+         * @param msTimeout The time to wait for the start of the block.
+         * @param blockData Set to the data of the block.
+         * @param blockNumber Set to the number of the block.
+         * @return Returns SOH or STX if a block was received, EOT,
+         *         READ_TIMEOUT, READ_ERROR or READ_GARBAGE.
+         */
+        int ReceiveBlock(const size_t msTimeout,
+                         DataBuffer&  blockData,
+                         uint8_t&     blockNumber) ;
+
+        /**
+         * @brief Sends a ZMODEM header in hexadecimal form.
+         * @param frameType The frame type.
+         * @param headerData The header data.
+         */
+        void SendHexHeader(const int               frameType,
+                           const ZmodemHeaderData& headerData) ;
+
+        /**
+         * @brief Sends a ZMODEM header in binary form, protected by CRC-32
+         *        if the receiver supports it.
+         * @param frameType The frame type.
+         * @param headerData The header data.
+         */
+        void SendBinaryHeader(const int               frameType,
+                              const ZmodemHeaderData& headerData) ;
+
+        /**
+         * @brief Sends a ZMODEM data subpacket.
+         * @param data The data of the subpacket.
+         * @param numberOfBytes The size of the data.
+         * @param frameEnd The frame end, which tells the receiver if
+         *        another subpacket follows and if it has to acknowledge.
+         */
+        void SendSubpacket(const uint8_t* const data,
+                           const size_t         numberOfBytes,
+                           const uint8_t        frameEnd) ;
+
+        /**
+         * @brief Appends a byte to the output buffer, escaped with ZDLE if
+         *        it could be mistaken for a control character.
+         * @param value The byte.
+         */
+        void AppendEscaped(const uint8_t value) ;
+
+        /**
+         * @brief Reads a ZMODEM header, skipping any preceding data.
+         * @param msTimeout The time to wait for the header.
+         * @param headerData Set to the header data.
+         * @return Returns the frame type, READ_TIMEOUT or READ_ERROR.
+         */
+        int ReadHeader(const size_t      msTimeout,
+                       ZmodemHeaderData& headerData) ;
+
+        /**
+         * @brief Reads a ZMODEM data subpacket.
+         * @param subpacketData Set to the data of the subpacket.
+         * @return Returns the frame end, READ_TIMEOUT or READ_ERROR.
+         */
+        int ReceiveSubpacket(DataBuffer& subpacketData) ;
+
+        /**
+         * @brief Reads a byte, removing ZDLE escapes and ignoring flow
+         *        control characters.
+         * @param deadline The time until which to wait.
+         * @return Returns the byte, a frame end marked by GOT_FRAME_END,
+         *         READ_TIMEOUT or READ_ERROR.
+         */
+        int ReadZdleByte(const Clock::time_point deadline) ;
+
+        /**
+         * @brief Reads a byte.
+         * @param deadline The time until which to wait.
+         * @return Returns the byte or READ_TIMEOUT.
+         */
+        int ReadByte(const Clock::time_point deadline) ;
+
+        /**
+         * @brief Reads a number of bytes.
+         * @param data The buffer the bytes are read into.
+         * @param numberOfBytes The number of bytes to read.
+         * @param deadline The time until which to wait.
+         * @return Returns true iff all bytes were read in time.
+         */
+        bool ReadBytes(uint8_t* const          data,
+                       const size_t            numberOfBytes,
+                       const Clock::time_point deadline) ;
+
+        /**
+         * @brief Gets the next byte without removing it from the input.
+         * @return Returns the byte, or READ_TIMEOUT if no input is waiting.
+         */
+        int PeekByte() ;
+
+        /**
+         * @brief Determines if input is waiting to be processed.
+         * @return Returns true iff input is waiting.
+         */
+        bool IsInputPending() ;
+
+        /**
+         * @brief Discards input until the line has been idle for
+         *        PURGE_TIMEOUT_MS milliseconds.
+         */
+        void Purge() ;
+
+        /**
+         * @brief Writes data to the serial port.
+         * @param data The data to be written.
+         */
+        void WriteData(const DataBuffer& data) ;
+
+        /**
+         * @brief Notifies the remote side that the transfer is aborted.
+         */
+        void SendAbort() noexcept ;
+
+        /**
+         * @brief Counts an error and throws an exception if there were too
+         *        many consecutive errors.
+         * @param numberOfErrors The number of consecutive errors.
+         */
+        void CountError(size_t& numberOfErrors) const ;
+
+        /**
+         * @brief Calls the progress callback, if any.
+         * @param bytesTransferred The number of bytes transferred.
+         * @param fileSize The size of the file, or 0 if unknown.
+         */
+        void ReportProgress(const size_t bytesTransferred,
+                            const size_t fileSize) const ;
+
+        /**
+         * @brief Makes a deadline.
+         * @param msTimeout The number of milliseconds from now.
+         * @return Returns the deadline.
+         */
+        static Clock::time_point MakeDeadline(const size_t msTimeout) ;
+
+        /**
+         * @brief The serial port used for the transfers.
+         */
+        SerialPort* mSerialPort ;
+
+        /**
+         * @brief The protocol of the transfers.
+         */
+        FileTransferProtocol mProtocol ;
+
+        /**
+         * @brief The options of the transfers.
+         */
+        FileTransferOptions mOptions ;
+
+        /**
+         * @brief Data read from the serial port that has not been processed.
+         */
+        std::array<char, READ_BUFFER_SIZE> mReadBuffer {} ;
+
+        /**
+         * @brief The position of the next unprocessed byte in mReadBuffer.
+         */
+        size_t mReadPosition {0} ;
+
+        /**
+         * @brief The number of bytes in mReadBuffer.
+         */
+        size_t mReadSize {0} ;
+
+        /**
+         * @brief The buffer frames are assembled in before being written.
+         */
+        DataBuffer mOutput {} ;
+
+        /**
+         * @brief Whether the ZMODEM sender uses CRC-32.
+         */
+        bool mSendCrc32 {false} ;
+
+        /**
+         * @brief Whether the last binary ZMODEM header received used CRC-32,
+         *        which then also protects the following subpackets.
+         */
+        bool mReceiveCrc32 {false} ;
+
+        /**
+         * @brief The number of repeated blocks or subpackets.
+         */
+        size_t mRetransmissions {0} ;
+    } ;
+
+    SerialFileTransfer::SerialFileTransfer(SerialPort&                serialPort,
+                                           const FileTransferProtocol fileTransferProtocol,
+                                           const FileTransferOptions& fileTransferOptions)
+        : mImpl(new Implementation(serialPort,
+                                   fileTransferProtocol,
+                                   fileTransferOptions))
+    {
+        /* Empty */
+    }
+
+    SerialFileTransfer::~SerialFileTransfer() = default ;
+
+    SerialFileTransfer::SerialFileTransfer(SerialFileTransfer&& otherSerialFileTransfer) :
+        mImpl(std::move(otherSerialFileTransfer.mImpl))
+    {
+        // empty
+    }
+
+    SerialFileTransfer&
+    SerialFileTransfer::operator=(SerialFileTransfer&& otherSerialFileTransfer)
+    {
+        mImpl = std::move(otherSerialFileTransfer.mImpl) ;
+        return *this ;
+    }
+
+    FileTransferResult
+    SerialFileTransfer::Send(const std::string& filePath)
+    {
+        return mImpl->Send(filePath) ;
+    }
+
+    FileTransferResult
+    SerialFileTransfer::Receive(const std::string& path)
+    {
+        return mImpl->Receive(path) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    SerialFileTransfer::Implementation::Implementation(SerialPort&                serialPort,
+                                                       const FileTransferProtocol fileTransferProtocol,
+                                                       const FileTransferOptions& fileTransferOptions)
+        : mSerialPort(&serialPort)
+        , mProtocol(fileTransferProtocol)
+        , mOptions(fileTransferOptions)
+    {
+        if (mOptions.msTimeout == 0)
+        {
+            throw std::invalid_argument {"The timeout of a file transfer must not be zero."} ;
+        }
+    }
+
+    inline
+    FileTransferResult
+    SerialFileTransfer::Implementation::Send(const std::string& filePath)
+    {
+        FileTransferResult file_transfer_result {} ;
+        file_transfer_result.filePath = filePath ;
+
+        const auto start_time = Clock::now() ;
+
+        mReadPosition = 0 ;
+        mReadSize = 0 ;
+        mRetransmissions = 0 ;
+
+        try
+        {
+            if (mProtocol == FileTransferProtocol::ZMODEM)
+            {
+                this->SendZmodem(filePath, file_transfer_result) ;
+            }
+            else
+            {
+                this->SendXmodem(filePath, file_transfer_result) ;
+            }
+        }
+        catch (...)
+        {
+            this->SendAbort() ;
+            throw ;
+        }
+
+        file_transfer_result.retransmissions = mRetransmissions ;
+        file_transfer_result.durationUs = static_cast<size_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_time).count()) ;
+
+        return file_transfer_result ;
+    }
+
+    inline
+    FileTransferResult
+    SerialFileTransfer::Implementation::Receive(const std::string& path)
+    {
+        FileTransferResult file_transfer_result {} ;
+
+        const auto start_time = Clock::now() ;
+
+        mReadPosition = 0 ;
+        mReadSize = 0 ;
+        mRetransmissions = 0 ;
+
+        try
+        {
+            if (mProtocol == FileTransferProtocol::ZMODEM)
+            {
+                this->ReceiveZmodem(path, file_transfer_result) ;
+            }
+            else
+            {
+                this->ReceiveXmodem(path, file_transfer_result) ;
+            }
+        }
+        catch (...)
+        {
+            this->SendAbort() ;
+            throw ;
+        }
+
+        file_transfer_result.retransmissions = mRetransmissions ;
+        file_transfer_result.durationUs = static_cast<size_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_time).count()) ;
+
+        return file_transfer_result ;
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendXmodem(const std::string&  filePath,
+                                                   FileTransferResult& fileTransferResult)
+    {
+        const TransferFile transfer_file {filePath, O_RDONLY} ;
+        const auto file_status = transfer_file.GetStatus() ;
+        const auto file_size = static_cast<size_t>(file_status.st_size) ;
+
+        fileTransferResult.fileSize = file_size ;
+
+        const auto block_size = (mProtocol == FileTransferProtocol::XMODEM) ?
+                                XMODEM_BLOCK_SIZE : XMODEM_1K_BLOCK_SIZE ;
+
+        this->WaitForReceiver() ;
+
+        // YMODEM announces the file in block 0 and then waits for the
+        // receiver to request the data.
+        if (mProtocol == FileTransferProtocol::YMODEM)
+        {
+            const auto file_information = MakeFileInformation(filePath, file_status) ;
+
+            this->SendBlock(0,
+                            file_information.data(),
+                            file_information.size(),
+                            (file_information.size() <= XMODEM_BLOCK_SIZE) ? XMODEM_BLOCK_SIZE : XMODEM_1K_BLOCK_SIZE,
+                            0) ;
+
+            this->WaitForReceiver() ;
+        }
+
+        DataBuffer block_data(block_size) ;
+        uint8_t block_number = 1 ;
+        size_t position = 0 ;
+
+        while (position < file_size)
+        {
+            const auto number_of_bytes = transfer_file.Read(position,
+                                                            block_data.data(),
+                                                            std::min(block_size, file_size - position)) ;
+
+            // The file has been truncated while it was sent.
+            if (number_of_bytes == 0)
+            {
+                break ;
+            }
+
+            // The end of the file is sent in a short block, which needs
+            // less padding.
+            this->SendBlock(block_number,
+                            block_data.data(),
+                            number_of_bytes,
+                            (number_of_bytes <= XMODEM_BLOCK_SIZE) ? XMODEM_BLOCK_SIZE : block_size,
+                            CPMEOF) ;
+
+            position += number_of_bytes ;
+            block_number++ ;
+
+            this->ReportProgress(position, file_size) ;
+        }
+
+        this->SendEndOfTransmission() ;
+
+        // An empty block 0 ends the YMODEM batch.
+        if (mProtocol == FileTransferProtocol::YMODEM)
+        {
+            this->WaitForReceiver() ;
+            this->SendBlock(0, nullptr, 0, XMODEM_BLOCK_SIZE, 0) ;
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::ReceiveXmodem(const std::string&  path,
+                                                      FileTransferResult& fileTransferResult)
+    {
+        const auto is_ymodem = (mProtocol == FileTransferProtocol::YMODEM) ;
+        const auto start_interval = std::min(mOptions.msTimeout, XMODEM_START_INTERVAL_MS) ;
+
+        DataBuffer block_data {} ;
+        uint8_t block_number = 0 ;
+        size_t number_of_errors = 0 ;
+
+        auto file_path = path ;
+        size_t file_size = 0 ;
+
+        // The YMODEM receiver asks for block 0 with the file information.
+        if (is_ymodem)
+        {
+            while (true)
+            {
+                this->WriteData({CRC_REQUEST}) ;
+
+                const auto block_type = this->ReceiveBlock(start_interval,
+                                                           block_data,
+                                                           block_number) ;
+
+                if (((block_type == SOH) or
+                     (block_type == STX)) and
+                    (block_number == 0))
+                {
+                    break ;
+                }
+
+                this->CountError(number_of_errors) ;
+
+                if (block_type == READ_ERROR)
+                {
+                    this->Purge() ;
+                }
+            }
+
+            const auto file_name = ParseFileInformation(block_data, file_size) ;
+
+            if (file_name.empty())
+            {
+                this->WriteData({ACK}) ;
+                throw std::runtime_error(ERR_MSG_NO_FILE) ;
+            }
+
+            file_path = MakeReceivedFilePath(path, file_name) ;
+            this->WriteData({ACK}) ;
+        }
+
+        const TransferFile transfer_file {file_path, O_WRONLY | O_CREAT | O_TRUNC} ;
+
+        fileTransferResult.filePath = file_path ;
+
+        uint8_t expected_block_number = 1 ;
+        size_t position = 0 ;
+        size_t number_of_end_of_transmissions = 0 ;
+        size_t number_of_garbage_characters = 0 ;
+        bool is_started = false ;
+
+        number_of_errors = 0 ;
+        this->WriteData({CRC_REQUEST}) ;
+
+        while (true)
+        {
+            const auto block_type = this->ReceiveBlock(is_started ? mOptions.msTimeout : start_interval,
+                                                       block_data,
+                                                       block_number) ;
+
+            if ((block_type == SOH) or
+                (block_type == STX))
+            {
+                if (block_number == expected_block_number)
+                {
+                    // YMODEM drops the padding of the last block.
+                    auto number_of_bytes = block_data.size() ;
+
+                    if (is_ymodem and
+                        (file_size > 0))
+                    {
+                        number_of_bytes = std::min(number_of_bytes, file_size - std::min(file_size, position)) ;
+                    }
+
+                    transfer_file.Write(position, block_data.data(), number_of_bytes) ;
+                    position += number_of_bytes ;
+                    expected_block_number++ ;
+                    number_of_errors = 0 ;
+                    is_started = true ;
+
+                    this->WriteData({ACK}) ;
+                    this->ReportProgress(position, file_size) ;
+                }
+                else if ((block_number == static_cast<uint8_t>(expected_block_number - 1)) and
+                         (is_started or is_ymodem))
+                {
+                    // The acknowledgement of the previous block was lost,
+                    // or block 0 was repeated.
+                    this->WriteData({ACK}) ;
+
+                    if (not is_started)
+                    {
+                        this->WriteData({CRC_REQUEST}) ;
+                    }
+                }
+                else
+                {
+                    throw std::runtime_error(ERR_MSG_OUT_OF_SEQUENCE) ;
+                }
+
+                continue ;
+            }
+
+            if (block_type == EOT)
+            {
+                // YMODEM confirms the end of the file by asking for a
+                // second EOT.
+                if (is_ymodem and
+                    (number_of_end_of_transmissions++ == 0))
+                {
+                    this->WriteData({NAK}) ;
+                    continue ;
+                }
+
+                this->WriteData({ACK}) ;
+                break ;
+            }
+
+            // Noise between blocks is skipped, as long as a block could
+            // have been received in the same time.
+            if ((block_type == READ_GARBAGE) and
+                (++number_of_garbage_characters % XMODEM_1K_BLOCK_SIZE != 0))
+            {
+                continue ;
+            }
+
+            this->CountError(number_of_errors) ;
+
+            // A corrupted block is discarded and requested again.
+            if (block_type == READ_ERROR)
+            {
+                mRetransmissions++ ;
+                this->Purge() ;
+                this->WriteData({NAK}) ;
+                continue ;
+            }
+
+            this->WriteData({is_started ? NAK : CRC_REQUEST}) ;
+        }
+
+        fileTransferResult.fileSize = position ;
+
+        // Further files of a YMODEM batch are declined by cancelling it.
+        if (is_ymodem)
+        {
+            number_of_errors = 0 ;
+
+            while (true)
+            {
+                this->WriteData({CRC_REQUEST}) ;
+
+                const auto block_type = this->ReceiveBlock(mOptions.msTimeout,
+                                                           block_data,
+                                                           block_number) ;
+
+                if (block_type == EOT)
+                {
+                    this->WriteData({ACK}) ;
+                    continue ;
+                }
+
+                if (((block_type == SOH) or
+                     (block_type == STX)) and
+                    (block_number == 0))
+                {
+                    size_t next_file_size = 0 ;
+
+                    if (ParseFileInformation(block_data, next_file_size).empty())
+                    {
+                        this->WriteData({ACK}) ;
+                    }
+                    else
+                    {
+                        this->SendAbort() ;
+                    }
+
+                    break ;
+                }
+
+                this->CountError(number_of_errors) ;
+
+                if (block_type == READ_ERROR)
+                {
+                    this->Purge() ;
+                }
+            }
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::WaitForReceiver()
+    {
+        size_t number_of_errors = 0 ;
+
+        while (true)
+        {
+            const auto character = this->ReadByte(MakeDeadline(mOptions.msTimeout)) ;
+
+            if (character == CRC_REQUEST)
+            {
+                return ;
+            }
+
+            if (character == CAN)
+            {
+                if (this->ReadByte(MakeDeadline(mOptions.msTimeout)) == CAN)
+                {
+                    throw std::runtime_error(ERR_MSG_TRANSFER_CANCELLED) ;
+                }
+            }
+
+            // Receivers that only support checksums are not answered.
+            if ((character == READ_TIMEOUT) or
+                (character == NAK))
+            {
+                this->CountError(number_of_errors) ;
+            }
+        }
+    }
+
+    inline
+    int
+    SerialFileTransfer::Implementation::WaitForAcknowledgement()
+    {
+        const auto deadline = MakeDeadline(mOptions.msTimeout) ;
+
+        while (true)
+        {
+            const auto character = this->ReadByte(deadline) ;
+
+            if ((character == ACK) or
+                (character == NAK) or
+                (character == READ_TIMEOUT))
+            {
+                return character ;
+            }
+
+            if ((character == CAN) and
+                (this->ReadByte(deadline) == CAN))
+            {
+                throw std::runtime_error(ERR_MSG_TRANSFER_CANCELLED) ;
+            }
+
+            // Further 'C' characters sent while the receiver waited for
+            // the transfer to start are ignored.
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendBlock(const uint8_t        blockNumber,
+                                                  const uint8_t* const data,
+                                                  const size_t         numberOfBytes,
+                                                  const size_t         blockSize,
+                                                  const uint8_t        padding)
+    {
+        DataBuffer block {} ;
+        block.reserve(blockSize + 5) ;
+
+        block.push_back((blockSize == XMODEM_1K_BLOCK_SIZE) ? STX : SOH) ;
+        block.push_back(blockNumber) ;
+        block.push_back(static_cast<uint8_t>(~blockNumber)) ;
+
+        if (numberOfBytes > 0)
+        {
+            block.insert(block.end(), data, data + numberOfBytes) ;
+        }
+
+        block.resize(blockSize + 3, padding) ;
+
+        const auto crc = ComputeCrc16(block.data() + 3, blockSize) ;
+        block.push_back(static_cast<uint8_t>(crc >> 8)) ;
+        block.push_back(static_cast<uint8_t>(crc)) ;
+
+        size_t number_of_errors = 0 ;
+
+        while (true)
+        {
+            this->WriteData(block) ;
+
+            if (this->WaitForAcknowledgement() == ACK)
+            {
+                return ;
+            }
+
+            this->CountError(number_of_errors) ;
+            mRetransmissions++ ;
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendEndOfTransmission()
+    {
+        size_t number_of_errors = 0 ;
+
+        while (true)
+        {
+            this->WriteData({EOT}) ;
+
+            if (this->WaitForAcknowledgement() == ACK)
+            {
+                return ;
+            }
+
+            this->CountError(number_of_errors) ;
+        }
+    }
+
+    inline
+    int
+    SerialFileTransfer::Implementation::ReceiveBlock(const size_t msTimeout,
+                                                     DataBuffer&  blockData,
+                                                     uint8_t&     blockNumber)
+    {
+        const auto block_type = this->ReadByte(MakeDeadline(msTimeout)) ;
+
+        if ((block_type == READ_TIMEOUT) or
+            (block_type == EOT))
+        {
+            return block_type ;
+        }
+
+        if (block_type == CAN)
+        {
+            if (this->ReadByte(MakeDeadline(mOptions.msTimeout)) == CAN)
+            {
+                throw std::runtime_error(ERR_MSG_TRANSFER_CANCELLED) ;
+            }
+
+            return READ_ERROR ;
+        }
+
+        if ((block_type != SOH) and
+            (block_type != STX))
+        {
+            return READ_GARBAGE ;
+        }
+
+        // The block number, its complement, the data and the CRC.
+        const auto block_size = (block_type == STX) ? XMODEM_1K_BLOCK_SIZE : XMODEM_BLOCK_SIZE ;
+        std::array<uint8_t, XMODEM_1K_BLOCK_SIZE + 4> block {} ;
+
+        if (not this->ReadBytes(block.data(),
+                                block_size + 4,
+                                MakeDeadline(mOptions.msTimeout)))
+        {
+            return READ_ERROR ;
+        }
+
+        const auto crc = static_cast<uint16_t>(block[block_size + 2] << 8 | block[block_size + 3]) ;
+
+        if ((block[0] != static_cast<uint8_t>(~block[1])) or
+            (crc != ComputeCrc16(block.data() + 2, block_size)))
+        {
+            return READ_ERROR ;
+        }
+
+        blockNumber = block[0] ;
+        blockData.assign(block.begin() + 2, block.begin() + 2 + block_size) ;
+
+        return block_type ;
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendZmodem(const std::string&  filePath,
+                                                   FileTransferResult& fileTransferResult)
+    {
+        const TransferFile transfer_file {filePath, O_RDONLY} ;
+        const auto file_status = transfer_file.GetStatus() ;
+        const auto file_size = static_cast<size_t>(file_status.st_size) ;
+
+        fileTransferResult.fileSize = file_size ;
+
+        ZmodemHeaderData header_data {} ;
+        size_t number_of_errors = 0 ;
+
+        // Start the receiver, e.g. "rz" on a remote shell, and wait for its
+        // capabilities.
+        this->WriteData({'r', 'z', '\r'}) ;
+        this->SendHexHeader(ZRQINIT, MakePositionHeader(0)) ;
+
+        size_t window_size = mOptions.zmodemWindowSize ;
+
+        while (true)
+        {
+            const auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+            if (frame_type == ZRINIT)
+            {
+                mSendCrc32 = ((header_data[ZF0] & CANFC32) != 0) ;
+
+                // A receiver that cannot buffer the whole file announces the
+                // size of its buffer, which limits the window.
+                const auto receive_buffer_size = static_cast<size_t>(header_data[ZP0]) |
+                                                 static_cast<size_t>(header_data[ZP0 + 1]) << 8 ;
+
+                if ((receive_buffer_size > 0) and
+                    ((window_size == 0) or
+                     (receive_buffer_size < window_size)))
+                {
+                    window_size = receive_buffer_size ;
+                }
+
+                break ;
+            }
+
+            if (frame_type == ZCHALLENGE)
+            {
+                this->SendHexHeader(ZACK, header_data) ;
+                continue ;
+            }
+
+            this->CountError(number_of_errors) ;
+            this->SendHexHeader(ZRQINIT, MakePositionHeader(0)) ;
+        }
+
+        // Offer the file until the receiver requests a position.
+        const auto file_information = MakeFileInformation(filePath, file_status) ;
+        size_t position = 0 ;
+
+        number_of_errors = 0 ;
+        bool is_offered = false ;
+
+        while (true)
+        {
+            if (not is_offered)
+            {
+                this->SendBinaryHeader(ZFILE, {{0, 0, 0, ZCBIN}}) ;
+                this->SendSubpacket(file_information.data(),
+                                    file_information.size(),
+                                    ZCRCW) ;
+            }
+
+            const auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+            if (frame_type == ZRPOS)
+            {
+                position = GetPosition(header_data) ;
+                break ;
+            }
+
+            if (frame_type == ZSKIP)
+            {
+                throw std::runtime_error(ERR_MSG_FILE_DECLINED) ;
+            }
+
+            // A ZRINIT repeated in answer to ZRQINIT may still be on its way,
+            // so the answer to the file offer is awaited once more.
+            is_offered = (frame_type == ZRINIT) and (not is_offered) ;
+
+            if (not is_offered)
+            {
+                this->CountError(number_of_errors) ;
+            }
+        }
+
+        // Stream the file from the requested position. Subpackets are sent
+        // with ZCRCG and need no acknowledgement, unless a window is used,
+        // in which case every quarter window ends with ZCRCQ and the sender
+        // stops when the receiver falls a whole window behind.
+        DataBuffer subpacket_data(ZMODEM_SUBPACKET_SIZE) ;
+        size_t last_error_position = 0 ;
+
+        number_of_errors = 0 ;
+
+        while (true)
+        {
+            if (position > file_size)
+            {
+                throw std::runtime_error(ERR_MSG_INVALID_POSITION) ;
+            }
+
+            if (position < file_size)
+            {
+                this->SendBinaryHeader(ZDATA, MakePositionHeader(position)) ;
+            }
+
+            auto acknowledged_position = position ;
+            auto query_position = position ;
+            bool is_repositioned = false ;
+
+            while ((position < file_size) and
+                   (not is_repositioned))
+            {
+                const auto number_of_bytes = transfer_file.Read(position,
+                                                                subpacket_data.data(),
+                                                                std::min(ZMODEM_SUBPACKET_SIZE, file_size - position)) ;
+
+                auto frame_end = ZCRCG ;
+
+                if ((number_of_bytes == 0) or
+                    (position + number_of_bytes == file_size))
+                {
+                    frame_end = ZCRCE ;
+                }
+                else if ((window_size > 0) and
+                         (position + number_of_bytes - query_position >= std::max<size_t>(window_size / 4, 1)))
+                {
+                    frame_end = ZCRCQ ;
+                    query_position = position + number_of_bytes ;
+                }
+
+                this->SendSubpacket(subpacket_data.data(),
+                                    number_of_bytes,
+                                    frame_end) ;
+
+                if (number_of_bytes == 0)
+                {
+                    // The file has been truncated while it was sent.
+                    throw std::runtime_error(ERR_MSG_INVALID_POSITION) ;
+                }
+
+                position += number_of_bytes ;
+                this->ReportProgress(position, file_size) ;
+
+                // Process the reverse channel. Data that does not start a
+                // header, such as the line feed and XON ending hex headers,
+                // is discarded.
+                while (true)
+                {
+                    const auto is_window_full = (window_size > 0) and
+                                                (position < file_size) and
+                                                (position - acknowledged_position >= window_size) ;
+
+                    if (not is_window_full)
+                    {
+                        const auto next_character = this->PeekByte() ;
+
+                        if (next_character == READ_TIMEOUT)
+                        {
+                            break ;
+                        }
+
+                        if ((next_character != ZPAD) and
+                            (next_character != CAN))
+                        {
+                            mReadPosition++ ;
+                            continue ;
+                        }
+                    }
+
+                    const auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+                    if (frame_type == ZACK)
+                    {
+                        acknowledged_position = std::max(acknowledged_position, GetPosition(header_data)) ;
+                        number_of_errors = 0 ;
+                    }
+                    else if (frame_type == ZRPOS)
+                    {
+                        position = GetPosition(header_data) ;
+
+                        if (position > last_error_position)
+                        {
+                            last_error_position = position ;
+                            number_of_errors = 0 ;
+                        }
+
+                        this->CountError(number_of_errors) ;
+                        mRetransmissions++ ;
+                        is_repositioned = true ;
+                        break ;
+                    }
+                    else if (frame_type == ZSKIP)
+                    {
+                        throw std::runtime_error(ERR_MSG_FILE_DECLINED) ;
+                    }
+                    else if (is_window_full)
+                    {
+                        // The acknowledgement was lost, so the data since
+                        // the last one is sent again.
+                        this->CountError(number_of_errors) ;
+                        position = acknowledged_position ;
+                        mRetransmissions++ ;
+                        is_repositioned = true ;
+                        break ;
+                    }
+                }
+            }
+
+            if (is_repositioned)
+            {
+                continue ;
+            }
+
+            // Announce the end of the file until the receiver confirms it or
+            // requests data again.
+            this->SendBinaryHeader(ZEOF, MakePositionHeader(file_size)) ;
+
+            auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+            while (frame_type == ZACK)
+            {
+                frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+            }
+
+            if (frame_type == ZRINIT)
+            {
+                break ;
+            }
+
+            if (frame_type == ZRPOS)
+            {
+                position = GetPosition(header_data) ;
+                mRetransmissions++ ;
+            }
+
+            this->CountError(number_of_errors) ;
+        }
+
+        // End the session.
+        number_of_errors = 0 ;
+
+        while (true)
+        {
+            this->SendHexHeader(ZFIN, MakePositionHeader(0)) ;
+
+            const auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+            if (frame_type == ZFIN)
+            {
+                this->WriteData({'O', 'O'}) ;
+                break ;
+            }
+
+            this->CountError(number_of_errors) ;
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::ReceiveZmodem(const std::string&  directory,
+                                                      FileTransferResult& fileTransferResult)
+    {
+        const ZmodemHeaderData receiver_capabilities {{0, 0, 0, CANFDX | CANOVIO | CANFC32}} ;
+
+        ZmodemHeaderData header_data {} ;
+        DataBuffer subpacket_data {} ;
+        size_t number_of_errors = 0 ;
+
+        // Announce the receiver until the sender offers a file.
+        this->SendHexHeader(ZRINIT, receiver_capabilities) ;
+
+        while (true)
+        {
+            const auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+            if (frame_type == ZFILE)
+            {
+                if (this->ReceiveSubpacket(subpacket_data) >= 0)
+                {
+                    break ;
+                }
+
+                this->CountError(number_of_errors) ;
+                this->SendHexHeader(ZNAK, MakePositionHeader(0)) ;
+                continue ;
+            }
+
+            if (frame_type == ZSINIT)
+            {
+                if (this->ReceiveSubpacket(subpacket_data) >= 0)
+                {
+                    this->SendHexHeader(ZACK, MakePositionHeader(1)) ;
+                }
+                else
+                {
+                    this->SendHexHeader(ZNAK, MakePositionHeader(0)) ;
+                }
+
+                continue ;
+            }
+
+            if (frame_type == ZFIN)
+            {
+                this->SendHexHeader(ZFIN, MakePositionHeader(0)) ;
+                throw std::runtime_error(ERR_MSG_NO_FILE) ;
+            }
+
+            if (frame_type != ZRQINIT)
+            {
+                this->CountError(number_of_errors) ;
+            }
+
+            this->SendHexHeader(ZRINIT, receiver_capabilities) ;
+        }
+
+        size_t file_size = 0 ;
+        const auto file_path = MakeReceivedFilePath(directory,
+                                                    ParseFileInformation(subpacket_data, file_size)) ;
+
+        const TransferFile transfer_file {file_path, O_WRONLY | O_CREAT | O_TRUNC} ;
+
+        fileTransferResult.filePath = file_path ;
+
+        // Receive the data, requesting the position after the last good
+        // subpacket whenever an error occurs.
+        size_t position = 0 ;
+        number_of_errors = 0 ;
+
+        this->SendHexHeader(ZRPOS, MakePositionHeader(position)) ;
+
+        while (true)
+        {
+            const auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+            if (frame_type == ZDATA)
+            {
+                if (GetPosition(header_data) != position)
+                {
+                    this->CountError(number_of_errors) ;
+                    this->SendHexHeader(ZRPOS, MakePositionHeader(position)) ;
+                    continue ;
+                }
+
+                while (true)
+                {
+                    const auto frame_end = this->ReceiveSubpacket(subpacket_data) ;
+
+                    if (frame_end < 0)
+                    {
+                        this->CountError(number_of_errors) ;
+                        mRetransmissions++ ;
+                        this->SendHexHeader(ZRPOS, MakePositionHeader(position)) ;
+                        break ;
+                    }
+
+                    transfer_file.Write(position,
+                                        subpacket_data.data(),
+                                        subpacket_data.size()) ;
+
+                    position += subpacket_data.size() ;
+                    number_of_errors = 0 ;
+
+                    this->ReportProgress(position, file_size) ;
+
+                    if ((frame_end == ZCRCW) or
+                        (frame_end == ZCRCQ))
+                    {
+                        this->SendHexHeader(ZACK, MakePositionHeader(position)) ;
+                    }
+
+                    if ((frame_end == ZCRCW) or
+                        (frame_end == ZCRCE))
+                    {
+                        break ;
+                    }
+                }
+
+                continue ;
+            }
+
+            if (frame_type == ZEOF)
+            {
+                // An end of file announced before the sender saw the last
+                // ZRPOS is ignored, so that the ZRPOS is repeated.
+                if (GetPosition(header_data) == position)
+                {
+                    break ;
+                }
+
+                continue ;
+            }
+
+            if (frame_type == ZFILE)
+            {
+                // The sender did not receive the ZRPOS.
+                this->ReceiveSubpacket(subpacket_data) ;
+            }
+            else
+            {
+                this->CountError(number_of_errors) ;
+            }
+
+            this->SendHexHeader(ZRPOS, MakePositionHeader(position)) ;
+        }
+
+        fileTransferResult.fileSize = position ;
+
+        // Decline further files and end the session.
+        number_of_errors = 0 ;
+        bool is_announced = false ;
+
+        while (true)
+        {
+            if (not is_announced)
+            {
+                this->SendHexHeader(ZRINIT, receiver_capabilities) ;
+            }
+
+            is_announced = false ;
+
+            const auto frame_type = this->ReadHeader(mOptions.msTimeout, header_data) ;
+
+            if (frame_type == ZFILE)
+            {
+                this->ReceiveSubpacket(subpacket_data) ;
+                this->SendHexHeader(ZSKIP, MakePositionHeader(0)) ;
+                is_announced = true ;
+                continue ;
+            }
+
+            if (frame_type == ZFIN)
+            {
+                this->SendHexHeader(ZFIN, MakePositionHeader(0)) ;
+
+                // Consume the "OO" ending the session, if it arrives.
+                const auto deadline = MakeDeadline(std::min(mOptions.msTimeout, PURGE_TIMEOUT_MS)) ;
+                size_t number_of_overs = 0 ;
+
+                while (number_of_overs < 2)
+                {
+                    const auto character = this->ReadByte(deadline) ;
+
+                    if (character == READ_TIMEOUT)
+                    {
+                        break ;
+                    }
+
+                    number_of_overs = (character == 'O') ? number_of_overs + 1 : 0 ;
+                }
+
+                break ;
+            }
+
+            if (frame_type != ZEOF)
+            {
+                this->CountError(number_of_errors) ;
+            }
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendHexHeader(const int               frameType,
+                                                      const ZmodemHeaderData& headerData)
+    {
+        static constexpr char HEX_DIGITS[] = "0123456789abcdef" ;
+
+        std::array<uint8_t, 7> header {} ;
+        header[0] = static_cast<uint8_t>(frameType) ;
+        std::copy(headerData.begin(), headerData.end(), header.begin() + 1) ;
+
+        const auto crc = ComputeCrc16(header.data(), 5) ;
+        header[5] = static_cast<uint8_t>(crc >> 8) ;
+        header[6] = static_cast<uint8_t>(crc) ;
+
+        mOutput.assign({ZPAD, ZPAD, ZDLE, ZHEX}) ;
+
+        for (const auto value : header)
+        {
+            mOutput.push_back(static_cast<uint8_t>(HEX_DIGITS[value >> 4])) ;
+            mOutput.push_back(static_cast<uint8_t>(HEX_DIGITS[value & 0x0F])) ;
+        }
+
+        mOutput.push_back('\r') ;
+        mOutput.push_back(static_cast<uint8_t>('\n' | 0x80)) ;
+
+        // Resume output that may have been stopped by noise, except at the
+        // end of the session.
+        if ((frameType != ZFIN) and
+            (frameType != ZACK))
+        {
+            mOutput.push_back(XON) ;
+        }
+
+        this->WriteData(mOutput) ;
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendBinaryHeader(const int               frameType,
+                                                         const ZmodemHeaderData& headerData)
+    {
+        std::array<uint8_t, 5> header {} ;
+        header[0] = static_cast<uint8_t>(frameType) ;
+        std::copy(headerData.begin(), headerData.end(), header.begin() + 1) ;
+
+        mOutput.assign({ZPAD, ZDLE, mSendCrc32 ? ZBIN32 : ZBIN}) ;
+
+        for (const auto value : header)
+        {
+            this->AppendEscaped(value) ;
+        }
+
+        if (mSendCrc32)
+        {
+            const auto crc = ComputeCrc32(header.data(), header.size()) ;
+
+            for (size_t i = 0 ; i < 4 ; i++)
+            {
+                this->AppendEscaped(static_cast<uint8_t>(crc >> (8 * i))) ;
+            }
+        }
+        else
+        {
+            const auto crc = ComputeCrc16(header.data(), header.size()) ;
+            this->AppendEscaped(static_cast<uint8_t>(crc >> 8)) ;
+            this->AppendEscaped(static_cast<uint8_t>(crc)) ;
+        }
+
+        this->WriteData(mOutput) ;
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendSubpacket(const uint8_t* const data,
+                                                      const size_t         numberOfBytes,
+                                                      const uint8_t        frameEnd)
+    {
+        mOutput.clear() ;
+        mOutput.reserve(2 * numberOfBytes + 16) ;
+
+        for (size_t i = 0 ; i < numberOfBytes ; i++)
+        {
+            this->AppendEscaped(data[i]) ;
+        }
+
+        mOutput.push_back(ZDLE) ;
+        mOutput.push_back(frameEnd) ;
+
+        // The CRC covers the data and the frame end.
+        if (mSendCrc32)
+        {
+            const auto crc = ComputeCrc32(&frameEnd, 1, ComputeCrc32(data, numberOfBytes)) ;
+
+            for (size_t i = 0 ; i < 4 ; i++)
+            {
+                this->AppendEscaped(static_cast<uint8_t>(crc >> (8 * i))) ;
+            }
+        }
+        else
+        {
+            const auto crc = ComputeCrc16(&frameEnd, 1, ComputeCrc16(data, numberOfBytes)) ;
+            this->AppendEscaped(static_cast<uint8_t>(crc >> 8)) ;
+            this->AppendEscaped(static_cast<uint8_t>(crc)) ;
+        }
+
+        if (frameEnd == ZCRCW)
+        {
+            mOutput.push_back(XON) ;
+        }
+
+        this->WriteData(mOutput) ;
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::AppendEscaped(const uint8_t value)
+    {
+        switch (value)
+        {
+        case ZDLE:
+        case 0x10:
+        case 0x90:
+        case XON:
+        case XON | 0x80:
+        case XOFF:
+        case XOFF | 0x80:
+            mOutput.push_back(ZDLE) ;
+            mOutput.push_back(static_cast<uint8_t>(value ^ 0x40)) ;
+            return ;
+        case '\r':
+        case '\r' | 0x80:
+            // "@" followed by a carriage return is a Telenet escape.
+            if ((not mOutput.empty()) and
+                ((mOutput.back() & 0x7F) == '@'))
+            {
+                mOutput.push_back(ZDLE) ;
+                mOutput.push_back(static_cast<uint8_t>(value ^ 0x40)) ;
+                return ;
+            }
+            break ;
+        default:
+            break ;
+        }
+
+        mOutput.push_back(value) ;
+    }
+
+    inline
+    int
+    SerialFileTransfer::Implementation::ReadHeader(const size_t      msTimeout,
+                                                   ZmodemHeaderData& headerData)
+    {
+        const auto deadline = MakeDeadline(msTimeout) ;
+        size_t number_of_cancels = 0 ;
+
+        while (true)
+        {
+            auto character = this->ReadByte(deadline) ;
+
+            if (character == READ_TIMEOUT)
+            {
+                return READ_TIMEOUT ;
+            }
+
+            // Five CAN characters outside of a header abort the session.
+            if (character == CAN)
+            {
+                if (++number_of_cancels >= 5)
+                {
+                    throw std::runtime_error(ERR_MSG_TRANSFER_CANCELLED) ;
+                }
+
+                continue ;
+            }
+
+            number_of_cancels = 0 ;
+
+            if (character != ZPAD)
+            {
+                continue ;
+            }
+
+            while (character == ZPAD)
+            {
+                character = this->ReadByte(deadline) ;
+            }
+
+            if (character == READ_TIMEOUT)
+            {
+                return READ_TIMEOUT ;
+            }
+
+            if (character != ZDLE)
+            {
+                continue ;
+            }
+
+            character = this->ReadByte(deadline) ;
+
+            std::array<uint8_t, 9> header {} ;
+            size_t header_size = 0 ;
+
+            if (character == ZHEX)
+            {
+                // Two hexadecimal digits per byte and a CRC-16.
+                header_size = 7 ;
+
+                for (size_t i = 0 ; i < header_size ; i++)
+                {
+                    const auto high = GetHexValue(this->ReadByte(deadline)) ;
+                    const auto low = GetHexValue(this->ReadByte(deadline)) ;
+
+                    if ((high < 0) or
+                        (low < 0))
+                    {
+                        return READ_ERROR ;
+                    }
+
+                    header[i] = static_cast<uint8_t>(high << 4 | low) ;
+                }
+
+                const auto crc = static_cast<uint16_t>(header[5] << 8 | header[6]) ;
+
+                if (crc != ComputeCrc16(header.data(), 5))
+                {
+                    return READ_ERROR ;
+                }
+
+                // Discard the line end, so that it is not mistaken for data
+                // following the header.
+                if ((this->PeekByte() & 0x7F) == '\r')
+                {
+                    mReadPosition++ ;
+
+                    if ((this->PeekByte() & 0x7F) == '\n')
+                    {
+                        mReadPosition++ ;
+                    }
+                }
+            }
+            else if ((character == ZBIN) or
+                     (character == ZBIN32))
+            {
+                mReceiveCrc32 = (character == ZBIN32) ;
+                header_size = mReceiveCrc32 ? 9 : 7 ;
+
+                for (size_t i = 0 ; i < header_size ; i++)
+                {
+                    const auto value = this->ReadZdleByte(deadline) ;
+
+                    if (value == READ_TIMEOUT)
+                    {
+                        return READ_TIMEOUT ;
+                    }
+
+                    if ((value < 0) or
+                        (value > 0xFF))
+                    {
+                        return READ_ERROR ;
+                    }
+
+                    header[i] = static_cast<uint8_t>(value) ;
+                }
+
+                if (mReceiveCrc32)
+                {
+                    const auto crc = static_cast<uint32_t>(header[5]) |
+                                     static_cast<uint32_t>(header[6]) << 8 |
+                                     static_cast<uint32_t>(header[7]) << 16 |
+                                     static_cast<uint32_t>(header[8]) << 24 ;
+
+                    if (crc != ComputeCrc32(header.data(), 5))
+                    {
+                        return READ_ERROR ;
+                    }
+                }
+                else
+                {
+                    const auto crc = static_cast<uint16_t>(header[5] << 8 | header[6]) ;
+
+                    if (crc != ComputeCrc16(header.data(), 5))
+                    {
+                        return READ_ERROR ;
+                    }
+                }
+            }
+            else
+            {
+                continue ;
+            }
+
+            std::copy(header.begin() + 1, header.begin() + 5, headerData.begin()) ;
+            return header[0] ;
+        }
+    }
+
+    inline
+    int
+    SerialFileTransfer::Implementation::ReceiveSubpacket(DataBuffer& subpacketData)
+    {
+        const auto deadline = MakeDeadline(mOptions.msTimeout) ;
+
+        subpacketData.clear() ;
+
+        while (true)
+        {
+            const auto value = this->ReadZdleByte(deadline) ;
+
+            if (value < 0)
+            {
+                return value ;
+            }
+
+            if ((value & GOT_FRAME_END) == 0)
+            {
+                if (subpacketData.size() >= ZMODEM_MAXIMUM_SUBPACKET_SIZE)
+                {
+                    return READ_ERROR ;
+                }
+
+                subpacketData.push_back(static_cast<uint8_t>(value)) ;
+                continue ;
+            }
+
+            const auto frame_end = static_cast<uint8_t>(value) ;
+            const size_t crc_size = mReceiveCrc32 ? 4 : 2 ;
+            std::array<uint8_t, 4> crc_bytes {} ;
+
+            for (size_t i = 0 ; i < crc_size ; i++)
+            {
+                const auto crc_byte = this->ReadZdleByte(deadline) ;
+
+                if ((crc_byte < 0) or
+                    (crc_byte > 0xFF))
+                {
+                    return (crc_byte == READ_TIMEOUT) ? READ_TIMEOUT : READ_ERROR ;
+                }
+
+                crc_bytes[i] = static_cast<uint8_t>(crc_byte) ;
+            }
+
+            bool is_valid = false ;
+
+            if (mReceiveCrc32)
+            {
+                const auto crc = static_cast<uint32_t>(crc_bytes[0]) |
+                                 static_cast<uint32_t>(crc_bytes[1]) << 8 |
+                                 static_cast<uint32_t>(crc_bytes[2]) << 16 |
+                                 static_cast<uint32_t>(crc_bytes[3]) << 24 ;
+
+                is_valid = (crc == ComputeCrc32(&frame_end, 1, ComputeCrc32(subpacketData.data(), subpacketData.size()))) ;
+            }
+            else
+            {
+                const auto crc = static_cast<uint16_t>(crc_bytes[0] << 8 | crc_bytes[1]) ;
+
+                is_valid = (crc == ComputeCrc16(&frame_end, 1, ComputeCrc16(subpacketData.data(), subpacketData.size()))) ;
+            }
+
+            return is_valid ? frame_end : READ_ERROR ;
+        }
+    }
+
+    inline
+    int
+    SerialFileTransfer::Implementation::ReadZdleByte(const Clock::time_point deadline)
+    {
+        auto character = this->ReadByte(deadline) ;
+
+        // Flow control characters are never part of the data.
+        while ((character >= 0) and
+               (character != ZDLE))
+        {
+            if (((character & 0x7F) != XON) and
+                ((character & 0x7F) != XOFF))
+            {
+                return character ;
+            }
+
+            character = this->ReadByte(deadline) ;
+        }
+
+        if (character < 0)
+        {
+            return character ;
+        }
+
+        while (true)
+        {
+            character = this->ReadByte(deadline) ;
+
+            switch (character)
+            {
+            case READ_TIMEOUT:
+                return READ_TIMEOUT ;
+            case CAN:
+                // ZDLE is CAN, so four further CAN characters abort.
+                for (size_t i = 0 ; i < 3 ; i++)
+                {
+                    if (this->ReadByte(deadline) != CAN)
+                    {
+                        return READ_ERROR ;
+                    }
+                }
+
+                throw std::runtime_error(ERR_MSG_TRANSFER_CANCELLED) ;
+            case ZCRCE:
+            case ZCRCG:
+            case ZCRCQ:
+            case ZCRCW:
+                return character | GOT_FRAME_END ;
+            case ZRUB0:
+                return 0x7F ;
+            case ZRUB1:
+                return 0xFF ;
+            case XON:
+            case XON | 0x80:
+            case XOFF:
+            case XOFF | 0x80:
+                continue ;
+            default:
+                if ((character & 0x60) == 0x40)
+                {
+                    return character ^ 0x40 ;
+                }
+
+                return READ_ERROR ;
+            }
+        }
+    }
+
+    inline
+    int
+    SerialFileTransfer::Implementation::ReadByte(const Clock::time_point deadline)
+    {
+        if (mReadPosition == mReadSize)
+        {
+            // Data that is already available is read even after the deadline.
+            const auto ms_remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count() ;
+
+            mReadPosition = 0 ;
+            mReadSize = mSerialPort->ReadInto(mReadBuffer.data(),
+                                              mReadBuffer.size(),
+                                              static_cast<size_t>(std::max<int64_t>(ms_remaining, 1))) ;
+
+            if (mReadSize == 0)
+            {
+                return READ_TIMEOUT ;
+            }
+        }
+
+        return static_cast<uint8_t>(mReadBuffer[mReadPosition++]) ;
+    }
+
+    inline
+    bool
+    SerialFileTransfer::Implementation::ReadBytes(uint8_t* const          data,
+                                                  const size_t            numberOfBytes,
+                                                  const Clock::time_point deadline)
+    {
+        size_t number_of_bytes_read = 0 ;
+
+        while (number_of_bytes_read < numberOfBytes)
+        {
+            if (mReadPosition == mReadSize)
+            {
+                const auto character = this->ReadByte(deadline) ;
+
+                if (character == READ_TIMEOUT)
+                {
+                    return false ;
+                }
+
+                data[number_of_bytes_read++] = static_cast<uint8_t>(character) ;
+                continue ;
+            }
+
+            const auto number_of_bytes = std::min(numberOfBytes - number_of_bytes_read,
+                                                  mReadSize - mReadPosition) ;
+
+            std::memcpy(data + number_of_bytes_read,
+                        mReadBuffer.data() + mReadPosition,
+                        number_of_bytes) ;
+
+            mReadPosition += number_of_bytes ;
+            number_of_bytes_read += number_of_bytes ;
+        }
+
+        return true ;
+    }
+
+    inline
+    int
+    SerialFileTransfer::Implementation::PeekByte()
+    {
+        if (mReadPosition == mReadSize)
+        {
+            if ((not this->IsInputPending()) or
+                (this->ReadByte(MakeDeadline(0)) == READ_TIMEOUT))
+            {
+                return READ_TIMEOUT ;
+            }
+
+            mReadPosition-- ;
+        }
+
+        return static_cast<uint8_t>(mReadBuffer[mReadPosition]) ;
+    }
+
+    inline
+    bool
+    SerialFileTransfer::Implementation::IsInputPending()
+    {
+        return (mReadPosition < mReadSize) or
+               (mSerialPort->GetNumberOfBytesAvailable() > 0) ;
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::Purge()
+    {
+        while (this->ReadByte(MakeDeadline(PURGE_TIMEOUT_MS)) != READ_TIMEOUT)
+        {
+            mReadPosition = mReadSize ;
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::WriteData(const DataBuffer& data)
+    {
+        mSerialPort->Write(data) ;
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::SendAbort() noexcept
+    {
+        try
+        {
+            mSerialPort->Write(DataBuffer(ABORT_LENGTH, CAN)) ;
+        }
+        catch (...)
+        {
+            // The port may have been closed or cancelled.
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::CountError(size_t& numberOfErrors) const
+    {
+        if (++numberOfErrors > mOptions.maximumRetries)
+        {
+            throw std::runtime_error(ERR_MSG_TOO_MANY_ERRORS) ;
+        }
+    }
+
+    inline
+    void
+    SerialFileTransfer::Implementation::ReportProgress(const size_t bytesTransferred,
+                                                       const size_t fileSize) const
+    {
+        if (mOptions.progressCallback)
+        {
+            mOptions.progressCallback(bytesTransferred, fileSize) ;
+        }
+    }
+
+    inline
+    Clock::time_point
+    SerialFileTransfer::Implementation::MakeDeadline(const size_t msTimeout)
+    {
+        return Clock::now() + std::chrono::milliseconds(msTimeout) ;
+    }
+
+} // namespace LibSerial
@@ -32,19 +32,220 @@
  *****************************************************************************/
 
 #include "libserial/SerialPort.h"
+#include "libserial/SerialPortEnumerator.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <fcntl.h>
 #include <linux/serial.h>
+#include <mutex>
+#include <poll.h>
+#include <shared_mutex>
 #include <sstream>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <thread>
 #include <type_traits>
 #include <unistd.h>
 
 namespace LibSerial
 {
+#ifdef __linux__
+    namespace
+    {
+        /**
+         * @brief Reads an integer value from a sysfs attribute file.
+         * @param path The path of the attribute file.
+         * @param value The value read from the file.
+         * @return Returns true iff the value was read successfully.
+         */
+        bool
+        ReadSysfsAttribute(const std::string& path,
+                           int&               value)
+        {
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            const auto fd = call_with_retry(open, path.c_str(), O_RDONLY | O_CLOEXEC) ;
+
+            if (fd < 0)
+            {
+                return false ;
+            }
+
+            char buffer[32] {} ;
+            const auto read_result = call_with_retry(read, fd, buffer, sizeof(buffer) - 1) ;
+            close(fd) ;
+
+            if (read_result <= 0)
+            {
+                return false ;
+            }
+
+            char* end = nullptr ;
+            const auto result = std::strtol(buffer, &end, 10) ;
+
+            if (end == buffer)
+            {
+                return false ;
+            }
+
+            value = static_cast<int>(result) ;
+            return true ;
+        }
+
+        /**
+         * @brief Writes an integer value to a sysfs attribute file.
+         * @param path The path of the attribute file.
+         * @param value The value to be written.
+         * @return Returns true iff the value was written successfully.
+         */
+        bool
+        WriteSysfsAttribute(const std::string& path,
+                            const int          value)
+        {
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            const auto fd = call_with_retry(open, path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC) ;
+
+            if (fd < 0)
+            {
+                return false ;
+            }
+
+            const auto value_string = std::to_string(value) ;
+            const auto write_result = call_with_retry(write,
+                                                      fd,
+                                                      value_string.c_str(),
+                                                      value_string.size()) ;
+            close(fd) ;
+
+            return (write_result == static_cast<ssize_t>(value_string.size())) ;
+        }
+    } // namespace
+#endif
+
+    namespace
+    {
+        /**
+         * @brief A chunk of a file mapped read-only into memory, which is
+         *        unmapped on destruction.
+         */
+        class MappedFileChunk
+        {
+        public:
+            /**
+             * @brief Constructor. Maps the chunk and asks the kernel to read
+             *        it ahead asynchronously.
+             * @param fileDescriptor The file descriptor of the file.
+             * @param offset The offset of the chunk, a multiple of the page
+             *        size.
+             * @param size The size of the chunk in bytes, or 0.
+             * @throw std::runtime_error if the chunk cannot be mapped.
+             */
+            MappedFileChunk(const int    fileDescriptor,
+                            const off_t  offset,
+                            const size_t size)
+                : mSize(size)
+            {
+                if (mSize == 0)
+                {
+                    return ;
+                }
+
+                mData = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fileDescriptor, offset) ;
+
+                if (mData == MAP_FAILED)    // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+                {
+                    mData = nullptr ;
+                    throw std::runtime_error(std::strerror(errno)) ;
+                }
+
+                madvise(mData, mSize, MADV_SEQUENTIAL) ;
+                madvise(mData, mSize, MADV_WILLNEED) ;
+            }
+
+            /**
+             * @brief Destructor. Unmaps the chunk.
+             */
+            ~MappedFileChunk()
+            {
+                if (mData != nullptr)
+                {
+                    munmap(mData, mSize) ;
+                }
+            }
+
+            /**
+             * @brief Copy construction is disallowed.
+             */
+            MappedFileChunk(const MappedFileChunk& otherMappedFileChunk) = delete ;
+
+            /**
+             * @brief Move construction transfers the mapping.
+             */
+            MappedFileChunk(MappedFileChunk&& otherMappedFileChunk) noexcept
+                : mData(otherMappedFileChunk.mData)
+                , mSize(otherMappedFileChunk.mSize)
+            {
+                otherMappedFileChunk.mData = nullptr ;
+            }
+
+            /**
+             * @brief Copy assignment is disallowed.
+             */
+            MappedFileChunk& operator=(const MappedFileChunk& otherMappedFileChunk) = delete ;
+
+            /**
+             * @brief Move assignment transfers the mapping.
+             */
+            MappedFileChunk& operator=(MappedFileChunk&& otherMappedFileChunk) noexcept
+            {
+                std::swap(mData, otherMappedFileChunk.mData) ;
+                std::swap(mSize, otherMappedFileChunk.mSize) ;
+                return *this ;
+            }
+
+            /**
+             * @brief Gets the mapped data.
+             * @return Returns the address of the chunk.
+             */
+            const void* GetData() const
+            {
+                return mData ;
+            }
+
+            /**
+             * @brief Gets the size of the chunk.
+             * @return Returns the size of the chunk in bytes.
+             */
+            size_t GetSize() const
+            {
+                return mSize ;
+            }
+
+        private:
+
+            /**
+             * The address of the mapping, or nullptr.
+             */
+            void* mData = nullptr ;
+
+            /**
+             * The size of the chunk in bytes.
+             */
+            size_t mSize = 0 ;
+        } ;
+    } // namespace
+
     /**
      * @brief SerialPort::Implementation is the SerialPort implementation class.
      */
@@ -111,6 +312,21 @@ namespace LibSerial
         void Open(const std::string& fileName,
                   const std::ios_base::openmode& openMode) ;
 
+        /**
+         * @brief Opens the serial port and applies a compile-time
+         *        configuration with a single tcsetattr() call.
+         * @param fileName The file name of the serial port.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         * @param applySerialConfig Applies the configuration to the
+         *        settings of the serial port, see SerialConfig::ApplyTo().
+         * @param characterTimeUs The time (us) needed to transmit a character.
+         */
+        void OpenWithConfig(const std::string& fileName,
+                            const std::ios_base::openmode& openMode,
+                            void (*applySerialConfig)(termios&),
+                            size_t characterTimeUs) ;
+
         /**
          * @brief Closes the serial port. All settings of the serial port will be
          *        lost and no more I/O can be performed on the serial port.
@@ -122,6 +338,14 @@ namespace LibSerial
          */
         void DrainWriteBuffer() ;
 
+        /**
+         * @brief Waits until the write buffer is drained or the timeout
+         *        elapses.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns true iff the write buffer was drained.
+         */
+        bool DrainWriteBuffer(size_t msTimeout) ;
+
         /**
          * @brief Flushes the serial port input buffer.
          */
@@ -286,6 +510,12 @@ namespace LibSerial
          */
         int GetNumberOfBytesAvailable() ;
 
+        /**
+         * @brief Gets the number of bytes queued for transmission.
+         * @return Returns the number of bytes in the output queue.
+         */
+        int GetNumberOfBytesQueuedForOutput() ;
+
 #ifdef __linux__
         /**
          * @brief Gets a list of available serial ports.
@@ -293,8 +523,371 @@ namespace LibSerial
          *         each available serial port.
          */
         std::vector<std::string> GetAvailableSerialPorts() const ;
+
+        /**
+         * @brief Enables or disables low latency mode.
+         * @param lowLatency True to enable low latency mode, false to
+         *        restore the original behavior.
+         * @return Returns a LowLatencyStatus describing which mechanisms were
+         *         applied.
+         */
+        LowLatencyStatus SetLowLatency(const bool lowLatency) ;
+
+        /**
+         * @brief Sets the root of the sysfs file system.
+         * @param sysfsRoot The sysfs mount point.
+         */
+        void SetSysfsRoot(const std::string& sysfsRoot) ;
 #endif
 
+        /**
+         * @brief Enables or disables auto-reconnect mode.
+         * @param autoReconnect True to enable auto-reconnect mode.
+         * @param msInitialBackoff The delay in milliseconds before the first
+         *        attempt to reopen the device.
+         * @param msMaximumBackoff The maximum delay in milliseconds between
+         *        two attempts to reopen the device.
+         */
+        void SetAutoReconnect(const bool   autoReconnect,
+                              const size_t msInitialBackoff,
+                              const size_t msMaximumBackoff) ;
+
+        /**
+         * @brief Determines if auto-reconnect mode is enabled.
+         * @return Returns true iff auto-reconnect mode is enabled.
+         */
+        bool GetAutoReconnect() const ;
+
+        /**
+         * @brief Determines if the device of an open serial port is present.
+         * @return Returns false iff the device has hung up and not been
+         *         reopened yet.
+         */
+        bool IsConnected() const ;
+
+        /**
+         * @brief Sets the function called on connection state changes.
+         * @param connectionEventCallback The function to be called.
+         */
+        void SetConnectionEventCallback(const ConnectionEventCallback& connectionEventCallback) ;
+
+        /**
+         * @brief Enables or disables write pacing.
+         * @param bytesPerSecond The average number of bytes written per
+         *        second, or 0 for no rate limit.
+         * @param maximumBurst The maximum number of bytes written at once.
+         * @param usInterFrameGap The minimum idle time of the line in
+         *        microseconds between two Write*() calls.
+         */
+        void SetWritePacing(const size_t bytesPerSecond,
+                            const size_t maximumBurst,
+                            const size_t usInterFrameGap) ;
+
+        /**
+         * @brief Determines if write pacing is enabled.
+         * @return Returns true iff write pacing is enabled.
+         */
+        bool GetWritePacing() const ;
+
+        /**
+         * @brief Enables or disables write coalescing.
+         * @param bufferSize The size of the buffer in bytes, or 0 to disable
+         *        write coalescing.
+         * @param usFlushDelay The maximum time in microseconds data stays in
+         *        the buffer, or 0 for no delayed write.
+         */
+        void SetWriteCoalescing(const size_t bufferSize,
+                                const size_t usFlushDelay) ;
+
+        /**
+         * @brief Determines if write coalescing is enabled.
+         * @return Returns true iff write coalescing is enabled.
+         */
+        bool GetWriteCoalescing() const ;
+
+        /**
+         * @brief Writes the data collected by write coalescing.
+         */
+        void Flush() ;
+
+        /**
+         * @brief Enables or disables traffic capture.
+         * @param serialCaptureWriter The capture, or nullptr to disable
+         *        traffic capture.
+         * @param portId The id recorded with the chunks of this serial port.
+         */
+        void SetCapture(const std::shared_ptr<SerialCaptureWriter>& serialCaptureWriter,
+                        const uint32_t                              portId) ;
+
+        /**
+         * @brief Records data read or written to the capture, if any. An
+         *        error stops the capture instead of failing the I/O that has
+         *        already taken place, and is thrown by the next Read*() or
+         *        Write*() call.
+         * @param direction The direction of the data.
+         * @param data The data to be recorded.
+         * @param numberOfBytes The number of bytes to be recorded.
+         */
+        void RecordCapture(const CaptureDirection direction,
+                           const void* const      data,
+                           const size_t           numberOfBytes) ;
+
+        /**
+         * @brief Throws the error that stopped the capture, once.
+         */
+        void RethrowCaptureError() ;
+
+        /**
+         * @brief Enables or disables the flight recorder.
+         * @param bufferSize The number of bytes kept, or 0 to disable the
+         *        flight recorder.
+         */
+        void SetFlightRecorder(const size_t bufferSize) ;
+
+        /**
+         * @brief Gets the contents of the flight recorder.
+         * @return Returns the chunks held by the flight recorder.
+         */
+        std::vector<CaptureRecord> DumpFlightRecorder() const ;
+
+        /**
+         * @brief Sets the function the contents of the flight recorder are
+         *        passed to.
+         * @param flightRecorderCallback The function to be called.
+         */
+        void SetFlightRecorderCallback(const FlightRecorderCallback& flightRecorderCallback) ;
+
+        /**
+         * @brief Queues the contents of the flight recorder for the flight
+         *        recorder callback, if both are set.
+         * @param flightRecorderTrigger The event that occurred.
+         */
+        void NotifyFlightRecorder(const FlightRecorderTrigger flightRecorderTrigger) ;
+
+        /**
+         * @brief Calls the queued callbacks on this thread. Called once the
+         *        locks of the call that queued them have been released.
+         *        Exceptions they throw are ignored, as that call has already
+         *        completed.
+         */
+        void DispatchEvents() noexcept ;
+
+        /**
+         * @brief Sets the file or pipe the data read is copied to.
+         * @param fileDescriptor The file descriptor, or -1 to stop copying.
+         */
+        void SetInputTee(const int fileDescriptor) ;
+
+        /**
+         * @brief Gets the file descriptor the data read is copied to.
+         * @return Returns the file descriptor, or -1.
+         */
+        int GetInputTee() const ;
+
+        /**
+         * @brief Reads from the device like read() and copies the data read
+         *        to the input tee.
+         * @param buffer The buffer the data is read into.
+         * @param numberOfBytes The maximum number of bytes to be read.
+         * @return Returns the result of the read, as read() does.
+         */
+        ssize_t ReadWithInputTee(void* const  buffer,
+                                 const size_t numberOfBytes) ;
+
+        /**
+         * @brief Copies data spliced into mInputTeePipe to the input tee and
+         *        reads it into the buffer.
+         * @param buffer The buffer the data is read into.
+         * @param numberOfBytes The number of bytes in mInputTeePipe.
+         * @return Returns the result of reading from mInputTeePipe.
+         */
+        ssize_t ReadSplicedInput(void* const  buffer,
+                                 const size_t numberOfBytes) ;
+
+        /**
+         * @brief Moves the data in mInputTeeFilePipe to the input tee. The
+         *        data that cannot be moved is discarded.
+         * @param numberOfBytes The number of bytes in mInputTeeFilePipe.
+         * @return Returns the number of bytes moved.
+         */
+        size_t SpliceToInputTee(const size_t numberOfBytes) ;
+
+        /**
+         * @brief Writes data to the input tee, waiting while it does not
+         *        accept more data. The data that cannot be written is
+         *        dropped.
+         * @param data The data to be written.
+         * @param numberOfBytes The number of bytes to be written.
+         */
+        void WriteToInputTee(const void* const data,
+                             const size_t      numberOfBytes) ;
+
+        /**
+         * @brief Sets the deadline of waiting for the input tee to the
+         *        timeout of the current Read*() call.
+         * @param msTimeout The timeout of the read in milliseconds, or 0
+         *        to wait until the read is cancelled.
+         */
+        void SetInputTeeDeadline(const size_t msTimeout) ;
+
+        /**
+         * @brief Waits until the input tee accepts more data, the deadline of
+         *        the read passes or the read is cancelled. In the latter
+         *        cases mInputTeeErrno is set.
+         * @return Returns true iff the input tee accepts more data.
+         */
+        bool WaitForInputTee() ;
+
+        /**
+         * @brief Closes the pipes used to splice the data read.
+         */
+        void CloseInputTeePipes() ;
+
+        /**
+         * @brief Gets the counters maintained by the serial port.
+         * @return Returns a copy of the counters.
+         */
+        SerialPortStatistics GetStatistics() const ;
+
+        /**
+         * @brief Resets the counters maintained by the serial port to zero.
+         */
+        void ResetStatistics() ;
+
+        /**
+         * @brief Enables or disables thread-safe mode.
+         * @param threadSafe True to enable thread-safe mode.
+         */
+        void SetThreadSafe(const bool threadSafe) ;
+
+        /**
+         * @brief Determines if thread-safe mode is enabled.
+         * @return Returns true iff thread-safe mode is enabled.
+         */
+        bool GetThreadSafe() const ;
+
+        /**
+         * @brief Cancels the blocking operations of the serial port.
+         */
+        void Cancel() noexcept ;
+
+        /**
+         * @brief Leaves the cancelled state entered by Cancel().
+         */
+        void ResetCancel() noexcept ;
+
+        /**
+         * @brief Determines if the blocking operations are cancelled.
+         * @return Returns true iff the blocking operations are cancelled.
+         */
+        bool IsCancelled() const noexcept ;
+
+        /**
+         * @brief Holds the locks of one I/O direction for the duration of a
+         *        Read*() or Write*() call: the mutex serializing the callers
+         *        of that direction and a shared lock on the settings, which
+         *        the call releases while it waits for the device. The events
+         *        queued during the call are dispatched once the locks are
+         *        released.
+         */
+        class IoLock
+        {
+        public:
+
+            /**
+             * @brief Constructs an IoLock that holds no locks.
+             */
+            explicit IoLock(Implementation& implementation)
+                : mImplementation(&implementation)
+            {
+                /* Empty */
+            }
+
+            /**
+             * @brief Locks the direction mutex, then the settings.
+             */
+            IoLock(Implementation&                            implementation,
+                   std::mutex&                                directionMutex,
+                   std::shared_lock<std::shared_timed_mutex>& settingsLock)
+                : mImplementation(&implementation)
+                , mDirectionLock(directionMutex)
+                , mSettingsLock(&settingsLock)
+            {
+                mSettingsLock->lock() ;
+            }
+
+            /**
+             * @brief Move construction transfers the locks.
+             */
+            IoLock(IoLock&& otherIoLock) noexcept
+                : mImplementation(otherIoLock.mImplementation)
+                , mDirectionLock(std::move(otherIoLock.mDirectionLock))
+                , mSettingsLock(otherIoLock.mSettingsLock)
+            {
+                otherIoLock.mImplementation = nullptr ;
+                otherIoLock.mSettingsLock = nullptr ;
+            }
+
+            IoLock(const IoLock& otherIoLock) = delete ;
+            IoLock& operator=(const IoLock& otherIoLock) = delete ;
+            IoLock& operator=(IoLock&& otherIoLock) = delete ;
+
+            /**
+             * @brief Releases the settings, then the direction mutex, and
+             *        dispatches the queued events.
+             */
+            ~IoLock()
+            {
+                if ((mSettingsLock != nullptr) and
+                    mSettingsLock->owns_lock())
+                {
+                    mSettingsLock->unlock() ;
+                }
+
+                if (mDirectionLock.owns_lock())
+                {
+                    mDirectionLock.unlock() ;
+                }
+
+                if (mImplementation != nullptr)
+                {
+                    mImplementation->DispatchEvents() ;
+                }
+            }
+
+        private:
+
+            Implementation* mImplementation {nullptr} ;
+            std::unique_lock<std::mutex> mDirectionLock {} ;
+            std::shared_lock<std::shared_timed_mutex>* mSettingsLock {nullptr} ;
+        } ;
+
+        /**
+         * @brief Locks the input direction in thread-safe mode.
+         * @return Returns the locks, which are empty in the default mode.
+         */
+        IoLock LockInput() ;
+
+        /**
+         * @brief Locks the output direction in thread-safe mode.
+         * @return Returns the locks, which are empty in the default mode.
+         */
+        IoLock LockOutput() ;
+
+        /**
+         * @brief Locks the settings for exclusive use in thread-safe mode.
+         * @return Returns the lock, which does not own the mutex in the
+         *         default mode.
+         */
+        std::unique_lock<std::shared_timed_mutex> LockSettings() ;
+
+        /**
+         * @brief Locks the settings for shared use in thread-safe mode.
+         * @return Returns the lock, which does not own the mutex in the
+         *         default mode.
+         */
+        std::shared_lock<std::shared_timed_mutex> LockSharedSettings() ;
+
         /**
          * @brief Reads the specified number of bytes from the serial port.
          *        The method will timeout if no data is received in the
@@ -363,6 +956,19 @@ namespace LibSerial
                       char         lineTerminator = '\n',
                       size_t       msTimeout = 0) ;
 
+        /**
+         * @brief Reads up to bufferSize bytes from the serial port directly
+         *        into a caller supplied buffer, waiting up to msTimeout
+         *        milliseconds for the first byte to arrive.
+         * @param dataBuffer The buffer to place data into.
+         * @param bufferSize The size of the buffer in bytes.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes read.
+         */
+        size_t ReadInto(char*  dataBuffer,
+                        size_t bufferSize,
+                        size_t msTimeout) ;
+
         /**
          * @brief Writes a DataBuffer to the serial port.
          * @param dataBuffer The DataBuffer to write to the serial port.
@@ -375,6 +981,41 @@ namespace LibSerial
          */
         void Write(const std::string& dataString) ;
 
+        /**
+         * @brief Writes the contents of a caller supplied buffer to the
+         *        serial port.
+         * @param dataBuffer The data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void Write(const char* dataBuffer,
+                   size_t      numberOfBytes) ;
+
+        /**
+         * @brief Writes as much of a caller supplied buffer as the serial
+         *        port accepts without waiting.
+         * @param dataBuffer The data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         * @return Returns the number of bytes written.
+         */
+        size_t TryWrite(const char* dataBuffer,
+                        size_t      numberOfBytes) ;
+
+        /**
+         * @brief Gets the time until write pacing lets TryWrite() write the
+         *        specified number of bytes.
+         * @param numberOfBytes The number of bytes that remain to be written.
+         * @return Returns the time in microseconds.
+         */
+        size_t GetWritePacingDelay(size_t numberOfBytes) ;
+
+        /**
+         * @brief Writes the contents of a file to the serial port.
+         * @param filePath The path of the file to be sent.
+         * @param sendFileOptions The chunk size and progress callback.
+         */
+        void SendFile(const std::string&     filePath,
+                      const SendFileOptions& sendFileOptions) ;
+
         /**
          * @brief Writes a single byte to the serial port.
          * @param charBuffer The byte to be written to the serial port.
@@ -422,44 +1063,393 @@ namespace LibSerial
     private:
 
         /**
-         * @brief Gets the bit rate for the serial port given the current baud rate setting.
-         * @return Returns the bit rate the serial port is capable of achieving.
+         * @brief Gets the current termios settings of the serial port. While
+         *        the device is disconnected, the cached settings are returned.
+         * @return Returns the current settings.
          */
-        int GetBitRate(const BaudRate& baudRate) const ;
+        termios GetPortSettings() const ;
 
         /**
-         * @brief Sets the default Linux specific line discipline modes.
+         * @brief Applies termios settings to the serial port and caches them
+         *        so that they can be restored after a reconnection. While the
+         *        device is disconnected, the settings are only cached.
+         * @param portSettings The settings to be applied.
          */
-        void SetDefaultLinuxSpecificModes() ;
+        void SetPortSettings(const termios& portSettings) ;
 
         /**
-         * @brief Sets the default serial port input modes.
+         * @brief Performs a single non-blocking read() from the serial port.
+         *        All Read() methods go through this primitive.
+         * @param buffer The buffer to place data into.
+         * @param numberOfBytes The maximum number of bytes to read.
+         * @return Returns the number of bytes read, or zero if no data is
+         *         available or the device is disconnected.
          */
-        void SetDefaultInputModes() ;
+        ssize_t ReadSome(void*  buffer,
+                         size_t numberOfBytes) ;
 
         /**
-         * @brief Sets the default serial port output modes.
+         * @brief Performs a single write() to the serial port. All Write()
+         *        methods go through this primitive.
+         * @param buffer The data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         * @return Returns the number of bytes consumed, which includes bytes
+         *         discarded while the device is disconnected, or zero if the
+         *         write would block.
          */
-        void SetDefaultOutputModes() ;
+        size_t WriteSome(const void* buffer,
+                         size_t      numberOfBytes) ;
 
         /**
-         * @brief Sets the default serial port control modes.
+         * @brief Sleeps for the time one byte needs to arrive. In thread-safe
+         *        mode, the shared lock on the settings is released meanwhile.
+         * @param settingsLock The shared lock held by the calling direction.
+         * @throw NotOpen if the port was closed by another thread.
          */
-        void SetDefaultControlModes() ;
+        void WaitForDevice(std::shared_lock<std::shared_timed_mutex>& settingsLock) ;
 
         /**
-         * @brief Sets the default serial port local modes.
+         * @brief Sleeps for the specified time, or until Cancel() is called.
+         *        In thread-safe mode, the shared lock on the settings is
+         *        released meanwhile.
+         * @param settingsLock The shared lock held by the calling direction.
+         * @param usTimeout The time to sleep in microseconds.
+         * @throw OperationCancelled if Cancel() has been called.
+         * @throw NotOpen if the port was closed by another thread.
          */
-        void SetDefaultLocalModes() ;
+        void WaitForDevice(std::shared_lock<std::shared_timed_mutex>& settingsLock,
+                           int usTimeout) ;
 
         /**
-         * The file descriptor corresponding to the serial port.
+         * @brief Sleeps for the specified time, or until Cancel() is called.
+         * @param usTimeout The time to sleep in microseconds.
+         * @throw OperationCancelled if Cancel() has been called.
          */
-        int mFileDescriptor = -1 ;
+        void WaitForCancel(int usTimeout) ;
 
         /**
-         * The time in microseconds required for a byte of data to arrive at
-         * the serial port.
+         * @brief Throws OperationCancelled if Cancel() has been called.
+         */
+        void ThrowIfCancelled() const ;
+
+        /**
+         * @brief Called by Write*() methods before their first write(). Waits
+         *        until the inter-frame gap after the previous Write*() call
+         *        has elapsed.
+         */
+        void WaitForInterFrameGap() ;
+
+        /**
+         * @brief Called by Write*() methods before each write(). Waits until
+         *        the token bucket allows the remaining bytes to be written,
+         *        up to the maximum burst.
+         * @param numberOfBytes The number of bytes that remain to be written.
+         * @return Returns the number of bytes that may be written now, which
+         *         is at least one.
+         */
+        size_t WaitForWritePacing(size_t numberOfBytes) ;
+
+        /**
+         * @brief Called by Write*() methods after each write(). Takes the
+         *        written bytes from the token bucket and extends the time the
+         *        line is estimated to be busy.
+         * @param numberOfBytes The number of bytes written.
+         */
+        void UpdateWritePacing(size_t numberOfBytes) ;
+
+        /**
+         * @brief Adds the tokens accumulated since the last refill to the
+         *        token bucket of write pacing.
+         */
+        void RefillPacingTokens() ;
+
+        /**
+         * @brief Sleeps on the pacing timer until the specified time, or
+         *        until Cancel() is called, and accounts for the delay in the
+         *        statistics. In thread-safe mode, the shared lock on the
+         *        settings is released meanwhile.
+         * @param wakeTime The time to wake up.
+         * @throw OperationCancelled if Cancel() has been called.
+         * @throw NotOpen if the port was closed by another thread.
+         */
+        void WaitForPacingTimer(const std::chrono::steady_clock::time_point& wakeTime) ;
+
+        /**
+         * @brief Writes data to the serial port, subject to write pacing.
+         *        Keeps retrying while the write would block.
+         * @param buffer The data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void WriteAll(const void* buffer,
+                      size_t      numberOfBytes) ;
+
+        /**
+         * @brief Writes as much data as write pacing allows without waiting.
+         *        Writes nothing while the inter-frame gap has not elapsed.
+         * @param buffer The data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         * @return Returns the number of bytes written.
+         */
+        size_t WriteWithoutWaiting(const void* buffer,
+                                   size_t      numberOfBytes) ;
+
+        /**
+         * @brief Adds data to the write coalescing buffer, or writes it if
+         *        write coalescing is disabled or the data does not fit.
+         * @param buffer The data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void WriteCoalesced(const void* buffer,
+                            size_t      numberOfBytes) ;
+
+        /**
+         * @brief Writes and empties the write coalescing buffer. The buffer
+         *        is emptied even if writing fails.
+         */
+        void FlushCoalescedData() ;
+
+        /**
+         * @brief Writes the data collected by write coalescing until the
+         *        deadline. The data that could not be written stays in the
+         *        buffer. The buffer is emptied if writing fails.
+         * @param deadline The time to give up at.
+         * @return Returns true iff all the data was written.
+         */
+        bool FlushCoalescedData(const std::chrono::steady_clock::time_point& deadline) ;
+
+        /**
+         * @brief Throws the exception that occurred in the background thread
+         *        of write coalescing, if any.
+         */
+        void RethrowCoalescingError() ;
+
+        /**
+         * @brief The main loop of the background thread that writes the
+         *        write coalescing buffer when the flush delay has elapsed.
+         */
+        void RunCoalescingThread() ;
+
+        /**
+         * @brief Stops the background thread of write coalescing, if any.
+         */
+        void StopCoalescingThread() ;
+
+        /**
+         * @brief Called by Write*() methods while the output queue is full.
+         *        In thread-safe mode, waits as WaitForDevice() so that settings
+         *        changes can proceed. Otherwise, returns immediately.
+         */
+        void WaitForOutputSpace() ;
+
+        /**
+         * @brief Locks the auto-reconnect state and the statistics, which
+         *        are shared by the input and output directions, in
+         *        thread-safe mode.
+         * @return Returns the lock, which does not own the mutex in the
+         *         default mode.
+         */
+        std::unique_lock<std::recursive_mutex> LockConnection() const ;
+
+        /**
+         * @brief Determines if a failed or empty read()/write() was caused by
+         *        a hang-up of the device.
+         * @param ioResult The value returned by read() or write().
+         * @return Returns true iff the device has hung up.
+         */
+        bool IsHangUp(ssize_t ioResult) const ;
+
+        /**
+         * @brief Marks the device as disconnected and schedules the first
+         *        reconnection attempt.
+         */
+        void HandleHangUp() ;
+
+        /**
+         * @brief Attempts to reopen the device if the backoff delay has
+         *        elapsed. On success, the new file description replaces the
+         *        old one under the same file descriptor and the cached
+         *        settings are restored.
+         * @return Returns true iff the device has been reopened.
+         */
+        bool TryReconnect() ;
+
+        /**
+         * @brief Gets the kernel name of the device, (e.g. ttyUSB0), after
+         *        resolving symbolic links in the file name.
+         * @return Returns the kernel name of the device.
+         */
+        std::string GetDeviceName() const ;
+
+        /**
+         * @brief Determines the path used to reopen the device, which is its
+         *        /dev/serial/by-id path if it has one.
+         * @return Returns the path used to reopen the device.
+         */
+        std::string GetReconnectPath() const ;
+
+        /**
+         * @brief Queues a call of the connection event callback, if one is
+         *        set.
+         * @param connectionEvent The event to be reported.
+         */
+        void NotifyConnectionEvent(const ConnectionEvent connectionEvent) ;
+
+        /**
+         * @brief Queues a call of a user callback until the I/O call that
+         *        detected the event has released its locks, so that the
+         *        callback may call back into the serial port.
+         * @param event The call of the callback.
+         */
+        void QueueEvent(std::function<void()>&& event) ;
+
+        /**
+         * @brief Gets the bit rate for the serial port given the current baud rate setting.
+         * @return Returns the bit rate the serial port is capable of achieving.
+         */
+        int GetBitRate(const BaudRate& baudRate) const ;
+
+        /**
+         * @brief Sets the default Linux specific line discipline modes.
+         */
+        void SetDefaultLinuxSpecificModes() ;
+
+        /**
+         * @brief Sets the default serial port input modes.
+         */
+        void SetDefaultInputModes() ;
+
+        /**
+         * @brief Sets the default serial port output modes.
+         */
+        void SetDefaultOutputModes() ;
+
+        /**
+         * @brief Sets the default serial port control modes.
+         */
+        void SetDefaultControlModes() ;
+
+        /**
+         * @brief Sets the default serial port local modes.
+         */
+        void SetDefaultLocalModes() ;
+
+#ifdef __linux__
+        /**
+         * @brief Gets the sysfs path of the latency_timer attribute of the
+         *        serial port device. The attribute is only provided by some
+         *        USB-serial drivers and the returned path may not exist.
+         * @return Returns the path of the latency_timer attribute.
+         */
+        std::string GetLatencyTimerPath() const ;
+
+        /**
+         * @brief Restores the low latency settings that were in effect
+         *        before the first call to SetLowLatency(). Errors are ignored.
+         */
+        void RestoreLowLatencySettings() noexcept ;
+#endif
+
+        /**
+         * The file descriptor corresponding to the serial port.
+         */
+        int mFileDescriptor = -1 ;
+
+        /**
+         * The file name used to open the serial port.
+         */
+        std::string mFileName {} ;
+
+        /**
+         * The root of the sysfs file system.
+         */
+        std::string mSysfsRoot {SYSFS_ROOT_DEFAULT} ;
+
+        /**
+         * True if SetLowLatency() has saved the original low latency
+         * settings of the serial port, which must be restored on Close().
+         */
+        bool mLowLatencySaved = false ;
+
+        /**
+         * The ASYNC_LOW_LATENCY flag before the first call to SetLowLatency(),
+         * or -1 if TIOCGSERIAL is not supported by the device.
+         */
+        int mOldAsyncLowLatency = -1 ;
+
+        /**
+         * The latency_timer value (ms) before the first call to
+         * SetLowLatency(), or -1 if the driver has no latency_timer.
+         */
+        int mOldLatencyTimerMs = -1 ;
+
+        /**
+         * True if SetLowLatency(true) was the last call to SetLowLatency(),
+         * so that low latency mode is re-enabled after a reconnection.
+         */
+        bool mLowLatencyRequested = false ;
+
+        /**
+         * True if a hang-up of the device is handled by reopening it
+         * instead of throwing an exception.
+         */
+        bool mAutoReconnect = false ;
+
+        /**
+         * True while the device has hung up and has not been reopened.
+         * The file descriptor then refers to the hung up file description.
+         */
+        std::atomic<bool> mDisconnected {false} ;
+
+        /**
+         * The delay before the first attempt to reopen the device.
+         */
+        std::chrono::milliseconds mInitialBackoff {RECONNECT_BACKOFF_INITIAL_MS} ;
+
+        /**
+         * The maximum delay between two attempts to reopen the device.
+         */
+        std::chrono::milliseconds mMaximumBackoff {RECONNECT_BACKOFF_MAXIMUM_MS} ;
+
+        /**
+         * The delay before the next attempt to reopen the device.
+         */
+        std::chrono::milliseconds mCurrentBackoff {RECONNECT_BACKOFF_INITIAL_MS} ;
+
+        /**
+         * The earliest time of the next attempt to reopen the device.
+         */
+        std::chrono::steady_clock::time_point mNextReconnectTime {} ;
+
+        /**
+         * The path used to reopen the device.
+         */
+        std::string mReconnectPath {} ;
+
+        /**
+         * The termios settings last applied by SetPortSettings().
+         */
+        termios mPortSettings {} ;
+
+        /**
+         * The modem control lines explicitly set and cleared by the user,
+         * which are restored after a reconnection.
+         */
+        int mModemLinesSet = 0 ;
+        int mModemLinesCleared = 0 ;
+
+        /**
+         * The function called on connection state changes.
+         */
+        ConnectionEventCallback mConnectionEventCallback {} ;
+
+        /**
+         * The counters maintained by the serial port.
+         */
+        SerialPortStatistics mStatistics {} ;
+
+        /**
+         * The time in microseconds required for a byte of data to arrive at
+         * the serial port.
          */
         int mByteArrivalTimeDelta = 1 ;
 
@@ -469,494 +1459,2258 @@ namespace LibSerial
          * is closed.
          */
         termios mOldPortSettings {} ;
-    } ;
 
-    SerialPort::SerialPort()
-        : mImpl(new Implementation())
-    {
-        /* Empty */
-    }
+        /**
+         * True if the serial port is in thread-safe mode.
+         */
+        bool mThreadSafe = false ;
 
-    SerialPort::SerialPort(const std::string&   fileName,
-                           const BaudRate&      baudRate,
-                           const CharacterSize& characterSize,
-                           const FlowControl&   flowControlType,
-                           const Parity&        parityType,
-                           const StopBits&      stopBits)
-        : mImpl(new Implementation(fileName,
-                                   baudRate,
-                                   characterSize,
-                                   flowControlType,
-                                   parityType,
-                                   stopBits))
-    {
-        /* Empty */
-    }
+        /**
+         * Serialize the callers of Read*() and of Write*() methods
+         * respectively in thread-safe mode.
+         */
+        std::mutex mInputMutex {} ;
+        std::mutex mOutputMutex {} ;
 
-    SerialPort::SerialPort(SerialPort&& otherSerialPort) : 
-        mImpl(std::move(otherSerialPort.mImpl))
-    {
-        // empty
+        /**
+         * Held exclusively while the settings or the state of the port are
+         * changed and shared by the I/O directions and getters.
+         */
+        std::shared_timed_mutex mSettingsMutex {} ;
+
+        /**
+         * The shared locks on the settings held by the input and output
+         * directions, released while they wait for the device.
+         */
+        std::shared_lock<std::shared_timed_mutex> mInputSettingsLock {mSettingsMutex, std::defer_lock} ;
+        std::shared_lock<std::shared_timed_mutex> mOutputSettingsLock {mSettingsMutex, std::defer_lock} ;
+
+        /**
+         * Protects the auto-reconnect state, the statistics and the queued
+         * events. Recursive since events are queued while the
+         * auto-reconnect state is updated.
+         */
+        mutable std::recursive_mutex mConnectionMutex {} ;
+
+        /**
+         * The callbacks to be called once the I/O call that queued them has
+         * released its locks.
+         */
+        std::vector<std::function<void()>> mPendingEvents {} ;
+
+        /**
+         * True while mPendingEvents is not empty, so that I/O calls do not
+         * take the connection lock to find out.
+         */
+        std::atomic<bool> mHasPendingEvents {false} ;
+
+        /**
+         * True while the blocking operations of the serial port are cancelled.
+         */
+        std::atomic<bool> mCancelled {false} ;
+
+        /**
+         * The eventfd that wakes up the threads waiting for the device when
+         * Cancel() is called. It is readable while mCancelled is true.
+         */
+        int mCancelFileDescriptor {eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)} ;    // NOLINT (hicpp-signed-bitwise)
+
+        /**
+         * True if Write*() methods are paced.
+         */
+        bool mWritePacing = false ;
+
+        /**
+         * The rate at which the token bucket of write pacing fills, or 0 if
+         * the rate is not limited.
+         */
+        size_t mPacingBytesPerSecond = 0 ;
+
+        /**
+         * The capacity of the token bucket of write pacing.
+         */
+        size_t mPacingMaximumBurst = WRITE_PACING_BURST_DEFAULT ;
+
+        /**
+         * The minimum idle time of the line between two Write*() calls.
+         */
+        std::chrono::microseconds mPacingInterFrameGap {0} ;
+
+        /**
+         * The number of bytes that may be written without waiting. Negative
+         * if more bytes were written than the bucket held.
+         */
+        double mPacingTokens = 0. ;
+
+        /**
+         * The time the token bucket was last refilled.
+         */
+        std::chrono::steady_clock::time_point mPacingRefillTime {} ;
+
+        /**
+         * The estimated time the transmission of the written data ends.
+         */
+        std::chrono::steady_clock::time_point mLineIdleTime {} ;
+
+        /**
+         * The timerfd used to wait for write pacing, created when write
+         * pacing is first enabled.
+         */
+        int mPacingTimerFileDescriptor = -1 ;
+
+        /**
+         * The size of the write coalescing buffer, or 0 if write coalescing
+         * is disabled.
+         */
+        size_t mCoalescingBufferSize = 0 ;
+
+        /**
+         * The maximum time data stays in the write coalescing buffer, or 0 if
+         * the buffer is not written after a delay.
+         */
+        std::chrono::microseconds mCoalescingFlushDelay {0} ;
+
+        /**
+         * The data collected by write coalescing. Like the settings of write
+         * coalescing, it is protected by the output direction lock.
+         */
+        std::vector<char> mCoalescingBuffer {} ;
+
+        /**
+         * The exception that occurred in the background thread of write
+         * coalescing, which is thrown by the next Write*() or Flush() call.
+         */
+        std::exception_ptr mCoalescingError {} ;
+
+        /**
+         * Protects the time of the delayed write and the stop request of the
+         * background thread of write coalescing.
+         */
+        std::mutex mCoalescingMutex {} ;
+
+        /**
+         * Wakes up the background thread of write coalescing.
+         */
+        std::condition_variable mCoalescingCondition {} ;
+
+        /**
+         * The time the write coalescing buffer is written, if it is not
+         * written before.
+         */
+        std::chrono::steady_clock::time_point mCoalescingFlushTime {std::chrono::steady_clock::time_point::max()} ;
+
+        /**
+         * True when the background thread of write coalescing must exit.
+         */
+        bool mCoalescingThreadStop = false ;
+
+        /**
+         * The background thread of write coalescing, started when a flush
+         * delay is first set.
+         */
+        std::thread mCoalescingThread {} ;
+
+        /**
+         * The capture the data read and written is recorded to, if any.
+         */
+        std::shared_ptr<SerialCaptureWriter> mCapture {} ;
+
+        /**
+         * The id recorded with the captured data.
+         */
+        uint32_t mCapturePortId = 0 ;
+
+        /**
+         * True once recording to the capture failed, which stops the
+         * capture until SetCapture() is called again.
+         */
+        std::atomic<bool> mCaptureFailed {false} ;
+
+        /**
+         * The error that stopped the capture, thrown by the next Read*() or
+         * Write*() call. Accessed while holding the connection lock.
+         */
+        std::exception_ptr mCaptureError {} ;
+
+        /**
+         * The flight recorder the data read and written is recorded to, if
+         * enabled.
+         */
+        std::unique_ptr<SerialFlightRecorder> mFlightRecorder {} ;
+
+        /**
+         * The function the contents of the flight recorder are passed to.
+         */
+        FlightRecorderCallback mFlightRecorderCallback {} ;
+
+        /**
+         * The file or pipe the data read is copied to, or -1.
+         */
+        int mInputTeeFileDescriptor = -1 ;
+
+        /**
+         * True while the data read is spliced rather than copied through
+         * user space.
+         */
+        bool mInputTeeSplice = false ;
+
+        /**
+         * True if the input tee is a pipe, to which tee() copies directly.
+         */
+        bool mInputTeeIsPipe = false ;
+
+        /**
+         * The pipe the data is spliced into from the device and read from
+         * by the Read*() methods.
+         */
+        std::array<int, 2> mInputTeePipe {{-1, -1}} ;
+
+        /**
+         * The pipe tee() duplicates the data into if the input tee is a
+         * file, from which it is spliced to the file.
+         */
+        std::array<int, 2> mInputTeeFilePipe {{-1, -1}} ;
+
+        /**
+         * The capacity of mInputTeePipe in bytes.
+         */
+        size_t mInputTeePipeSize = 0 ;
+
+        /**
+         * The errno of a failed write to the input tee, thrown by the next
+         * Read*() call, or 0.
+         */
+        int mInputTeeErrno = 0 ;
+
+        /**
+         * The deadline of the current Read*() call, up to which a read waits
+         * for the input tee.
+         */
+        std::chrono::steady_clock::time_point mInputTeeDeadline {std::chrono::steady_clock::time_point::max()} ;
+    } ;
+
+    SerialPort::SerialPort()
+        : mImpl(new Implementation())
+    {
+        /* Empty */
+    }
+
+    SerialPort::SerialPort(const std::string&   fileName,
+                           const BaudRate&      baudRate,
+                           const CharacterSize& characterSize,
+                           const FlowControl&   flowControlType,
+                           const Parity&        parityType,
+                           const StopBits&      stopBits)
+        : mImpl(new Implementation(fileName,
+                                   baudRate,
+                                   characterSize,
+                                   flowControlType,
+                                   parityType,
+                                   stopBits))
+    {
+        /* Empty */
+    }
+
+    SerialPort::SerialPort(SerialPort&& otherSerialPort) : 
+        mImpl(std::move(otherSerialPort.mImpl))
+    {
+        // empty
+    }
+
+    SerialPort& SerialPort::operator=(SerialPort&& otherSerialPort)
+    {
+        mImpl = std::move(otherSerialPort.mImpl);
+        return *this;
+    }
+
+    SerialPort::~SerialPort() noexcept = default ;
+
+    void
+    SerialPort::Open(const std::string& fileName,
+                     const std::ios_base::openmode& openMode)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->Open(fileName,
+                    openMode) ;
+    }
+
+    void
+    SerialPort::OpenWithConfig(const std::string& fileName,
+                               const std::ios_base::openmode& openMode,
+                               void (*applySerialConfig)(termios&),
+                               const size_t characterTimeUs)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->OpenWithConfig(fileName,
+                              openMode,
+                              applySerialConfig,
+                              characterTimeUs) ;
+    }
+
+    void
+    SerialPort::Close()
+    {
+        // Writing the data collected by write coalescing may detect a
+        // hang-up, which queues events.
+        {
+            const auto settings_lock = mImpl->LockSettings() ;
+            mImpl->Close() ;
+        }
+
+        mImpl->DispatchEvents() ;
+    }
+
+    void
+    SerialPort::DrainWriteBuffer()
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->DrainWriteBuffer() ;
+    }
+
+    bool
+    SerialPort::DrainWriteBuffer(const size_t msTimeout)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        return mImpl->DrainWriteBuffer(msTimeout) ;
+    }
+
+    void
+    SerialPort::FlushInputBuffer()
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->FlushInputBuffer() ;
+    }
+
+    void
+    SerialPort::FlushOutputBuffer()
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->FlushOutputBuffer() ;
+    }
+
+    void
+    SerialPort::FlushIOBuffers()
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->FlushIOBuffers() ;
+    }
+
+    bool
+    SerialPort::IsDataAvailable()
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->IsDataAvailable() ;
+    }
+
+    bool
+    SerialPort::IsOpen() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->IsOpen() ;
+    }
+
+    void
+    SerialPort::SetDefaultSerialPortParameters()
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetDefaultSerialPortParameters() ;
+    }
+
+    void
+    SerialPort::SetBaudRate(const BaudRate& baudRate)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetBaudRate(baudRate) ;
+    }
+
+    BaudRate
+    SerialPort::GetBaudRate() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetBaudRate() ;
+    }
+
+    void
+    SerialPort::SetCharacterSize(const CharacterSize& characterSize)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetCharacterSize(characterSize) ;
+    }
+
+    CharacterSize
+    SerialPort::GetCharacterSize() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetCharacterSize() ;
+    }
+
+    void
+    SerialPort::SetFlowControl(const FlowControl& flowControlType)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetFlowControl(flowControlType) ;
+    }
+
+    FlowControl
+    SerialPort::GetFlowControl() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetFlowControl() ;
+    }
+
+    void
+    SerialPort::SetParity(const Parity& parityType)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetParity(parityType) ;
+    }
+
+    Parity
+    SerialPort::GetParity() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetParity() ;
+    }
+
+    void
+    SerialPort::SetStopBits(const StopBits& stopBits)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetStopBits(stopBits) ;
+    }
+
+    StopBits
+    SerialPort::GetStopBits() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetStopBits() ;
+    }
+
+    void
+    SerialPort::SetVMin(const short vmin)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetVMin(vmin) ;
+    }
+
+    short
+    SerialPort::GetVMin() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetVMin() ;
+    }
+
+    void
+    SerialPort::SetVTime(const short vtime)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetVTime(vtime) ;
+    }
+
+    short
+    SerialPort::GetVTime() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetVTime() ;
+    }
+
+    void
+    SerialPort::SetDTR(const bool dtrState)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetDTR(dtrState) ;
+    }
+
+    bool
+    SerialPort::GetDTR() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetDTR() ;
+    }
+
+    void
+    SerialPort::SetRTS(const bool rtsState)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetRTS(rtsState) ;
+    }
+
+    bool
+    SerialPort::GetRTS() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetRTS() ;
+    }
+
+    bool
+    SerialPort::GetCTS()
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetCTS() ;
+    }
+
+    bool
+    SerialPort::GetDSR()
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetDSR() ;
+    }
+
+    int
+    SerialPort::GetFileDescriptor() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetFileDescriptor() ;
+    }
+
+    int
+    SerialPort::GetNumberOfBytesAvailable()
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetNumberOfBytesAvailable() ;
+    }
+
+    int
+    SerialPort::GetNumberOfBytesQueuedForOutput()
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetNumberOfBytesQueuedForOutput() ;
+    }
+
+#ifdef __linux__
+    std::vector<std::string>
+    SerialPort::GetAvailableSerialPorts() const
+    {
+        return mImpl->GetAvailableSerialPorts() ;
+    }
+
+    LowLatencyStatus
+    SerialPort::SetLowLatency(const bool lowLatency)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        return mImpl->SetLowLatency(lowLatency) ;
+    }
+
+    void
+    SerialPort::SetSysfsRoot(const std::string& sysfsRoot)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetSysfsRoot(sysfsRoot) ;
+    }
+#endif
+
+    void
+    SerialPort::SetAutoReconnect(const bool   autoReconnect,
+                                 const size_t msInitialBackoff,
+                                 const size_t msMaximumBackoff)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetAutoReconnect(autoReconnect,
+                                msInitialBackoff,
+                                msMaximumBackoff) ;
+    }
+
+    bool
+    SerialPort::GetAutoReconnect() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetAutoReconnect() ;
+    }
+
+    bool
+    SerialPort::IsConnected() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->IsConnected() ;
+    }
+
+    void
+    SerialPort::SetConnectionEventCallback(const ConnectionEventCallback& connectionEventCallback)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetConnectionEventCallback(connectionEventCallback) ;
+    }
+
+    void
+    SerialPort::SetWritePacing(const size_t bytesPerSecond,
+                               const size_t maximumBurst,
+                               const size_t usInterFrameGap)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetWritePacing(bytesPerSecond,
+                              maximumBurst,
+                              usInterFrameGap) ;
+    }
+
+    bool
+    SerialPort::GetWritePacing() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetWritePacing() ;
+    }
+
+    void
+    SerialPort::SetWriteCoalescing(const size_t bufferSize,
+                                   const size_t usFlushDelay)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->SetWriteCoalescing(bufferSize,
+                                  usFlushDelay) ;
+    }
+
+    bool
+    SerialPort::GetWriteCoalescing() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetWriteCoalescing() ;
+    }
+
+    void
+    SerialPort::Flush()
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->Flush() ;
+    }
+
+    void
+    SerialPort::SetCapture(const std::shared_ptr<SerialCaptureWriter>& serialCaptureWriter,
+                           const uint32_t                              portId)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetCapture(serialCaptureWriter,
+                          portId) ;
+    }
+
+    void
+    SerialPort::SetFlightRecorder(const size_t bufferSize)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetFlightRecorder(bufferSize) ;
+    }
+
+    std::vector<CaptureRecord>
+    SerialPort::DumpFlightRecorder() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->DumpFlightRecorder() ;
+    }
+
+    void
+    SerialPort::SetFlightRecorderCallback(const FlightRecorderCallback& flightRecorderCallback)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetFlightRecorderCallback(flightRecorderCallback) ;
+    }
+
+    void
+    SerialPort::ReportParseError()
+    {
+        {
+            const auto settings_lock = mImpl->LockSharedSettings() ;
+            mImpl->NotifyFlightRecorder(FlightRecorderTrigger::PARSE_ERROR) ;
+        }
+
+        mImpl->DispatchEvents() ;
+    }
+
+    void
+    SerialPort::SetInputTee(const int fileDescriptor)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetInputTee(fileDescriptor) ;
+    }
+
+    int
+    SerialPort::GetInputTee() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetInputTee() ;
+    }
+
+    SerialPortStatistics
+    SerialPort::GetStatistics() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetStatistics() ;
+    }
+
+    void
+    SerialPort::ResetStatistics()
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        mImpl->ResetStatistics() ;
+    }
+
+    void
+    SerialPort::SetThreadSafe(const bool threadSafe)
+    {
+        mImpl->SetThreadSafe(threadSafe) ;
+    }
+
+    bool
+    SerialPort::GetThreadSafe() const
+    {
+        return mImpl->GetThreadSafe() ;
+    }
+
+    void
+    SerialPort::Cancel() noexcept
+    {
+        mImpl->Cancel() ;
+    }
+
+    void
+    SerialPort::ResetCancel() noexcept
+    {
+        mImpl->ResetCancel() ;
+    }
+
+    bool
+    SerialPort::IsCancelled() const noexcept
+    {
+        return mImpl->IsCancelled() ;
+    }
+
+    void
+    SerialPort::Read(DataBuffer& dataBuffer,
+                     const size_t numberOfBytes,
+                     const size_t msTimeout)
+    {
+        const auto input_lock = mImpl->LockInput() ;
+        mImpl->Read(dataBuffer,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    void
+    SerialPort::Read(std::string& dataString,
+                     const size_t numberOfBytes,
+                     const size_t msTimeout)
+    {
+        const auto input_lock = mImpl->LockInput() ;
+        mImpl->Read(dataString,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    void
+    SerialPort::ReadByte(char&        charBuffer,
+                         const size_t msTimeout)
+    {
+        const auto input_lock = mImpl->LockInput() ;
+        mImpl->ReadByte(charBuffer,
+                        msTimeout) ;
+    }
+
+    void
+    SerialPort::ReadByte(unsigned char& charBuffer,
+                         const size_t   msTimeout)
+    {
+        const auto input_lock = mImpl->LockInput() ;
+        mImpl->ReadByte(charBuffer,
+                        msTimeout) ;
+    }
+
+    void
+    SerialPort::ReadLine(std::string& dataString,
+                         const char   lineTerminator,
+                         const size_t msTimeout)
+    {
+        const auto input_lock = mImpl->LockInput() ;
+        mImpl->ReadLine(dataString,
+                        lineTerminator,
+                        msTimeout) ;
+    }
+
+    size_t
+    SerialPort::ReadInto(char* const  dataBuffer,
+                         const size_t bufferSize,
+                         const size_t msTimeout)
+    {
+        const auto input_lock = mImpl->LockInput() ;
+        return mImpl->ReadInto(dataBuffer,
+                               bufferSize,
+                               msTimeout) ;
+    }
+
+    void
+    SerialPort::Write(const DataBuffer& dataBuffer)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->Write(dataBuffer) ;
+    }
+
+    void
+    SerialPort::Write(const std::string& dataString)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->Write(dataString) ;
+    }
+
+    void
+    SerialPort::Write(const char* const dataBuffer,
+                      const size_t      numberOfBytes)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->Write(dataBuffer,
+                     numberOfBytes) ;
+    }
+
+    size_t
+    SerialPort::TryWrite(const char* const dataBuffer,
+                         const size_t      numberOfBytes)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        return mImpl->TryWrite(dataBuffer,
+                               numberOfBytes) ;
+    }
+
+    size_t
+    SerialPort::GetWritePacingDelay(const size_t numberOfBytes)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        return mImpl->GetWritePacingDelay(numberOfBytes) ;
+    }
+
+    void
+    SerialPort::SendFile(const std::string&     filePath,
+                         const SendFileOptions& sendFileOptions)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->SendFile(filePath,
+                        sendFileOptions) ;
+    }
+
+    void
+    SerialPort::WriteByte(const char charBuffer)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->WriteByte(charBuffer) ;
+    }
+
+    void
+    SerialPort::WriteByte(const unsigned char charBuffer)
+    {
+        const auto output_lock = mImpl->LockOutput() ;
+        mImpl->WriteByte(charBuffer) ;
+    }
+
+    void
+    SerialPort::SetSerialPortBlockingStatus(const bool blockingStatus)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetSerialPortBlockingStatus(blockingStatus) ;
+    }
+
+    bool
+    SerialPort::GetSerialPortBlockingStatus() const
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetSerialPortBlockingStatus() ;
+    }
+
+    void
+    SerialPort::SetModemControlLine(const int modemLine,
+                                    const bool lineState)
+    {
+        const auto settings_lock = mImpl->LockSettings() ;
+        mImpl->SetModemControlLine(modemLine, lineState) ;
+    }
+
+    bool
+    SerialPort::GetModemControlLine(const int modemLine)
+    {
+        const auto settings_lock = mImpl->LockSharedSettings() ;
+        return mImpl->GetModemControlLine(modemLine) ;
+    }
+
+    /** -------------------------- Implementation -------------------------- */
+
+    inline
+    SerialPort::Implementation::Implementation(const std::string&   fileName,
+                                               const BaudRate&      baudRate,
+                                               const CharacterSize& characterSize,
+                                               const FlowControl&   flowControlType,
+                                               const Parity&        parityType,
+                                               const StopBits&      stopBits)
+    {
+        this->Open(fileName, std::ios_base::in | std::ios_base::out) ;
+        this->SetBaudRate(baudRate) ;
+        this->SetCharacterSize(characterSize) ;
+        this->SetFlowControl(flowControlType) ;
+        this->SetParity(parityType) ;
+        this->SetStopBits(stopBits) ;
+    }
+
+    inline
+    SerialPort::Implementation::~Implementation()
+    try
+    {
+        // The background thread must not write while the port is closed.
+        this->StopCoalescingThread() ;
+
+        // Close the serial port if it is open.
+        if (this->IsOpen())
+        {
+            this->Close() ;
+        }
+
+        if (mCancelFileDescriptor >= 0)
+        {
+            call_with_retry(close, mCancelFileDescriptor) ;
+        }
+
+        if (mPacingTimerFileDescriptor >= 0)
+        {
+            call_with_retry(close, mPacingTimerFileDescriptor) ;
+        }
+
+        this->CloseInputTeePipes() ;
+    }
+    catch(...)
+    {
+        //
+        // :IMPORTANT: We do not let any exceptions escape the destructor.
+        // (see https://isocpp.org/wiki/faq/exceptions#dtors-shouldnt-throw)
+        //
+        // :TODO: Once we add logging to LibSerial, we should issue a warning
+        // if we reach here.
+        //
+    }
+
+    inline
+    void
+    SerialPort::Implementation::Open(const std::string& fileName,
+                                     const std::ios_base::openmode& openMode)
+    {
+        this->OpenWithConfig(fileName, openMode, nullptr, 0) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::OpenWithConfig(const std::string& fileName,
+                                               const std::ios_base::openmode& openMode,
+                                               void (*applySerialConfig)(termios&),
+                                               const size_t characterTimeUs)
+    {
+        // Throw an exception if the port is already open.
+        if (this->IsOpen())
+        {
+            throw AlreadyOpen(ERR_MSG_PORT_ALREADY_OPEN) ;
+        }
+
+        // We only allow three different combinations of ios_base::openmode so
+        // we can use a switch here to construct the flags to be used with the
+        // open() system call.  Since we are dealing with the serial port we
+        // need to use the O_NOCTTY option.
+        int flags = (O_NOCTTY | O_NONBLOCK) ;   // NOLINT (hicpp-signed-bitwise)
+
+        if (openMode == (std::ios_base::in | std::ios_base::out))
+        {
+            flags |= O_RDWR ;
+        }
+        else if (openMode == std::ios_base::in)
+        {
+            flags |= O_RDONLY ;
+        }
+        else if (openMode == std::ios_base::out)
+        {
+            flags |= O_WRONLY ;
+        }
+        else
+        {
+            throw OpenFailed {"Invalid or unsupported open mode"} ;
+        }
+
+        // Try to open the serial port.
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        mFileDescriptor = call_with_retry(open, fileName.c_str(), flags) ;
+
+        if (this->mFileDescriptor < 0)
+        {
+            throw OpenFailed(std::strerror(errno)) ;
+        }
+
+        // Set the serial port to exclusive access to this process.
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCEXCL) == -1)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Save the current settings of the serial port so they can be
+        // restored when the serial port is closed.
+        if (tcgetattr(this->mFileDescriptor,
+                      &mOldPortSettings) < 0)
+        {
+            throw OpenFailed(std::strerror(errno)) ;
+        }
+
+        // Remember the file name, e.g. to locate the device in sysfs.
+        mFileName = fileName ;
+
+        // Operations on the newly opened port are not cancelled.
+        this->ResetCancel() ;
+
+        // Set up the default configuration for the serial port, or apply
+        // the compile-time configuration with a single tcsetattr() call.
+        if (applySerialConfig == nullptr)
+        {
+            this->SetDefaultSerialPortParameters() ;
+        }
+        else
+        {
+            auto port_settings = mOldPortSettings ;
+            applySerialConfig(port_settings) ;
+            this->SetPortSettings(port_settings) ;
+            mByteArrivalTimeDelta = static_cast<int>(characterTimeUs) ;
+        }
+
+        // Flush the input and output buffers associated with the port.
+        this->FlushIOBuffers() ;
+
+        // Determine the stable path of the device while it is present.
+        if (mAutoReconnect)
+        {
+            mReconnectPath = this->GetReconnectPath() ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::Close()
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Write the data collected by write coalescing without waiting,
+        // unless another thread is writing.
+        {
+            const std::unique_lock<std::mutex> output_lock {mOutputMutex, std::try_to_lock} ;
+
+            if (output_lock.owns_lock())
+            {
+                try
+                {
+                    size_t number_of_bytes_written = 0 ;
+
+                    while (number_of_bytes_written < mCoalescingBuffer.size())
+                    {
+                        const auto write_result = this->WriteSome(&mCoalescingBuffer[number_of_bytes_written],
+                                                                  mCoalescingBuffer.size() - number_of_bytes_written) ;
+                        if (write_result == 0)
+                        {
+                            break ;
+                        }
+
+                        number_of_bytes_written += write_result ;
+                    }
+                }
+                catch (...)
+                {
+                    // The device may have been removed, see below.
+                }
+            }
+
+            // Writers only access the buffer while holding the settings
+            // lock, so the remaining data can be discarded in any case.
+            mCoalescingBuffer.clear() ;
+            mCoalescingError = nullptr ;
+        }
+
+        // Restore the old settings of the port.
+        //
+        // :IMPORTANT: If there is an error while attempting to restore the old
+        // settings, do not throw an exception here and attempt to close the
+        // serial port anyways. See issue #135 for the reason for this. The
+        // serial port device may have been removed when this method is called.
+        // In such a case we will not be able to restore the old settings. But
+        // we should still close the serial port file descriptor. Otherwise,
+        // the user has no way to cleanly recover from this state.
+        std::string err_msg {} ;
+        if (tcsetattr(this->mFileDescriptor,
+                      TCSANOW,
+                      &mOldPortSettings) < 0)
+        {
+            err_msg = std::strerror(errno) ;
+        }
+
+#ifdef __linux__
+        // Undo any changes made by SetLowLatency().
+        this->RestoreLowLatencySettings() ;
+#endif
+
+        // Otherwise, close the serial port and set the file descriptor
+        // to an invalid value.
+        bool is_failed = false ;
+        if (call_with_retry(close, this->mFileDescriptor) < 0)
+        {
+            is_failed = true ;
+            err_msg += ", " ;
+            err_msg += std::strerror(errno) ;
+        }
+
+        // Set the file descriptor to an invalid value, -1.
+        mFileDescriptor = -1 ;
+        mFileName.clear() ;
+
+        // Forget the state of the closed device.
+        mDisconnected = false ;
+        mReconnectPath.clear() ;
+        mModemLinesSet = 0 ;
+        mModemLinesCleared = 0 ;
+        mLowLatencyRequested = false ;
+
+        //
+        // Throw an exception if close() failed
+        //
+        if (is_failed)
+        {
+            throw std::runtime_error(err_msg) ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::DrainWriteBuffer()
+    {
+        this->DrainWriteBuffer(size_t {0}) ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::DrainWriteBuffer(const size_t msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Obtain the deadline.
+        const auto deadline = (msTimeout == 0) ?
+                              std::chrono::steady_clock::time_point::max() :
+                              std::chrono::steady_clock::now() + std::chrono::milliseconds(msTimeout) ;
+
+        const auto get_remaining_us = [&deadline]()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count() ;
+        } ;
+
+        // The data collected by write coalescing is part of the write buffer.
+        this->RethrowCoalescingError() ;
+
+        if (msTimeout == 0)
+        {
+            this->FlushCoalescedData() ;
+        }
+        else if (not this->FlushCoalescedData(deadline))
+        {
+            return false ;
+        }
+
+        // tcdrain() neither times out nor can be interrupted by Cancel().
+        // Sleep while the output queue empties and only call it for the
+        // final character.
+        int number_of_bytes_queued = 0 ;
+
+        while ((number_of_bytes_queued = this->GetNumberOfBytesQueuedForOutput()) > 0)
+        {
+            // Wait for the estimated drain time, but at most one second.
+            auto wait_time = std::min(int64_t {number_of_bytes_queued} * mByteArrivalTimeDelta,
+                                      int64_t {MICROSECONDS_PER_SEC}) ;
+
+            if (msTimeout > 0)
+            {
+                const auto remaining_us = get_remaining_us() ;
+
+                if (remaining_us <= 0)
+                {
+                    return false ;
+                }
+
+                wait_time = std::min(wait_time, remaining_us) ;
+            }
+
+            this->WaitForDevice(mOutputSettingsLock,
+                                static_cast<int>(wait_time)) ;
+        }
+
+        this->ThrowIfCancelled() ;
+
+        // There is nothing to drain while the device is absent.
+        if (mDisconnected)
+        {
+            return true ;
+        }
+
+#ifdef TIOCSERGETLSR
+        if (msTimeout > 0)
+        {
+            // TIOCOUTQ does not count the bytes in the FIFO of a UART, which
+            // stay there while flow control stalls the output. Where the
+            // driver reports the line status, wait for the transmitter to
+            // become empty within the deadline instead of calling tcdrain().
+            while (true)
+            {
+                unsigned int line_status = 0 ;
+
+                // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+                if (call_with_retry(ioctl,
+                                    this->mFileDescriptor,
+                                    TIOCSERGETLSR,
+                                    &line_status) < 0)
+                {
+                    break ;
+                }
+
+                if ((line_status & TIOCSER_TEMT) != 0)
+                {
+                    return true ;
+                }
+
+                const auto remaining_us = get_remaining_us() ;
+
+                if (remaining_us <= 0)
+                {
+                    return false ;
+                }
+
+                this->WaitForDevice(mOutputSettingsLock,
+                                    static_cast<int>(std::min(int64_t {mByteArrivalTimeDelta}, remaining_us))) ;
+            }
+        }
+#endif
+
+        // Do not start an unbounded tcdrain() after the deadline.
+        if ((msTimeout > 0) and
+            (get_remaining_us() <= 0))
+        {
+            return false ;
+        }
+
+        if (tcdrain(this->mFileDescriptor) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        return true ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::FlushInputBuffer()
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // There is nothing to drain or flush while the device is absent.
+        if (mDisconnected)
+        {
+            return ;
+        }
+
+        if (tcflush(this->mFileDescriptor, TCIFLUSH) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::FlushOutputBuffer()
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // There is nothing to drain or flush while the device is absent.
+        if (mDisconnected)
+        {
+            return ;
+        }
+
+        if (tcflush(this->mFileDescriptor, TCOFLUSH) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::FlushIOBuffers()
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // There is nothing to drain or flush while the device is absent.
+        if (mDisconnected)
+        {
+            return ;
+        }
+
+        if (tcflush(this->mFileDescriptor, TCIOFLUSH) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::IsOpen() const
+    {
+        return (this->mFileDescriptor != -1) ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::IsDataAvailable()
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        int number_of_bytes_available = 0 ;
+        bool is_data_available = false ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const auto ioctl_result = call_with_retry(ioctl,
+                                                  this->mFileDescriptor,
+                                                  FIONREAD,
+                                                  &number_of_bytes_available) ;
+
+        if ((ioctl_result >= 0) and
+            (number_of_bytes_available > 0))
+        {
+            is_data_available = true ;
+        }
+
+        return is_data_available ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetDefaultSerialPortParameters()
+    {
+        // Make sure that the serial port is open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        #ifdef __linux__
+            SetDefaultLinuxSpecificModes() ;
+        #endif
+
+        SetDefaultInputModes() ;
+        SetDefaultOutputModes() ;
+        SetDefaultControlModes() ;
+        SetDefaultLocalModes() ;
+
+        SetBaudRate(BaudRate::BAUD_DEFAULT) ;
+        SetCharacterSize(CharacterSize::CHAR_SIZE_DEFAULT) ;
+        SetFlowControl(FlowControl::FLOW_CONTROL_DEFAULT) ;
+        SetParity(Parity::PARITY_DEFAULT) ;
+        SetStopBits(StopBits::STOP_BITS_DEFAULT) ;
+        SetVMin(VMIN_DEFAULT) ;
+        SetVTime(VTIME_DEFAULT) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetBaudRate(const BaudRate& baudRate)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Get the current serial port settings.
+        auto port_settings = this->GetPortSettings() ;
+
+        // Set the baud rate for both input and output.
+        if (0 != cfsetspeed(&port_settings, static_cast<speed_t>(baudRate)))
+        {
+            // If applying the baud rate settings fail, throw an exception.
+            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
+        }
+
+        // Apply the modified settings.
+        this->SetPortSettings(port_settings) ;
+
+        // Set the time interval value (us) required for one byte of data to arrive.
+        mByteArrivalTimeDelta = (BITS_PER_BYTE * MICROSECONDS_PER_SEC) / GetBitRate(baudRate) ;
+    }
+
+    inline
+    BaudRate
+    SerialPort::Implementation::GetBaudRate() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Get the current serial port settings.
+        const auto port_settings = this->GetPortSettings() ;
+
+        // Read the input and output baud rates.
+        const auto input_baud = cfgetispeed(&port_settings) ;
+        const auto output_baud = cfgetospeed(&port_settings) ;
+
+        // Make sure that the input and output baud rates are
+        // equal. Otherwise, we do not know which one to return.
+        if (input_baud != output_baud)
+        {
+            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
+            // return BaudRate::BAUD_INVALID ;
+        }
+
+        // Obtain the input baud rate from the current settings.
+        return BaudRate(input_baud) ;
+    }
+
+    inline
+    int
+    SerialPort::Implementation::GetBitRate(const BaudRate& baudRate) const
+    {
+        const auto bit_rate = LibSerial::GetBitRate(baudRate) ;
+
+        // If an incorrect baud rate was specified, throw an exception.
+        if (bit_rate == 0)
+        {
+            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
+        }
+
+        return bit_rate ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetCharacterSize(const CharacterSize& characterSize)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Get the current serial port settings.
+        auto port_settings = this->GetPortSettings() ;
+
+        // Set the character size to the specified value. If the character
+        // size is not 8 then it is also important to set ISTRIP. Setting
+        // ISTRIP causes all but the 7 low-order bits to be set to
+        // zero. Otherwise they are set to unspecified values and may
+        // cause problems. At the same time, we should clear the ISTRIP
+        // flag when the character size is 8 otherwise the MSB will always
+        // be set to zero (ISTRIP does not check the character size
+        // setting;it just sets every bit above the low 7 bits to zero).
+        if (characterSize == CharacterSize::CHAR_SIZE_8)
+        {
+            // NOLINTNEXTLINE (hicpp-signed-bitwise)
+            port_settings.c_iflag &= ~ISTRIP ;  // Clear the ISTRIP flag.
+        }
+        else
+        {
+            port_settings.c_iflag |= ISTRIP ;   // Set the ISTRIP flag.
+        }
+
+        // Set the character size.
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        port_settings.c_cflag &= ~CSIZE ;                               // Clear all CSIZE bits.
+        port_settings.c_cflag |= static_cast<tcflag_t>(characterSize) ; // Set the character size.
+
+        // Apply the modified settings.
+        this->SetPortSettings(port_settings) ;
+    }
+
+    inline
+    CharacterSize
+    SerialPort::Implementation::GetCharacterSize() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Get the current serial port settings.
+        const auto port_settings = this->GetPortSettings() ;
+
+        // Read the character size from the setttings.
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        return CharacterSize(port_settings.c_cflag & CSIZE) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetFlowControl(const FlowControl& flowControlType)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Flush the input and output buffers associated with the port.
+        if (tcflush(this->mFileDescriptor,
+                    TCIOFLUSH) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Get the current serial port settings.
+        auto port_settings = this->GetPortSettings() ;
+
+        // Set the flow control. Hardware flow control uses the RTS (Ready
+        // To Send) and CTS (clear to Send) lines. Software flow control
+        // uses IXON|IXOFF
+        switch(flowControlType)
+        {
+        case FlowControl::FLOW_CONTROL_HARDWARE:
+            port_settings.c_iflag &= ~ (IXON|IXOFF) ;   // NOLINT (hicpp-signed-bitwise)
+            port_settings.c_cflag |= CRTSCTS ;
+            port_settings.c_cc[VSTART] = _POSIX_VDISABLE ;
+            port_settings.c_cc[VSTOP] = _POSIX_VDISABLE ;
+            break ;
+        case FlowControl::FLOW_CONTROL_SOFTWARE:
+            port_settings.c_iflag |= IXON|IXOFF ;        // NOLINT(hicpp-signed-bitwise)
+            port_settings.c_cflag &= ~CRTSCTS ;
+            port_settings.c_cc[VSTART] = CTRL_Q ;        // 0x11 (021) ^q
+            port_settings.c_cc[VSTOP]  = CTRL_S ;        // 0x13 (023) ^s
+            break ;
+        case FlowControl::FLOW_CONTROL_NONE:
+            port_settings.c_iflag &= ~(IXON|IXOFF) ;    // NOLINT(hicpp-signed-bitwise)
+            port_settings.c_cflag &= ~CRTSCTS ;
+            break ;
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_FLOW_CONTROL) ;
+            // break ; break not needed after a throw
+        }
+
+        // Apply the modified settings.
+        this->SetPortSettings(port_settings) ;
+    }
+
+    inline
+    FlowControl
+    SerialPort::Implementation::GetFlowControl() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Get the current serial port settings.
+        const auto port_settings = this->GetPortSettings() ;
+
+        // Check if IXON and IXOFF are set in c_iflag. If both are set and
+        // VSTART and VSTOP are set to 0x11 (^Q) and 0x13 (^S) respectively,
+        // then we are using software flow control.
+        if ((port_settings.c_iflag & IXON) and // NOLINT (hicpp-signed-bitwise)
+            (port_settings.c_iflag & IXOFF) and // NOLINT (hicpp-signed-bitwise)
+            (CTRL_Q == port_settings.c_cc[VSTART]) and
+            (CTRL_S == port_settings.c_cc[VSTOP]))
+        {
+            return FlowControl::FLOW_CONTROL_SOFTWARE ;
+        }
+
+        if (not ((port_settings.c_iflag & IXON) or // NOLINT (hicpp-signed-bitwise)
+                 (port_settings.c_iflag & IXOFF))) // NOLINT (hicpp-signed-bitwise)
+        {
+            if (0 != (port_settings.c_cflag & CRTSCTS))
+            {
+                // If neither IXON or IXOFF is set then we must have hardware flow
+                // control.
+                return FlowControl::FLOW_CONTROL_HARDWARE ;
+            }
+            return FlowControl::FLOW_CONTROL_NONE ;
+        }
+
+        // If none of the above conditions are satisfied then the serial port
+        // is using a flow control setup which we do not support at present.
+        return FlowControl::FLOW_CONTROL_INVALID ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetParity(const Parity& parityType)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Get the current serial port settings.
+        auto port_settings = this->GetPortSettings() ;
+
+        // Set the parity type
+        switch(parityType)
+        {
+        case Parity::PARITY_EVEN:
+            port_settings.c_cflag |= PARENB ;
+            port_settings.c_cflag &= ~PARODD ;  // NOLINT (hicpp-signed-bitwise)
+            port_settings.c_iflag |= INPCK ;
+            break ;
+        case Parity::PARITY_ODD:
+            port_settings.c_cflag |= PARENB ;
+            port_settings.c_cflag |= PARODD ;
+            port_settings.c_iflag |= INPCK ;
+            break ;
+        case Parity::PARITY_NONE:
+            port_settings.c_cflag &= ~PARENB ;  // NOLINT (hicpp-signed-bitwise)
+            port_settings.c_iflag |= IGNPAR ;
+            break ;
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_PARITY) ;
+            // break ; break not needed after a throw
+        }
+
+        // Apply the modified port settings.
+        this->SetPortSettings(port_settings) ;
     }
 
-    SerialPort& SerialPort::operator=(SerialPort&& otherSerialPort)
+    inline
+    Parity
+    SerialPort::Implementation::GetParity() const
     {
-        mImpl = std::move(otherSerialPort.mImpl);
-        return *this;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    SerialPort::~SerialPort() noexcept = default ;
+        // Get the current serial port settings.
+        const auto port_settings = this->GetPortSettings() ;
 
-    void
-    SerialPort::Open(const std::string& fileName,
-                     const std::ios_base::openmode& openMode)
-    {
-        mImpl->Open(fileName,
-                    openMode) ;
+        // Get the parity setting from the termios structure.
+        if (0 != (port_settings.c_cflag & PARENB)) // NOLINT (hicpp-signed-bitwise)
+        {
+            // parity is enabled.
+            if (port_settings.c_cflag & PARODD) // NOLINT (hicpp-signed-bitwise)
+            {
+                return Parity::PARITY_ODD ; // odd parity
+            }
+            return Parity::PARITY_EVEN ;    // even parity
+        }
+        return Parity::PARITY_NONE ;        // no parity.
     }
 
+    inline
     void
-    SerialPort::Close()
+    SerialPort::Implementation::SetStopBits(const StopBits& stopBits)
     {
-        mImpl->Close() ;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    void
-    SerialPort::DrainWriteBuffer()
-    {
-        mImpl->DrainWriteBuffer() ;
-    }
+        // Get the current serial port settings.
+        auto port_settings = this->GetPortSettings() ;
 
-    void
-    SerialPort::FlushInputBuffer()
-    {
-        mImpl->FlushInputBuffer() ;
-    }
+        // Set the number of stop bits.
+        switch(stopBits)
+        {
+        case StopBits::STOP_BITS_1:
+            port_settings.c_cflag &= ~CSTOPB ;  // NOLINT (hicpp-signed-bitwise)
+            break ;
+        case StopBits::STOP_BITS_2:
+            port_settings.c_cflag |= CSTOPB ;
+            break ;
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_STOP_BITS) ;
+            // break ; break not needed after a throw
+        }
 
-    void
-    SerialPort::FlushOutputBuffer()
-    {
-        mImpl->FlushOutputBuffer() ;
+        // Apply the modified settings.
+        this->SetPortSettings(port_settings) ;
     }
 
-    void
-    SerialPort::FlushIOBuffers()
+    inline
+    StopBits
+    SerialPort::Implementation::GetStopBits() const
     {
-        mImpl->FlushIOBuffers() ;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    bool
-    SerialPort::IsDataAvailable()
-    {
-        return mImpl->IsDataAvailable() ;
-    }
+        // Get the current serial port settings.
+        const auto port_settings = this->GetPortSettings() ;
 
-    bool
-    SerialPort::IsOpen() const
-    {
-        return mImpl->IsOpen() ;
+        // If CSTOPB is set then we are using two stop bits, otherwise we
+        // are using 1 stop bit.
+        if (port_settings.c_cflag & CSTOPB) // NOLINT (hicpp-signed-bitwise)
+        {
+            return StopBits::STOP_BITS_2 ;
+        }
+        return StopBits::STOP_BITS_1 ;
     }
 
+    inline
     void
-    SerialPort::SetDefaultSerialPortParameters()
+    SerialPort::Implementation::SetVMin(const short vmin)
     {
-        mImpl->SetDefaultSerialPortParameters() ;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    void
-    SerialPort::SetBaudRate(const BaudRate& baudRate)
-    {
-        mImpl->SetBaudRate(baudRate) ;
-    }
+        if (vmin < 0 || vmin > 255)
+        {
+            std::stringstream error_message ;
+            error_message << "Invalid vmin value: " << vmin << ". " ;
+            error_message << "Vmin must be in the range [0, 255]." ;
+            throw std::invalid_argument {error_message.str()} ;
+        }
 
-    BaudRate
-    SerialPort::GetBaudRate() const
-    {
-        return mImpl->GetBaudRate() ;
-    }
+        // Get the current serial port settings.
+        auto port_settings = this->GetPortSettings() ;
 
-    void
-    SerialPort::SetCharacterSize(const CharacterSize& characterSize)
-    {
-        mImpl->SetCharacterSize(characterSize) ;
-    }
+        port_settings.c_cc[VMIN] = static_cast<cc_t>(vmin) ;
 
-    CharacterSize
-    SerialPort::GetCharacterSize() const
-    {
-        return mImpl->GetCharacterSize() ;
+        // Apply the modified settings.
+        this->SetPortSettings(port_settings) ;
     }
 
-    void
-    SerialPort::SetFlowControl(const FlowControl& flowControlType)
+    inline
+    short
+    SerialPort::Implementation::GetVMin() const
     {
-        mImpl->SetFlowControl(flowControlType) ;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    FlowControl
-    SerialPort::GetFlowControl() const
-    {
-        return mImpl->GetFlowControl() ;
+        // Get the current serial port settings.
+        const auto port_settings = this->GetPortSettings() ;
+
+        return port_settings.c_cc[VMIN] ;
     }
 
+    inline
     void
-    SerialPort::SetParity(const Parity& parityType)
+    SerialPort::Implementation::SetVTime(const short vtime)
     {
-        mImpl->SetParity(parityType) ;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    Parity
-    SerialPort::GetParity() const
-    {
-        return mImpl->GetParity() ;
-    }
+        if (vtime < 0 || vtime > 255)
+        {
+            std::stringstream error_message ;
+            error_message << "Invalid vtime value: " << vtime << ". " ;
+            error_message << "Vtime must be in the range [0, 255]." ;
+            throw std::invalid_argument {error_message.str()} ;
+        }
 
-    void
-    SerialPort::SetStopBits(const StopBits& stopBits)
-    {
-        mImpl->SetStopBits(stopBits) ;
-    }
+        // Get the current serial port settings.
+        auto port_settings = this->GetPortSettings() ;
 
-    StopBits
-    SerialPort::GetStopBits() const
-    {
-        return mImpl->GetStopBits() ;
-    }
+        port_settings.c_cc[VTIME] = static_cast<cc_t>(vtime) ;
 
-    void
-    SerialPort::SetVMin(const short vmin)
-    {
-        mImpl->SetVMin(vmin) ;
+        // Apply the modified settings.
+        this->SetPortSettings(port_settings) ;
     }
 
+    inline
     short
-    SerialPort::GetVMin() const
+    SerialPort::Implementation::GetVTime() const
     {
-        return mImpl->GetVMin() ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Get the current serial port settings.
+        const auto port_settings = this->GetPortSettings() ;
+
+        return port_settings.c_cc[VTIME] ;
     }
 
+    inline
     void
-    SerialPort::SetVTime(const short vtime)
+    SerialPort::Implementation::SetDTR(const bool dtrState)
     {
-        mImpl->SetVTime(vtime) ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        this->SetModemControlLine(TIOCM_DTR,
+                                   dtrState) ;
     }
 
-    short
-    SerialPort::GetVTime() const
+    inline
+    bool
+    SerialPort::Implementation::GetDTR()
     {
-        return mImpl->GetVTime() ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        return this->GetModemControlLine(TIOCM_DTR) ;
     }
 
+    inline
     void
-    SerialPort::SetDTR(const bool dtrState)
+    SerialPort::Implementation::SetRTS(const bool rtsState)
     {
-        mImpl->SetDTR(dtrState) ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        this->SetModemControlLine(TIOCM_RTS,
+                                  rtsState) ;
     }
 
+    inline
     bool
-    SerialPort::GetDTR() const
+    SerialPort::Implementation::GetRTS()
     {
-        return mImpl->GetDTR() ;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    void
-    SerialPort::SetRTS(const bool rtsState)
-    {
-        mImpl->SetRTS(rtsState) ;
+        return this->GetModemControlLine(TIOCM_RTS) ;
     }
 
+    inline
     bool
-    SerialPort::GetRTS() const
+    SerialPort::Implementation::GetCTS()
     {
-        return mImpl->GetRTS() ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        return this->GetModemControlLine(TIOCM_CTS) ;
     }
 
+    inline
     bool
-    SerialPort::GetCTS()
+    SerialPort::Implementation::GetDSR()
     {
-        return mImpl->GetCTS() ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        return this->GetModemControlLine(TIOCM_DSR) ;
     }
 
-    bool
-    SerialPort::GetDSR()
+    inline
+    int
+    SerialPort::Implementation::GetFileDescriptor() const
     {
-        return mImpl->GetDSR() ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        return this->mFileDescriptor ;
     }
 
+    inline
     int
-    SerialPort::GetFileDescriptor() const
+    SerialPort::Implementation::GetNumberOfBytesAvailable()
     {
-        return mImpl->GetFileDescriptor() ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        int number_of_bytes_available = 0 ;
+
+        // No data can arrive while the device is absent.
+        if (mDisconnected)
+        {
+            return number_of_bytes_available ;
+        }
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            FIONREAD,
+                            &number_of_bytes_available) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        return number_of_bytes_available ;
     }
 
+    inline
     int
-    SerialPort::GetNumberOfBytesAvailable()
+    SerialPort::Implementation::GetNumberOfBytesQueuedForOutput()
     {
-        return mImpl->GetNumberOfBytesAvailable() ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        int number_of_bytes_queued = 0 ;
+
+        // Data written while the device is absent is discarded.
+        if (mDisconnected)
+        {
+            return number_of_bytes_queued ;
+        }
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCOUTQ,
+                            &number_of_bytes_queued) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        return number_of_bytes_queued ;
     }
 
 #ifdef __linux__
+    inline
     std::vector<std::string>
-    SerialPort::GetAvailableSerialPorts() const
+    SerialPort::Implementation::GetAvailableSerialPorts() const
     {
-        return mImpl->GetAvailableSerialPorts() ;
-    }
-#endif
+        // Serial ports are listed from sysfs rather than by attempting to
+        // open every /dev/ttyS*, /dev/ttyACM* and /dev/ttyUSB* candidate.
+        const SerialPortEnumerator serial_port_enumerator {mSysfsRoot} ;
 
-    void
-    SerialPort::Read(DataBuffer& dataBuffer,
-                     const size_t numberOfBytes,
-                     const size_t msTimeout)
-    {
-        mImpl->Read(dataBuffer,
-                    numberOfBytes,
-                    msTimeout) ;
-    }
+        std::vector<std::string> serial_port_names {} ;
+        for (const auto& serial_port_info : serial_port_enumerator.GetSerialPorts())
+        {
+            serial_port_names.push_back(serial_port_info.devicePath) ;
+        }
 
-    void
-    SerialPort::Read(std::string& dataString,
-                     const size_t numberOfBytes,
-                     const size_t msTimeout)
-    {
-        mImpl->Read(dataString,
-                    numberOfBytes,
-                    msTimeout) ;
+        return serial_port_names ;
     }
 
-    void
-    SerialPort::ReadByte(char&        charBuffer,
-                         const size_t msTimeout)
+    inline
+    LowLatencyStatus
+    SerialPort::Implementation::SetLowLatency(const bool lowLatency)
     {
-        mImpl->ReadByte(charBuffer,
-                        msTimeout) ;
-    }
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-    void
-    SerialPort::ReadByte(unsigned char& charBuffer,
-                         const size_t   msTimeout)
-    {
-        mImpl->ReadByte(charBuffer,
-                        msTimeout) ;
-    }
+        mLowLatencyRequested = lowLatency ;
 
-    void
-    SerialPort::ReadLine(std::string& dataString,
-                         const char   lineTerminator,
-                         const size_t msTimeout)
-    {
-        mImpl->ReadLine(dataString,
-                        lineTerminator,
-                        msTimeout) ;
-    }
+        // Get the current serial driver settings. Devices that are not
+        // handled by the serial core, (e.g. pseudo terminals), do not support
+        // TIOCGSERIAL and this mechanism is skipped for them.
+        serial_struct serial_port_info {} ;
 
-    void
-    SerialPort::Write(const DataBuffer& dataBuffer)
-    {
-        mImpl->Write(dataBuffer) ;
-    }
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const bool has_serial_info = (call_with_retry(ioctl,
+                                                      this->mFileDescriptor,
+                                                      TIOCGSERIAL,
+                                                      &serial_port_info) != -1) ;
 
-    void
-    SerialPort::Write(const std::string& dataString)
-    {
-        mImpl->Write(dataString) ;
-    }
+        // Get the current latency_timer if the driver provides one.
+        const auto latency_timer_path = this->GetLatencyTimerPath() ;
+        int latency_timer_ms = -1 ;
 
-    void
-    SerialPort::WriteByte(const char charBuffer)
-    {
-        mImpl->WriteByte(charBuffer) ;
-    }
+        if (not ReadSysfsAttribute(latency_timer_path, latency_timer_ms))
+        {
+            latency_timer_ms = -1 ;
+        }
 
-    void
-    SerialPort::WriteByte(const unsigned char charBuffer)
-    {
-        mImpl->WriteByte(charBuffer) ;
-    }
+        // Save the original settings the first time we are called so that
+        // they can be restored when the serial port is closed.
+        if (not mLowLatencySaved)
+        {
+            mOldAsyncLowLatency = -1 ;
+            if (has_serial_info)
+            {
+                // NOLINTNEXTLINE (hicpp-signed-bitwise)
+                mOldAsyncLowLatency = ((serial_port_info.flags & ASYNC_LOW_LATENCY) != 0) ? 1 : 0 ;
+            }
+            mOldLatencyTimerMs = latency_timer_ms ;
+            mLowLatencySaved = true ;
+        }
 
-    void
-    SerialPort::SetSerialPortBlockingStatus(const bool blockingStatus)
-    {
-        mImpl->SetSerialPortBlockingStatus(blockingStatus) ;
-    }
+        LowLatencyStatus status {} ;
 
-    bool
-    SerialPort::GetSerialPortBlockingStatus() const
-    {
-        return mImpl->GetSerialPortBlockingStatus() ;
-    }
+        if (has_serial_info)
+        {
+            if (lowLatency)
+            {
+                serial_port_info.flags |= ASYNC_LOW_LATENCY ;
+            }
+            else
+            {
+                serial_port_info.flags &= ~ASYNC_LOW_LATENCY ; // NOLINT (hicpp-signed-bitwise)
+            }
 
-    void
-    SerialPort::SetModemControlLine(const int modemLine,
-                                    const bool lineState)
-    {
-        mImpl->SetModemControlLine(modemLine, lineState) ;
-    }
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            status.asyncLowLatency = (call_with_retry(ioctl,
+                                                      this->mFileDescriptor,
+                                                      TIOCSSERIAL,
+                                                      &serial_port_info) != -1) ;
+        }
 
-    bool
-    SerialPort::GetModemControlLine(const int modemLine)
-    {
-        return mImpl->GetModemControlLine(modemLine) ;
-    }
+        if (latency_timer_ms >= 0)
+        {
+            // When leaving low latency mode, go back to the original value
+            // unless the timer was already at its minimum when we started.
+            int new_latency_timer_ms = LATENCY_TIMER_LOW_LATENCY_MS ;
+            if (not lowLatency)
+            {
+                new_latency_timer_ms = (mOldLatencyTimerMs > LATENCY_TIMER_LOW_LATENCY_MS) ?
+                                       mOldLatencyTimerMs : LATENCY_TIMER_DEFAULT_MS ;
+            }
 
-    /** -------------------------- Implementation -------------------------- */
+            status.latencyTimer = WriteSysfsAttribute(latency_timer_path,
+                                                      new_latency_timer_ms) ;
+            status.latencyTimerMs = status.latencyTimer ? new_latency_timer_ms : latency_timer_ms ;
+        }
 
-    inline
-    SerialPort::Implementation::Implementation(const std::string&   fileName,
-                                               const BaudRate&      baudRate,
-                                               const CharacterSize& characterSize,
-                                               const FlowControl&   flowControlType,
-                                               const Parity&        parityType,
-                                               const StopBits&      stopBits)
-    {
-        this->Open(fileName, std::ios_base::in | std::ios_base::out) ;
-        this->SetBaudRate(baudRate) ;
-        this->SetCharacterSize(characterSize) ;
-        this->SetFlowControl(flowControlType) ;
-        this->SetParity(parityType) ;
-        this->SetStopBits(stopBits) ;
+        return status ;
     }
 
     inline
-    SerialPort::Implementation::~Implementation()
-    try
+    void
+    SerialPort::Implementation::SetSysfsRoot(const std::string& sysfsRoot)
     {
-        // Close the serial port if it is open.
-        if (this->IsOpen())
-        {
-            this->Close() ;
-        }
+        mSysfsRoot = sysfsRoot ;
     }
-    catch(...)
+
+    inline
+    std::string
+    SerialPort::Implementation::GetLatencyTimerPath() const
     {
-        //
-        // :IMPORTANT: We do not let any exceptions escape the destructor.
-        // (see https://isocpp.org/wiki/faq/exceptions#dtors-shouldnt-throw)
-        //
-        // :TODO: Once we add logging to LibSerial, we should issue a warning
-        // if we reach here.
-        //
+        return mSysfsRoot + "/class/tty/" + this->GetDeviceName() + "/device/latency_timer" ;
     }
 
     inline
     void
-    SerialPort::Implementation::Open(const std::string& fileName,
-                                     const std::ios_base::openmode& openMode)
+    SerialPort::Implementation::RestoreLowLatencySettings() noexcept
     {
-        // Throw an exception if the port is already open.
-        if (this->IsOpen())
+        if (not mLowLatencySaved)
         {
-            throw AlreadyOpen(ERR_MSG_PORT_ALREADY_OPEN) ;
+            return ;
         }
 
-        // We only allow three different combinations of ios_base::openmode so
-        // we can use a switch here to construct the flags to be used with the
-        // open() system call.  Since we are dealing with the serial port we
-        // need to use the O_NOCTTY option.
-        int flags = (O_NOCTTY | O_NONBLOCK) ;   // NOLINT (hicpp-signed-bitwise)
+        mLowLatencySaved = false ;
 
-        if (openMode == (std::ios_base::in | std::ios_base::out))
-        {
-            flags |= O_RDWR ;
-        }
-        else if (openMode == std::ios_base::in)
+        serial_struct serial_port_info {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if ((mOldAsyncLowLatency >= 0) and
+            (call_with_retry(ioctl,
+                             this->mFileDescriptor,
+                             TIOCGSERIAL,
+                             &serial_port_info) != -1))
         {
-            flags |= O_RDONLY ;
+            if (mOldAsyncLowLatency == 1)
+            {
+                serial_port_info.flags |= ASYNC_LOW_LATENCY ;
+            }
+            else
+            {
+                serial_port_info.flags &= ~ASYNC_LOW_LATENCY ; // NOLINT (hicpp-signed-bitwise)
+            }
+
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCSSERIAL,
+                            &serial_port_info) ;
         }
-        else if (openMode == std::ios_base::out)
+
+        if (mOldLatencyTimerMs >= 0)
         {
-            flags |= O_WRONLY ;
+            WriteSysfsAttribute(this->GetLatencyTimerPath(),
+                                mOldLatencyTimerMs) ;
         }
-        else
+    }
+#endif
+
+    inline
+    void
+    SerialPort::Implementation::SetAutoReconnect(const bool   autoReconnect,
+                                                 const size_t msInitialBackoff,
+                                                 const size_t msMaximumBackoff)
+    {
+        if (msInitialBackoff > msMaximumBackoff)
         {
-            throw OpenFailed {"Invalid or unsupported open mode"} ;
+            throw std::invalid_argument {"The initial backoff must not exceed the maximum backoff."} ;
         }
 
-        // Try to open the serial port.
-        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
-        mFileDescriptor = call_with_retry(open, fileName.c_str(), flags) ;
+        mAutoReconnect = autoReconnect ;
+        mInitialBackoff = std::chrono::milliseconds(msInitialBackoff) ;
+        mMaximumBackoff = std::chrono::milliseconds(msMaximumBackoff) ;
 
-        if (this->mFileDescriptor < 0)
+        if (mAutoReconnect and
+            this->IsOpen() and
+            (not mDisconnected))
         {
-            throw OpenFailed(std::strerror(errno)) ;
+            mReconnectPath = this->GetReconnectPath() ;
         }
+    }
 
-        // Set the serial port to exclusive access to this process.
-        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
-        if (call_with_retry(ioctl,
-                            this->mFileDescriptor,
-                            TIOCEXCL) == -1)
+    inline
+    bool
+    SerialPort::Implementation::GetAutoReconnect() const
+    {
+        return mAutoReconnect ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::IsConnected() const
+    {
+        return this->IsOpen() and (not mDisconnected) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetConnectionEventCallback(const ConnectionEventCallback& connectionEventCallback)
+    {
+        mConnectionEventCallback = connectionEventCallback ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetWritePacing(const size_t bytesPerSecond,
+                                               const size_t maximumBurst,
+                                               const size_t usInterFrameGap)
+    {
+        if (maximumBurst == 0)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw std::invalid_argument {"The maximum burst must be at least one byte."} ;
         }
 
-        // Save the current settings of the serial port so they can be
-        // restored when the serial port is closed.
-        if (tcgetattr(this->mFileDescriptor,
-                      &mOldPortSettings) < 0)
+        const auto write_pacing = (bytesPerSecond > 0) or (usInterFrameGap > 0) ;
+
+        if (write_pacing and
+            (mPacingTimerFileDescriptor < 0))
         {
-            throw OpenFailed(std::strerror(errno)) ;
+            mPacingTimerFileDescriptor = timerfd_create(CLOCK_MONOTONIC,
+                                                        TFD_CLOEXEC | TFD_NONBLOCK) ;   // NOLINT (hicpp-signed-bitwise)
+
+            if (mPacingTimerFileDescriptor < 0)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
         }
 
-        // Set up the default configuration for the serial port.
-        this->SetDefaultSerialPortParameters() ;
+        mWritePacing = write_pacing ;
+        mPacingBytesPerSecond = bytesPerSecond ;
+        mPacingMaximumBurst = maximumBurst ;
+        mPacingInterFrameGap = std::chrono::microseconds(usInterFrameGap) ;
 
-        // Flush the input and output buffers associated with the port.
-        this->FlushIOBuffers() ;
+        // Start with a full bucket and an idle line.
+        mPacingTokens = static_cast<double>(maximumBurst) ;
+        mPacingRefillTime = std::chrono::steady_clock::now() ;
+        mLineIdleTime = {} ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::GetWritePacing() const
+    {
+        return mWritePacing ;
     }
 
     inline
     void
-    SerialPort::Implementation::Close()
+    SerialPort::Implementation::SetWriteCoalescing(const size_t bufferSize,
+                                                   const size_t usFlushDelay)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if ((usFlushDelay > 0) and
+            (not mThreadSafe))
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            throw std::logic_error {"Write coalescing with a flush delay requires thread-safe mode."} ;
         }
 
-        // Restore the old settings of the port.
-        //
-        // :IMPORTANT: If there is an error while attempting to restore the old
-        // settings, do not throw an exception here and attempt to close the
-        // serial port anyways. See issue #135 for the reason for this. The
-        // serial port device may have been removed when this method is called.
-        // In such a case we will not be able to restore the old settings. But
-        // we should still close the serial port file descriptor. Otherwise,
-        // the user has no way to cleanly recover from this state.
-        //
-        std::string err_msg {} ;
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &mOldPortSettings) < 0)
+        // Write the data collected with the previous settings.
+        if (this->IsOpen())
         {
-            err_msg = std::strerror(errno) ;
+            this->FlushCoalescedData() ;
         }
 
-        // Otherwise, close the serial port and set the file descriptor
-        // to an invalid value.
-        bool is_failed = false ;
-        if (call_with_retry(close, this->mFileDescriptor) < 0)
         {
-            is_failed = true ;
-            err_msg += ", " ;
-            err_msg += std::strerror(errno) ;
+            // Getters read the settings under the shared lock, so they are
+            // changed under the exclusive one. The output direction stays
+            // locked, so that no data is collected meanwhile.
+            if (mOutputSettingsLock.owns_lock())
+            {
+                mOutputSettingsLock.unlock() ;
+            }
+
+            const auto settings_lock = this->LockSettings() ;
+
+            mCoalescingBufferSize = bufferSize ;
+            mCoalescingFlushDelay = std::chrono::microseconds(usFlushDelay) ;
+            mCoalescingBuffer.reserve(bufferSize) ;
         }
 
-        // Set the file descriptor to an invalid value, -1.
-        mFileDescriptor = -1 ;
+        {
+            const std::lock_guard<std::mutex> coalescing_lock {mCoalescingMutex} ;
+            mCoalescingFlushTime = std::chrono::steady_clock::time_point::max() ;
+        }
 
-        //
-        // Throw an exception if close() failed
-        //
-        if (is_failed)
+        if ((usFlushDelay > 0) and
+            (not mCoalescingThread.joinable()))
         {
-            throw std::runtime_error(err_msg) ;
+            mCoalescingThread = std::thread {&Implementation::RunCoalescingThread, this} ;
         }
     }
 
+    inline
+    bool
+    SerialPort::Implementation::GetWriteCoalescing() const
+    {
+        return mCoalescingBufferSize > 0 ;
+    }
+
     inline
     void
-    SerialPort::Implementation::DrainWriteBuffer()
+    SerialPort::Implementation::Flush()
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -964,703 +3718,834 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        if (tcdrain(this->mFileDescriptor) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        this->RethrowCoalescingError() ;
+        this->FlushCoalescedData() ;
     }
 
     inline
     void
-    SerialPort::Implementation::FlushInputBuffer()
+    SerialPort::Implementation::SetCapture(const std::shared_ptr<SerialCaptureWriter>& serialCaptureWriter,
+                                           const uint32_t                              portId)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        mCapture = serialCaptureWriter ;
+        mCapturePortId = portId ;
+
+        const auto connection_lock = this->LockConnection() ;
+        mCaptureError = nullptr ;
+        mCaptureFailed = false ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::RecordCapture(const CaptureDirection direction,
+                                              const void* const      data,
+                                              const size_t           numberOfBytes)
+    {
+        if ((not mCapture) or
+            mCaptureFailed)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return ;
         }
 
-        if (tcflush(this->mFileDescriptor, TCIFLUSH) < 0)
+        try
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            mCapture->Record(mCapturePortId,
+                             direction,
+                             data,
+                             numberOfBytes) ;
+        }
+        catch (...)
+        {
+            // E.g. a new segment could not be allocated. The data has
+            // already been read or written, so it must not be lost.
+            const auto connection_lock = this->LockConnection() ;
+
+            if (not mCaptureFailed)
+            {
+                mCaptureError = std::current_exception() ;
+                mCaptureFailed = true ;
+            }
         }
     }
 
     inline
     void
-    SerialPort::Implementation::FlushOutputBuffer()
+    SerialPort::Implementation::RethrowCaptureError()
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (not mCaptureFailed)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return ;
         }
 
-        if (tcflush(this->mFileDescriptor, TCOFLUSH) < 0)
+        std::exception_ptr capture_error {} ;
+
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            const auto connection_lock = this->LockConnection() ;
+            std::swap(capture_error, mCaptureError) ;
+        }
+
+        if (capture_error)
+        {
+            std::rethrow_exception(capture_error) ;
         }
     }
 
     inline
     void
-    SerialPort::Implementation::FlushIOBuffers()
+    SerialPort::Implementation::SetFlightRecorder(const size_t bufferSize)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (bufferSize == 0)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            mFlightRecorder.reset() ;
+            return ;
         }
 
-        if (tcflush(this->mFileDescriptor, TCIOFLUSH) < 0)
+        mFlightRecorder.reset(new SerialFlightRecorder(bufferSize)) ;
+    }
+
+    inline
+    std::vector<CaptureRecord>
+    SerialPort::Implementation::DumpFlightRecorder() const
+    {
+        if (not mFlightRecorder)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            return {} ;
         }
+
+        return mFlightRecorder->Dump() ;
     }
 
     inline
-    bool
-    SerialPort::Implementation::IsOpen() const
+    void
+    SerialPort::Implementation::SetFlightRecorderCallback(const FlightRecorderCallback& flightRecorderCallback)
     {
-        return (this->mFileDescriptor != -1) ;
+        mFlightRecorderCallback = flightRecorderCallback ;
     }
 
     inline
-    bool
-    SerialPort::Implementation::IsDataAvailable()
+    void
+    SerialPort::Implementation::NotifyFlightRecorder(const FlightRecorderTrigger flightRecorderTrigger)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (mFlightRecorder and
+            mFlightRecorderCallback)
+        {
+            // The records are dumped now, so that the callback gets the data
+            // that led to the event.
+            this->QueueEvent([flightRecorderCallback = mFlightRecorderCallback,
+                              flightRecorderTrigger,
+                              records = mFlightRecorder->Dump()]()
+                             {
+                                 flightRecorderCallback(flightRecorderTrigger,
+                                                        records) ;
+                             }) ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetInputTee(const int fileDescriptor)
+    {
+        this->CloseInputTeePipes() ;
+        mInputTeeFileDescriptor = -1 ;
+        mInputTeeErrno = 0 ;
+
+        if (fileDescriptor < 0)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return ;
         }
 
-        int number_of_bytes_available = 0 ;
-        bool is_data_available = false ;
+        struct stat file_status {} ;
 
         // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
-        const auto ioctl_result = call_with_retry(ioctl,
-                                                  this->mFileDescriptor,
-                                                  FIONREAD,
-                                                  &number_of_bytes_available) ;
+        const auto file_flags = call_with_retry(fcntl, fileDescriptor, F_GETFL) ;
 
-        if ((ioctl_result >= 0) and
-            (number_of_bytes_available > 0))
+        if ((fstat(fileDescriptor, &file_status) < 0) or
+            (file_flags < 0))
         {
-            is_data_available = true ;
+            throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        return is_data_available ;
-    }
+        mInputTeeFileDescriptor = fileDescriptor ;
+        mInputTeeIsPipe = S_ISFIFO(file_status.st_mode) ;    // NOLINT (hicpp-signed-bitwise)
 
-    inline
-    void
-    SerialPort::Implementation::SetDefaultSerialPortParameters()
-    {
-        // Make sure that the serial port is open.
-        if (not this->IsOpen())
+        // splice() cannot write to a file opened with O_APPEND.
+        if ((not mInputTeeIsPipe) and
+            ((file_flags & O_APPEND) != 0))    // NOLINT (hicpp-signed-bitwise)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            mInputTeeSplice = false ;
+            return ;
         }
 
-        #ifdef __linux__
-            SetDefaultLinuxSpecificModes() ;
-        #endif
+        if ((pipe2(mInputTeePipe.data(), O_CLOEXEC | O_NONBLOCK) < 0) or    // NOLINT (hicpp-signed-bitwise)
+            ((not mInputTeeIsPipe) and
+             (pipe2(mInputTeeFilePipe.data(), O_CLOEXEC | O_NONBLOCK) < 0)))    // NOLINT (hicpp-signed-bitwise)
+        {
+            const auto pipe_errno = errno ;
+            this->CloseInputTeePipes() ;
+            mInputTeeFileDescriptor = -1 ;
+            throw std::runtime_error(std::strerror(pipe_errno)) ;
+        }
 
-        SetDefaultInputModes() ;
-        SetDefaultOutputModes() ;
-        SetDefaultControlModes() ;
-        SetDefaultLocalModes() ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        mInputTeePipeSize = static_cast<size_t>(fcntl(mInputTeePipe[0], F_GETPIPE_SZ)) ;
+        mInputTeeSplice = true ;
+    }
 
-        SetBaudRate(BaudRate::BAUD_DEFAULT) ;
-        SetCharacterSize(CharacterSize::CHAR_SIZE_DEFAULT) ;
-        SetFlowControl(FlowControl::FLOW_CONTROL_DEFAULT) ;
-        SetParity(Parity::PARITY_DEFAULT) ;
-        SetStopBits(StopBits::STOP_BITS_DEFAULT) ;
-        SetVMin(VMIN_DEFAULT) ;
-        SetVTime(VTIME_DEFAULT) ;
+    inline
+    int
+    SerialPort::Implementation::GetInputTee() const
+    {
+        return mInputTeeFileDescriptor ;
     }
 
     inline
-    void
-    SerialPort::Implementation::SetBaudRate(const BaudRate& baudRate)
+    ssize_t
+    SerialPort::Implementation::ReadWithInputTee(void* const  buffer,
+                                                 const size_t numberOfBytes)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
-        {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
-        }
+        if (mInputTeeSplice)
+        {
+            // The data only fits into the pipe up to its capacity.
+            const auto splice_result = call_with_retry(splice,
+                                                       this->mFileDescriptor,
+                                                       nullptr,
+                                                       mInputTeePipe[1],
+                                                       nullptr,
+                                                       std::min(numberOfBytes, mInputTeePipeSize),
+                                                       SPLICE_F_NONBLOCK) ;
+
+            if (splice_result > 0)
+            {
+                return this->ReadSplicedInput(buffer,
+                                              static_cast<size_t>(splice_result)) ;
+            }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+            if ((splice_result == 0) or
+                (errno != EINVAL))
+            {
+                return splice_result ;
+            }
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
+            // Not every tty driver supports splice(), copy the data instead.
+            this->CloseInputTeePipes() ;
         }
 
-        // Set the baud rate for both input and output.
-        if (0 != cfsetspeed(&port_settings, static_cast<speed_t>(baudRate)))
-        {
-            // If applying the baud rate settings fail, throw an exception.
-            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
-        }
+        const auto read_result = call_with_retry(read,
+                                                 this->mFileDescriptor,
+                                                 buffer,
+                                                 numberOfBytes) ;
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        if (read_result > 0)
         {
-            // If applying the settings fails, throw an exception.
-            throw std::runtime_error(std::strerror(errno)) ;
+            this->WriteToInputTee(buffer,
+                                  static_cast<size_t>(read_result)) ;
         }
 
-        // Set the time interval value (us) required for one byte of data to arrive.
-        mByteArrivalTimeDelta = (BITS_PER_BYTE * MICROSECONDS_PER_SEC) / GetBitRate(baudRate) ;
+        return read_result ;
     }
 
     inline
-    BaudRate
-    SerialPort::Implementation::GetBaudRate() const
+    ssize_t
+    SerialPort::Implementation::ReadSplicedInput(void* const  buffer,
+                                                 const size_t numberOfBytes)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        // tee() duplicates the pipe buffers without consuming them, so the
+        // same data can be read below.
+        size_t number_of_bytes_teed = 0 ;
+
+        if (mInputTeeErrno == 0)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            const auto tee_result = call_with_retry(tee,
+                                                    mInputTeePipe[0],
+                                                    mInputTeeIsPipe ? mInputTeeFileDescriptor : mInputTeeFilePipe[1],
+                                                    numberOfBytes,
+                                                    SPLICE_F_NONBLOCK) ;
+
+            if (tee_result > 0)
+            {
+                number_of_bytes_teed = static_cast<size_t>(tee_result) ;
+
+                if (not mInputTeeIsPipe)
+                {
+                    number_of_bytes_teed = this->SpliceToInputTee(number_of_bytes_teed) ;
+                }
+            }
+            else if ((tee_result < 0) and
+                     (errno == EINVAL))
+            {
+                mInputTeeSplice = false ;
+            }
+            else if ((tee_result < 0) and
+                     (errno != EAGAIN))
+            {
+                mInputTeeErrno = errno ;
+            }
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        const auto read_result = call_with_retry(read,
+                                                 mInputTeePipe[0],
+                                                 buffer,
+                                                 numberOfBytes) ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        // A full pipe or a target without splice() support receives the
+        // rest of the data by write().
+        if ((read_result > 0) and
+            (number_of_bytes_teed < static_cast<size_t>(read_result)))
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            this->WriteToInputTee(static_cast<const uint8_t*>(buffer) + number_of_bytes_teed,
+                                  static_cast<size_t>(read_result) - number_of_bytes_teed) ;
         }
 
-        // Read the input and output baud rates.
-        const auto input_baud = cfgetispeed(&port_settings) ;
-        const auto output_baud = cfgetospeed(&port_settings) ;
-
-        // Make sure that the input and output baud rates are
-        // equal. Otherwise, we do not know which one to return.
-        if (input_baud != output_baud)
+        if (not mInputTeeSplice)
         {
-            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
-            // return BaudRate::BAUD_INVALID ;
+            this->CloseInputTeePipes() ;
         }
 
-        // Obtain the input baud rate from the current settings.
-        return BaudRate(input_baud) ;
+        return read_result ;
     }
 
     inline
-    int
-    SerialPort::Implementation::GetBitRate(const BaudRate& baudRate) const
+    size_t
+    SerialPort::Implementation::SpliceToInputTee(const size_t numberOfBytes)
     {
-        int baud_rate_as_int = 1 ;
+        size_t number_of_bytes_moved = 0 ;
 
-        switch (baudRate)
+        while (number_of_bytes_moved < numberOfBytes)
         {
-        case BaudRate::BAUD_50:
-            baud_rate_as_int = 50 ;
-            break ;
-
-        case BaudRate::BAUD_75:
-            baud_rate_as_int = 75 ;
-            break ;
+            const auto splice_result = call_with_retry(splice,
+                                                       mInputTeeFilePipe[0],
+                                                       nullptr,
+                                                       mInputTeeFileDescriptor,
+                                                       nullptr,
+                                                       numberOfBytes - number_of_bytes_moved,
+                                                       SPLICE_F_MOVE) ;
 
-        case BaudRate::BAUD_110:
-            baud_rate_as_int = 110 ;
-            break ;
+            if (splice_result > 0)
+            {
+                number_of_bytes_moved += static_cast<size_t>(splice_result) ;
+                continue ;
+            }
 
-        case BaudRate::BAUD_134:
-            baud_rate_as_int = 134 ;
-            break ;
+            if ((splice_result < 0) and
+                (errno == EAGAIN))
+            {
+                if (not this->WaitForInputTee())
+                {
+                    break ;
+                }
 
-        case BaudRate::BAUD_150:
-            baud_rate_as_int = 150 ;
-            break ;
+                continue ;
+            }
 
-        case BaudRate::BAUD_200:
-            baud_rate_as_int = 200 ;
-            break ;
+            // The target does not support splice(), copy the data instead.
+            if ((splice_result < 0) and
+                (errno == EINVAL))
+            {
+                mInputTeeSplice = false ;
+                return number_of_bytes_moved ;
+            }
 
-        case BaudRate::BAUD_300:
-            baud_rate_as_int = 300 ;
+            mInputTeeErrno = (splice_result < 0) ? errno : EIO ;
             break ;
+        }
 
-        case BaudRate::BAUD_600:
-            baud_rate_as_int = 600 ;
-            break ;
+        // Discard what could not be moved, so that the pipe is empty again.
+        uint8_t discarded_data[256] {} ;
 
-        case BaudRate::BAUD_1200:
-            baud_rate_as_int = 1200 ;
-            break ;
+        while (call_with_retry(read, mInputTeeFilePipe[0], discarded_data, sizeof(discarded_data)) > 0)
+        {
+            // Keep reading.
+        }
 
-        case BaudRate::BAUD_1800:
-            baud_rate_as_int = 1800 ;
-            break ;
+        return number_of_bytes_moved ;
+    }
 
-        case BaudRate::BAUD_2400:
-            baud_rate_as_int = 2400 ;
-            break ;
+    inline
+    void
+    SerialPort::Implementation::WriteToInputTee(const void* const data,
+                                                const size_t      numberOfBytes)
+    {
+        size_t number_of_bytes_written = 0 ;
 
-        case BaudRate::BAUD_4800:
-            baud_rate_as_int = 4800 ;
-            break ;
+        while ((mInputTeeErrno == 0) and
+               (number_of_bytes_written < numberOfBytes))
+        {
+            // A write to a pipe in blocking mode waits until all the data
+            // fits, so only write as much as the pipe is known to accept.
+            if (mInputTeeIsPipe and
+                (not this->WaitForInputTee()))
+            {
+                break ;
+            }
 
-        case BaudRate::BAUD_9600:
-            baud_rate_as_int = 9600 ;
-            break ;
+            const auto write_size = mInputTeeIsPipe ?
+                                    std::min(numberOfBytes - number_of_bytes_written, static_cast<size_t>(PIPE_BUF)) :
+                                    numberOfBytes - number_of_bytes_written ;
 
-        case BaudRate::BAUD_19200:
-            baud_rate_as_int = 19200 ;
-            break ;
+            const auto write_result = call_with_retry(write,
+                                                      mInputTeeFileDescriptor,
+                                                      static_cast<const uint8_t*>(data) + number_of_bytes_written,
+                                                      write_size) ;
 
-        case BaudRate::BAUD_38400:
-            baud_rate_as_int = 38400 ;
-            break ;
+            if (write_result > 0)
+            {
+                number_of_bytes_written += static_cast<size_t>(write_result) ;
+                continue ;
+            }
 
-        case BaudRate::BAUD_57600:
-            baud_rate_as_int = 57600 ;
-            break ;
+            if ((write_result < 0) and
+                (errno == EAGAIN))
+            {
+                if (not mInputTeeIsPipe)
+                {
+                    this->WaitForInputTee() ;
+                }
 
-        case BaudRate::BAUD_115200:
-            baud_rate_as_int = 115200 ;
-            break ;
+                continue ;
+            }
 
-        case BaudRate::BAUD_230400:
-            baud_rate_as_int = 230400 ;
-            break ;
+            mInputTeeErrno = (write_result < 0) ? errno : EIO ;
+        }
+    }
 
-// @note: >B230400 are defined in Linux but not other POSIX systems, (e.g. Mac OS X).
-#ifdef __linux__
-        case BaudRate::BAUD_460800:
-            baud_rate_as_int = 460800 ;
-            break ;
+    inline
+    void
+    SerialPort::Implementation::SetInputTeeDeadline(const size_t msTimeout)
+    {
+        mInputTeeDeadline = (msTimeout == 0) ?
+                            std::chrono::steady_clock::time_point::max() :
+                            std::chrono::steady_clock::now() + std::chrono::milliseconds(msTimeout) ;
+    }
 
-        case BaudRate::BAUD_500000:
-            baud_rate_as_int = 500000 ;
-            break ;
+    inline
+    bool
+    SerialPort::Implementation::WaitForInputTee()
+    {
+        std::array<pollfd, 2> poll_fds {{{mInputTeeFileDescriptor, POLLOUT, 0},
+                                         {mCancelFileDescriptor, POLLIN, 0}}} ;
 
-        case BaudRate::BAUD_576000:
-            baud_rate_as_int = 576000 ;
-            break ;
+        const auto number_of_fds = (mCancelFileDescriptor < 0) ? 1 : 2 ;
 
-        case BaudRate::BAUD_921600:
-            baud_rate_as_int = 921600 ;
-            break ;
+        while (not mCancelled)
+        {
+            auto ms_timeout = -1 ;
 
-        case BaudRate::BAUD_1000000:
-            baud_rate_as_int = 1000000 ;
-            break ;
+            if (mInputTeeDeadline != std::chrono::steady_clock::time_point::max())
+            {
+                const auto remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(mInputTeeDeadline -
+                                                                                                std::chrono::steady_clock::now()).count() ;
 
-        case BaudRate::BAUD_1152000:
-            baud_rate_as_int = 1152000 ;
-            break ;
+                if (remaining_ms <= 0)
+                {
+                    mInputTeeErrno = ETIMEDOUT ;
+                    return false ;
+                }
 
-        case BaudRate::BAUD_1500000:
-            baud_rate_as_int = 1500000 ;
-            break ;
+                ms_timeout = static_cast<int>(std::min<int64_t>(remaining_ms, INT_MAX)) ;
+            }
 
-#if __MAX_BAUD > B2000000
-        case BaudRate::BAUD_2000000:
-            baud_rate_as_int = 2000000 ;
-            break ;
+            if ((call_with_retry(poll, poll_fds.data(), number_of_fds, ms_timeout) > 0) and
+                (poll_fds[0].revents != 0))
+            {
+                return true ;
+            }
+        }
 
-        case BaudRate::BAUD_2500000:
-            baud_rate_as_int = 2500000 ;
-            break ;
+        mInputTeeErrno = ECANCELED ;
+        return false ;
+    }
 
-        case BaudRate::BAUD_3000000:
-            baud_rate_as_int = 3000000 ;
-            break ;
+    inline
+    void
+    SerialPort::Implementation::CloseInputTeePipes()
+    {
+        for (auto pipe : {&mInputTeePipe, &mInputTeeFilePipe})
+        {
+            for (auto& pipe_fd : *pipe)
+            {
+                if (pipe_fd >= 0)
+                {
+                    call_with_retry(close, pipe_fd) ;
+                    pipe_fd = -1 ;
+                }
+            }
+        }
 
-        case BaudRate::BAUD_3500000:
-            baud_rate_as_int = 3500000 ;
-            break ;
+        mInputTeeSplice = false ;
+    }
 
-        case BaudRate::BAUD_4000000:
-            baud_rate_as_int = 4000000 ;
-            break ;
-#endif // __MAX_BAUD
-#endif // __linux__
-        default:
-            // If an incorrect baud rate was specified, throw an exception.
-            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
-        }
+    inline
+    SerialPortStatistics
+    SerialPort::Implementation::GetStatistics() const
+    {
+        const auto connection_lock = this->LockConnection() ;
+        return mStatistics ;
+    }
 
-        return baud_rate_as_int ;
+    inline
+    void
+    SerialPort::Implementation::ResetStatistics()
+    {
+        const auto connection_lock = this->LockConnection() ;
+        mStatistics = SerialPortStatistics {} ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetCharacterSize(const CharacterSize& characterSize)
+    SerialPort::Implementation::SetThreadSafe(const bool threadSafe)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if ((not threadSafe) and
+            (mCoalescingFlushDelay.count() > 0))
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            throw std::logic_error {"Write coalescing with a flush delay requires thread-safe mode."} ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        // Without a flush delay, the background thread is idle.
+        if (not threadSafe)
         {
-            throw std::runtime_error(ERR_MSG_INVALID_CHARACTER_SIZE) ;
+            this->StopCoalescingThread() ;
         }
 
-        // Set the character size to the specified value. If the character
-        // size is not 8 then it is also important to set ISTRIP. Setting
-        // ISTRIP causes all but the 7 low-order bits to be set to
-        // zero. Otherwise they are set to unspecified values and may
-        // cause problems. At the same time, we should clear the ISTRIP
-        // flag when the character size is 8 otherwise the MSB will always
-        // be set to zero (ISTRIP does not check the character size
-        // setting;it just sets every bit above the low 7 bits to zero).
-        if (characterSize == CharacterSize::CHAR_SIZE_8)
+        mThreadSafe = threadSafe ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::GetThreadSafe() const
+    {
+        return mThreadSafe ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::Cancel() noexcept
+    {
+        mCancelled = true ;
+
+        // Only async-signal-safe calls are made here.
+        if (mCancelFileDescriptor >= 0)
         {
-            // NOLINTNEXTLINE (hicpp-signed-bitwise)
-            port_settings.c_iflag &= ~ISTRIP ;  // Clear the ISTRIP flag.
+            const uint64_t increment = 1 ;
+            call_with_retry(write, mCancelFileDescriptor, &increment, sizeof(increment)) ;
         }
-        else
+    }
+
+    inline
+    void
+    SerialPort::Implementation::ResetCancel() noexcept
+    {
+        // Reading the eventfd resets its counter to zero. It is read before
+        // the flag is cleared, so that a concurrent Cancel() cannot leave the
+        // flag set without waking the threads waiting on the eventfd.
+        if (mCancelFileDescriptor >= 0)
         {
-            port_settings.c_iflag |= ISTRIP ;   // Set the ISTRIP flag.
+            uint64_t counter = 0 ;
+            call_with_retry(read, mCancelFileDescriptor, &counter, sizeof(counter)) ;
         }
 
-        // Set the character size.
-        // NOLINTNEXTLINE (hicpp-signed-bitwise)
-        port_settings.c_cflag &= ~CSIZE ;                               // Clear all CSIZE bits.
-        port_settings.c_cflag |= static_cast<tcflag_t>(characterSize) ; // Set the character size.
+        mCancelled = false ;
+    }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+    inline
+    bool
+    SerialPort::Implementation::IsCancelled() const noexcept
+    {
+        return mCancelled ;
+    }
+
+    inline
+    SerialPort::Implementation::IoLock
+    SerialPort::Implementation::LockInput()
+    {
+        if (not mThreadSafe)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            return IoLock {*this} ;
         }
+        return IoLock {*this, mInputMutex, mInputSettingsLock} ;
     }
 
     inline
-    CharacterSize
-    SerialPort::Implementation::GetCharacterSize() const
+    SerialPort::Implementation::IoLock
+    SerialPort::Implementation::LockOutput()
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (not mThreadSafe)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return IoLock {*this} ;
         }
+        return IoLock {*this, mOutputMutex, mOutputSettingsLock} ;
+    }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+    inline
+    std::unique_lock<std::shared_timed_mutex>
+    SerialPort::Implementation::LockSettings()
+    {
+        if (not mThreadSafe)
+        {
+            return std::unique_lock<std::shared_timed_mutex> {mSettingsMutex, std::defer_lock} ;
+        }
+        return std::unique_lock<std::shared_timed_mutex> {mSettingsMutex} ;
+    }
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+    inline
+    std::shared_lock<std::shared_timed_mutex>
+    SerialPort::Implementation::LockSharedSettings()
+    {
+        if (not mThreadSafe)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            return std::shared_lock<std::shared_timed_mutex> {mSettingsMutex, std::defer_lock} ;
         }
+        return std::shared_lock<std::shared_timed_mutex> {mSettingsMutex} ;
+    }
 
-        // Read the character size from the setttings.
-        // NOLINTNEXTLINE (hicpp-signed-bitwise)
-        return CharacterSize(port_settings.c_cflag & CSIZE) ;
+    inline
+    std::unique_lock<std::recursive_mutex>
+    SerialPort::Implementation::LockConnection() const
+    {
+        if (not mThreadSafe)
+        {
+            return std::unique_lock<std::recursive_mutex> {mConnectionMutex, std::defer_lock} ;
+        }
+        return std::unique_lock<std::recursive_mutex> {mConnectionMutex} ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetFlowControl(const FlowControl& flowControlType)
+    SerialPort::Implementation::WaitForDevice(std::shared_lock<std::shared_timed_mutex>& settingsLock)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        this->WaitForDevice(settingsLock, mByteArrivalTimeDelta) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::WaitForDevice(std::shared_lock<std::shared_timed_mutex>& settingsLock,
+                                              const int usTimeout)
+    {
+        if (not settingsLock.owns_lock())
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            this->WaitForCancel(usTimeout) ;
+            return ;
         }
 
-        // Flush the input and output buffers associated with the port.
-        if (tcflush(this->mFileDescriptor,
-                    TCIOFLUSH) < 0)
+        // Let settings changes proceed while this thread sleeps.
+        settingsLock.unlock() ;
+        this->WaitForCancel(usTimeout) ;
+        settingsLock.lock() ;
+
+        if (not this->IsOpen())
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
+    }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+    inline
+    void
+    SerialPort::Implementation::WaitForCancel(const int usTimeout)
+    {
+        this->ThrowIfCancelled() ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (mCancelFileDescriptor < 0)
         {
-            throw std::runtime_error(ERR_MSG_INVALID_FLOW_CONTROL) ;
+            usleep(usTimeout) ;
         }
-
-        // Set the flow control. Hardware flow control uses the RTS (Ready
-        // To Send) and CTS (clear to Send) lines. Software flow control
-        // uses IXON|IXOFF
-        switch(flowControlType)
+        else
         {
-        case FlowControl::FLOW_CONTROL_HARDWARE:
-            port_settings.c_iflag &= ~ (IXON|IXOFF) ;   // NOLINT (hicpp-signed-bitwise)
-            port_settings.c_cflag |= CRTSCTS ;
-            port_settings.c_cc[VSTART] = _POSIX_VDISABLE ;
-            port_settings.c_cc[VSTOP] = _POSIX_VDISABLE ;
-            break ;
-        case FlowControl::FLOW_CONTROL_SOFTWARE:
-            port_settings.c_iflag |= IXON|IXOFF ;        // NOLINT(hicpp-signed-bitwise)
-            port_settings.c_cflag &= ~CRTSCTS ;
-            port_settings.c_cc[VSTART] = CTRL_Q ;        // 0x11 (021) ^q
-            port_settings.c_cc[VSTOP]  = CTRL_S ;        // 0x13 (023) ^s
-            break ;
-        case FlowControl::FLOW_CONTROL_NONE:
-            port_settings.c_iflag &= ~(IXON|IXOFF) ;    // NOLINT(hicpp-signed-bitwise)
-            port_settings.c_cflag &= ~CRTSCTS ;
-            break ;
-        default:
-            throw std::invalid_argument(ERR_MSG_INVALID_FLOW_CONTROL) ;
-            // break ; break not needed after a throw
+            // Sleep with microsecond resolution, which poll() lacks, until
+            // the eventfd becomes readable.
+            pollfd poll_fd {mCancelFileDescriptor, POLLIN, 0} ;
+
+            const timespec timeout {usTimeout / 1000000,
+                                    (usTimeout % 1000000) * 1000} ;
+
+            call_with_retry(ppoll, &poll_fd, 1, &timeout, nullptr) ;
         }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        this->ThrowIfCancelled() ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::ThrowIfCancelled() const
+    {
+        if (mCancelled)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw OperationCancelled(ERR_MSG_OPERATION_CANCELLED) ;
         }
     }
 
     inline
-    FlowControl
-    SerialPort::Implementation::GetFlowControl() const
+    void
+    SerialPort::Implementation::WaitForInterFrameGap()
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if ((not mWritePacing) or
+            (mPacingInterFrameGap.count() == 0))
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        const auto wake_time = mLineIdleTime + mPacingInterFrameGap ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (wake_time > std::chrono::steady_clock::now())
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            this->WaitForPacingTimer(wake_time) ;
         }
+    }
 
-        // Check if IXON and IXOFF are set in c_iflag. If both are set and
-        // VSTART and VSTOP are set to 0x11 (^Q) and 0x13 (^S) respectively,
-        // then we are using software flow control.
-        if ((port_settings.c_iflag & IXON) and // NOLINT (hicpp-signed-bitwise)
-            (port_settings.c_iflag & IXOFF) and // NOLINT (hicpp-signed-bitwise)
-            (CTRL_Q == port_settings.c_cc[VSTART]) and
-            (CTRL_S == port_settings.c_cc[VSTOP]))
+    inline
+    size_t
+    SerialPort::Implementation::WaitForWritePacing(const size_t numberOfBytes)
+    {
+        if ((not mWritePacing) or
+            (mPacingBytesPerSecond == 0))
         {
-            return FlowControl::FLOW_CONTROL_SOFTWARE ;
+            return numberOfBytes ;
         }
 
-        if (not ((port_settings.c_iflag & IXON) or // NOLINT (hicpp-signed-bitwise)
-                 (port_settings.c_iflag & IXOFF))) // NOLINT (hicpp-signed-bitwise)
+        // Wait for enough tokens to write as much as a burst allows, rather
+        // than writing whatever the bucket holds, to save system calls.
+        const auto number_of_tokens_needed = static_cast<double>(std::min(numberOfBytes,
+                                                                          mPacingMaximumBurst)) ;
+        this->RefillPacingTokens() ;
+
+        if (mPacingTokens < number_of_tokens_needed)
         {
-            if (0 != (port_settings.c_cflag & CRTSCTS))
+            const auto wait_time_us = std::ceil((number_of_tokens_needed - mPacingTokens) *
+                                                MICROSECONDS_PER_SEC / mPacingBytesPerSecond) ;
+
+            this->WaitForPacingTimer(mPacingRefillTime +
+                                     std::chrono::microseconds(static_cast<int64_t>(wait_time_us))) ;
+
+            // Write pacing may have been changed by another thread.
+            if ((not mWritePacing) or
+                (mPacingBytesPerSecond == 0))
             {
-                // If neither IXON or IXOFF is set then we must have hardware flow
-                // control.
-                return FlowControl::FLOW_CONTROL_HARDWARE ;
+                return numberOfBytes ;
             }
-            return FlowControl::FLOW_CONTROL_NONE ;
+
+            this->RefillPacingTokens() ;
         }
 
-        // If none of the above conditions are satisfied then the serial port
-        // is using a flow control setup which we do not support at present.
-        return FlowControl::FLOW_CONTROL_INVALID ;
+        const auto number_of_bytes_allowed = static_cast<size_t>(std::max(mPacingTokens, 1.)) ;
+        return std::min(numberOfBytes, number_of_bytes_allowed) ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetParity(const Parity& parityType)
+    SerialPort::Implementation::UpdateWritePacing(const size_t numberOfBytes)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (not mWritePacing)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (mPacingBytesPerSecond > 0)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            mPacingTokens -= static_cast<double>(numberOfBytes) ;
         }
 
-        // Set the parity type
-        switch(parityType)
-        {
-        case Parity::PARITY_EVEN:
-            port_settings.c_cflag |= PARENB ;
-            port_settings.c_cflag &= ~PARODD ;  // NOLINT (hicpp-signed-bitwise)
-            port_settings.c_iflag |= INPCK ;
-            break ;
-        case Parity::PARITY_ODD:
-            port_settings.c_cflag |= PARENB ;
-            port_settings.c_cflag |= PARODD ;
-            port_settings.c_iflag |= INPCK ;
-            break ;
-        case Parity::PARITY_NONE:
-            port_settings.c_cflag &= ~PARENB ;  // NOLINT (hicpp-signed-bitwise)
-            port_settings.c_iflag |= IGNPAR ;
-            break ;
-        default:
-            throw std::invalid_argument(ERR_MSG_INVALID_PARITY) ;
-            // break ; break not needed after a throw
-        }
+        const auto transmit_time = std::chrono::microseconds(static_cast<int64_t>(numberOfBytes) *
+                                                             mByteArrivalTimeDelta) ;
 
-        // Apply the modified port settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        mLineIdleTime = std::max(mLineIdleTime, std::chrono::steady_clock::now()) + transmit_time ;
     }
 
     inline
-    Parity
-    SerialPort::Implementation::GetParity() const
+    void
+    SerialPort::Implementation::RefillPacingTokens()
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
-        {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
-        }
-
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        const auto current_time = std::chrono::steady_clock::now() ;
+        const auto elapsed_time = current_time - mPacingRefillTime ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed_time).count() ;
 
-        // Get the parity setting from the termios structure.
-        if (0 != (port_settings.c_cflag & PARENB)) // NOLINT (hicpp-signed-bitwise)
-        {
-            // parity is enabled.
-            if (port_settings.c_cflag & PARODD) // NOLINT (hicpp-signed-bitwise)
-            {
-                return Parity::PARITY_ODD ; // odd parity
-            }
-            return Parity::PARITY_EVEN ;    // even parity
-        }
-        return Parity::PARITY_NONE ;        // no parity.
+        mPacingTokens = std::min(mPacingTokens + static_cast<double>(elapsed_us) *
+                                                 mPacingBytesPerSecond / MICROSECONDS_PER_SEC,
+                                 static_cast<double>(mPacingMaximumBurst)) ;
+        mPacingRefillTime = current_time ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetStopBits(const StopBits& stopBits)
+    SerialPort::Implementation::WaitForPacingTimer(const std::chrono::steady_clock::time_point& wakeTime)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
-        {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
-        }
+        this->ThrowIfCancelled() ;
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        // The timer is armed with an absolute time of CLOCK_MONOTONIC, which
+        // is the clock of std::chrono::steady_clock on Linux.
+        const auto wake_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeTime.time_since_epoch()).count() ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        itimerspec timer_value {} ;
+        timer_value.it_value.tv_sec = wake_time_ns / 1000000000 ;
+        timer_value.it_value.tv_nsec = wake_time_ns % 1000000000 ;
+
+        if (timerfd_settime(mPacingTimerFileDescriptor,
+                            TFD_TIMER_ABSTIME,
+                            &timer_value,
+                            nullptr) < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        // Set the number of stop bits.
-        switch(stopBits)
-        {
-        case StopBits::STOP_BITS_1:
-            port_settings.c_cflag &= ~CSTOPB ;  // NOLINT (hicpp-signed-bitwise)
-            break ;
-        case StopBits::STOP_BITS_2:
-            port_settings.c_cflag |= CSTOPB ;
-            break ;
-        default:
-            throw std::invalid_argument(ERR_MSG_INVALID_STOP_BITS) ;
-            // break ; break not needed after a throw
-        }
+        const auto entry_time = std::chrono::steady_clock::now() ;
+        const auto settings_lock_owned = mOutputSettingsLock.owns_lock() ;
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        // Let settings changes proceed while this thread sleeps.
+        if (settings_lock_owned)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            mOutputSettingsLock.unlock() ;
         }
-    }
 
-    inline
-    StopBits
-    SerialPort::Implementation::GetStopBits() const
-    {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        std::array<pollfd, 2> poll_fds {{{mPacingTimerFileDescriptor, POLLIN, 0},
+                                         {mCancelFileDescriptor, POLLIN, 0}}} ;
+
+        const auto number_of_fds = (mCancelFileDescriptor < 0) ? 1 : 2 ;
+
+        call_with_retry(poll, poll_fds.data(), number_of_fds, -1) ;
+
+        // Consume the expiration of the timer, if any.
+        uint64_t number_of_expirations = 0 ;
+        call_with_retry(read, mPacingTimerFileDescriptor, &number_of_expirations, sizeof(number_of_expirations)) ;
+
+        if (settings_lock_owned)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            mOutputSettingsLock.lock() ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            const auto connection_lock = this->LockConnection() ;
+            const auto delay = std::chrono::steady_clock::now() - entry_time ;
+
+            mStatistics.pacingDelayCount++ ;
+            mStatistics.pacingDelayUs += std::chrono::duration_cast<std::chrono::microseconds>(delay).count() ;
         }
 
-        // If CSTOPB is set then we are using two stop bits, otherwise we
-        // are using 1 stop bit.
-        if (port_settings.c_cflag & CSTOPB) // NOLINT (hicpp-signed-bitwise)
+        this->ThrowIfCancelled() ;
+
+        if (not this->IsOpen())
         {
-            return StopBits::STOP_BITS_2 ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
-        return StopBits::STOP_BITS_1 ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetVMin(const short vmin)
+    SerialPort::Implementation::WaitForOutputSpace()
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (mOutputSettingsLock.owns_lock())
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            this->WaitForDevice(mOutputSettingsLock) ;
         }
+    }
 
-        if (vmin < 0 || vmin > 255)
+    inline
+    termios
+    SerialPort::Implementation::GetPortSettings() const
+    {
+        if (mDisconnected)
         {
-            std::stringstream error_message ;
-            error_message << "Invalid vmin value: " << vmin << ". " ;
-            error_message << "Vmin must be in the range [0, 255]." ;
-            throw std::invalid_argument {error_message.str()} ;
+            return mPortSettings ;
         }
 
-        // Get the current serial port settings.
         termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
 
         if (tcgetattr(this->mFileDescriptor,
                       &port_settings) < 0)
@@ -1668,265 +4553,384 @@ namespace LibSerial
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        port_settings.c_cc[VMIN] = static_cast<cc_t>(vmin) ;
-
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        return port_settings ;
     }
 
     inline
-    short
-    SerialPort::Implementation::GetVMin() const
+    void
+    SerialPort::Implementation::SetPortSettings(const termios& portSettings)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        // The settings are applied when the device is reopened.
+        if (mDisconnected)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            mPortSettings = portSettings ;
+            return ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (tcsetattr(this->mFileDescriptor,
+                      TCSANOW,
+                      &portSettings) < 0)
         {
+            // If applying the settings fails, throw an exception.
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        return port_settings.c_cc[VMIN] ;
+        mPortSettings = portSettings ;
     }
 
     inline
-    void
-    SerialPort::Implementation::SetVTime(const short vtime)
+    ssize_t
+    SerialPort::Implementation::ReadSome(void* const  buffer,
+                                         const size_t numberOfBytes)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        this->ThrowIfCancelled() ;
+
+        // No data can arrive while the device is absent.
+        if (mDisconnected and
+            (not this->TryReconnect()))
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return 0 ;
         }
 
-        if (vtime < 0 || vtime > 255)
+        if (mInputTeeErrno != 0)
         {
-            std::stringstream error_message ;
-            error_message << "Invalid vtime value: " << vtime << ". " ;
-            error_message << "Vtime must be in the range [0, 255]." ;
-            throw std::invalid_argument {error_message.str()} ;
+            const auto input_tee_errno = mInputTeeErrno ;
+            mInputTeeErrno = 0 ;
+            throw std::runtime_error(std::strerror(input_tee_errno)) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        this->RethrowCaptureError() ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        const auto read_result = (mInputTeeFileDescriptor >= 0) ?
+                                 this->ReadWithInputTee(buffer, numberOfBytes) :
+                                 call_with_retry(read,
+                                                 this->mFileDescriptor,
+                                                 buffer,
+                                                 numberOfBytes) ;
+
+        if (read_result > 0)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            this->RecordCapture(CaptureDirection::RECEIVED,
+                                buffer,
+                                static_cast<size_t>(read_result)) ;
+
+            if (mFlightRecorder)
+            {
+                mFlightRecorder->Record(CaptureDirection::RECEIVED,
+                                        buffer,
+                                        static_cast<size_t>(read_result)) ;
+            }
+
+            return read_result ;
         }
 
-        port_settings.c_cc[VTIME] = static_cast<cc_t>(vtime) ;
+        if ((read_result < 0) and
+            (errno == EWOULDBLOCK))
+        {
+            return 0 ;
+        }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        if (this->IsHangUp(read_result))
+        {
+            if (not mAutoReconnect)
+            {
+                this->NotifyFlightRecorder(FlightRecorderTrigger::DISCONNECTED) ;
+                throw std::runtime_error(std::strerror(EIO)) ;
+            }
+
+            this->HandleHangUp() ;
+            return 0 ;
+        }
+
+        if (read_result < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
+
+        return 0 ;
     }
 
     inline
-    short
-    SerialPort::Implementation::GetVTime() const
+    size_t
+    SerialPort::Implementation::WriteSome(const void* const buffer,
+                                          const size_t      numberOfBytes)
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        this->ThrowIfCancelled() ;
+        this->RethrowCaptureError() ;
+
+        // Data written while the device is absent is discarded.
+        if (mDisconnected and
+            (not this->TryReconnect()))
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            const auto connection_lock = this->LockConnection() ;
+            mStatistics.bytesDiscarded += numberOfBytes ;
+            return numberOfBytes ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        const auto write_result = call_with_retry(write,
+                                                  this->mFileDescriptor,
+                                                  buffer,
+                                                  numberOfBytes) ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (write_result >= 0)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            if (write_result > 0)
+            {
+                this->RecordCapture(CaptureDirection::TRANSMITTED,
+                                    buffer,
+                                    static_cast<size_t>(write_result)) ;
+            }
+
+            if (mFlightRecorder and
+                (write_result > 0))
+            {
+                mFlightRecorder->Record(CaptureDirection::TRANSMITTED,
+                                        buffer,
+                                        static_cast<size_t>(write_result)) ;
+            }
+
+            return static_cast<size_t>(write_result) ;
+        }
+
+        if (errno == EWOULDBLOCK)
+        {
+            return 0 ;
         }
 
-        return port_settings.c_cc[VTIME] ;
-    }
+        if (mAutoReconnect and
+            this->IsHangUp(write_result))
+        {
+            this->HandleHangUp() ;
 
-    inline
-    void
-    SerialPort::Implementation::SetDTR(const bool dtrState)
-    {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+            const auto connection_lock = this->LockConnection() ;
+            mStatistics.bytesDiscarded += numberOfBytes ;
+            return numberOfBytes ;
+        }
+
+        if (this->IsHangUp(write_result))
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            const auto write_errno = errno ;
+            this->NotifyFlightRecorder(FlightRecorderTrigger::DISCONNECTED) ;
+            throw std::runtime_error(std::strerror(write_errno)) ;
         }
 
-        this->SetModemControlLine(TIOCM_DTR,
-                                   dtrState) ;
+        throw std::runtime_error(std::strerror(errno)) ;
     }
 
     inline
     bool
-    SerialPort::Implementation::GetDTR()
+    SerialPort::Implementation::IsHangUp(const ssize_t ioResult) const
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (ioResult < 0)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return (errno == EIO) or (errno == ENXIO) or (errno == ENODEV) ;
         }
 
-        return this->GetModemControlLine(TIOCM_DTR) ;
+        // A read() of zero bytes is either a hang-up or, with VMIN == 0, no
+        // data. Only the former is reported as POLLHUP.
+        pollfd poll_fd {this->mFileDescriptor, POLLIN, 0} ;
+
+        return (call_with_retry(poll, &poll_fd, 1, 0) > 0) and
+               ((poll_fd.revents & POLLHUP) != 0) ;    // NOLINT (hicpp-signed-bitwise)
     }
 
     inline
     void
-    SerialPort::Implementation::SetRTS(const bool rtsState)
+    SerialPort::Implementation::HandleHangUp()
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        const auto connection_lock = this->LockConnection() ;
+
+        // In thread-safe mode, both directions may detect the same hang-up.
+        if (mDisconnected)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return ;
         }
 
-        this->SetModemControlLine(TIOCM_RTS,
-                                  rtsState) ;
+        // Keep the hung up file description open so that the file descriptor
+        // number cannot be reused until the device is reopened.
+        mDisconnected = true ;
+        mCurrentBackoff = mInitialBackoff ;
+        mNextReconnectTime = std::chrono::steady_clock::now() + mCurrentBackoff ;
+
+        mStatistics.disconnectCount++ ;
+        this->NotifyConnectionEvent(ConnectionEvent::DISCONNECTED) ;
+        this->NotifyFlightRecorder(FlightRecorderTrigger::DISCONNECTED) ;
     }
 
     inline
     bool
-    SerialPort::Implementation::GetRTS()
+    SerialPort::Implementation::TryReconnect()
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        const auto connection_lock = this->LockConnection() ;
+
+        // In thread-safe mode, the other direction may have reopened it.
+        if (not mDisconnected)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return true ;
         }
 
-        return this->GetModemControlLine(TIOCM_RTS) ;
-    }
+        const auto current_time = std::chrono::steady_clock::now() ;
 
-    inline
-    bool
-    SerialPort::Implementation::GetCTS()
-    {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (current_time < mNextReconnectTime)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return false ;
         }
 
-        return this->GetModemControlLine(TIOCM_CTS) ;
-    }
+        mStatistics.reconnectAttempts++ ;
 
-    inline
-    bool
-    SerialPort::Implementation::GetDSR()
-    {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        // Schedule the next attempt in case this one fails.
+        mNextReconnectTime = current_time + mCurrentBackoff ;
+        mCurrentBackoff = std::min(2 * mCurrentBackoff, mMaximumBackoff) ;
+
+        // Reopen the device with the access mode and blocking status of the
+        // hung up file description.
+        const auto status_flags = fcntl(this->mFileDescriptor, F_GETFL) ;  // NOLINT (cppcoreguidelines-pro-type-vararg)
+        const auto open_flags = (status_flags & (O_ACCMODE | O_NONBLOCK)) | O_NOCTTY ;    // NOLINT (hicpp-signed-bitwise)
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const auto file_desc = call_with_retry(open,
+                                               mReconnectPath.c_str(),
+                                               open_flags) ;
+
+        if (file_desc < 0)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            return false ;
         }
 
-        return this->GetModemControlLine(TIOCM_DSR) ;
+        // Restore exclusive access and all cached settings in one shot, then
+        // move the new file description under the original file descriptor.
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if ((call_with_retry(ioctl, file_desc, TIOCEXCL) == -1) or
+            (tcsetattr(file_desc, TCSANOW, &mPortSettings) < 0) or
+            (call_with_retry(dup2, file_desc, this->mFileDescriptor) < 0))
+        {
+            close(file_desc) ;
+            return false ;
+        }
+
+        close(file_desc) ;
+
+        if (mModemLinesSet != 0)
+        {
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            call_with_retry(ioctl, this->mFileDescriptor, TIOCMBIS, &mModemLinesSet) ;
+        }
+
+        if (mModemLinesCleared != 0)
+        {
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            call_with_retry(ioctl, this->mFileDescriptor, TIOCMBIC, &mModemLinesCleared) ;
+        }
+
+        mDisconnected = false ;
+        mCurrentBackoff = mInitialBackoff ;
+        mFileName = mReconnectPath ;
+
+#ifdef __linux__
+        // The reopened device starts with the driver defaults.
+        if (mLowLatencyRequested)
+        {
+            this->SetLowLatency(true) ;
+        }
+#endif
+
+        mStatistics.reconnectCount++ ;
+        this->NotifyConnectionEvent(ConnectionEvent::RECONNECTED) ;
+
+        return true ;
     }
 
     inline
-    int
-    SerialPort::Implementation::GetFileDescriptor() const
+    std::string
+    SerialPort::Implementation::GetDeviceName() const
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        // Resolve symbolic links such as /dev/serial/by-id/... so that we
+        // obtain the kernel name of the device, e.g. ttyUSB0.
+        std::string device_name = mFileName ;
+        char* const real_path = realpath(mFileName.c_str(), nullptr) ;
+
+        if (real_path != nullptr)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            device_name = real_path ;
+            free(real_path) ;   // NOLINT (cppcoreguidelines-no-malloc)
         }
 
-        return this->mFileDescriptor ;
+        return device_name.substr(device_name.find_last_of('/') + 1) ;
     }
 
     inline
-    int
-    SerialPort::Implementation::GetNumberOfBytesAvailable()
+    std::string
+    SerialPort::Implementation::GetReconnectPath() const
     {
-        // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
-        {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
-        }
+        // A USB-serial adapter may come back under a different kernel name,
+        // but its by-id path stays the same.
+        SerialPortEnumerator serial_port_enumerator {mSysfsRoot} ;
+        serial_port_enumerator.SetResolveByIdPaths(true) ;
 
-        int number_of_bytes_available = 0 ;
+        SerialPortInfo serial_port_info {} ;
 
-        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
-        if (call_with_retry(ioctl,
-                            this->mFileDescriptor,
-                            FIONREAD,
-                            &number_of_bytes_available) < 0)
+        if (serial_port_enumerator.GetSerialPortInfo(this->GetDeviceName(), serial_port_info) and
+            (not serial_port_info.byIdPath.empty()))
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            return serial_port_info.byIdPath ;
         }
 
-        return number_of_bytes_available ;
+        return mFileName ;
     }
 
-#ifdef __linux__
     inline
-    std::vector<std::string>
-    SerialPort::Implementation::GetAvailableSerialPorts() const
+    void
+    SerialPort::Implementation::NotifyConnectionEvent(const ConnectionEvent connectionEvent)
     {
-        constexpr int array_size = 3 ;
-        constexpr size_t max_port_number = 128 ;
+        if (mConnectionEventCallback)
+        {
+            // The callback is copied, as it may be replaced before the event
+            // is dispatched.
+            this->QueueEvent([connectionEventCallback = mConnectionEventCallback, connectionEvent]()
+                             {
+                                 connectionEventCallback(connectionEvent) ;
+                             }) ;
+        }
+    }
 
-        std::string serial_ports[array_size] = {"/dev/ttyS",
-                                                "/dev/ttyACM",
-                                                "/dev/ttyUSB"} ;
+    inline
+    void
+    SerialPort::Implementation::QueueEvent(std::function<void()>&& event)
+    {
+        const auto connection_lock = this->LockConnection() ;
+        mPendingEvents.push_back(std::move(event)) ;
+        mHasPendingEvents = true ;
+    }
 
-        std::vector<std::string> serial_port_names {} ;
-        for (const auto& port_prefix: serial_ports)
+    inline
+    void
+    SerialPort::Implementation::DispatchEvents() noexcept
+    {
+        if (not mHasPendingEvents)
         {
-            for (size_t j = 0 ;j < max_port_number;j++)
-            {
-                const auto file_name = port_prefix + std::to_string(j) ;
-
-                // Try to open the serial port.
-                const auto file_desc = call_with_retry(open,
-                                                       file_name.c_str(),
-                                                       O_RDWR | O_NOCTTY | O_NONBLOCK) ; // NOLINT (hicpp-vararg)
+            return ;
+        }
 
-                if (file_desc > 0)
-                {
-                    serial_struct serial_port_info {} ;
-                    // NOLINTNEXTLINE (hicpp-vararg)
-                    if (call_with_retry(ioctl,
-                                        file_desc,
-                                        TIOCGSERIAL,
-                                        &serial_port_info) == -1)
-                    {
-                        throw std::runtime_error(std::strerror(errno)) ;
-                    }
+        std::vector<std::function<void()>> pending_events {} ;
 
-                    serial_port_names.push_back(file_name) ;
+        {
+            const auto connection_lock = this->LockConnection() ;
+            std::swap(pending_events, mPendingEvents) ;
+            mHasPendingEvents = false ;
+        }
 
-                    close(file_desc) ;
-                }
+        for (const auto& pending_event : pending_events)
+        {
+            try
+            {
+                pending_event() ;
+            }
+            catch (...)
+            {
+                // The I/O that detected the event has already completed.
             }
         }
-
-        return serial_port_names ;
     }
-#endif
 
     inline
     void
@@ -1954,6 +4958,24 @@ namespace LibSerial
             throw std::invalid_argument {ERR_MSG_INVALID_MODEM_LINE} ;
         }
 
+        // Remember the requested state so that it can be restored after a
+        // reconnection.
+        if (lineState)
+        {
+            mModemLinesSet |= modemLine ;       // NOLINT (hicpp-signed-bitwise)
+            mModemLinesCleared &= ~modemLine ;  // NOLINT (hicpp-signed-bitwise)
+        }
+        else
+        {
+            mModemLinesCleared |= modemLine ;   // NOLINT (hicpp-signed-bitwise)
+            mModemLinesSet &= ~modemLine ;      // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (mDisconnected)
+        {
+            return ;
+        }
+
         // Set or unset the specified bit according to the value of lineState.
         int ioctl_result = -1 ;
 
@@ -2095,26 +5117,14 @@ namespace LibSerial
         }
 
         // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        auto port_settings = this->GetPortSettings() ;
 
         // @NOTE - termios.c_line is not a standard element of the termios
         // structure, (as per the Single Unix Specification 3).
         port_settings.c_line = '\0' ;
 
         // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        this->SetPortSettings(port_settings) ;
     }
 
     inline
@@ -2128,25 +5138,13 @@ namespace LibSerial
         }
 
         // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        auto port_settings = this->GetPortSettings() ;
 
         // Ignore Break conditions on input.
         port_settings.c_iflag = IGNBRK ;
 
         // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        this->SetPortSettings(port_settings) ;
     }
 
     inline
@@ -2160,24 +5158,12 @@ namespace LibSerial
         }
 
         // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        auto port_settings = this->GetPortSettings() ;
 
         port_settings.c_oflag = 0 ;
 
         // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        this->SetPortSettings(port_settings) ;
     }
 
     inline
@@ -2191,25 +5177,13 @@ namespace LibSerial
         }
 
         // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        auto port_settings = this->GetPortSettings() ;
 
         // Enable the receiver (CREAD) and ignore modem control lines (CLOCAL).
         port_settings.c_cflag |= CREAD | CLOCAL ;    // NOLINT (hicpp-signed-bitwise)
 
         // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        this->SetPortSettings(port_settings) ;
     }
 
     inline
@@ -2223,24 +5197,12 @@ namespace LibSerial
         }
 
         // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        auto port_settings = this->GetPortSettings() ;
 
         port_settings.c_lflag = 0 ;
 
         // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        this->SetPortSettings(port_settings) ;
     }
 
     inline
@@ -2273,6 +5235,9 @@ namespace LibSerial
         // Obtain the entry time.
         const auto entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
 
+        // Waiting for the input tee is bounded by the same timeout.
+        this->SetInputTeeDeadline(msTimeout) ;
+
         while (number_of_bytes_remaining > 0)
         {
             // If insufficient space remains in the buffer, exit the loop and return .
@@ -2287,10 +5252,8 @@ namespace LibSerial
                 dataBuffer.resize(number_of_bytes_read + 1) ;
             }
 
-            const auto read_result = call_with_retry(read,
-                                                     this->mFileDescriptor,
-                                                     &dataBuffer[number_of_bytes_read],
-                                                     number_of_bytes_remaining) ;
+            const auto read_result = this->ReadSome(&dataBuffer[number_of_bytes_read],
+                                                    number_of_bytes_remaining) ;
 
             if (read_result > 0)
             {
@@ -2306,11 +5269,6 @@ namespace LibSerial
                     }
                 }
             }
-            else if ((read_result <= 0) and
-                     (errno != EWOULDBLOCK))
-            {
-                throw std::runtime_error(std::strerror(errno)) ;
-            }
 
             // Obtain the current time.
             const auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
@@ -2329,11 +5287,12 @@ namespace LibSerial
                 // Resize the data buffer.
                 dataBuffer.resize(number_of_bytes_read) ;
 
+                this->NotifyFlightRecorder(FlightRecorderTrigger::READ_TIMEOUT) ;
                 throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
             }
 
             // Allow sufficient time for an additional byte to arrive.
-            usleep(mByteArrivalTimeDelta) ;
+            this->WaitForDevice(mInputSettingsLock) ;
         }
     }
 
@@ -2367,6 +5326,9 @@ namespace LibSerial
         // Obtain the entry time.
         const auto entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
 
+        // Waiting for the input tee is bounded by the same timeout.
+        this->SetInputTeeDeadline(msTimeout) ;
+
         while (number_of_bytes_remaining > 0)
         {
             // If insufficient space remains in the buffer, exit the loop and return .
@@ -2381,10 +5343,8 @@ namespace LibSerial
                 dataString.resize(number_of_bytes_read + 1) ;
             }
 
-            const auto read_result = call_with_retry(read,
-                                                     this->mFileDescriptor,
-                                                     &dataString[number_of_bytes_read],
-                                                     number_of_bytes_remaining) ;
+            const auto read_result = this->ReadSome(&dataString[number_of_bytes_read],
+                                                    number_of_bytes_remaining) ;
 
             if (read_result > 0)
             {
@@ -2400,11 +5360,6 @@ namespace LibSerial
                     }
                 }
             }
-            else if (read_result <= 0 &&
-                     errno != EWOULDBLOCK)
-            {
-                throw std::runtime_error(std::strerror(errno)) ;
-            }
 
             // Obtain the current time.
             const auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
@@ -2423,11 +5378,12 @@ namespace LibSerial
                 // Resize the data string.
                 dataString.resize(number_of_bytes_read) ;
 
+                this->NotifyFlightRecorder(FlightRecorderTrigger::READ_TIMEOUT) ;
                 throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
             }
 
             // Allow sufficient time for an additional byte to arrive.
-            usleep(mByteArrivalTimeDelta) ;
+            this->WaitForDevice(mInputSettingsLock) ;
         }
     }
 
@@ -2450,47 +5406,92 @@ namespace LibSerial
         // Obtain the entry time.
         const auto entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
 
+        // Waiting for the input tee is bounded by the same timeout.
+        this->SetInputTeeDeadline(msTimeout) ;
+
         // Loop until the number of bytes requested have been read or the
         // timeout has elapsed.
         ssize_t read_result = 0 ;
         while (read_result < 1)
         {
-            read_result = call_with_retry(read,
-                                          this->mFileDescriptor,
-                                          &charBuffer,
-                                          sizeof(ByteType)) ;
+            read_result = this->ReadSome(&charBuffer,
+                                         sizeof(ByteType)) ;
+
+            // If the byte has been successfully read, exit the loop and return.
+            if (read_result == sizeof(ByteType))
+            {
+                break ;
+            }
+
+            // Obtain the current time.
+            const auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+
+            // Calculate the time delta.
+            const auto elapsed_time = current_time - entry_time ;
+
+            // Calculate the elapsed number of milliseconds.
+            const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count() ;
+
+            // Throw a ReadTimeout exception if more than msTimeout milliseconds
+            // have elapsed while waiting for data.
+            if ((msTimeout > 0) and
+                (static_cast<size_t>(elapsed_ms) > msTimeout))
+            {
+                this->NotifyFlightRecorder(FlightRecorderTrigger::READ_TIMEOUT) ;
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+
+            // Allow sufficient time for an additional byte to arrive.
+            this->WaitForDevice(mInputSettingsLock) ;
+        }
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::ReadInto(char* const  dataBuffer,
+                                         const size_t bufferSize,
+                                         const size_t msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if (bufferSize == 0)
+        {
+            return 0 ;
+        }
+
+        // Obtain the entry time.
+        const auto entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
 
-            // If the byte has been successfully read, exit the loop and return.
-            if (read_result == sizeof(ByteType))
-            {
-                break ;
-            }
+        // Waiting for the input tee is bounded by the same timeout.
+        this->SetInputTeeDeadline(msTimeout) ;
+
+        while (true)
+        {
+            // Return whatever is available once the first byte has arrived.
+            const auto read_result = this->ReadSome(dataBuffer,
+                                                    bufferSize) ;
 
-            if ((read_result <= 0) and
-                (errno != EWOULDBLOCK))
+            if (read_result > 0)
             {
-                throw std::runtime_error(std::strerror(errno)) ;
+                return static_cast<size_t>(read_result) ;
             }
 
-            // Obtain the current time.
-            const auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
-
-            // Calculate the time delta.
-            const auto elapsed_time = current_time - entry_time ;
-
             // Calculate the elapsed number of milliseconds.
+            const auto elapsed_time = std::chrono::high_resolution_clock::now().time_since_epoch() - entry_time ;
             const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count() ;
 
-            // Throw a ReadTimeout exception if more than msTimeout milliseconds
-            // have elapsed while waiting for data.
             if ((msTimeout > 0) and
-                (static_cast<size_t>(elapsed_ms) > msTimeout))
+                (static_cast<size_t>(elapsed_ms) >= msTimeout))
             {
-                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+                return 0 ;
             }
 
             // Allow sufficient time for an additional byte to arrive.
-            usleep(mByteArrivalTimeDelta) ;
+            this->WaitForDevice(mInputSettingsLock) ;
         }
     }
 
@@ -2538,6 +5539,7 @@ namespace LibSerial
             if (msTimeout > 0 &&
                 elapsed_ms > msTimeout)
             {
+                this->NotifyFlightRecorder(FlightRecorderTrigger::READ_TIMEOUT) ;
                 throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
             }
 
@@ -2560,50 +5562,136 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        size_t number_of_bytes = dataBuffer.size() ;
+        // Nothing needs to be done if there is no data in the buffer.
+        if (dataBuffer.empty())
+        {
+            return ;
+        }
+
+        this->WriteCoalesced(dataBuffer.data(),
+                             dataBuffer.size()) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::Write(const std::string& dataString)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
         // Nothing needs to be done if there is no data in the string.
-        if (number_of_bytes <= 0)
+        if (dataString.empty())
         {
             return ;
         }
 
-        // Local variables.
-        size_t number_of_bytes_written = 0 ;
-        size_t number_of_bytes_remaining = number_of_bytes ;
+        this->WriteCoalesced(dataString.data(),
+                             dataString.size()) ;
+    }
 
-        // Write the data to the serial port. Keep retrying if EAGAIN
-        // error is received and EWOULDBLOCK is not received.
-        ssize_t write_result = 0 ;
+    inline
+    void
+    SerialPort::Implementation::Write(const char* const dataBuffer,
+                                      const size_t      numberOfBytes)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-        while (number_of_bytes_remaining > 0)
+        if (numberOfBytes == 0)
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &dataBuffer[number_of_bytes_written],
-                                           number_of_bytes_remaining) ;
+            return ;
+        }
 
-            if (write_result >= 0)
-            {
-                number_of_bytes_written += write_result ;
-                number_of_bytes_remaining = number_of_bytes - number_of_bytes_written ;
+        this->WriteCoalesced(dataBuffer,
+                             numberOfBytes) ;
+    }
 
-                if (number_of_bytes_remaining == 0)
-                {
-                    break ;
-                }
+    inline
+    size_t
+    SerialPort::Implementation::TryWrite(const char* const dataBuffer,
+                                         const size_t      numberOfBytes)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        this->RethrowCoalescingError() ;
+
+        // Keep the order of the data: nothing new is written before the
+        // data collected by write coalescing.
+        if (not mCoalescingBuffer.empty())
+        {
+            const auto number_of_bytes_written = this->WriteWithoutWaiting(mCoalescingBuffer.data(),
+                                                                           mCoalescingBuffer.size()) ;
+
+            mCoalescingBuffer.erase(mCoalescingBuffer.begin(),
+                                    mCoalescingBuffer.begin() + number_of_bytes_written) ;
+
+            if (not mCoalescingBuffer.empty())
+            {
+                return 0 ;
             }
-            else if (write_result <= 0 &&
-                     errno != EWOULDBLOCK)
+        }
+
+        if (numberOfBytes == 0)
+        {
+            return 0 ;
+        }
+
+        return this->WriteWithoutWaiting(dataBuffer,
+                                         numberOfBytes) ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::GetWritePacingDelay(const size_t numberOfBytes)
+    {
+        if (not mWritePacing)
+        {
+            return 0 ;
+        }
+
+        const auto current_time = std::chrono::steady_clock::now() ;
+        auto wake_time = current_time ;
+
+        if (mPacingInterFrameGap.count() > 0)
+        {
+            wake_time = std::max(wake_time,
+                                 mLineIdleTime + mPacingInterFrameGap) ;
+        }
+
+        // Wait for as many tokens as WaitForWritePacing() does.
+        if (mPacingBytesPerSecond > 0)
+        {
+            const auto number_of_tokens_needed = static_cast<double>(std::min(std::max(numberOfBytes, size_t {1}),
+                                                                              mPacingMaximumBurst)) ;
+            this->RefillPacingTokens() ;
+
+            if (mPacingTokens < number_of_tokens_needed)
             {
-                throw std::runtime_error(std::strerror(errno)) ;
+                const auto wait_time_us = std::ceil((number_of_tokens_needed - mPacingTokens) *
+                                                    MICROSECONDS_PER_SEC / mPacingBytesPerSecond) ;
+
+                wake_time = std::max(wake_time,
+                                     mPacingRefillTime + std::chrono::microseconds(static_cast<int64_t>(wait_time_us))) ;
             }
         }
+
+        return static_cast<size_t>(std::chrono::duration_cast<std::chrono::microseconds>(wake_time - current_time).count()) ;
     }
 
     inline
     void
-    SerialPort::Implementation::Write(const std::string& dataString)
+    SerialPort::Implementation::SendFile(const std::string&     filePath,
+                                         const SendFileOptions& sendFileOptions)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -2611,45 +5699,85 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        size_t number_of_bytes = dataString.size() ;
-
-        // Nothing needs to be done if there is no data in the string.
-        if (number_of_bytes <= 0)
+        if (sendFileOptions.chunkSize == 0)
         {
-            return ;
+            throw std::invalid_argument {"The chunk size must not be 0."} ;
         }
 
-        // Local variables.
-        size_t number_of_bytes_written = 0 ;
-        size_t number_of_bytes_remaining = number_of_bytes ;
+        // Mappings start at multiples of the page size.
+        const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE)) ;
+        const auto chunk_size = (sendFileOptions.chunkSize + page_size - 1) / page_size * page_size ;
 
-        // Write the data to the serial port. Keep retrying if EAGAIN
-        // error is received and EWOULDBLOCK is not received.
-        ssize_t write_result = 0 ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const auto file_descriptor = call_with_retry(open, filePath.c_str(), O_RDONLY | O_CLOEXEC) ;
 
-        while (number_of_bytes_remaining > 0)
+        if (file_descriptor < 0)
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &dataString[number_of_bytes_written],
-                                           number_of_bytes_remaining) ;
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        try
+        {
+            struct stat file_status {} ;
 
-            if (write_result >= 0)
+            if (fstat(file_descriptor, &file_status) < 0)
             {
-                number_of_bytes_written += write_result ;
-                number_of_bytes_remaining = number_of_bytes - number_of_bytes_written ;
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
 
-                if (number_of_bytes_remaining == 0)
-                {
-                    break ;
-                }
+            // Devices, pipes and directories cannot be mapped by size.
+            if (not S_ISREG(file_status.st_mode))    // NOLINT (hicpp-signed-bitwise)
+            {
+                throw std::invalid_argument {"The file must be a regular file."} ;
             }
-            else if (write_result <= 0 &&
-                     errno != EWOULDBLOCK)
+
+            const auto file_size = static_cast<size_t>(file_status.st_size) ;
+
+            auto get_chunk_size = [file_size, chunk_size](const size_t offset)
             {
-                throw std::runtime_error(std::strerror(errno)) ;
+                return (offset < file_size) ? std::min(chunk_size, file_size - offset) : 0 ;
+            } ;
+
+            // While a chunk is written, the next one is already mapped and
+            // being read ahead by the kernel.
+            size_t number_of_bytes_sent = 0 ;
+            MappedFileChunk current_chunk {file_descriptor, 0, get_chunk_size(0)} ;
+
+            while (current_chunk.GetSize() > 0)
+            {
+                const auto next_offset = number_of_bytes_sent + current_chunk.GetSize() ;
+
+                MappedFileChunk next_chunk {file_descriptor,
+                                            static_cast<off_t>(next_offset),
+                                            get_chunk_size(next_offset)} ;
+
+                this->WriteCoalesced(current_chunk.GetData(),
+                                     current_chunk.GetSize()) ;
+
+                number_of_bytes_sent = next_offset ;
+
+                if (sendFileOptions.progressCallback)
+                {
+                    // Report only data that has actually been written.
+                    if (mCoalescingBufferSize != 0)
+                    {
+                        this->FlushCoalescedData() ;
+                    }
+
+                    sendFileOptions.progressCallback(number_of_bytes_sent,
+                                                     file_size) ;
+                }
+
+                current_chunk = std::move(next_chunk) ;
             }
         }
+        catch (...)
+        {
+            call_with_retry(close, file_descriptor) ;
+            throw ;
+        }
+
+        call_with_retry(close, file_descriptor) ;
     }
 
     inline
@@ -2662,61 +5790,270 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Write the data to the serial port. Keep retrying if EAGAIN
-        // error is received and EWOULDBLOCK is not received.
-        ssize_t write_result = 0 ;
+        this->WriteCoalesced(&charBuffer, 1) ;
+    }
 
-        while (write_result <= 0)
+    inline
+    void
+    SerialPort::Implementation::WriteByte(const unsigned char charBuffer)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &charBuffer,
-                                           1) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        this->WriteCoalesced(&charBuffer, 1) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::WriteAll(const void* const buffer,
+                                         const size_t      numberOfBytes)
+    {
+        const auto data = static_cast<const char*>(buffer) ;
 
-            if (write_result == 1)
+        // Local variables.
+        size_t number_of_bytes_written = 0 ;
+        size_t number_of_bytes_remaining = numberOfBytes ;
+
+        this->WaitForInterFrameGap() ;
+
+        // Write the data to the serial port. Keep retrying while the write
+        // would block.
+        while (number_of_bytes_remaining > 0)
+        {
+            const auto number_of_bytes_allowed = this->WaitForWritePacing(number_of_bytes_remaining) ;
+
+            const auto write_result = this->WriteSome(&data[number_of_bytes_written],
+                                                      number_of_bytes_allowed) ;
+
+            this->UpdateWritePacing(write_result) ;
+
+            number_of_bytes_written += write_result ;
+            number_of_bytes_remaining = numberOfBytes - number_of_bytes_written ;
+
+            if (write_result == 0)
             {
-                break ;
+                this->WaitForOutputSpace() ;
+            }
+        }
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::WriteWithoutWaiting(const void* const buffer,
+                                                    const size_t      numberOfBytes)
+    {
+        if (this->GetWritePacingDelay(numberOfBytes) > 0)
+        {
+            return 0 ;
+        }
+
+        auto number_of_bytes_allowed = numberOfBytes ;
+
+        // GetWritePacingDelay() has refilled the token bucket.
+        if (mWritePacing and
+            (mPacingBytesPerSecond > 0))
+        {
+            number_of_bytes_allowed = std::min(numberOfBytes,
+                                               static_cast<size_t>(mPacingTokens)) ;
+        }
+
+        const auto write_result = this->WriteSome(buffer,
+                                                  number_of_bytes_allowed) ;
+
+        this->UpdateWritePacing(write_result) ;
+
+        return write_result ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::WriteCoalesced(const void* const buffer,
+                                               const size_t      numberOfBytes)
+    {
+        this->RethrowCoalescingError() ;
+
+        if (mCoalescingBufferSize == 0)
+        {
+            this->WriteAll(buffer, numberOfBytes) ;
+            return ;
+        }
+
+        if (mCoalescingBuffer.size() + numberOfBytes > mCoalescingBufferSize)
+        {
+            this->FlushCoalescedData() ;
+        }
+
+        // Data that does not fit into the empty buffer is written directly.
+        if (numberOfBytes >= mCoalescingBufferSize)
+        {
+            this->WriteAll(buffer, numberOfBytes) ;
+            return ;
+        }
+
+        const auto was_empty = mCoalescingBuffer.empty() ;
+        const auto data = static_cast<const char*>(buffer) ;
+
+        mCoalescingBuffer.insert(mCoalescingBuffer.end(),
+                                 data,
+                                 data + numberOfBytes) ;
+
+        if (mCoalescingBuffer.size() == mCoalescingBufferSize)
+        {
+            this->FlushCoalescedData() ;
+        }
+        else if (was_empty and
+                 (mCoalescingFlushDelay.count() > 0))
+        {
+            // Schedule the delayed write of the oldest byte in the buffer.
+            const std::lock_guard<std::mutex> coalescing_lock {mCoalescingMutex} ;
+            mCoalescingFlushTime = std::chrono::steady_clock::now() + mCoalescingFlushDelay ;
+            mCoalescingCondition.notify_one() ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::FlushCoalescedData()
+    {
+        if (mCoalescingBuffer.empty())
+        {
+            return ;
+        }
+
+        // Empty the buffer first, so that a failed write does not repeat
+        // the data it may have partially written.
+        std::vector<char> data {} ;
+        data.swap(mCoalescingBuffer) ;
+        mCoalescingBuffer.reserve(mCoalescingBufferSize) ;
+
+        this->WriteAll(data.data(), data.size()) ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::FlushCoalescedData(const std::chrono::steady_clock::time_point& deadline)
+    {
+        // Take the data out of the buffer, as FlushCoalescedData() does, and
+        // put back what could not be written in time.
+        std::vector<char> data {} ;
+        data.swap(mCoalescingBuffer) ;
+        mCoalescingBuffer.reserve(mCoalescingBufferSize) ;
+
+        size_t number_of_bytes_written = 0 ;
+
+        if (not data.empty())
+        {
+            this->WaitForInterFrameGap() ;
+        }
+
+        while (number_of_bytes_written < data.size())
+        {
+            const auto remaining_us = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count() ;
+
+            if (remaining_us <= 0)
+            {
+                mCoalescingBuffer.insert(mCoalescingBuffer.begin(),
+                                         data.begin() + number_of_bytes_written,
+                                         data.end()) ;
+                return false ;
             }
 
-            if ((write_result <= 0) and
-                (errno != EWOULDBLOCK))
+            const auto number_of_bytes_allowed = this->WaitForWritePacing(data.size() - number_of_bytes_written) ;
+
+            const auto write_result = this->WriteSome(&data[number_of_bytes_written],
+                                                      number_of_bytes_allowed) ;
+
+            this->UpdateWritePacing(write_result) ;
+            number_of_bytes_written += write_result ;
+
+            if (write_result == 0)
             {
-                throw std::runtime_error(std::strerror(errno)) ;
+                this->WaitForDevice(mOutputSettingsLock,
+                                    static_cast<int>(std::min(int64_t {mByteArrivalTimeDelta}, remaining_us))) ;
             }
         }
+
+        return true ;
     }
 
     inline
     void
-    SerialPort::Implementation::WriteByte(const unsigned char charBuffer)
+    SerialPort::Implementation::RethrowCoalescingError()
     {
-                // Throw an exception if the serial port is not open.
-        if (not this->IsOpen())
+        if (mCoalescingError)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            const auto coalescing_error = mCoalescingError ;
+            mCoalescingError = nullptr ;
+            std::rethrow_exception(coalescing_error) ;
         }
+    }
 
-        // Write the data to the serial port. Keep retrying if EAGAIN
-        // error is received and EWOULDBLOCK is not received.
-        ssize_t write_result = 0 ;
+    inline
+    void
+    SerialPort::Implementation::RunCoalescingThread()
+    {
+        std::unique_lock<std::mutex> coalescing_lock {mCoalescingMutex} ;
 
-        while (write_result <= 0)
+        while (not mCoalescingThreadStop)
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &charBuffer,
-                                           1) ;
+            if (mCoalescingFlushTime == std::chrono::steady_clock::time_point::max())
+            {
+                mCoalescingCondition.wait(coalescing_lock) ;
+                continue ;
+            }
 
-            if (write_result == 1)
+            if (std::chrono::steady_clock::now() < mCoalescingFlushTime)
             {
-                break ;
+                mCoalescingCondition.wait_until(coalescing_lock, mCoalescingFlushTime) ;
+                continue ;
             }
 
-            if ((write_result <= 0) and
-                (errno != EWOULDBLOCK))
+            mCoalescingFlushTime = std::chrono::steady_clock::time_point::max() ;
+
+            // Take the output direction lock as a Write*() call would. Writers
+            // schedule the next delayed write with that lock held, so it must
+            // not be taken while holding the coalescing lock.
+            coalescing_lock.unlock() ;
+
             {
-                throw std::runtime_error(std::strerror(errno)) ;
+                const auto output_lock = this->LockOutput() ;
+
+                try
+                {
+                    if (this->IsOpen())
+                    {
+                        this->FlushCoalescedData() ;
+                    }
+                }
+                catch (...)
+                {
+                    mCoalescingError = std::current_exception() ;
+                }
             }
+
+            coalescing_lock.lock() ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::StopCoalescingThread()
+    {
+        if (not mCoalescingThread.joinable())
+        {
+            return ;
         }
+
+        {
+            const std::lock_guard<std::mutex> coalescing_lock {mCoalescingMutex} ;
+            mCoalescingThreadStop = true ;
+            mCoalescingCondition.notify_one() ;
+        }
+
+        mCoalescingThread.join() ;
+        mCoalescingThreadStop = false ;
     }
 } // namespace LibSerial
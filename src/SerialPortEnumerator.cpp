@@ -0,0 +1,563 @@
+/******************************************************************************
+ * @file SerialPortEnumerator.cpp                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialPortEnumerator.h"
+#include "libserial/SerialPort.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
+namespace LibSerial
+{
+    namespace
+    {
+        /**
+         * @brief The maximum size of a sysfs attribute read by the enumerator.
+         */
+        constexpr size_t SYSFS_ATTRIBUTE_MAX_SIZE = 256 ;
+
+        /**
+         * @brief Reads a sysfs attribute file, stripping the trailing newline.
+         * @param path The path of the attribute file.
+         * @param value The contents of the attribute file.
+         * @return Returns true iff the attribute was read successfully.
+         */
+        bool
+        ReadSysfsString(const std::string& path,
+                        std::string&       value)
+        {
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            const auto fd = call_with_retry(open, path.c_str(), O_RDONLY | O_CLOEXEC) ;
+
+            if (fd < 0)
+            {
+                return false ;
+            }
+
+            char buffer[SYSFS_ATTRIBUTE_MAX_SIZE] {} ;
+            const auto read_result = call_with_retry(read, fd, buffer, sizeof(buffer) - 1) ;
+            close(fd) ;
+
+            if (read_result < 0)
+            {
+                return false ;
+            }
+
+            value.assign(buffer, static_cast<size_t>(read_result)) ;
+
+            while ((not value.empty()) and
+                   ((value.back() == '\n') or (value.back() == ' ')))
+            {
+                value.pop_back() ;
+            }
+
+            return true ;
+        }
+
+        /**
+         * @brief Reads a hexadecimal sysfs attribute, (e.g. idVendor).
+         * @param path The path of the attribute file.
+         * @param value The value read from the file.
+         * @return Returns true iff the value was read successfully.
+         */
+        bool
+        ReadSysfsHex(const std::string& path,
+                     uint16_t&          value)
+        {
+            std::string value_string {} ;
+
+            if (not ReadSysfsString(path, value_string) or value_string.empty())
+            {
+                return false ;
+            }
+
+            char* end = nullptr ;
+            const auto result = std::strtoul(value_string.c_str(), &end, 16) ;
+
+            if (*end != '\0')
+            {
+                return false ;
+            }
+
+            value = static_cast<uint16_t>(result) ;
+            return true ;
+        }
+
+        /**
+         * @brief Resolves all symbolic links in a path.
+         * @param path The path to be resolved.
+         * @return Returns the canonical path, or an empty string if the path
+         *         does not exist.
+         */
+        std::string
+        ResolvePath(const std::string& path)
+        {
+            char resolved_path[PATH_MAX] {} ;
+
+            if (realpath(path.c_str(), resolved_path) == nullptr)
+            {
+                return {} ;
+            }
+
+            return resolved_path ;
+        }
+
+        /**
+         * @brief Gets the name of the target of a symbolic link, (e.g. the
+         *        driver name from a sysfs "driver" link).
+         * @param path The path of the symbolic link.
+         * @return Returns the last path component of the link target, or an
+         *         empty string if path is not a symbolic link.
+         */
+        std::string
+        ReadLinkBaseName(const std::string& path)
+        {
+            char link_target[PATH_MAX] {} ;
+            const auto length = readlink(path.c_str(), link_target, sizeof(link_target) - 1) ;
+
+            if (length <= 0)
+            {
+                return {} ;
+            }
+
+            const std::string target(link_target, static_cast<size_t>(length)) ;
+            return target.substr(target.find_last_of('/') + 1) ;
+        }
+
+        /**
+         * @brief Orders device names so that numeric suffixes compare by
+         *        value, (e.g. ttyS2 before ttyS10).
+         */
+        bool
+        CompareDeviceNames(const SerialPortInfo& lhs,
+                           const SerialPortInfo& rhs)
+        {
+            const auto lhs_digits = lhs.name.find_last_not_of("0123456789") + 1 ;
+            const auto rhs_digits = rhs.name.find_last_not_of("0123456789") + 1 ;
+
+            const auto lhs_prefix = lhs.name.substr(0, lhs_digits) ;
+            const auto rhs_prefix = rhs.name.substr(0, rhs_digits) ;
+
+            if (lhs_prefix != rhs_prefix)
+            {
+                return lhs_prefix < rhs_prefix ;
+            }
+
+            const auto lhs_suffix = lhs.name.substr(lhs_digits) ;
+            const auto rhs_suffix = rhs.name.substr(rhs_digits) ;
+
+            if (lhs_suffix.size() != rhs_suffix.size())
+            {
+                return lhs_suffix.size() < rhs_suffix.size() ;
+            }
+
+            return lhs_suffix < rhs_suffix ;
+        }
+
+        /**
+         * @brief Gets the entry names of a directory, excluding "." and "..".
+         * @param path The path of the directory.
+         * @return Returns the entry names, or an empty std::vector if the
+         *         directory cannot be read.
+         */
+        std::vector<std::string>
+        ListDirectory(const std::string& path)
+        {
+            std::vector<std::string> entries {} ;
+            auto* directory = opendir(path.c_str()) ;
+
+            if (directory == nullptr)
+            {
+                return entries ;
+            }
+
+            while (const auto* entry = readdir(directory))
+            {
+                const std::string entry_name = entry->d_name ;
+
+                if ((entry_name != ".") and (entry_name != ".."))
+                {
+                    entries.push_back(entry_name) ;
+                }
+            }
+
+            closedir(directory) ;
+            return entries ;
+        }
+    } // namespace
+
+    /**
+     * @brief SerialPortEnumerator::Implementation is the
+     *        SerialPortEnumerator implementation class.
+     */
+    class SerialPortEnumerator::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param sysfsRoot The mount point of the sysfs file system.
+         * @param devRoot The directory containing the device files.
+         */
+        Implementation(const std::string& sysfsRoot,
+                       const std::string& devRoot) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Enables resolution of the /dev/serial/by-id paths.
+         * @param resolveByIdPaths True to resolve by-id paths.
+         */
+        void SetResolveByIdPaths(const bool resolveByIdPaths) ;
+
+        /**
+         * @brief Enables probing of the device files with TIOCGSERIAL.
+         * @param probeDevices True to probe the device files.
+         */
+        void SetProbeDevices(const bool probeDevices) ;
+
+        /**
+         * @brief Gets the serial ports present in the system, sorted by name.
+         * @return Returns a std::vector with the metadata of each serial port.
+         */
+        std::vector<SerialPortInfo> GetSerialPorts() const ;
+
+        /**
+         * @brief Gets the metadata of a single serial port.
+         * @param name The kernel name of the serial port.
+         * @param serialPortInfo The metadata of the serial port.
+         * @return Returns true iff name refers to a serial port device.
+         */
+        bool GetSerialPortInfo(const std::string& name,
+                               SerialPortInfo&    serialPortInfo) const ;
+
+    private:
+
+        /**
+         * @brief Fills in the USB metadata of a serial port by walking up
+         *        the sysfs device hierarchy to the USB device directory.
+         * @param serialPortInfo The metadata of the serial port.
+         */
+        void ReadUsbAttributes(SerialPortInfo& serialPortInfo) const ;
+
+        /**
+         * @brief Finds the /dev/serial/by-id link pointing at a device file.
+         * @param devicePath The path of the device file.
+         * @return Returns the by-id path, or an empty string if none exists.
+         */
+        std::string FindByIdPath(const std::string& devicePath) const ;
+
+        /**
+         * @brief Opens a device file and queries it with TIOCGSERIAL.
+         * @param devicePath The path of the device file.
+         * @return Returns true iff the device responds as a serial port.
+         */
+        bool ProbeDevice(const std::string& devicePath) const ;
+
+        /**
+         * @brief The mount point of the sysfs file system.
+         */
+        std::string mSysfsRoot {} ;
+
+        /**
+         * @brief The directory containing the device files.
+         */
+        std::string mDevRoot {} ;
+
+        /**
+         * @brief True iff /dev/serial/by-id paths are resolved.
+         */
+        bool mResolveByIdPaths = false ;
+
+        /**
+         * @brief True iff device files are opened and probed.
+         */
+        bool mProbeDevices = false ;
+    } ;
+
+    SerialPortEnumerator::SerialPortEnumerator(const std::string& sysfsRoot,
+                                               const std::string& devRoot)
+        : mImpl(new Implementation(sysfsRoot, devRoot))
+    {
+        /* Empty */
+    }
+
+    SerialPortEnumerator::~SerialPortEnumerator() = default ;
+
+    SerialPortEnumerator::SerialPortEnumerator(SerialPortEnumerator&& otherSerialPortEnumerator) :
+        mImpl(std::move(otherSerialPortEnumerator.mImpl))
+    {
+        // empty
+    }
+
+    SerialPortEnumerator&
+    SerialPortEnumerator::operator=(SerialPortEnumerator&& otherSerialPortEnumerator)
+    {
+        mImpl = std::move(otherSerialPortEnumerator.mImpl) ;
+        return *this ;
+    }
+
+    void
+    SerialPortEnumerator::SetResolveByIdPaths(const bool resolveByIdPaths)
+    {
+        mImpl->SetResolveByIdPaths(resolveByIdPaths) ;
+    }
+
+    void
+    SerialPortEnumerator::SetProbeDevices(const bool probeDevices)
+    {
+        mImpl->SetProbeDevices(probeDevices) ;
+    }
+
+    std::vector<SerialPortInfo>
+    SerialPortEnumerator::GetSerialPorts() const
+    {
+        return mImpl->GetSerialPorts() ;
+    }
+
+    bool
+    SerialPortEnumerator::GetSerialPortInfo(const std::string& name,
+                                            SerialPortInfo&    serialPortInfo) const
+    {
+        return mImpl->GetSerialPortInfo(name, serialPortInfo) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    SerialPortEnumerator::Implementation::Implementation(const std::string& sysfsRoot,
+                                                         const std::string& devRoot)
+        : mSysfsRoot(sysfsRoot)
+        , mDevRoot(devRoot)
+    {
+        /* Empty */
+    }
+
+    inline
+    void
+    SerialPortEnumerator::Implementation::SetResolveByIdPaths(const bool resolveByIdPaths)
+    {
+        mResolveByIdPaths = resolveByIdPaths ;
+    }
+
+    inline
+    void
+    SerialPortEnumerator::Implementation::SetProbeDevices(const bool probeDevices)
+    {
+        mProbeDevices = probeDevices ;
+    }
+
+    inline
+    std::vector<SerialPortInfo>
+    SerialPortEnumerator::Implementation::GetSerialPorts() const
+    {
+        std::vector<SerialPortInfo> serial_ports {} ;
+
+        for (const auto& name : ListDirectory(mSysfsRoot + "/class/tty"))
+        {
+            SerialPortInfo serial_port_info {} ;
+
+            if (this->GetSerialPortInfo(name, serial_port_info))
+            {
+                serial_ports.push_back(serial_port_info) ;
+            }
+        }
+
+        std::sort(serial_ports.begin(), serial_ports.end(), CompareDeviceNames) ;
+        return serial_ports ;
+    }
+
+    inline
+    bool
+    SerialPortEnumerator::Implementation::GetSerialPortInfo(const std::string& name,
+                                                            SerialPortInfo&    serialPortInfo) const
+    {
+        const auto class_path = mSysfsRoot + "/class/tty/" + name ;
+
+        // Virtual terminals, pseudo terminals, etc. have no backing device.
+        const auto sysfs_path = ResolvePath(class_path + "/device") ;
+
+        if (sysfs_path.empty())
+        {
+            return false ;
+        }
+
+        // The serial8250 driver registers placeholder ports for which no
+        // UART has been detected. Their type attribute is PORT_UNKNOWN (0).
+        std::string port_type {} ;
+
+        if (ReadSysfsString(class_path + "/type", port_type) and
+            (port_type == "0"))
+        {
+            return false ;
+        }
+
+        SerialPortInfo serial_port_info {} ;
+        serial_port_info.name       = name ;
+        serial_port_info.devicePath = mDevRoot + "/" + name ;
+        serial_port_info.sysfsPath  = sysfs_path ;
+        serial_port_info.driver     = ReadLinkBaseName(sysfs_path + "/driver") ;
+        serial_port_info.subsystem  = ReadLinkBaseName(sysfs_path + "/subsystem") ;
+
+        this->ReadUsbAttributes(serial_port_info) ;
+
+        if (mResolveByIdPaths)
+        {
+            serial_port_info.byIdPath = this->FindByIdPath(serial_port_info.devicePath) ;
+        }
+
+        if (mProbeDevices and
+            (not this->ProbeDevice(serial_port_info.devicePath)))
+        {
+            return false ;
+        }
+
+        serialPortInfo = serial_port_info ;
+        return true ;
+    }
+
+    inline
+    void
+    SerialPortEnumerator::Implementation::ReadUsbAttributes(SerialPortInfo& serialPortInfo) const
+    {
+        const auto sysfs_root = ResolvePath(mSysfsRoot) ;
+        auto device_path = serialPortInfo.sysfsPath ;
+
+        // The tty device is a child of a USB interface, which in turn is a
+        // child of the USB device holding the descriptor attributes.
+        while ((device_path.size() > sysfs_root.size()) and
+               (device_path.compare(0, sysfs_root.size(), sysfs_root) == 0))
+        {
+            if (ReadSysfsHex(device_path + "/idVendor", serialPortInfo.usbVendorId) and
+                ReadSysfsHex(device_path + "/idProduct", serialPortInfo.usbProductId))
+            {
+                serialPortInfo.isUsbDevice = true ;
+                ReadSysfsString(device_path + "/serial", serialPortInfo.usbSerialNumber) ;
+                ReadSysfsString(device_path + "/manufacturer", serialPortInfo.manufacturer) ;
+                ReadSysfsString(device_path + "/product", serialPortInfo.product) ;
+                return ;
+            }
+
+            device_path.erase(device_path.find_last_of('/')) ;
+        }
+
+        serialPortInfo.usbVendorId = 0 ;
+        serialPortInfo.usbProductId = 0 ;
+    }
+
+    inline
+    std::string
+    SerialPortEnumerator::Implementation::FindByIdPath(const std::string& devicePath) const
+    {
+        const auto by_id_directory = mDevRoot + "/serial/by-id" ;
+        const auto resolved_device_path = ResolvePath(devicePath) ;
+
+        if (resolved_device_path.empty())
+        {
+            return {} ;
+        }
+
+        for (const auto& link_name : ListDirectory(by_id_directory))
+        {
+            const auto link_path = by_id_directory + "/" + link_name ;
+
+            if (ResolvePath(link_path) == resolved_device_path)
+            {
+                return link_path ;
+            }
+        }
+
+        return {} ;
+    }
+
+    inline
+    bool
+    SerialPortEnumerator::Implementation::ProbeDevice(const std::string& devicePath) const
+    {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const auto file_desc = call_with_retry(open,
+                                               devicePath.c_str(),
+                                               O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC) ;
+
+        if (file_desc < 0)
+        {
+            return false ;
+        }
+
+#ifdef __linux__
+        serial_struct serial_port_info {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        const auto result = call_with_retry(ioctl,
+                                            file_desc,
+                                            TIOCGSERIAL,
+                                            &serial_port_info) ;
+#else
+        const auto result = isatty(file_desc) ? 0 : -1 ;
+#endif
+
+        close(file_desc) ;
+        return (result != -1) ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,1197 @@
+/******************************************************************************
+ * @file SerialReliableLink.cpp                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialReliableLink.h"
+#include "libserial/SerialChecksum.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace LibSerial
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock ;
+
+        /**
+         * @brief The byte delimiting frames.
+         */
+        constexpr uint8_t FRAME_DELIMITER = 0x7E ;
+
+        /**
+         * @brief The byte preceding an escaped byte, which is sent XORed
+         *        with FRAME_ESCAPE_MASK.
+         */
+        constexpr uint8_t FRAME_ESCAPE = 0x7D ;
+        constexpr uint8_t FRAME_ESCAPE_MASK = 0x20 ;
+
+        /**
+         * @brief The software flow control characters, which are escaped.
+         */
+        constexpr uint8_t XON = 0x11 ;
+        constexpr uint8_t XOFF = 0x13 ;
+
+        /**
+         * @brief The frame types.
+         */
+        constexpr uint8_t FRAME_TYPE_DATA = 1 ;
+        constexpr uint8_t FRAME_TYPE_ACKNOWLEDGEMENT = 2 ;
+
+        /**
+         * @brief The frame flag marking the last frame of a message.
+         */
+        constexpr uint8_t FRAME_FLAG_END_OF_MESSAGE = 0x01 ;
+
+        /**
+         * @brief The layout of the frame header: type, flags, sequence
+         *        number, next expected sequence number, selective
+         *        acknowledgement bits and payload size, in little endian.
+         *        The header and payload are followed by their CRC-32.
+         */
+        constexpr size_t HEADER_TYPE_OFFSET = 0 ;
+        constexpr size_t HEADER_FLAGS_OFFSET = 1 ;
+        constexpr size_t HEADER_SEQUENCE_OFFSET = 2 ;
+        constexpr size_t HEADER_ACKNOWLEDGEMENT_OFFSET = 4 ;
+        constexpr size_t HEADER_SELECTIVE_ACKNOWLEDGEMENT_OFFSET = 6 ;
+        constexpr size_t HEADER_LENGTH_OFFSET = 14 ;
+        constexpr size_t HEADER_SIZE = 16 ;
+        constexpr size_t CRC_SIZE = 4 ;
+
+        /**
+         * @brief The size of the largest valid frame before byte stuffing.
+         */
+        constexpr size_t FRAME_SIZE_MAXIMUM = HEADER_SIZE + RELIABLE_LINK_PAYLOAD_MAXIMUM + CRC_SIZE ;
+
+        /**
+         * @brief The smallest retransmission timeout variance term in
+         *        microseconds, as the clock granularity G of RFC 6298.
+         */
+        constexpr int64_t RTT_VARIATION_MINIMUM_US = 1000 ;
+
+        const std::string ERR_MSG_NOT_ACKNOWLEDGED = "The peer stopped acknowledging frames." ;
+
+        /**
+         * @brief Stores an unsigned value in little endian byte order.
+         */
+        void StoreLittleEndian(uint8_t* const data,
+                               uint64_t       value,
+                               const size_t   size)
+        {
+            for (size_t i = 0 ; i < size ; i++)
+            {
+                data[i] = static_cast<uint8_t>(value) ;
+                value >>= 8 ;
+            }
+        }
+
+        /**
+         * @brief Loads an unsigned value in little endian byte order.
+         */
+        uint64_t LoadLittleEndian(const uint8_t* const data,
+                                  const size_t         size)
+        {
+            uint64_t value = 0 ;
+
+            for (size_t i = size ; i > 0 ; i--)
+            {
+                value = (value << 8) | data[i - 1] ;
+            }
+
+            return value ;
+        }
+
+        /**
+         * @brief Appends data to a frame, escaping the bytes with a special
+         *        meaning on the link.
+         */
+        void AppendEscaped(DataBuffer&          frame,
+                           const uint8_t* const data,
+                           const size_t         size)
+        {
+            for (size_t i = 0 ; i < size ; i++)
+            {
+                const auto byte = data[i] ;
+
+                if ((byte == FRAME_DELIMITER) or
+                    (byte == FRAME_ESCAPE) or
+                    (byte == XON) or
+                    (byte == XOFF))
+                {
+                    frame.push_back(FRAME_ESCAPE) ;
+                    frame.push_back(byte ^ FRAME_ESCAPE_MASK) ;
+                }
+                else
+                {
+                    frame.push_back(byte) ;
+                }
+            }
+        }
+    } // namespace
+
+    /**
+     * @brief SerialReliableLink::Implementation is the SerialReliableLink
+     *        implementation class.
+     */
+    class SerialReliableLink::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param serialPort The serial port used for the link.
+         * @param reliableLinkOptions The options of the link.
+         */
+        Implementation(SerialPort&                serialPort,
+                       const ReliableLinkOptions& reliableLinkOptions) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Queues a message and writes the frames the window admits.
+         * @param message The message.
+         */
+        void Send(const DataBuffer& message) ;
+
+        /**
+         * @brief Receives the next message.
+         * @param msTimeout The maximum time to wait in milliseconds, or 0 to
+         *        wait indefinitely.
+         * @return Returns the message.
+         */
+        DataBuffer Receive(const size_t msTimeout) ;
+
+        /**
+         * @brief Gets the number of messages available.
+         * @return Returns the number of messages available.
+         */
+        size_t GetNumberOfMessagesAvailable() const ;
+
+        /**
+         * @brief Processes events until all messages sent are acknowledged.
+         * @param msTimeout The maximum time to wait in milliseconds, or 0 to
+         *        wait indefinitely.
+         */
+        void Flush(const size_t msTimeout) ;
+
+        /**
+         * @brief Processes events until a message is available or the
+         *        timeout has elapsed.
+         * @param msTimeout The maximum time to wait in milliseconds.
+         */
+        void ProcessEvents(const size_t msTimeout) ;
+
+        /**
+         * @brief Gets the counters maintained by the link.
+         * @return Returns a copy of the counters.
+         */
+        ReliableLinkStatistics GetStatistics() const ;
+
+        /**
+         * @brief Resets the counters maintained by the link to zero.
+         */
+        void ResetStatistics() ;
+
+    private:
+
+        /**
+         * @brief A queued data frame that has not been acknowledged
+         *        cumulatively yet.
+         */
+        struct OutgoingFrame
+        {
+            uint16_t sequence {0} ;
+            uint8_t flags {0} ;
+            DataBuffer payload {} ;
+            Clock::time_point sendTime {} ;
+            uint64_t transmitOrder {0} ;
+            size_t transmissions {0} ;
+            bool isAcknowledged {false} ;
+            bool isLost {false} ;
+        } ;
+
+        /**
+         * @brief A slot of the reorder buffer.
+         */
+        struct ReceivedFrame
+        {
+            bool isReceived {false} ;
+            uint8_t flags {0} ;
+            DataBuffer payload {} ;
+        } ;
+
+        /**
+         * @brief Processes events until isDone() returns true or the end
+         *        time has been reached.
+         * @param endTime The time to return at the latest.
+         * @param isDone Determines if the caller's condition is met.
+         */
+        void ProcessUntil(const Clock::time_point&     endTime,
+                          const std::function<bool()>& isDone) ;
+
+        /**
+         * @brief Reads the available data from the serial port and handles
+         *        the complete frames.
+         */
+        void ReadFrames() ;
+
+        /**
+         * @brief Checks a received frame and handles its acknowledgement
+         *        and data.
+         * @param receiveTime The time the frame was read.
+         */
+        void HandleFrame(const Clock::time_point& receiveTime) ;
+
+        /**
+         * @brief Marks the frames acknowledged by the peer, updates the
+         *        round trip time and marks the frames sent before an
+         *        acknowledged one as lost.
+         * @param acknowledgement The next sequence number expected by the
+         *        peer.
+         * @param selectiveAcknowledgement The bits of the frames received
+         *        by the peer after the next expected one.
+         * @param receiveTime The time the acknowledgement was read.
+         */
+        void HandleAcknowledgement(const uint16_t           acknowledgement,
+                                   const uint64_t           selectiveAcknowledgement,
+                                   const Clock::time_point& receiveTime) ;
+
+        /**
+         * @brief Stores a received data frame in the reorder buffer and
+         *        reassembles the messages completed in sequence.
+         * @param sequence The sequence number of the frame.
+         * @param flags The flags of the frame.
+         * @param payload The payload of the frame.
+         * @param payloadSize The size of the payload.
+         */
+        void HandleDataFrame(const uint16_t       sequence,
+                             const uint8_t        flags,
+                             const uint8_t* const payload,
+                             const size_t         payloadSize) ;
+
+        /**
+         * @brief Marks the frames whose retransmission timeout has expired
+         *        as lost and backs off the timeout.
+         * @param currentTime The current time.
+         */
+        void ExpireRetransmitTimers(const Clock::time_point& currentTime) ;
+
+        /**
+         * @brief Writes the new and lost frames within the window, or an
+         *        acknowledgement if one is due and no data frame carries it.
+         */
+        void WriteFrames() ;
+
+        /**
+         * @brief Appends a frame carrying the current acknowledgement.
+         * @param output The buffer the frame is appended to.
+         * @param type The frame type.
+         * @param flags The frame flags.
+         * @param sequence The sequence number of the frame.
+         * @param payload The payload of the frame.
+         */
+        void AppendFrame(DataBuffer&       output,
+                         const uint8_t     type,
+                         const uint8_t     flags,
+                         const uint16_t    sequence,
+                         const DataBuffer& payload) ;
+
+        /**
+         * @brief Gets the selective acknowledgement bits, bit i of which is
+         *        set if the frame following the next expected one by i + 1
+         *        has been received.
+         * @return Returns the selective acknowledgement bits.
+         */
+        uint64_t GetSelectiveAcknowledgement() const ;
+
+        /**
+         * @brief Updates the smoothed round trip time and the retransmission
+         *        timeout as in RFC 6298.
+         * @param rttUs The measured round trip time in microseconds.
+         */
+        void UpdateRetransmitTimeout(const int64_t rttUs) ;
+
+        /**
+         * @brief Gets the earliest time a retransmission timer expires.
+         * @return Returns the time, or time_point::max() if no frame is
+         *         awaiting an acknowledgement.
+         */
+        Clock::time_point GetNextTimerTime() const ;
+
+        /**
+         * @brief Gets the number of frames that have been written at least
+         *        once, which lead the outgoing frames.
+         * @return Returns the number of frames.
+         */
+        size_t GetNumberOfTransmittedFrames() const ;
+
+        /**
+         * The serial port used for the link.
+         */
+        SerialPort* mSerialPort ;
+
+        /**
+         * The options of the link.
+         */
+        ReliableLinkOptions mOptions ;
+
+        /**
+         * The data frames that have not been acknowledged cumulatively, in
+         * sequence. The first windowSize frames may be written.
+         */
+        std::deque<OutgoingFrame> mOutgoingFrames {} ;
+
+        /**
+         * The sequence number of the next queued data frame.
+         */
+        uint16_t mNextSequence = 0 ;
+
+        /**
+         * The order of the next frame transmission, which tells the frames
+         * sent before an acknowledged one.
+         */
+        uint64_t mNextTransmitOrder = 0 ;
+
+        /**
+         * The frames received after a gap, indexed by sequence number.
+         */
+        std::array<ReceivedFrame, RELIABLE_LINK_WINDOW_MAXIMUM> mReorderBuffer {} ;
+
+        /**
+         * The sequence number of the next data frame expected.
+         */
+        uint16_t mReceiveNext = 0 ;
+
+        /**
+         * Whether a received data frame has not been acknowledged yet.
+         */
+        bool mIsAcknowledgementPending = false ;
+
+        /**
+         * The payloads of the message being reassembled.
+         */
+        DataBuffer mPartialMessage {} ;
+
+        /**
+         * The messages received and not returned by Receive() yet.
+         */
+        std::deque<DataBuffer> mReceivedMessages {} ;
+
+        /**
+         * The unstuffed bytes of the frame being received.
+         */
+        DataBuffer mFrameBuffer {} ;
+
+        /**
+         * Whether a frame delimiter has been seen since the last error, so
+         * that the following bytes belong to a frame.
+         */
+        bool mIsInFrame = false ;
+
+        /**
+         * Whether the previous byte was FRAME_ESCAPE.
+         */
+        bool mIsEscaped = false ;
+
+        /**
+         * Whether the round trip time has been measured.
+         */
+        bool mHasRttSample = false ;
+
+        /**
+         * The smoothed round trip time in microseconds.
+         */
+        int64_t mSmoothedRttUs = 0 ;
+
+        /**
+         * The round trip time variation in microseconds.
+         */
+        int64_t mRttVariationUs = 0 ;
+
+        /**
+         * The retransmission timeout in microseconds.
+         */
+        int64_t mRetransmitTimeoutUs = 0 ;
+
+        /**
+         * The counters maintained by the link.
+         */
+        ReliableLinkStatistics mStatistics {} ;
+    } ;
+
+    SerialReliableLink::SerialReliableLink(SerialPort&                serialPort,
+                                           const ReliableLinkOptions& reliableLinkOptions)
+        : mImpl(new Implementation(serialPort, reliableLinkOptions))
+    {
+        /* Empty */
+    }
+
+    SerialReliableLink::~SerialReliableLink() = default ;
+
+    SerialReliableLink::SerialReliableLink(SerialReliableLink&& otherSerialReliableLink) :
+        mImpl(std::move(otherSerialReliableLink.mImpl))
+    {
+        // empty
+    }
+
+    SerialReliableLink&
+    SerialReliableLink::operator=(SerialReliableLink&& otherSerialReliableLink)
+    {
+        mImpl = std::move(otherSerialReliableLink.mImpl) ;
+        return *this ;
+    }
+
+    void
+    SerialReliableLink::Send(const DataBuffer& message)
+    {
+        mImpl->Send(message) ;
+    }
+
+    DataBuffer
+    SerialReliableLink::Receive(const size_t msTimeout)
+    {
+        return mImpl->Receive(msTimeout) ;
+    }
+
+    size_t
+    SerialReliableLink::GetNumberOfMessagesAvailable() const
+    {
+        return mImpl->GetNumberOfMessagesAvailable() ;
+    }
+
+    void
+    SerialReliableLink::Flush(const size_t msTimeout)
+    {
+        mImpl->Flush(msTimeout) ;
+    }
+
+    void
+    SerialReliableLink::ProcessEvents(const size_t msTimeout)
+    {
+        mImpl->ProcessEvents(msTimeout) ;
+    }
+
+    ReliableLinkStatistics
+    SerialReliableLink::GetStatistics() const
+    {
+        return mImpl->GetStatistics() ;
+    }
+
+    void
+    SerialReliableLink::ResetStatistics()
+    {
+        mImpl->ResetStatistics() ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    SerialReliableLink::Implementation::Implementation(SerialPort&                serialPort,
+                                                       const ReliableLinkOptions& reliableLinkOptions)
+        : mSerialPort(&serialPort)
+        , mOptions(reliableLinkOptions)
+    {
+        if ((mOptions.windowSize == 0) or
+            (mOptions.windowSize > RELIABLE_LINK_WINDOW_MAXIMUM))
+        {
+            throw std::invalid_argument {"The window of a reliable link must hold 1 to 64 frames."} ;
+        }
+
+        if ((mOptions.maximumPayloadSize == 0) or
+            (mOptions.maximumPayloadSize > RELIABLE_LINK_PAYLOAD_MAXIMUM))
+        {
+            throw std::invalid_argument {"The payload of a reliable link frame must hold 1 to 4096 bytes."} ;
+        }
+
+        if ((mOptions.msMinimumRetransmitTimeout == 0) or
+            (mOptions.msMinimumRetransmitTimeout > mOptions.msMaximumRetransmitTimeout))
+        {
+            throw std::invalid_argument {"The retransmission timeout bounds of a reliable link are invalid."} ;
+        }
+
+        mRetransmitTimeoutUs = static_cast<int64_t>(std::min(std::max(mOptions.msInitialRetransmitTimeout,
+                                                                      mOptions.msMinimumRetransmitTimeout),
+                                                             mOptions.msMaximumRetransmitTimeout)) * MICROSECONDS_PER_MS ;
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::Send(const DataBuffer& message)
+    {
+        const auto maximum_queued_frames = 2 * mOptions.windowSize ;
+        size_t offset = 0 ;
+
+        // An empty message is sent as one frame without payload.
+        do
+        {
+            if (mOutgoingFrames.size() >= maximum_queued_frames)
+            {
+                this->ProcessUntil(Clock::time_point::max(), [this, maximum_queued_frames]()
+                {
+                    return mOutgoingFrames.size() < maximum_queued_frames ;
+                }) ;
+            }
+
+            const auto payload_size = std::min(mOptions.maximumPayloadSize,
+                                               message.size() - offset) ;
+
+            OutgoingFrame outgoing_frame {} ;
+            outgoing_frame.sequence = mNextSequence++ ;
+            outgoing_frame.payload.assign(message.begin() + offset,
+                                          message.begin() + offset + payload_size) ;
+
+            offset += payload_size ;
+
+            if (offset == message.size())
+            {
+                outgoing_frame.flags = FRAME_FLAG_END_OF_MESSAGE ;
+            }
+
+            mOutgoingFrames.push_back(std::move(outgoing_frame)) ;
+        }
+        while (offset < message.size()) ;
+
+        mStatistics.messagesSent++ ;
+
+        // Write the frames the window admits without waiting.
+        this->ProcessUntil(Clock::now(), []()
+        {
+            return true ;
+        }) ;
+    }
+
+    inline
+    DataBuffer
+    SerialReliableLink::Implementation::Receive(const size_t msTimeout)
+    {
+        if (mReceivedMessages.empty())
+        {
+            const auto end_time = (msTimeout == 0) ?
+                                  Clock::time_point::max() :
+                                  Clock::now() + std::chrono::milliseconds(msTimeout) ;
+
+            this->ProcessUntil(end_time, [this]()
+            {
+                return not mReceivedMessages.empty() ;
+            }) ;
+
+            if (mReceivedMessages.empty())
+            {
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+        }
+
+        auto message = std::move(mReceivedMessages.front()) ;
+        mReceivedMessages.pop_front() ;
+
+        return message ;
+    }
+
+    inline
+    size_t
+    SerialReliableLink::Implementation::GetNumberOfMessagesAvailable() const
+    {
+        return mReceivedMessages.size() ;
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::Flush(const size_t msTimeout)
+    {
+        const auto end_time = (msTimeout == 0) ?
+                              Clock::time_point::max() :
+                              Clock::now() + std::chrono::milliseconds(msTimeout) ;
+
+        this->ProcessUntil(end_time, [this]()
+        {
+            return mOutgoingFrames.empty() ;
+        }) ;
+
+        if (not mOutgoingFrames.empty())
+        {
+            throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::ProcessEvents(const size_t msTimeout)
+    {
+        const auto end_time = Clock::now() +
+                              std::chrono::milliseconds(msTimeout) ;
+
+        this->ProcessUntil(end_time, [this]()
+        {
+            return not mReceivedMessages.empty() ;
+        }) ;
+    }
+
+    inline
+    ReliableLinkStatistics
+    SerialReliableLink::Implementation::GetStatistics() const
+    {
+        auto statistics = mStatistics ;
+        statistics.smoothedRttUs = static_cast<size_t>(mSmoothedRttUs) ;
+        statistics.retransmitTimeoutUs = static_cast<size_t>(mRetransmitTimeoutUs) ;
+
+        return statistics ;
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::ResetStatistics()
+    {
+        mStatistics = ReliableLinkStatistics {} ;
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::ProcessUntil(const Clock::time_point&     endTime,
+                                                     const std::function<bool()>& isDone)
+    {
+        while (true)
+        {
+            this->ReadFrames() ;
+
+            const auto current_time = Clock::now() ;
+            this->ExpireRetransmitTimers(current_time) ;
+            this->WriteFrames() ;
+
+            if (isDone() or
+                (current_time >= endTime))
+            {
+                return ;
+            }
+
+            // Wait for data, or until the next retransmission timer expires.
+            const auto wake_time = std::min(endTime, this->GetNextTimerTime()) ;
+
+            int poll_timeout = -1 ;
+
+            if (wake_time != Clock::time_point::max())
+            {
+                const auto wait_time = std::chrono::duration_cast<std::chrono::microseconds>(wake_time - current_time) ;
+                poll_timeout = static_cast<int>((std::max(wait_time.count(), int64_t {0}) + MICROSECONDS_PER_MS - 1) /
+                                                MICROSECONDS_PER_MS) ;
+            }
+
+            pollfd poll_fd {mSerialPort->GetFileDescriptor(), POLLIN, 0} ;
+            call_with_retry(poll, &poll_fd, 1, poll_timeout) ;
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::ReadFrames()
+    {
+        const auto number_of_bytes_available = mSerialPort->GetNumberOfBytesAvailable() ;
+
+        if (number_of_bytes_available <= 0)
+        {
+            return ;
+        }
+
+        DataBuffer received_data {} ;
+
+        try
+        {
+            mSerialPort->Read(received_data,
+                              static_cast<size_t>(number_of_bytes_available),
+                              1) ;
+        }
+        catch (const ReadTimeout&)
+        {
+            // The data read before the timeout is kept in received_data.
+        }
+
+        const auto receive_time = Clock::now() ;
+
+        for (const auto byte : received_data)
+        {
+            if (byte == FRAME_DELIMITER)
+            {
+                // Consecutive delimiters enclose no frame.
+                if (mIsInFrame and
+                    (not mFrameBuffer.empty()))
+                {
+                    this->HandleFrame(receive_time) ;
+                }
+
+                mFrameBuffer.clear() ;
+                mIsInFrame = true ;
+                mIsEscaped = false ;
+            }
+            else if (not mIsInFrame)
+            {
+                // Discard the bytes up to the next delimiter.
+                continue ;
+            }
+            else if (byte == FRAME_ESCAPE)
+            {
+                mIsEscaped = true ;
+            }
+            else if (mFrameBuffer.size() == FRAME_SIZE_MAXIMUM)
+            {
+                // A lost delimiter merged frames beyond the largest size.
+                mStatistics.corruptedFrames++ ;
+                mFrameBuffer.clear() ;
+                mIsInFrame = false ;
+            }
+            else
+            {
+                mFrameBuffer.push_back(mIsEscaped ? (byte ^ FRAME_ESCAPE_MASK) : byte) ;
+                mIsEscaped = false ;
+            }
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::HandleFrame(const Clock::time_point& receiveTime)
+    {
+        const auto frame_size = mFrameBuffer.size() ;
+
+        if ((frame_size < HEADER_SIZE + CRC_SIZE) or
+            (LoadLittleEndian(&mFrameBuffer[HEADER_LENGTH_OFFSET], 2) != frame_size - HEADER_SIZE - CRC_SIZE) or
+            (LoadLittleEndian(&mFrameBuffer[frame_size - CRC_SIZE], CRC_SIZE) != ComputeCrc32(mFrameBuffer.data(), frame_size - CRC_SIZE)))
+        {
+            mStatistics.corruptedFrames++ ;
+            return ;
+        }
+
+        const auto frame_type = mFrameBuffer[HEADER_TYPE_OFFSET] ;
+
+        if ((frame_type != FRAME_TYPE_DATA) and
+            (frame_type != FRAME_TYPE_ACKNOWLEDGEMENT))
+        {
+            mStatistics.corruptedFrames++ ;
+            return ;
+        }
+
+        mStatistics.framesReceived++ ;
+
+        this->HandleAcknowledgement(static_cast<uint16_t>(LoadLittleEndian(&mFrameBuffer[HEADER_ACKNOWLEDGEMENT_OFFSET], 2)),
+                                    LoadLittleEndian(&mFrameBuffer[HEADER_SELECTIVE_ACKNOWLEDGEMENT_OFFSET], 8),
+                                    receiveTime) ;
+
+        if (frame_type == FRAME_TYPE_DATA)
+        {
+            this->HandleDataFrame(static_cast<uint16_t>(LoadLittleEndian(&mFrameBuffer[HEADER_SEQUENCE_OFFSET], 2)),
+                                  mFrameBuffer[HEADER_FLAGS_OFFSET],
+                                  &mFrameBuffer[HEADER_SIZE],
+                                  frame_size - HEADER_SIZE - CRC_SIZE) ;
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::HandleAcknowledgement(const uint16_t           acknowledgement,
+                                                              const uint64_t           selectiveAcknowledgement,
+                                                              const Clock::time_point& receiveTime)
+    {
+        const auto number_of_transmitted_frames = this->GetNumberOfTransmittedFrames() ;
+
+        const auto base_sequence = mOutgoingFrames.empty() ?
+                                   mNextSequence :
+                                   mOutgoingFrames.front().sequence ;
+
+        const auto number_of_acknowledged_frames = static_cast<uint16_t>(acknowledgement - base_sequence) ;
+
+        // An acknowledgement of frames never sent is stale or invalid.
+        if (number_of_acknowledged_frames > number_of_transmitted_frames)
+        {
+            return ;
+        }
+
+        // The frame sent last among those newly acknowledged, which were
+        // sent once so that the acknowledgement is not ambiguous (Karn).
+        bool has_rtt_sample = false ;
+        uint64_t latest_transmit_order = 0 ;
+        Clock::time_point latest_send_time {} ;
+
+        const auto acknowledge = [&](OutgoingFrame& outgoingFrame)
+        {
+            if (outgoingFrame.isAcknowledged)
+            {
+                return ;
+            }
+
+            outgoingFrame.isAcknowledged = true ;
+
+            if ((outgoingFrame.transmissions == 1) and
+                ((not has_rtt_sample) or
+                 (outgoingFrame.transmitOrder > latest_transmit_order)))
+            {
+                has_rtt_sample = true ;
+                latest_transmit_order = outgoingFrame.transmitOrder ;
+                latest_send_time = outgoingFrame.sendTime ;
+            }
+        } ;
+
+        for (size_t i = 0 ; i < number_of_acknowledged_frames ; i++)
+        {
+            acknowledge(mOutgoingFrames[i]) ;
+        }
+
+        mOutgoingFrames.erase(mOutgoingFrames.begin(),
+                              mOutgoingFrames.begin() + number_of_acknowledged_frames) ;
+
+        const auto number_of_outstanding_frames = number_of_transmitted_frames - number_of_acknowledged_frames ;
+
+        // Bit i acknowledges the frame following the next expected one by
+        // i + 1.
+        for (size_t i = 0 ; i + 1 < number_of_outstanding_frames ; i++)
+        {
+            if (((selectiveAcknowledgement >> i) & 1) != 0)
+            {
+                acknowledge(mOutgoingFrames[i + 1]) ;
+            }
+        }
+
+        if (not has_rtt_sample)
+        {
+            return ;
+        }
+
+        this->UpdateRetransmitTimeout(std::chrono::duration_cast<std::chrono::microseconds>(receiveTime - latest_send_time).count()) ;
+
+        // A serial link does not reorder frames, so the frames sent before
+        // an acknowledged one and not acknowledged themselves were lost.
+        for (size_t i = 0 ; i < number_of_outstanding_frames ; i++)
+        {
+            auto& outgoing_frame = mOutgoingFrames[i] ;
+
+            if ((not outgoing_frame.isAcknowledged) and
+                (outgoing_frame.transmitOrder < latest_transmit_order))
+            {
+                outgoing_frame.isLost = true ;
+            }
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::HandleDataFrame(const uint16_t       sequence,
+                                                        const uint8_t        flags,
+                                                        const uint8_t* const payload,
+                                                        const size_t         payloadSize)
+    {
+        // Duplicates are acknowledged again, in case the acknowledgement
+        // was lost.
+        mIsAcknowledgementPending = true ;
+
+        const auto distance = static_cast<uint16_t>(sequence - mReceiveNext) ;
+
+        auto& received_frame = mReorderBuffer[sequence % RELIABLE_LINK_WINDOW_MAXIMUM] ;
+
+        if ((distance >= RELIABLE_LINK_WINDOW_MAXIMUM) or
+            received_frame.isReceived)
+        {
+            mStatistics.duplicateFrames++ ;
+            return ;
+        }
+
+        received_frame.isReceived = true ;
+        received_frame.flags = flags ;
+        received_frame.payload.assign(payload, payload + payloadSize) ;
+
+        // Reassemble the frames received in sequence.
+        while (true)
+        {
+            auto& next_frame = mReorderBuffer[mReceiveNext % RELIABLE_LINK_WINDOW_MAXIMUM] ;
+
+            if (not next_frame.isReceived)
+            {
+                break ;
+            }
+
+            mPartialMessage.insert(mPartialMessage.end(),
+                                   next_frame.payload.begin(),
+                                   next_frame.payload.end()) ;
+
+            if ((next_frame.flags & FRAME_FLAG_END_OF_MESSAGE) != 0)
+            {
+                mReceivedMessages.push_back(std::move(mPartialMessage)) ;
+                mPartialMessage.clear() ;
+                mStatistics.messagesReceived++ ;
+            }
+
+            next_frame.isReceived = false ;
+            next_frame.payload.clear() ;
+            mReceiveNext++ ;
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::ExpireRetransmitTimers(const Clock::time_point& currentTime)
+    {
+        const auto number_of_transmitted_frames = this->GetNumberOfTransmittedFrames() ;
+        const auto retransmit_timeout = std::chrono::microseconds(mRetransmitTimeoutUs) ;
+
+        bool is_expired = false ;
+
+        for (size_t i = 0 ; i < number_of_transmitted_frames ; i++)
+        {
+            auto& outgoing_frame = mOutgoingFrames[i] ;
+
+            if ((not outgoing_frame.isAcknowledged) and
+                (not outgoing_frame.isLost) and
+                (currentTime >= outgoing_frame.sendTime + retransmit_timeout))
+            {
+                outgoing_frame.isLost = true ;
+                is_expired = true ;
+            }
+        }
+
+        // Back off once for all the frames of the expired window.
+        if (is_expired)
+        {
+            mRetransmitTimeoutUs = std::min(2 * mRetransmitTimeoutUs,
+                                            static_cast<int64_t>(mOptions.msMaximumRetransmitTimeout) * MICROSECONDS_PER_MS) ;
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::WriteFrames()
+    {
+        const auto window_end = std::min(mOutgoingFrames.size(),
+                                         mOptions.windowSize) ;
+
+        DataBuffer output {} ;
+        std::vector<size_t> written_frames {} ;
+
+        for (size_t i = 0 ; i < window_end ; i++)
+        {
+            auto& outgoing_frame = mOutgoingFrames[i] ;
+
+            if (outgoing_frame.isAcknowledged or
+                ((outgoing_frame.transmissions > 0) and
+                 (not outgoing_frame.isLost)))
+            {
+                continue ;
+            }
+
+            if (outgoing_frame.transmissions > 0)
+            {
+                if (outgoing_frame.transmissions > mOptions.maximumRetransmissions)
+                {
+                    throw std::runtime_error(ERR_MSG_NOT_ACKNOWLEDGED) ;
+                }
+
+                mStatistics.retransmissions++ ;
+            }
+
+            this->AppendFrame(output,
+                              FRAME_TYPE_DATA,
+                              outgoing_frame.flags,
+                              outgoing_frame.sequence,
+                              outgoing_frame.payload) ;
+
+            written_frames.push_back(i) ;
+        }
+
+        if (written_frames.empty())
+        {
+            if (not mIsAcknowledgementPending)
+            {
+                return ;
+            }
+
+            this->AppendFrame(output,
+                              FRAME_TYPE_ACKNOWLEDGEMENT,
+                              0,
+                              mNextSequence,
+                              DataBuffer {}) ;
+        }
+
+        // The frames stay unsent if writing them fails.
+        mSerialPort->Write(output) ;
+        mIsAcknowledgementPending = false ;
+
+        const auto send_time = Clock::now() ;
+
+        for (const auto i : written_frames)
+        {
+            auto& outgoing_frame = mOutgoingFrames[i] ;
+            outgoing_frame.sendTime = send_time ;
+            outgoing_frame.transmitOrder = mNextTransmitOrder++ ;
+            outgoing_frame.transmissions++ ;
+            outgoing_frame.isLost = false ;
+        }
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::AppendFrame(DataBuffer&       output,
+                                                    const uint8_t     type,
+                                                    const uint8_t     flags,
+                                                    const uint16_t    sequence,
+                                                    const DataBuffer& payload)
+    {
+        std::array<uint8_t, HEADER_SIZE> header {} ;
+        header[HEADER_TYPE_OFFSET] = type ;
+        header[HEADER_FLAGS_OFFSET] = flags ;
+        StoreLittleEndian(&header[HEADER_SEQUENCE_OFFSET], sequence, 2) ;
+        StoreLittleEndian(&header[HEADER_ACKNOWLEDGEMENT_OFFSET], mReceiveNext, 2) ;
+        StoreLittleEndian(&header[HEADER_SELECTIVE_ACKNOWLEDGEMENT_OFFSET], this->GetSelectiveAcknowledgement(), 8) ;
+        StoreLittleEndian(&header[HEADER_LENGTH_OFFSET], payload.size(), 2) ;
+
+        std::array<uint8_t, CRC_SIZE> trailer {} ;
+        StoreLittleEndian(trailer.data(),
+                          ComputeCrc32(payload.data(),
+                                       payload.size(),
+                                       ComputeCrc32(header.data(), header.size())),
+                          CRC_SIZE) ;
+
+        output.push_back(FRAME_DELIMITER) ;
+        AppendEscaped(output, header.data(), header.size()) ;
+        AppendEscaped(output, payload.data(), payload.size()) ;
+        AppendEscaped(output, trailer.data(), trailer.size()) ;
+        output.push_back(FRAME_DELIMITER) ;
+
+        mStatistics.framesSent++ ;
+    }
+
+    inline
+    uint64_t
+    SerialReliableLink::Implementation::GetSelectiveAcknowledgement() const
+    {
+        uint64_t selective_acknowledgement = 0 ;
+
+        for (size_t i = 0 ; i + 1 < RELIABLE_LINK_WINDOW_MAXIMUM ; i++)
+        {
+            const auto sequence = static_cast<uint16_t>(mReceiveNext + 1 + i) ;
+
+            if (mReorderBuffer[sequence % RELIABLE_LINK_WINDOW_MAXIMUM].isReceived)
+            {
+                selective_acknowledgement |= uint64_t {1} << i ;
+            }
+        }
+
+        return selective_acknowledgement ;
+    }
+
+    inline
+    void
+    SerialReliableLink::Implementation::UpdateRetransmitTimeout(const int64_t rttUs)
+    {
+        if (not mHasRttSample)
+        {
+            mSmoothedRttUs = rttUs ;
+            mRttVariationUs = rttUs / 2 ;
+            mHasRttSample = true ;
+        }
+        else
+        {
+            mRttVariationUs = (3 * mRttVariationUs + std::abs(mSmoothedRttUs - rttUs)) / 4 ;
+            mSmoothedRttUs = (7 * mSmoothedRttUs + rttUs) / 8 ;
+        }
+
+        mRetransmitTimeoutUs = mSmoothedRttUs + std::max(4 * mRttVariationUs, RTT_VARIATION_MINIMUM_US) ;
+        mRetransmitTimeoutUs = std::max(mRetransmitTimeoutUs, static_cast<int64_t>(mOptions.msMinimumRetransmitTimeout) * MICROSECONDS_PER_MS) ;
+        mRetransmitTimeoutUs = std::min(mRetransmitTimeoutUs, static_cast<int64_t>(mOptions.msMaximumRetransmitTimeout) * MICROSECONDS_PER_MS) ;
+    }
+
+    inline
+    Clock::time_point
+    SerialReliableLink::Implementation::GetNextTimerTime() const
+    {
+        const auto number_of_transmitted_frames = this->GetNumberOfTransmittedFrames() ;
+
+        auto next_timer_time = Clock::time_point::max() ;
+
+        for (size_t i = 0 ; i < number_of_transmitted_frames ; i++)
+        {
+            const auto& outgoing_frame = mOutgoingFrames[i] ;
+
+            if ((not outgoing_frame.isAcknowledged) and
+                (not outgoing_frame.isLost))
+            {
+                next_timer_time = std::min(next_timer_time,
+                                           outgoing_frame.sendTime + std::chrono::microseconds(mRetransmitTimeoutUs)) ;
+            }
+        }
+
+        return next_timer_time ;
+    }
+
+    inline
+    size_t
+    SerialReliableLink::Implementation::GetNumberOfTransmittedFrames() const
+    {
+        const auto window_end = std::min(mOutgoingFrames.size(),
+                                         mOptions.windowSize) ;
+
+        size_t number_of_transmitted_frames = 0 ;
+
+        while ((number_of_transmitted_frames < window_end) and
+               (mOutgoingFrames[number_of_transmitted_frames].transmissions > 0))
+        {
+            number_of_transmitted_frames++ ;
+        }
+
+        return number_of_transmitted_frames ;
+    }
+
+} // namespace LibSerial
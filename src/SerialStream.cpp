@@ -38,6 +38,9 @@ namespace LibSerial
 {
     SerialStream::SerialStream() : std::iostream(nullptr)
     {
+        // Write each output operation to the serial port right away
+        // instead of leaving it in the put area of the SerialStreamBuf.
+        this->setf(std::ios_base::unitbuf) ;
         this->flush() ;
     }
 
@@ -49,6 +52,7 @@ namespace LibSerial
                                const StopBits&      stopBits) : 
         std::iostream(nullptr)
     {
+        this->setf(std::ios_base::unitbuf) ;
         this->Open(fileName) ;  // NOLINT (fuchsia-default-arguments)
         this->SetBaudRate(baudRate) ;
         this->SetCharacterSize(characterSize) ;
@@ -58,6 +62,35 @@ namespace LibSerial
         this->FlushIOBuffers() ;
     }
 
+    SerialStream::SerialStream(SerialStream&& otherSerialStream) :
+        std::iostream(std::move(otherSerialStream)),
+        mIOBuffer(std::move(otherSerialStream.mIOBuffer))
+    {
+        // Moving std::iostream does not transfer the associated streambuf.
+        this->set_rdbuf(mIOBuffer.get()) ;
+        otherSerialStream.set_rdbuf(nullptr) ;
+        otherSerialStream.clear(std::ios_base::badbit) ;
+    }
+
+    SerialStream&
+    SerialStream::operator=(SerialStream&& otherSerialStream)
+    {
+        if (this != &otherSerialStream)
+        {
+            // Swaps the stream state, flags and tied stream, but not the
+            // associated streambuf.
+            std::iostream::operator=(std::move(otherSerialStream)) ;
+
+            mIOBuffer = std::move(otherSerialStream.mIOBuffer) ;
+            this->set_rdbuf(mIOBuffer.get()) ;
+
+            otherSerialStream.set_rdbuf(nullptr) ;
+            otherSerialStream.clear(std::ios_base::badbit) ;
+        }
+
+        return *this ;
+    }
+
     SerialStream::~SerialStream() 
     try 
     {
@@ -685,6 +718,88 @@ namespace LibSerial
         throw ;
     }
 
+    void
+    SerialStream::SetReadTimeout(const size_t msTimeout)
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            // Try to set the read timeout in milliseconds.
+            my_buffer->SetReadTimeout(msTimeout) ;
+        }
+        else
+        {
+            // If the dynamic_cast above failed then we either have a NULL
+            // streambuf associated with this stream or we have a buffer of
+            // class other than SerialStreamBuf. In either case, we have a
+            // problem and we should stop all I/O using this stream.
+            setstate(badbit) ;
+        }
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    size_t
+    SerialStream::GetReadTimeout()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            // Try to get the read timeout in milliseconds.
+            return my_buffer->GetReadTimeout() ;
+        }
+        // If the dynamic_cast above failed then we either have a NULL
+        // streambuf associated with this stream or we have a buffer of
+        // class other than SerialStreamBuf. In either case, we have a
+        // problem and we should stop all I/O using this stream.
+        setstate(badbit) ;
+        return 0 ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    bool
+    SerialStream::IsReadTimedOut()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            return my_buffer->IsReadTimedOut() ;
+        }
+        // If the dynamic_cast above failed then we either have a NULL
+        // streambuf associated with this stream or we have a buffer of
+        // class other than SerialStreamBuf. In either case, we have a
+        // problem and we should stop all I/O using this stream.
+        setstate(badbit) ;
+        return false ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
     void
     SerialStream::SetDTR(const bool dtrState)
     try
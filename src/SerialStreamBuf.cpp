@@ -34,15 +34,24 @@
 #include "libserial/SerialStreamBuf.h"
 #include "libserial/SerialPort.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <fcntl.h>
 #include <linux/serial.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
 namespace LibSerial
 {
+    /**
+     * @brief The number of characters kept at the beginning of the get area
+     *        so that they can be put back after it is refilled.
+     */
+    constexpr std::streamsize STREAM_PUTBACK_SIZE = 1 ;
+
     /**
      * @brief SerialStreamBuf::Implementation is the SerialStreamBuf implementation class.
      */
@@ -50,9 +59,11 @@ namespace LibSerial
     {
     public:
         /**
-         * @brief Default Constructor.
+         * @brief Constructor.
+         * @param serialStreamBuf The SerialStreamBuf whose get and put
+         *        areas are managed by this instance.
          */
-        Implementation() = default ;
+        explicit Implementation(SerialStreamBuf& serialStreamBuf) ;
 
         /**
          * @brief Default Destructor.
@@ -63,6 +74,8 @@ namespace LibSerial
          * @brief Constructor that allows a SerialStreamBuf instance to be
          *        created and opened, initializing the corresponding
          *        serial port with the specified parameters.
+         * @param serialStreamBuf The SerialStreamBuf whose get and put
+         *        areas are managed by this instance.
          * @param fileName The file name of the serial stream.
          * @param baudRate The communications baud rate.
          * @param characterSize The size of the character buffer for
@@ -71,7 +84,8 @@ namespace LibSerial
          * @param stopBits The number of stop bits for the serial stream.
          * @param flowControlType The flow control type for the serial stream.
          */
-        Implementation(const std::string&   fileName,
+        Implementation(SerialStreamBuf&     serialStreamBuf,
+                       const std::string&   fileName,
                        const BaudRate&      baudRate,
                        const CharacterSize& characterSize,
                        const FlowControl&   flowControlType,
@@ -98,6 +112,15 @@ namespace LibSerial
          */
         Implementation& operator=(const Implementation&& otherImplementation) = delete ;
 
+        /**
+         * @brief Sets the SerialStreamBuf whose get and put areas are
+         *        managed by this instance, after the SerialStreamBuf has
+         *        been moved.
+         * @param serialStreamBuf The SerialStreamBuf that took over this
+         *        instance.
+         */
+        void SetSerialStreamBuf(SerialStreamBuf& serialStreamBuf) ;
+
         /**
          * @brief Opens the serial port associated with the specified
          *        file name and the specified mode.
@@ -235,6 +258,25 @@ namespace LibSerial
          */
         short GetVTime() const ;
 
+        /**
+         * @brief Sets the maximum time to wait for data from the serial port.
+         * @param msTimeout The read timeout in milliseconds, 0 to wait for
+         *        as long as VMIN and VTIME dictate.
+         */
+        void SetReadTimeout(const size_t msTimeout) ;
+
+        /**
+         * @brief Gets the read timeout.
+         * @return Returns the read timeout in milliseconds.
+         */
+        size_t GetReadTimeout() const ;
+
+        /**
+         * @brief Determines if the last read from the serial port timed out.
+         * @return Returns true iff the last read timed out.
+         */
+        bool IsReadTimedOut() const ;
+
         /**
          * @brief Sets the serial port DTR line status.
          * @param dtrState The state to set the DTR line
@@ -292,6 +334,22 @@ namespace LibSerial
         std::vector<std::string> GetAvailableSerialPorts() const ;
 #endif
 
+        /**
+         * @brief Replaces the get and put areas, see SerialStreamBuf::setbuf().
+         * @param character Pointer to the character buffer or nullptr.
+         * @param numberOfBytes The size of the character buffer.
+         * @return Returns a pointer to the SerialStreamBuf, or nullptr if
+         *         the get and put areas could not be replaced.
+         */
+        std::streambuf* setbuf(char_type* character,
+                               std::streamsize numberOfBytes) ;
+
+        /**
+         * @brief Writes the contents of the put area to the serial port.
+         * @return Returns 0 on success and -1 on failure.
+         */
+        int sync() ;
+
         /**
          * @brief Writes up to n characters from the character sequence at
          *        char s to the serial port associated with the buffer.
@@ -315,35 +373,22 @@ namespace LibSerial
                                std::streamsize numberOfBytes) ;
 
         /**
-         * @brief Writes the specified character to the associated serial port.
+         * @brief Writes the put area to the serial port and then stores
+         *        the specified character in it.
          * @param character The character to be written to the serial port.
-         * @return Returns the character.
+         * @return Returns the character, or eof if the write failed.
          */
         std::streambuf::int_type overflow(int_type character) ;
 
         /**
-         * @brief Reads and returns the next character from the associated
-         *        serial port if one otherwise returns traits::eof(). This
-         *        method is used for buffered I/O while uflow() is called
-         *        for unbuffered I/O.
+         * @brief Refills the get area from the serial port.
          * @return Returns the next character from the serial port.
          */
         std::streambuf::int_type underflow() ;
 
-        /**
-         * @brief Reads and returns the next character from the associated
-         *        serial port if one otherwise returns traits::eof(). This
-         *        method is used for unbuffered I/O while underflow() is
-         *        called for unbuffered I/O.
-         * @return Returns the next character from the serial port.
-         */
-        std::streambuf::int_type uflow() ;
-
         /**
          * @brief This function is called when a putback of a character
-         *        fails. This must be implemented for unbuffered I/O as all
-         *        streambuf subclasses are required to provide putback of
-         *        at least one character.
+         *        fails.
          * @param character The character to putback.
          * @return Returns The character iff successful, otherwise eof to signal an error.
          */
@@ -351,28 +396,112 @@ namespace LibSerial
 
         /**
          * @brief Checks whether input is available on the port.
-         * @return Returns 1 if characters are available at the serial port,
-         *         0 if no characters are available, and -1 if unsuccessful.
+         * @return Returns the number of characters available at the serial
+         *         port, 0 if no characters are available, and -1 if
+         *         unsuccessful.
          */
         std::streamsize  showmanyc() ;
 
+    private:
+
         /**
-         * @brief True if a putback value is available in mPutbackChar.
-         *
-         * :TODO: Should this be private?
+         * @brief Writes the contents of the put area to the serial port.
+         *        Characters that could not be written are kept at the
+         *        beginning of the put area.
+         * @return Returns true iff the put area was written completely.
          */
-        bool mPutbackAvailable {false} ;
+        bool WritePutArea() ;
 
         /**
-         * @brief We use unbuffered I/O for the serial port. However, we
-         *        need to provide the putback of at least one character.
-         *        This character contains the putback character.
-         *
-         * :TODO: Should this be private?
+         * @brief Writes characters to the serial port, continuing after
+         *        partial writes.
+         * @param character Pointer to the characters to write.
+         * @param numberOfBytes The number of characters to write.
+         * @return Returns the number of characters written.
          */
-        char mPutbackChar {0} ;
+        std::streamsize WriteToPort(const char_type* character,
+                                    std::streamsize numberOfBytes) ;
 
-    private:
+        /**
+         * @brief Refills the get area with a single read() from the
+         *        serial port, keeping the putback reserve.
+         * @param deadline The time after which to stop waiting for data.
+         * @return Returns the next character, or eof if nothing was read.
+         */
+        int_type FillGetArea(const std::chrono::steady_clock::time_point& deadline) ;
+
+        /**
+         * @brief Performs a single read() from the serial port, first
+         *        waiting for data with poll() until the deadline if a read
+         *        timeout is set or the port is in non-blocking mode.
+         * @param character Pointer to the character buffer to read into.
+         * @param numberOfBytes The size of the character buffer.
+         * @param deadline The time after which to stop waiting for data.
+         * @return Returns the number of characters read, or 0 if the read
+         *         timed out.
+         */
+        std::streamsize ReadFromPort(char_type* character,
+                                     std::streamsize numberOfBytes,
+                                     const std::chrono::steady_clock::time_point& deadline) ;
+
+        /**
+         * @brief Waits for data to become available at the serial port.
+         * @param deadline The time after which to stop waiting, ignored if
+         *        no read timeout is set.
+         * @return Returns false iff the deadline passed without data.
+         */
+        bool WaitForInput(const std::chrono::steady_clock::time_point& deadline) ;
+
+        /**
+         * @brief Discards the unread contents of the get area.
+         */
+        void ResetGetArea() ;
+
+        /**
+         * @brief Discards the unwritten contents of the put area.
+         */
+        void ResetPutArea() ;
+
+        /**
+         * @brief The SerialStreamBuf whose get and put areas are managed.
+         */
+        SerialStreamBuf* mSerialStreamBuf {nullptr} ;
+
+        /**
+         * @brief Storage for the get and put areas unless a character
+         *        buffer was provided with setbuf().
+         */
+        std::vector<char> mBufferStorage {} ;
+
+        /**
+         * @brief The get area, starting with the putback reserve.
+         */
+        char_type* mGetBuffer {nullptr} ;
+
+        /**
+         * @brief The size of the get area including the putback reserve.
+         */
+        std::streamsize mGetBufferSize {0} ;
+
+        /**
+         * @brief The put area, or nullptr for unbuffered output.
+         */
+        char_type* mPutBuffer {nullptr} ;
+
+        /**
+         * @brief The size of the put area.
+         */
+        std::streamsize mPutBufferSize {0} ;
+
+        /**
+         * @brief The read timeout, zero to wait indefinitely.
+         */
+        std::chrono::milliseconds mReadTimeout {0} ;
+
+        /**
+         * @brief True iff the last read from the serial port timed out.
+         */
+        bool mReadTimedOut {false} ;
 
         /**
          * SerialPort device that will be used for communication.
@@ -381,9 +510,9 @@ namespace LibSerial
     } ;
 
     SerialStreamBuf::SerialStreamBuf()
-        : mImpl(new Implementation)
+        : mImpl(new Implementation(*this))
     {
-        setbuf(nullptr, 0) ;
+        setbuf(nullptr, static_cast<std::streamsize>(STREAM_BUFFER_SIZE_DEFAULT)) ;
     }
 
     SerialStreamBuf::SerialStreamBuf(const std::string&   fileName,
@@ -392,14 +521,52 @@ namespace LibSerial
                                      const FlowControl&   flowControlType,
                                      const Parity&        parityType,
                                      const StopBits&      stopBits)
-        : mImpl(new Implementation(fileName,
+        : mImpl(new Implementation(*this,
+                                   fileName,
                                    baudRate,
                                    characterSize,
                                    flowControlType,
                                    parityType,
                                    stopBits))
     {
-        setbuf(nullptr, 0) ;
+        setbuf(nullptr, static_cast<std::streamsize>(STREAM_BUFFER_SIZE_DEFAULT)) ;
+    }
+
+    SerialStreamBuf::SerialStreamBuf(SerialStreamBuf&& otherSerialStreamBuf)
+        : std::streambuf(otherSerialStreamBuf),
+          mImpl(std::move(otherSerialStreamBuf.mImpl))
+    {
+        // The get and put areas are owned by mImpl, so only the streambuf
+        // pointers copied above need to stop referring to them.
+        if (mImpl)
+        {
+            mImpl->SetSerialStreamBuf(*this) ;
+        }
+
+        otherSerialStreamBuf.setg(nullptr, nullptr, nullptr) ;
+        otherSerialStreamBuf.setp(nullptr, nullptr) ;
+    }
+
+    SerialStreamBuf&
+    SerialStreamBuf::operator=(SerialStreamBuf&& otherSerialStreamBuf)
+    {
+        if (this != &otherSerialStreamBuf)
+        {
+            // Replacing mImpl first closes the current serial port while
+            // the get and put areas still refer to its buffers.
+            mImpl = std::move(otherSerialStreamBuf.mImpl) ;
+            std::streambuf::operator=(otherSerialStreamBuf) ;
+
+            if (mImpl)
+            {
+                mImpl->SetSerialStreamBuf(*this) ;
+            }
+
+            otherSerialStreamBuf.setg(nullptr, nullptr, nullptr) ;
+            otherSerialStreamBuf.setp(nullptr, nullptr) ;
+        }
+
+        return *this ;
     }
 
     SerialStreamBuf::~SerialStreamBuf() = default ;
@@ -544,6 +711,24 @@ namespace LibSerial
         return mImpl->GetVTime() ;
     }
 
+    void
+    SerialStreamBuf::SetReadTimeout(const size_t msTimeout)
+    {
+        mImpl->SetReadTimeout(msTimeout) ;
+    }
+
+    size_t
+    SerialStreamBuf::GetReadTimeout() const
+    {
+        return mImpl->GetReadTimeout() ;
+    }
+
+    bool
+    SerialStreamBuf::IsReadTimedOut() const
+    {
+        return mImpl->IsReadTimedOut() ;
+    }
+
     void
     SerialStreamBuf::SetDTR(const bool dtrState)
     {
@@ -603,7 +788,13 @@ namespace LibSerial
     std::streambuf*
     SerialStreamBuf::setbuf(char_type* character, std::streamsize numberOfBytes)
     {
-        return std::streambuf::setbuf(character, numberOfBytes) ;
+        return mImpl->setbuf(character, numberOfBytes) ;
+    }
+
+    int
+    SerialStreamBuf::sync()
+    {
+        return mImpl->sync() ;
     }
 
     std::streamsize
@@ -630,12 +821,6 @@ namespace LibSerial
         return mImpl->underflow() ;
     }
 
-    std::streambuf::int_type
-    SerialStreamBuf::uflow()
-    {
-        return mImpl->uflow() ;
-    }
-
     std::streambuf::int_type
     SerialStreamBuf::pbackfail(const int_type character)
     {
@@ -652,13 +837,22 @@ namespace LibSerial
     /** -------------------------- Implementation -------------------------- */
 
     inline
-    SerialStreamBuf::Implementation::Implementation(const std::string&   fileName,
+    SerialStreamBuf::Implementation::Implementation(SerialStreamBuf& serialStreamBuf)
+        : mSerialStreamBuf(&serialStreamBuf)
+    {
+        //  empty
+    }
+
+    inline
+    SerialStreamBuf::Implementation::Implementation(SerialStreamBuf&     serialStreamBuf,
+                                                    const std::string&   fileName,
                                                     const BaudRate&      baudRate,
                                                     const CharacterSize& characterSize,
                                                     const FlowControl&   flowControlType,
                                                     const Parity&        parityType,
                                                     const StopBits&      stopBits)
-    try : mSerialPort(fileName,
+    try : mSerialStreamBuf(&serialStreamBuf),
+          mSerialPort(fileName,
                       baudRate, 
                       characterSize,
                       flowControlType,
@@ -672,6 +866,13 @@ namespace LibSerial
         throw OpenFailed(err.what()) ;
     }
 
+    inline
+    void
+    SerialStreamBuf::Implementation::SetSerialStreamBuf(SerialStreamBuf& serialStreamBuf)
+    {
+        mSerialStreamBuf = &serialStreamBuf ;
+    }
+
     inline
     SerialStreamBuf::Implementation::~Implementation()
     try 
@@ -722,6 +923,12 @@ namespace LibSerial
     void
     SerialStreamBuf::Implementation::Close()
     {
+        // Pending output is written before the port goes away, as
+        // std::filebuf does.
+        this->WritePutArea() ;
+        this->ResetGetArea() ;
+        this->ResetPutArea() ;
+
         mSerialPort.Close() ;
     }
 
@@ -729,6 +936,7 @@ namespace LibSerial
     void
     SerialStreamBuf::Implementation::DrainWriteBuffer()
     {
+        this->WritePutArea() ;
         mSerialPort.DrainWriteBuffer() ;
     }
 
@@ -737,6 +945,7 @@ namespace LibSerial
     SerialStreamBuf::Implementation::FlushInputBuffer()
     {
         mSerialPort.FlushInputBuffer() ;
+        this->ResetGetArea() ;
     }
 
     inline
@@ -744,6 +953,7 @@ namespace LibSerial
     SerialStreamBuf::Implementation::FlushOutputBuffer()
     {
         mSerialPort.FlushOutputBuffer() ;
+        this->ResetPutArea() ;
     }
 
     inline
@@ -751,6 +961,8 @@ namespace LibSerial
     SerialStreamBuf::Implementation::FlushIOBuffers()
     {
         mSerialPort.FlushIOBuffers() ;
+        this->ResetGetArea() ;
+        this->ResetPutArea() ;
     }
 
     inline
@@ -764,7 +976,8 @@ namespace LibSerial
     bool
     SerialStreamBuf::Implementation::IsDataAvailable() 
     {
-        return mSerialPort.IsDataAvailable() ;
+        const auto get_area_size = mSerialStreamBuf->egptr() - mSerialStreamBuf->gptr() ;
+        return mSerialPort.IsDataAvailable() or (get_area_size > 0) ;
     }
 
     inline
@@ -872,6 +1085,27 @@ namespace LibSerial
         return mSerialPort.GetVTime() ;
     }
 
+    inline
+    void
+    SerialStreamBuf::Implementation::SetReadTimeout(const size_t msTimeout)
+    {
+        mReadTimeout = std::chrono::milliseconds(msTimeout) ;
+    }
+
+    inline
+    size_t
+    SerialStreamBuf::Implementation::GetReadTimeout() const
+    {
+        return static_cast<size_t>(mReadTimeout.count()) ;
+    }
+
+    inline
+    bool
+    SerialStreamBuf::Implementation::IsReadTimedOut() const
+    {
+        return mReadTimedOut ;
+    }
+
     inline
     void
     SerialStreamBuf::Implementation::SetDTR(const bool dtrState)
@@ -925,7 +1159,8 @@ namespace LibSerial
     int
     SerialStreamBuf::Implementation::GetNumberOfBytesAvailable()
     {
-        return mSerialPort.GetNumberOfBytesAvailable() ;
+        const auto get_area_size = mSerialStreamBuf->egptr() - mSerialStreamBuf->gptr() ;
+        return mSerialPort.GetNumberOfBytesAvailable() + static_cast<int>(get_area_size) ;
     }
 
 #ifdef __linux__
@@ -937,6 +1172,82 @@ namespace LibSerial
     }
 #endif
 
+    inline
+    std::streambuf*
+    SerialStreamBuf::Implementation::setbuf(char_type* character,
+                                            std::streamsize numberOfBytes)
+    {
+        // Pending output has to be written before the put area is replaced.
+        if (not this->WritePutArea())
+        {
+            return nullptr ;
+        }
+
+        // A get area is always needed to provide putback. Unbuffered input
+        // reads a single character at a time.
+        auto get_buffer_size = STREAM_PUTBACK_SIZE + 1 ;
+        std::streamsize put_buffer_size = 0 ;
+
+        if (character == nullptr and numberOfBytes > 0)
+        {
+            get_buffer_size = STREAM_PUTBACK_SIZE + numberOfBytes ;
+            put_buffer_size = numberOfBytes ;
+        }
+        else if (character != nullptr and numberOfBytes >= 2 * get_buffer_size)
+        {
+            get_buffer_size = numberOfBytes / 2 ;
+            put_buffer_size = numberOfBytes - get_buffer_size ;
+        }
+
+        // Unread input is carried over to the new get area. Copy it out
+        // first as the new get area may overlap the old one.
+        const auto get_area_size = mSerialStreamBuf->egptr() - mSerialStreamBuf->gptr() ;
+
+        if (get_area_size > get_buffer_size - STREAM_PUTBACK_SIZE)
+        {
+            return nullptr ;
+        }
+
+        const std::string unread_characters(mSerialStreamBuf->gptr(),
+                                            static_cast<size_t>(get_area_size)) ;
+
+        if (character != nullptr and put_buffer_size > 0)
+        {
+            mBufferStorage.clear() ;
+            mBufferStorage.shrink_to_fit() ;
+            mGetBuffer = character ;
+        }
+        else
+        {
+            mBufferStorage.assign(static_cast<size_t>(get_buffer_size + put_buffer_size), 0) ;
+            mGetBuffer = mBufferStorage.data() ;
+        }
+
+        mGetBufferSize = get_buffer_size ;
+        mPutBuffer     = (put_buffer_size > 0) ? mGetBuffer + get_buffer_size : nullptr ;
+        mPutBufferSize = put_buffer_size ;
+
+        this->ResetGetArea() ;
+        this->ResetPutArea() ;
+
+        std::memcpy(mGetBuffer + STREAM_PUTBACK_SIZE,
+                    unread_characters.data(),
+                    unread_characters.size()) ;
+
+        mSerialStreamBuf->setg(mGetBuffer + STREAM_PUTBACK_SIZE,
+                               mGetBuffer + STREAM_PUTBACK_SIZE,
+                               mGetBuffer + STREAM_PUTBACK_SIZE + get_area_size) ;
+
+        return mSerialStreamBuf ;
+    }
+
+    inline
+    int
+    SerialStreamBuf::Implementation::sync()
+    {
+        return this->WritePutArea() ? 0 : -1 ;
+    }
+
     inline
     std::streamsize
     SerialStreamBuf::Implementation::xsputn(const char_type* character,
@@ -954,21 +1265,34 @@ namespace LibSerial
             return 0 ;
         }
 
-        // Write the n characters to the serial port.
-        // 
-        // :TODO: Consider using mSerialPort.Write() here instead of writing
-        //        to the file descriptor directly.
-        const auto fd = mSerialPort.GetFileDescriptor() ;
-        ssize_t result = call_with_retry(write, fd, character, numberOfBytes) ;
-
-        // If the write failed then return 0.
-        if (result <= 0)
+        if (mPutBuffer != nullptr)
         {
-            return 0 ;
+            auto put_area_space = mSerialStreamBuf->epptr() - mSerialStreamBuf->pptr() ;
+
+            // Make room if the characters do not fit in the put area.
+            if (numberOfBytes > put_area_space)
+            {
+                if (not this->WritePutArea())
+                {
+                    return 0 ;
+                }
+
+                put_area_space = mPutBufferSize ;
+            }
+
+            // Append the characters to the put area if they fit, otherwise
+            // write them directly to the serial port.
+            if (numberOfBytes <= put_area_space)
+            {
+                std::memcpy(mSerialStreamBuf->pptr(),
+                            character,
+                            static_cast<size_t>(numberOfBytes)) ;
+                mSerialStreamBuf->pbump(static_cast<int>(numberOfBytes)) ;
+                return numberOfBytes ;
+            }
         }
 
-        // Otherwise, return the number of bytes actually written.
-        return result;
+        return this->WriteToPort(character, numberOfBytes) ;
     }
 
     inline
@@ -992,64 +1316,57 @@ namespace LibSerial
             return 0 ;
         }
 
-        // Try to read up to n characters in the array s.
-        ssize_t result = -1;
+        // The read timeout applies to the request as a whole.
+        const auto deadline = std::chrono::steady_clock::now() + mReadTimeout ;
 
-        // If a putback character is available, then we need to read only
-        // n-1 character.
-        if (mPutbackAvailable)
+        std::streamsize number_of_bytes_read = 0 ;
+
+        while (number_of_bytes_read < numberOfBytes)
         {
-            // Put the mPutbackChar at the beginning of the array 's'.
-            // Increment result to indicate that a character has been placed in s.
-            character[0] = mPutbackChar;
-            result++;
-
-            // The putback character is no longer available.
-            mPutbackAvailable = false;
-
-            // If we need to read more than one character, then call read()
-            // and try to read numberOfBytes-1 more characters and put them
-            // at location starting from &character[1].
-            if (numberOfBytes > 1)
+            const auto bytes_remaining = numberOfBytes - number_of_bytes_read ;
+            const auto get_area_size = mSerialStreamBuf->egptr() - mSerialStreamBuf->gptr() ;
+
+            // Consume the contents of the get area first.
+            if (get_area_size > 0)
+            {
+                const auto bytes_to_copy = std::min(get_area_size, bytes_remaining) ;
+                std::memcpy(character + number_of_bytes_read,
+                            mSerialStreamBuf->gptr(),
+                            static_cast<size_t>(bytes_to_copy)) ;
+                mSerialStreamBuf->gbump(static_cast<int>(bytes_to_copy)) ;
+                number_of_bytes_read += bytes_to_copy ;
+                continue ;
+            }
+
+            // Requests that do not fit in the get area are read directly
+            // into the destination, keeping the last character for putback.
+            if (bytes_remaining >= mGetBufferSize - STREAM_PUTBACK_SIZE)
             {
-                // 
-                // :TODO: Consider using mSerialPort.Read() here instead of
-                // using the file descriptor.
-                //
-                const auto fd = mSerialPort.GetFileDescriptor() ;
-                result = call_with_retry(read, fd, &character[1], numberOfBytes-1) ;
-
-                // If read was successful, then we need to increment result by
-                // one to indicate that the putback character was prepended to
-                // the array, s. If read failed then leave result at -1.
-                if (result != -1)
+                const auto result = this->ReadFromPort(character + number_of_bytes_read,
+                                                       bytes_remaining,
+                                                       deadline) ;
+                if (result == 0)
                 {
-                    result++;
+                    break ;
                 }
+
+                number_of_bytes_read += result ;
+
+                mGetBuffer[STREAM_PUTBACK_SIZE - 1] = character[number_of_bytes_read - 1] ;
+                mSerialStreamBuf->setg(mGetBuffer + STREAM_PUTBACK_SIZE - 1,
+                                       mGetBuffer + STREAM_PUTBACK_SIZE,
+                                       mGetBuffer + STREAM_PUTBACK_SIZE) ;
+                continue ;
             }
-        }
-        else
-        {
-            // If no putback character is available then we try to
-            // read numberOfBytes characters.
-            // 
-            // :TODO: Consider using mSerialPort.Read() here instead of
-            //        using the file descriptor.
-            const auto fd = mSerialPort.GetFileDescriptor() ;
-            result = call_with_retry(read, fd, character, numberOfBytes) ;
-        }
 
-        // If result == -1 then the read call had an error, otherwise, if
-        // result == 0 then we could not read the characters. In either
-        // case, we return 0 to indicate that no characters could be read
-        // from the serial port.
-        if (result <= 0)
-        {
-            return 0 ;
+            if (traits_type::eq_int_type(this->FillGetArea(deadline), traits_type::eof()))
+            {
+                break ;
+            }
         }
 
         // Return the number of characters actually read from the serial port.
-        return result;
+        return number_of_bytes_read ;
     }
 
     inline
@@ -1062,28 +1379,38 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Try to write the specified character to the serial port.
-        if (traits_type::eq_int_type(character, traits_type::eof()))
+        const auto is_eof = traits_type::eq_int_type(character, traits_type::eof()) ;
+
+        // Without a put area the character is written immediately.
+        if (mPutBuffer == nullptr)
         {
-            // If character is the eof character then we do nothing.
-            return traits_type::eof() ;
-        }
+            if (is_eof)
+            {
+                return traits_type::not_eof(character) ;
+            }
 
-        // Otherwise we write the character to the serial port.
-        // 
-        // :TODO: Consider using a method of SerialPort class here instead
-        //        of using the file descriptor.
-        const auto fd = mSerialPort.GetFileDescriptor() ;
-        char out_char = traits_type::to_char_type(character) ;
-        ssize_t result = call_with_retry(write, fd, &out_char, 1) ;
+            const char out_char = traits_type::to_char_type(character) ;
+
+            if (this->WriteToPort(&out_char, 1) != 1)
+            {
+                return traits_type::eof() ;
+            }
+
+            return traits_type::not_eof(character) ;
+        }
 
-        // If the write failed then return eof.
-        if (result <= 0)
+        // Otherwise, empty the full put area and store the character.
+        if (not this->WritePutArea())
         {
             return traits_type::eof() ;
         }
 
-        // Otherwise, return something other than eof().
+        if (not is_eof)
+        {
+            *mSerialStreamBuf->pptr() = traits_type::to_char_type(character) ;
+            mSerialStreamBuf->pbump(1) ;
+        }
+
         return traits_type::not_eof(character) ;
     }
 
@@ -1097,68 +1424,42 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Read the next character from the serial port.
-        char next_char = 0 ;
-        ssize_t result = -1;
-
-        // If a putback character is available then we return that
-        // character. However, we are not supposed to change the value of
-        // gptr() in this routine so we leave mPutbackAvailable set to true.
-        if (mPutbackAvailable)
-        {
-            next_char = mPutbackChar;
-        }
-        else
+        if (mSerialStreamBuf->gptr() < mSerialStreamBuf->egptr())
         {
-            // If no putback character is available then we need to read one
-            // character from the serial port.
-            // 
-            // :TODO: Consider using a method of SerialPort class here instead
-            // of using the file descriptor.
-            //
-            const auto fd = mSerialPort.GetFileDescriptor() ;
-            result = call_with_retry(read, fd, &next_char, 1) ;
-
-            // Make the next character the putback character. This has the
-            // effect of returning the next character without changing gptr()
-            // as required by the C++ standard.
-            if (result == 1)
-            {
-                mPutbackChar = next_char;
-                mPutbackAvailable = true ;
-            }
-            else if (result <= 0)
-            {
-                // If we had a problem reading the character, we return
-                // traits::eof().
-                return traits_type::eof() ;
-            }
+            return traits_type::to_int_type(*mSerialStreamBuf->gptr()) ;
         }
 
-        // :NOTE: Wed Aug  9 21:26:51 2000 Pagey
-        //        The value of mPutbackAvailable is always true when the code
-        //        reaches here.
-
-        // Return the character as an int value as required by the C++
-        // standard.
-        return traits_type::to_int_type(next_char) ;
+        return this->FillGetArea(std::chrono::steady_clock::now() + mReadTimeout) ;
     }
 
     inline
     std::streambuf::int_type
-    SerialStreamBuf::Implementation::uflow()
+    SerialStreamBuf::Implementation::FillGetArea(const std::chrono::steady_clock::time_point& deadline)
     {
-        // Throw an exception if the serial port is not open.
-        if (!this->IsOpen())
-        {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
-        }
+        // Move the last characters consumed into the putback reserve.
+        const auto putback_size = std::min(mSerialStreamBuf->gptr() - mSerialStreamBuf->eback(),
+                                           STREAM_PUTBACK_SIZE) ;
+
+        std::memmove(mGetBuffer + STREAM_PUTBACK_SIZE - putback_size,
+                     mSerialStreamBuf->gptr() - putback_size,
+                     static_cast<size_t>(putback_size)) ;
 
-        int_type next_char = underflow() ;
+        // Refill the rest of the get area with a single read().
+        const auto result = this->ReadFromPort(mGetBuffer + STREAM_PUTBACK_SIZE,
+                                               mGetBufferSize - STREAM_PUTBACK_SIZE,
+                                               deadline) ;
 
-        mPutbackAvailable = false;
+        mSerialStreamBuf->setg(mGetBuffer + STREAM_PUTBACK_SIZE - putback_size,
+                               mGetBuffer + STREAM_PUTBACK_SIZE,
+                               mGetBuffer + STREAM_PUTBACK_SIZE + result) ;
 
-        return next_char;
+        // If no character arrived in time, we return traits::eof().
+        if (result == 0)
+        {
+            return traits_type::eof() ;
+        }
+
+        return traits_type::to_int_type(*mSerialStreamBuf->gptr()) ;
     }
 
     inline
@@ -1171,24 +1472,22 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // If a putback character is already available, then we cannot
-        // do any more putback and hence need to return eof.
-        if (mPutbackAvailable)
+        // We cannot back up beyond the beginning of the get area. 
+        if (mSerialStreamBuf->gptr() == mSerialStreamBuf->eback())
         {
             return traits_type::eof() ;
         }
-        if (traits_type::eq_int_type(character, traits_type::eof()))
+
+        // Otherwise the character differs from the one previously read,
+        // or is eof to back up one character. The get area belongs to us,
+        // so the character can simply be replaced.
+        mSerialStreamBuf->gbump(-1) ;
+
+        if (not traits_type::eq_int_type(character, traits_type::eof()))
         {
-            // If an eof character is passed in, then we are required to
-            // backup one character. However, we cannot do this for a serial
-            // port. Hence we return eof to signal an error.
-            return traits_type::eof() ;
+            *mSerialStreamBuf->gptr() = traits_type::to_char_type(character) ;
         }
-        //
-        // If no putback character is available at present, then make
-        // "character" the putback character and return it.
-        mPutbackChar = traits_type::to_char_type(character) ;
-        mPutbackAvailable = true ;
+
         return traits_type::not_eof(character) ;
     }
 
@@ -1202,23 +1501,176 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        ssize_t number_of_bytes_available = 0 ;
+        int number_of_bytes_available = 0 ;
 
         // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
-        // 
-        // :TODO: Consider using a method of SerialPort class here instead
-        //        of using the file descriptor.
         const auto fd = mSerialPort.GetFileDescriptor() ;
         const auto result = call_with_retry(ioctl,
                                             fd,
                                             FIONREAD,
                                             &number_of_bytes_available) ;
 
-        if ((result >= 0) and (number_of_bytes_available > 0))
+        if (result < 0)
         {
-            mPutbackAvailable = true ;
+            return -1 ;
         }
 
-        return number_of_bytes_available;
+        return number_of_bytes_available ;
+    }
+
+    inline
+    bool
+    SerialStreamBuf::Implementation::WritePutArea()
+    {
+        const auto put_area_size = mSerialStreamBuf->pptr() - mSerialStreamBuf->pbase() ;
+
+        if (put_area_size <= 0)
+        {
+            return true ;
+        }
+
+        const auto result = this->WriteToPort(mSerialStreamBuf->pbase(), put_area_size) ;
+
+        // Keep the characters that could not be written.
+        std::memmove(mPutBuffer,
+                     mSerialStreamBuf->pbase() + result,
+                     static_cast<size_t>(put_area_size - result)) ;
+
+        this->ResetPutArea() ;
+        mSerialStreamBuf->pbump(static_cast<int>(put_area_size - result)) ;
+
+        return result == put_area_size ;
+    }
+
+    inline
+    std::streamsize
+    SerialStreamBuf::Implementation::WriteToPort(const char_type* character,
+                                                 std::streamsize numberOfBytes)
+    {
+        const auto fd = mSerialPort.GetFileDescriptor() ;
+        std::streamsize number_of_bytes_written = 0 ;
+
+        while (number_of_bytes_written < numberOfBytes)
+        {
+            const auto result = call_with_retry(write,
+                                                fd,
+                                                character + number_of_bytes_written,
+                                                static_cast<size_t>(numberOfBytes - number_of_bytes_written)) ;
+
+            // If the write failed then stop.
+            if (result <= 0)
+            {
+                break ;
+            }
+
+            number_of_bytes_written += result ;
+        }
+
+        return number_of_bytes_written ;
+    }
+
+    inline
+    std::streamsize
+    SerialStreamBuf::Implementation::ReadFromPort(char_type* character,
+                                                  std::streamsize numberOfBytes,
+                                                  const std::chrono::steady_clock::time_point& deadline)
+    {
+        const auto fd = mSerialPort.GetFileDescriptor() ;
+        mReadTimedOut = false ;
+
+        while (true)
+        {
+            // A blocking read() cannot be interrupted at the deadline, so
+            // wait for data first when a read timeout is set.
+            if ((mReadTimeout.count() > 0) and
+                (not this->WaitForInput(deadline)))
+            {
+                mReadTimedOut = true ;
+                return 0 ;
+            }
+
+            const auto result = call_with_retry(read,
+                                                fd,
+                                                character,
+                                                static_cast<size_t>(numberOfBytes)) ;
+
+            if (result > 0)
+            {
+                return result ;
+            }
+
+            // For a terminal device, no data means that VTIME elapsed
+            // before VMIN characters arrived, unless the device hung up.
+            if (result == 0)
+            {
+                pollfd poll_fd {fd, POLLIN, 0} ;
+
+                if ((call_with_retry(poll, &poll_fd, 1, 0) > 0) and
+                    ((poll_fd.revents & POLLHUP) != 0))
+                {
+                    throw std::runtime_error(std::strerror(EIO)) ;
+                }
+
+                mReadTimedOut = true ;
+                return 0 ;
+            }
+
+            if (errno != EAGAIN)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            // The port is in non-blocking mode. Wait for data instead of
+            // reporting the absence of data as an error.
+            if ((mReadTimeout.count() == 0) and
+                (not this->WaitForInput(deadline)))
+            {
+                mReadTimedOut = true ;
+                return 0 ;
+            }
+        }
+    }
+
+    inline
+    bool
+    SerialStreamBuf::Implementation::WaitForInput(const std::chrono::steady_clock::time_point& deadline)
+    {
+        int ms_timeout = -1 ;
+
+        if (mReadTimeout.count() > 0)
+        {
+            // Round up so that poll() does not return just before the deadline.
+            const auto us_remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                deadline - std::chrono::steady_clock::now()).count() ;
+
+            ms_timeout = (us_remaining <= 0) ? 0 :
+                static_cast<int>((us_remaining + MICROSECONDS_PER_MS - 1) / MICROSECONDS_PER_MS) ;
+        }
+
+        pollfd poll_fd {mSerialPort.GetFileDescriptor(), POLLIN, 0} ;
+        const auto result = call_with_retry(poll, &poll_fd, 1, ms_timeout) ;
+
+        if (result < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        return result > 0 ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::ResetGetArea()
+    {
+        mSerialStreamBuf->setg(mGetBuffer + STREAM_PUTBACK_SIZE,
+                               mGetBuffer + STREAM_PUTBACK_SIZE,
+                               mGetBuffer + STREAM_PUTBACK_SIZE) ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::ResetPutArea()
+    {
+        mSerialStreamBuf->setp(mPutBuffer, mPutBuffer + mPutBufferSize) ;
     }
 } // namespace LibSerial
@@ -0,0 +1,796 @@
+/******************************************************************************
+ * @file SerialTransactionEngine.cpp                                          *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialTransactionEngine.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <poll.h>
+#include <stdexcept>
+#include <utility>
+
+namespace LibSerial
+{
+    ReplyFramer
+    MakeLineFramer(const char lineTerminator)
+    {
+        return [lineTerminator](const uint8_t* const data,
+                                const size_t         size) -> size_t
+        {
+            const auto line_end = std::find(data,
+                                            data + size,
+                                            static_cast<uint8_t>(lineTerminator)) ;
+
+            if (line_end == data + size)
+            {
+                return 0 ;
+            }
+
+            return static_cast<size_t>(line_end - data) + 1 ;
+        } ;
+    }
+
+    ReplyMatcher
+    MakeFieldMatcher(const size_t requestOffset,
+                     const size_t replyOffset,
+                     const size_t fieldSize)
+    {
+        return [requestOffset, replyOffset, fieldSize](const DataBuffer& request,
+                                                       const DataBuffer& reply)
+        {
+            if ((request.size() < requestOffset + fieldSize) or
+                (reply.size() < replyOffset + fieldSize))
+            {
+                return false ;
+            }
+
+            return std::equal(request.begin() + requestOffset,
+                              request.begin() + requestOffset + fieldSize,
+                              reply.begin() + replyOffset) ;
+        } ;
+    }
+
+    /**
+     * @brief SerialTransactionEngine::Implementation is the
+     *        SerialTransactionEngine implementation class.
+     */
+    class SerialTransactionEngine::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param serialPort The serial port used for the transactions.
+         * @param replyFramer The function that delimits replies.
+         * @param replyMatcher The function that matches replies to requests.
+         */
+        Implementation(SerialPort&         serialPort,
+                       const ReplyFramer&  replyFramer,
+                       const ReplyMatcher& replyMatcher) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Sets the maximum number of requests awaiting a reply.
+         * @param maximumOutstanding The maximum number of requests awaiting
+         *        a reply.
+         */
+        void SetMaximumOutstanding(const size_t maximumOutstanding) ;
+
+        /**
+         * @brief Gets the maximum number of requests awaiting a reply.
+         * @return Returns the maximum number of requests awaiting a reply.
+         */
+        size_t GetMaximumOutstanding() const ;
+
+        /**
+         * @brief Submits a request.
+         * @param request The request to be written to the serial port.
+         * @param msTimeout The time in milliseconds allowed for the reply.
+         * @return Returns the id of the transaction.
+         */
+        TransactionId Submit(const DataBuffer& request,
+                             const size_t      msTimeout) ;
+
+        /**
+         * @brief Processes events until a transaction has finished or the
+         *        timeout has elapsed.
+         * @param msTimeout The maximum time to wait in milliseconds.
+         * @return Returns the transactions that have finished.
+         */
+        std::vector<SerialTransaction> ProcessEvents(const size_t msTimeout) ;
+
+        /**
+         * @brief Submits a request and processes events until it has finished.
+         * @param request The request to be written to the serial port.
+         * @param msTimeout The time in milliseconds allowed for the reply.
+         * @return Returns the finished transaction.
+         */
+        SerialTransaction Transact(const DataBuffer& request,
+                                   const size_t      msTimeout) ;
+
+        /**
+         * @brief Gets the number of transactions that have not finished.
+         * @return Returns the number of pending transactions.
+         */
+        size_t GetNumberOfPendingTransactions() const ;
+
+        /**
+         * @brief Gets the counters maintained by the engine.
+         * @return Returns a copy of the counters.
+         */
+        SerialTransactionStatistics GetStatistics() const ;
+
+        /**
+         * @brief Resets the counters maintained by the engine to zero.
+         */
+        void ResetStatistics() ;
+
+    private:
+
+        /**
+         * @brief A submitted transaction that has not finished.
+         */
+        struct PendingTransaction
+        {
+            TransactionId transactionId {0} ;
+            DataBuffer request {} ;
+            size_t msTimeout {0} ;
+            std::chrono::steady_clock::time_point writeTime {} ;
+        } ;
+
+        /**
+         * @brief An entry of the timer wheel.
+         */
+        struct TimerEntry
+        {
+            TransactionId transactionId {0} ;
+            uint64_t deadlineTick {0} ;
+        } ;
+
+        /**
+         * @brief Processes events until isDone() returns true or the end
+         *        time has been reached.
+         * @param endTime The time to return at the latest.
+         * @param isDone Determines if the caller's condition is met.
+         */
+        void ProcessUntil(const std::chrono::steady_clock::time_point& endTime,
+                          const std::function<bool()>&                 isDone) ;
+
+        /**
+         * @brief Writes queued requests while fewer than the maximum number
+         *        of requests are outstanding, and starts their deadlines.
+         */
+        void WriteQueuedRequests() ;
+
+        /**
+         * @brief Reads the available data from the serial port and matches
+         *        the complete replies to outstanding requests.
+         */
+        void ReadReplies() ;
+
+        /**
+         * @brief Finishes the oldest outstanding request accepted by the
+         *        reply matcher, or counts the reply as unmatched.
+         * @param reply The complete reply.
+         * @param receiveTime The time the reply was read.
+         */
+        void MatchReply(DataBuffer&&                                 reply,
+                        const std::chrono::steady_clock::time_point& receiveTime) ;
+
+        /**
+         * @brief Advances the timer wheel to the current time and finishes
+         *        the outstanding requests whose deadline has passed.
+         * @param currentTime The current time.
+         */
+        void AdvanceTimerWheel(const std::chrono::steady_clock::time_point& currentTime) ;
+
+        /**
+         * @brief Gets the time of the first occupied tick of the timer
+         *        wheel, which is no later than the earliest deadline.
+         * @return Returns the time, or time_point::max() if the wheel is empty.
+         */
+        std::chrono::steady_clock::time_point GetNextTimerTime() const ;
+
+        /**
+         * @brief Converts a time to a tick of the timer wheel.
+         * @param time The time to convert.
+         * @param roundUp True to round up to the next tick.
+         * @return Returns the tick.
+         */
+        uint64_t GetTick(const std::chrono::steady_clock::time_point& time,
+                         const bool                                   roundUp) const ;
+
+        /**
+         * @brief Records a finished transaction.
+         * @param pendingTransaction The transaction.
+         * @param status The outcome of the transaction.
+         * @param reply The reply, if any.
+         * @param finishTime The time the transaction finished.
+         */
+        void FinishTransaction(PendingTransaction&&                         pendingTransaction,
+                               const TransactionStatus                      status,
+                               DataBuffer&&                                 reply,
+                               const std::chrono::steady_clock::time_point& finishTime) ;
+
+        /**
+         * The serial port used for the transactions.
+         */
+        SerialPort* mSerialPort ;
+
+        /**
+         * The function that delimits replies.
+         */
+        ReplyFramer mReplyFramer ;
+
+        /**
+         * The function that matches replies to requests, or an empty
+         * function to match each reply to the oldest outstanding request.
+         */
+        ReplyMatcher mReplyMatcher ;
+
+        /**
+         * The maximum number of requests awaiting a reply.
+         */
+        size_t mMaximumOutstanding = 1 ;
+
+        /**
+         * The id of the next submitted transaction.
+         */
+        TransactionId mNextTransactionId = 1 ;
+
+        /**
+         * The submitted requests that have not been written yet.
+         */
+        std::deque<PendingTransaction> mQueuedTransactions {} ;
+
+        /**
+         * The written requests awaiting a reply, in the order written.
+         */
+        std::deque<PendingTransaction> mOutstandingTransactions {} ;
+
+        /**
+         * The transactions that have finished and not been returned yet.
+         */
+        std::vector<SerialTransaction> mFinishedTransactions {} ;
+
+        /**
+         * The received data that does not form a complete reply yet.
+         */
+        DataBuffer mReceiveBuffer {} ;
+
+        /**
+         * The deadlines of the outstanding requests, hashed by tick. Entries
+         * of requests that have already finished are dropped lazily.
+         */
+        std::array<std::vector<TimerEntry>, TRANSACTION_TIMER_WHEEL_SLOTS> mTimerWheel {} ;
+
+        /**
+         * The time of tick 0 of the timer wheel.
+         */
+        std::chrono::steady_clock::time_point mTimerEpoch {std::chrono::steady_clock::now()} ;
+
+        /**
+         * The last tick processed by the timer wheel.
+         */
+        uint64_t mCurrentTick = 0 ;
+
+        /**
+         * The counters maintained by the engine.
+         */
+        SerialTransactionStatistics mStatistics {} ;
+    } ;
+
+    SerialTransactionEngine::SerialTransactionEngine(SerialPort&         serialPort,
+                                                     const ReplyFramer&  replyFramer,
+                                                     const ReplyMatcher& replyMatcher)
+        : mImpl(new Implementation(serialPort, replyFramer, replyMatcher))
+    {
+        /* Empty */
+    }
+
+    SerialTransactionEngine::~SerialTransactionEngine() = default ;
+
+    SerialTransactionEngine::SerialTransactionEngine(SerialTransactionEngine&& otherSerialTransactionEngine) :
+        mImpl(std::move(otherSerialTransactionEngine.mImpl))
+    {
+        // empty
+    }
+
+    SerialTransactionEngine&
+    SerialTransactionEngine::operator=(SerialTransactionEngine&& otherSerialTransactionEngine)
+    {
+        mImpl = std::move(otherSerialTransactionEngine.mImpl) ;
+        return *this ;
+    }
+
+    void
+    SerialTransactionEngine::SetMaximumOutstanding(const size_t maximumOutstanding)
+    {
+        mImpl->SetMaximumOutstanding(maximumOutstanding) ;
+    }
+
+    size_t
+    SerialTransactionEngine::GetMaximumOutstanding() const
+    {
+        return mImpl->GetMaximumOutstanding() ;
+    }
+
+    TransactionId
+    SerialTransactionEngine::Submit(const DataBuffer& request,
+                                    const size_t      msTimeout)
+    {
+        return mImpl->Submit(request, msTimeout) ;
+    }
+
+    std::vector<SerialTransaction>
+    SerialTransactionEngine::ProcessEvents(const size_t msTimeout)
+    {
+        return mImpl->ProcessEvents(msTimeout) ;
+    }
+
+    SerialTransaction
+    SerialTransactionEngine::Transact(const DataBuffer& request,
+                                      const size_t      msTimeout)
+    {
+        return mImpl->Transact(request, msTimeout) ;
+    }
+
+    size_t
+    SerialTransactionEngine::GetNumberOfPendingTransactions() const
+    {
+        return mImpl->GetNumberOfPendingTransactions() ;
+    }
+
+    SerialTransactionStatistics
+    SerialTransactionEngine::GetStatistics() const
+    {
+        return mImpl->GetStatistics() ;
+    }
+
+    void
+    SerialTransactionEngine::ResetStatistics()
+    {
+        mImpl->ResetStatistics() ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    SerialTransactionEngine::Implementation::Implementation(SerialPort&         serialPort,
+                                                            const ReplyFramer&  replyFramer,
+                                                            const ReplyMatcher& replyMatcher)
+        : mSerialPort(&serialPort)
+        , mReplyFramer(replyFramer)
+        , mReplyMatcher(replyMatcher)
+    {
+        if (not mReplyFramer)
+        {
+            throw std::invalid_argument {"A reply framer is required."} ;
+        }
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::SetMaximumOutstanding(const size_t maximumOutstanding)
+    {
+        if (maximumOutstanding == 0)
+        {
+            throw std::invalid_argument {"At least one request must be allowed to be outstanding."} ;
+        }
+
+        mMaximumOutstanding = maximumOutstanding ;
+    }
+
+    inline
+    size_t
+    SerialTransactionEngine::Implementation::GetMaximumOutstanding() const
+    {
+        return mMaximumOutstanding ;
+    }
+
+    inline
+    TransactionId
+    SerialTransactionEngine::Implementation::Submit(const DataBuffer& request,
+                                                    const size_t      msTimeout)
+    {
+        PendingTransaction pending_transaction {} ;
+        pending_transaction.transactionId = mNextTransactionId++ ;
+        pending_transaction.request = request ;
+        pending_transaction.msTimeout = msTimeout ;
+
+        mQueuedTransactions.push_back(std::move(pending_transaction)) ;
+
+        return mQueuedTransactions.back().transactionId ;
+    }
+
+    inline
+    std::vector<SerialTransaction>
+    SerialTransactionEngine::Implementation::ProcessEvents(const size_t msTimeout)
+    {
+        const auto end_time = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(msTimeout) ;
+
+        this->ProcessUntil(end_time, [this]()
+        {
+            return not mFinishedTransactions.empty() ;
+        }) ;
+
+        std::vector<SerialTransaction> finished_transactions {} ;
+        finished_transactions.swap(mFinishedTransactions) ;
+
+        return finished_transactions ;
+    }
+
+    inline
+    SerialTransaction
+    SerialTransactionEngine::Implementation::Transact(const DataBuffer& request,
+                                                      const size_t      msTimeout)
+    {
+        const auto transaction_id = this->Submit(request, msTimeout) ;
+
+        const auto find_transaction = [this, transaction_id]()
+        {
+            return std::find_if(mFinishedTransactions.begin(),
+                                mFinishedTransactions.end(),
+                                [transaction_id](const SerialTransaction& serialTransaction)
+                                {
+                                    return serialTransaction.transactionId == transaction_id ;
+                                }) ;
+        } ;
+
+        // The deadline of the request guarantees that it finishes.
+        this->ProcessUntil(std::chrono::steady_clock::time_point::max(), [this, &find_transaction]()
+        {
+            return find_transaction() != mFinishedTransactions.end() ;
+        }) ;
+
+        const auto finished_transaction = find_transaction() ;
+        auto serial_transaction = std::move(*finished_transaction) ;
+        mFinishedTransactions.erase(finished_transaction) ;
+
+        return serial_transaction ;
+    }
+
+    inline
+    size_t
+    SerialTransactionEngine::Implementation::GetNumberOfPendingTransactions() const
+    {
+        return mQueuedTransactions.size() + mOutstandingTransactions.size() ;
+    }
+
+    inline
+    SerialTransactionStatistics
+    SerialTransactionEngine::Implementation::GetStatistics() const
+    {
+        return mStatistics ;
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::ResetStatistics()
+    {
+        mStatistics = SerialTransactionStatistics {} ;
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::ProcessUntil(const std::chrono::steady_clock::time_point& endTime,
+                                                          const std::function<bool()>&                 isDone)
+    {
+        while (true)
+        {
+            this->WriteQueuedRequests() ;
+            this->ReadReplies() ;
+
+            const auto current_time = std::chrono::steady_clock::now() ;
+            this->AdvanceTimerWheel(current_time) ;
+
+            // Keep the link busy with the requests that fit now.
+            this->WriteQueuedRequests() ;
+
+            if (isDone() or
+                (current_time >= endTime))
+            {
+                return ;
+            }
+
+            // Wait for data, or until the next deadline may have passed.
+            const auto wake_time = std::min(endTime, this->GetNextTimerTime()) ;
+
+            int poll_timeout = -1 ;
+
+            if (wake_time != std::chrono::steady_clock::time_point::max())
+            {
+                const auto wait_time = std::chrono::duration_cast<std::chrono::microseconds>(wake_time - current_time) ;
+                poll_timeout = static_cast<int>((std::max(wait_time.count(), int64_t {0}) + MICROSECONDS_PER_MS - 1) /
+                                                MICROSECONDS_PER_MS) ;
+            }
+
+            pollfd poll_fd {mSerialPort->GetFileDescriptor(), POLLIN, 0} ;
+            call_with_retry(poll, &poll_fd, 1, poll_timeout) ;
+        }
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::WriteQueuedRequests()
+    {
+        while ((not mQueuedTransactions.empty()) and
+               (mOutstandingTransactions.size() < mMaximumOutstanding))
+        {
+            auto& pending_transaction = mQueuedTransactions.front() ;
+
+            // The request stays queued if writing it fails.
+            mSerialPort->Write(pending_transaction.request) ;
+            pending_transaction.writeTime = std::chrono::steady_clock::now() ;
+
+            const auto deadline_time = pending_transaction.writeTime +
+                                       std::chrono::milliseconds(pending_transaction.msTimeout) ;
+
+            // A deadline in a tick already processed expires on the next one.
+            const auto deadline_tick = std::max(this->GetTick(deadline_time, true),
+                                                mCurrentTick + 1) ;
+
+            mTimerWheel[deadline_tick % TRANSACTION_TIMER_WHEEL_SLOTS].push_back({pending_transaction.transactionId,
+                                                                                   deadline_tick}) ;
+
+            mOutstandingTransactions.push_back(std::move(pending_transaction)) ;
+            mQueuedTransactions.pop_front() ;
+        }
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::ReadReplies()
+    {
+        const auto number_of_bytes_available = mSerialPort->GetNumberOfBytesAvailable() ;
+
+        if (number_of_bytes_available <= 0)
+        {
+            return ;
+        }
+
+        DataBuffer received_data {} ;
+
+        try
+        {
+            mSerialPort->Read(received_data,
+                              static_cast<size_t>(number_of_bytes_available),
+                              1) ;
+        }
+        catch (const ReadTimeout&)
+        {
+            // The data read before the timeout is kept in received_data.
+        }
+
+        const auto receive_time = std::chrono::steady_clock::now() ;
+
+        mReceiveBuffer.insert(mReceiveBuffer.end(),
+                              received_data.begin(),
+                              received_data.end()) ;
+
+        size_t reply_start = 0 ;
+
+        while (reply_start < mReceiveBuffer.size())
+        {
+            const auto reply_size = mReplyFramer(&mReceiveBuffer[reply_start],
+                                                 mReceiveBuffer.size() - reply_start) ;
+
+            if ((reply_size == 0) or
+                (reply_size > mReceiveBuffer.size() - reply_start))
+            {
+                break ;
+            }
+
+            DataBuffer reply(mReceiveBuffer.begin() + reply_start,
+                             mReceiveBuffer.begin() + reply_start + reply_size) ;
+
+            this->MatchReply(std::move(reply), receive_time) ;
+            reply_start += reply_size ;
+        }
+
+        mReceiveBuffer.erase(mReceiveBuffer.begin(),
+                             mReceiveBuffer.begin() + reply_start) ;
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::MatchReply(DataBuffer&&                                 reply,
+                                                        const std::chrono::steady_clock::time_point& receiveTime)
+    {
+        const auto outstanding_transaction = std::find_if(mOutstandingTransactions.begin(),
+                                                          mOutstandingTransactions.end(),
+                                                          [this, &reply](const PendingTransaction& pendingTransaction)
+                                                          {
+                                                              return (not mReplyMatcher) or
+                                                                     mReplyMatcher(pendingTransaction.request, reply) ;
+                                                          }) ;
+
+        if (outstanding_transaction == mOutstandingTransactions.end())
+        {
+            mStatistics.unmatchedReplyCount++ ;
+            return ;
+        }
+
+        auto pending_transaction = std::move(*outstanding_transaction) ;
+        mOutstandingTransactions.erase(outstanding_transaction) ;
+
+        this->FinishTransaction(std::move(pending_transaction),
+                                TransactionStatus::COMPLETED,
+                                std::move(reply),
+                                receiveTime) ;
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::AdvanceTimerWheel(const std::chrono::steady_clock::time_point& currentTime)
+    {
+        const auto current_tick = this->GetTick(currentTime, false) ;
+
+        if (current_tick <= mCurrentTick)
+        {
+            return ;
+        }
+
+        // Each slot needs to be visited at most once.
+        const auto number_of_ticks = std::min(current_tick - mCurrentTick,
+                                              uint64_t {TRANSACTION_TIMER_WHEEL_SLOTS}) ;
+
+        for (uint64_t tick = current_tick - number_of_ticks + 1; tick <= current_tick; ++tick)
+        {
+            auto& timer_slot = mTimerWheel[tick % TRANSACTION_TIMER_WHEEL_SLOTS] ;
+
+            // Entries of later revolutions of the wheel stay in the slot.
+            const auto expired_entries = std::stable_partition(timer_slot.begin(),
+                                                               timer_slot.end(),
+                                                               [current_tick](const TimerEntry& timerEntry)
+                                                               {
+                                                                   return timerEntry.deadlineTick > current_tick ;
+                                                               }) ;
+
+            for (auto timer_entry = expired_entries; timer_entry != timer_slot.end(); ++timer_entry)
+            {
+                const auto transaction_id = timer_entry->transactionId ;
+
+                const auto outstanding_transaction = std::find_if(mOutstandingTransactions.begin(),
+                                                                  mOutstandingTransactions.end(),
+                                                                  [transaction_id](const PendingTransaction& pendingTransaction)
+                                                                  {
+                                                                      return pendingTransaction.transactionId == transaction_id ;
+                                                                  }) ;
+
+                // The request may have received its reply already.
+                if (outstanding_transaction == mOutstandingTransactions.end())
+                {
+                    continue ;
+                }
+
+                auto pending_transaction = std::move(*outstanding_transaction) ;
+                mOutstandingTransactions.erase(outstanding_transaction) ;
+
+                this->FinishTransaction(std::move(pending_transaction),
+                                        TransactionStatus::TIMED_OUT,
+                                        DataBuffer {},
+                                        currentTime) ;
+            }
+
+            timer_slot.erase(expired_entries, timer_slot.end()) ;
+        }
+
+        mCurrentTick = current_tick ;
+    }
+
+    inline
+    std::chrono::steady_clock::time_point
+    SerialTransactionEngine::Implementation::GetNextTimerTime() const
+    {
+        for (uint64_t tick = mCurrentTick + 1; tick <= mCurrentTick + TRANSACTION_TIMER_WHEEL_SLOTS; ++tick)
+        {
+            if (not mTimerWheel[tick % TRANSACTION_TIMER_WHEEL_SLOTS].empty())
+            {
+                return mTimerEpoch + std::chrono::milliseconds(tick * TRANSACTION_TIMER_TICK_MS) ;
+            }
+        }
+
+        return std::chrono::steady_clock::time_point::max() ;
+    }
+
+    inline
+    uint64_t
+    SerialTransactionEngine::Implementation::GetTick(const std::chrono::steady_clock::time_point& time,
+                                                     const bool                                   roundUp) const
+    {
+        const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(time - mTimerEpoch).count() ;
+        const auto tick_us = static_cast<int64_t>(TRANSACTION_TIMER_TICK_MS) * MICROSECONDS_PER_MS ;
+
+        return static_cast<uint64_t>(roundUp ? (elapsed_us + tick_us - 1) / tick_us : elapsed_us / tick_us) ;
+    }
+
+    inline
+    void
+    SerialTransactionEngine::Implementation::FinishTransaction(PendingTransaction&&                         pendingTransaction,
+                                                               const TransactionStatus                      status,
+                                                               DataBuffer&&                                 reply,
+                                                               const std::chrono::steady_clock::time_point& finishTime)
+    {
+        SerialTransaction serial_transaction {} ;
+        serial_transaction.transactionId = pendingTransaction.transactionId ;
+        serial_transaction.status = status ;
+        serial_transaction.request = std::move(pendingTransaction.request) ;
+        serial_transaction.reply = std::move(reply) ;
+
+        const auto latency = finishTime - pendingTransaction.writeTime ;
+        serial_transaction.latencyUs = static_cast<size_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count()) ;
+
+        if (status == TransactionStatus::COMPLETED)
+        {
+            mStatistics.completedCount++ ;
+            mStatistics.totalLatencyUs += serial_transaction.latencyUs ;
+            mStatistics.maximumLatencyUs = std::max(mStatistics.maximumLatencyUs, serial_transaction.latencyUs) ;
+            mStatistics.minimumLatencyUs = (mStatistics.completedCount == 1) ?
+                                           serial_transaction.latencyUs :
+                                           std::min(mStatistics.minimumLatencyUs, serial_transaction.latencyUs) ;
+        }
+        else
+        {
+            mStatistics.timedOutCount++ ;
+        }
+
+        mFinishedTransactions.push_back(std::move(serial_transaction)) ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,531 @@
+/******************************************************************************
+ * @file SerialCapture.h                                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPortConstants.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief Default size of a capture segment file in bytes.
+     */
+    constexpr size_t CAPTURE_SEGMENT_SIZE_DEFAULT = 16 * 1024 * 1024 ;
+
+    /**
+     * @brief Minimum size of a capture segment file in bytes.
+     */
+    constexpr size_t CAPTURE_SEGMENT_SIZE_MINIMUM = 4096 ;
+
+    /**
+     * @brief Replay speed reproducing the original timing of a capture.
+     */
+    constexpr double REPLAY_SPEED_REAL_TIME = 1.0 ;
+
+    /**
+     * @brief Replay speed writing the records of a capture without delay.
+     */
+    constexpr double REPLAY_SPEED_AS_FAST_AS_POSSIBLE = 0.0 ;
+
+    /**
+     * @brief Port id selecting the records of all serial ports for replay.
+     */
+    constexpr uint32_t REPLAY_ALL_PORTS = UINT32_MAX ;
+
+    /**
+     * @brief Default size of the buffer of a flight recorder in bytes.
+     */
+    constexpr size_t FLIGHT_RECORDER_SIZE_DEFAULT = 64 * 1024 ;
+
+    /**
+     * @brief Minimum size of the buffer of a flight recorder in bytes.
+     */
+    constexpr size_t FLIGHT_RECORDER_SIZE_MINIMUM = 256 ;
+
+    /**
+     * @brief The direction of the data in a capture record.
+     */
+    enum class CaptureDirection : uint8_t
+    {
+        RECEIVED    = 0,
+        TRANSMITTED = 1
+    } ;
+
+    /**
+     * @brief The events on which a SerialPort passes the contents of its
+     *        flight recorder to the flight recorder callback.
+     */
+    enum class FlightRecorderTrigger
+    {
+        READ_TIMEOUT, // !< A Read*() method threw ReadTimeout.
+        PARSE_ERROR,  // !< The application called SerialPort::ReportParseError().
+        DISCONNECTED  // !< The device hung up.
+    } ;
+
+    /**
+     * @brief A chunk of data read from or written to a serial port.
+     */
+    struct CaptureRecord
+    {
+        /**
+         * @brief The CLOCK_MONOTONIC time the chunk was read or written, in
+         *        nanoseconds.
+         */
+        uint64_t timestampNs {0} ;
+
+        /**
+         * @brief The id passed to SerialPort::SetCapture().
+         */
+        uint32_t portId {0} ;
+
+        /**
+         * @brief The direction of the data.
+         */
+        CaptureDirection direction {CaptureDirection::RECEIVED} ;
+
+        /**
+         * @brief The data read or written.
+         */
+        DataBuffer data {} ;
+    } ;
+
+    /**
+     * @brief SerialCaptureWriter appends CaptureRecords to a capture, a
+     *        series of segment files named (basePath).000000,
+     *        (basePath).000001 and so on. Each segment is preallocated and
+     *        memory-mapped, so that appending a record only copies it into
+     *        the mapping and makes no system call. A new segment is created
+     *        when a record does not fit into the current one. Chunks larger
+     *        than a segment are split into several records.
+     *
+     *        A SerialCaptureWriter can be shared by several serial ports and
+     *        threads, see SerialPort::SetCapture().
+     */
+    class SerialCaptureWriter
+    {
+    public:
+
+        /**
+         * @brief Constructor. Creates the first segment of the capture,
+         *        replacing any existing capture at basePath.
+         * @param basePath The path of the segment files without the suffix.
+         * @param segmentSize The size of each segment file in bytes.
+         * @throw std::invalid_argument if segmentSize is less than
+         *        CAPTURE_SEGMENT_SIZE_MINIMUM.
+         * @throw std::runtime_error if the segment cannot be created.
+         */
+        explicit SerialCaptureWriter(const std::string& basePath,
+                                     const size_t       segmentSize = CAPTURE_SEGMENT_SIZE_DEFAULT) ;
+
+        /**
+         * @brief Destructor. Closes the capture.
+         */
+        virtual ~SerialCaptureWriter() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialCaptureWriter(const SerialCaptureWriter& otherSerialCaptureWriter) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialCaptureWriter(SerialCaptureWriter&& otherSerialCaptureWriter) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialCaptureWriter& operator=(const SerialCaptureWriter& otherSerialCaptureWriter) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialCaptureWriter& operator=(SerialCaptureWriter&& otherSerialCaptureWriter) ;
+
+        /**
+         * @brief Appends a record with the current CLOCK_MONOTONIC time.
+         * @param portId The id of the serial port.
+         * @param direction The direction of the data.
+         * @param data The data read or written.
+         * @param numberOfBytes The number of bytes of data.
+         */
+        void Record(const uint32_t         portId,
+                    const CaptureDirection direction,
+                    const void*            data,
+                    const size_t           numberOfBytes) ;
+
+        /**
+         * @brief Schedules the records appended so far to be written to
+         *        disk, without waiting for it.
+         */
+        void Flush() ;
+
+        /**
+         * @brief Closes the capture. Further records are discarded.
+         */
+        void Close() ;
+
+        /**
+         * @brief Gets the number of segment files of the capture.
+         * @return Returns the number of segment files.
+         */
+        size_t GetNumberOfSegments() const ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialCaptureWriter
+
+    /**
+     * @brief SerialCaptureReader iterates over the records of a capture
+     *        written by SerialCaptureWriter, in the order they were
+     *        appended. The segments are memory-mapped one at a time.
+     */
+    class SerialCaptureReader
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param basePath The path of the segment files without the suffix.
+         * @throw std::runtime_error if the first segment cannot be opened
+         *        or is not a capture segment.
+         */
+        explicit SerialCaptureReader(const std::string& basePath) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialCaptureReader() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialCaptureReader(const SerialCaptureReader& otherSerialCaptureReader) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialCaptureReader(SerialCaptureReader&& otherSerialCaptureReader) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialCaptureReader& operator=(const SerialCaptureReader& otherSerialCaptureReader) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialCaptureReader& operator=(SerialCaptureReader&& otherSerialCaptureReader) ;
+
+        /**
+         * @brief Reads the next record.
+         * @param captureRecord The record read.
+         * @return Returns false if there are no more records.
+         * @throw std::runtime_error if a segment is not a capture segment.
+         */
+        bool ReadNext(CaptureRecord& captureRecord) ;
+
+        /**
+         * @brief Restarts the iteration at the first record.
+         */
+        void Rewind() ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialCaptureReader
+
+    /**
+     * @brief Counters reported by SerialCaptureReplayer::Replay().
+     */
+    struct SerialCaptureReplayStatistics
+    {
+        /**
+         * @brief The number of records written.
+         */
+        size_t recordCount {0} ;
+
+        /**
+         * @brief The number of bytes written.
+         */
+        size_t byteCount {0} ;
+
+        /**
+         * @brief The duration of the replay in microseconds.
+         */
+        uint64_t durationUs {0} ;
+
+        /**
+         * @brief The largest delay of a record behind its scheduled time in
+         *        microseconds.
+         */
+        uint64_t maximumLatenessUs {0} ;
+
+        /**
+         * @brief The sum of the delays of the records behind their scheduled
+         *        time in microseconds.
+         */
+        uint64_t totalLatenessUs {0} ;
+    } ;
+
+    /**
+     * @brief SerialCaptureReplayer writes the device side of a capture to a
+     *        file descriptor, by default the master side of a pseudo
+     *        terminal whose slave side an unmodified application opens as
+     *        its serial port. The records of one direction are written with
+     *        their original spacing, scaled by the replay speed, or as fast
+     *        as possible. The waits use absolute CLOCK_MONOTONIC deadlines,
+     *        so timing errors do not accumulate.
+     */
+    class SerialCaptureReplayer
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param basePath The path of the segment files without the suffix.
+         * @throw std::runtime_error if the capture cannot be opened.
+         */
+        explicit SerialCaptureReplayer(const std::string& basePath) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialCaptureReplayer() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialCaptureReplayer(const SerialCaptureReplayer& otherSerialCaptureReplayer) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialCaptureReplayer(SerialCaptureReplayer&& otherSerialCaptureReplayer) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialCaptureReplayer& operator=(const SerialCaptureReplayer& otherSerialCaptureReplayer) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialCaptureReplayer& operator=(SerialCaptureReplayer&& otherSerialCaptureReplayer) ;
+
+        /**
+         * @brief Sets the replay speed as a multiple of the original speed.
+         * @param speed The replay speed, e.g. REPLAY_SPEED_REAL_TIME, 10.0
+         *        for ten times faster, or REPLAY_SPEED_AS_FAST_AS_POSSIBLE.
+         * @throw std::invalid_argument if speed is negative.
+         */
+        void SetSpeed(const double speed) ;
+
+        /**
+         * @brief Selects the records to be replayed. By default, the data
+         *        received from the device by all serial ports is replayed.
+         * @param direction The direction of the records to be replayed.
+         * @param portId The port id of the records to be replayed, or
+         *        REPLAY_ALL_PORTS.
+         */
+        void SetFilter(const CaptureDirection direction,
+                       const uint32_t         portId = REPLAY_ALL_PORTS) ;
+
+        /**
+         * @brief Creates the pseudo terminal Replay() writes to. The slave
+         *        side is put in raw mode and stays open until the replayer
+         *        is destroyed, so data is buffered until it is read.
+         * @return Returns the path of the slave side, e.g. /dev/pts/3.
+         * @throw std::runtime_error if the pseudo terminal cannot be created.
+         */
+        std::string OpenPseudoTerminal() ;
+
+        /**
+         * @brief Replays the capture into the pseudo terminal created by
+         *        OpenPseudoTerminal().
+         * @return Returns the counters of the replay.
+         * @throw std::logic_error if no pseudo terminal has been created.
+         * @throw OperationCancelled if Cancel() has been called.
+         */
+        SerialCaptureReplayStatistics Replay() ;
+
+        /**
+         * @brief Replays the capture into a file descriptor.
+         * @param fileDescriptor The file descriptor to write to.
+         * @return Returns the counters of the replay.
+         * @throw OperationCancelled if Cancel() has been called.
+         * @throw std::runtime_error if writing fails.
+         */
+        SerialCaptureReplayStatistics Replay(const int fileDescriptor) ;
+
+        /**
+         * @brief Stops a replay in progress in another thread, which then
+         *        throws OperationCancelled. The cancellation remains in
+         *        effect for later calls of Replay().
+         */
+        void Cancel() noexcept ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialCaptureReplayer
+
+    /**
+     * @brief SerialFlightRecorder keeps the most recent data read from and
+     *        written to a serial port in memory, for post-mortem analysis.
+     *        Each direction has a ring buffer. Recording a chunk copies it
+     *        into the ring and stores a CLOCK_MONOTONIC_COARSE timestamp; it
+     *        takes no lock and makes no system call, so the reading and the
+     *        writing thread of a serial port record concurrently. The chunks
+     *        of one direction must be recorded by one thread at a time.
+     *
+     *        Each ring holds the last bufferSize bytes of its direction, in
+     *        at most bufferSize / 16 chunks. Dump() may run concurrently
+     *        with Record(); a chunk that is overwritten while Dump() copies
+     *        it is truncated to its intact part or omitted.
+     */
+    class SerialFlightRecorder
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param bufferSize The number of bytes kept per direction, rounded
+         *        up to a power of two.
+         * @throw std::invalid_argument if bufferSize is less than
+         *        FLIGHT_RECORDER_SIZE_MINIMUM.
+         */
+        explicit SerialFlightRecorder(const size_t bufferSize = FLIGHT_RECORDER_SIZE_DEFAULT) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialFlightRecorder() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialFlightRecorder(const SerialFlightRecorder& otherSerialFlightRecorder) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialFlightRecorder(SerialFlightRecorder&& otherSerialFlightRecorder) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialFlightRecorder& operator=(const SerialFlightRecorder& otherSerialFlightRecorder) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialFlightRecorder& operator=(SerialFlightRecorder&& otherSerialFlightRecorder) ;
+
+        /**
+         * @brief Records a chunk of data. Only the last bufferSize bytes of
+         *        a larger chunk are kept.
+         * @param direction The direction of the data.
+         * @param data The data read or written.
+         * @param numberOfBytes The number of bytes of data.
+         */
+        void Record(const CaptureDirection direction,
+                    const void*            data,
+                    const size_t           numberOfBytes) noexcept ;
+
+        /**
+         * @brief Copies the chunks held by the recorder. Chunks that are
+         *        still being recorded by another thread are not included.
+         * @return Returns the chunks, oldest first, with a portId of 0.
+         */
+        std::vector<CaptureRecord> Dump() const ;
+
+        /**
+         * @brief Gets the number of bytes the recorder holds per direction.
+         * @return Returns the size of the buffer of each direction in bytes.
+         */
+        size_t GetBufferSize() const ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialFlightRecorder
+
+} // namespace LibSerial
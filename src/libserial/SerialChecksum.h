@@ -0,0 +1,70 @@
+/******************************************************************************
+ * @file SerialChecksum.h                                                     *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LibSerial
+{
+    /**
+     * @brief Computes the CRC-16/XMODEM checksum (polynomial 0x1021, initial
+     *        value 0, no reflection) used by XMODEM, YMODEM and ZMODEM.
+     *        Longer data can be processed in pieces by passing the result
+     *        for the previous piece as crc.
+     * @param data The data to be checksummed.
+     * @param numberOfBytes The number of bytes of data.
+     * @param crc The checksum of the preceding data, or 0.
+     * @return Returns the checksum.
+     */
+    uint16_t ComputeCrc16(const void*    data,
+                          const size_t   numberOfBytes,
+                          const uint16_t crc = 0) ;
+
+    /**
+     * @brief Computes the CRC-32 checksum (polynomial 0x04C11DB7, reflected,
+     *        as used by zlib, Ethernet and ZMODEM). The data is processed
+     *        eight bytes at a time with slicing-by-8 tables. Longer data can
+     *        be processed in pieces by passing the result for the previous
+     *        piece as crc.
+     * @param data The data to be checksummed.
+     * @param numberOfBytes The number of bytes of data.
+     * @param crc The checksum of the preceding data, or 0.
+     * @return Returns the checksum.
+     */
+    uint32_t ComputeCrc32(const void*    data,
+                          const size_t   numberOfBytes,
+                          const uint32_t crc = 0) ;
+
+} // namespace LibSerial
@@ -0,0 +1,339 @@
+/******************************************************************************
+ * @file SerialConfig.h                                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+
+#pragma once
+
+#include <libserial/SerialPortConstants.h>
+
+#include <cstddef>
+#include <termios.h>
+#include <unistd.h>
+
+namespace LibSerial
+{
+    /**
+     * @brief Converts a baud rate to the number of bits per second.
+     * @param baudRate The baud rate.
+     * @return Returns the bit rate, or 0 if the baud rate is not supported.
+     */
+    constexpr int GetBitRate(const BaudRate baudRate)
+    {
+        switch (baudRate)
+        {
+        case BaudRate::BAUD_50:      return 50 ;
+        case BaudRate::BAUD_75:      return 75 ;
+        case BaudRate::BAUD_110:     return 110 ;
+        case BaudRate::BAUD_134:     return 134 ;
+        case BaudRate::BAUD_150:     return 150 ;
+        case BaudRate::BAUD_200:     return 200 ;
+        case BaudRate::BAUD_300:     return 300 ;
+        case BaudRate::BAUD_600:     return 600 ;
+        case BaudRate::BAUD_1200:    return 1200 ;
+        case BaudRate::BAUD_1800:    return 1800 ;
+        case BaudRate::BAUD_2400:    return 2400 ;
+        case BaudRate::BAUD_4800:    return 4800 ;
+        case BaudRate::BAUD_9600:    return 9600 ;
+        case BaudRate::BAUD_19200:   return 19200 ;
+        case BaudRate::BAUD_38400:   return 38400 ;
+        case BaudRate::BAUD_57600:   return 57600 ;
+        case BaudRate::BAUD_115200:  return 115200 ;
+        case BaudRate::BAUD_230400:  return 230400 ;
+
+// @note: >B230400 are defined in Linux but not other POSIX systems, (e.g. Mac OS X).
+#ifdef __linux__
+        case BaudRate::BAUD_460800:  return 460800 ;
+        case BaudRate::BAUD_500000:  return 500000 ;
+        case BaudRate::BAUD_576000:  return 576000 ;
+        case BaudRate::BAUD_921600:  return 921600 ;
+        case BaudRate::BAUD_1000000: return 1000000 ;
+        case BaudRate::BAUD_1152000: return 1152000 ;
+        case BaudRate::BAUD_1500000: return 1500000 ;
+#if __MAX_BAUD > B2000000
+        case BaudRate::BAUD_2000000: return 2000000 ;
+        case BaudRate::BAUD_2500000: return 2500000 ;
+        case BaudRate::BAUD_3000000: return 3000000 ;
+        case BaudRate::BAUD_3500000: return 3500000 ;
+        case BaudRate::BAUD_4000000: return 4000000 ;
+#endif // __MAX_BAUD
+#endif // __linux__
+        default:                     return 0 ;
+        }
+    }
+
+    /**
+     * @brief Converts a character size to the number of data bits.
+     * @param characterSize The character size.
+     * @return Returns the number of data bits, or 0 if the character size
+     *         is not valid.
+     */
+    constexpr int GetDataBits(const CharacterSize characterSize)
+    {
+        switch (characterSize)
+        {
+        case CharacterSize::CHAR_SIZE_5: return 5 ;
+        case CharacterSize::CHAR_SIZE_6: return 6 ;
+        case CharacterSize::CHAR_SIZE_7: return 7 ;
+        case CharacterSize::CHAR_SIZE_8: return 8 ;
+        default:                         return 0 ;
+        }
+    }
+
+    /**
+     * @brief SerialConfig describes serial port settings that are known at
+     *        compile time. The termios flags, the time needed to transmit a
+     *        character and the timeouts derived from it are constant
+     *        expressions, invalid settings are rejected by the compiler, and
+     *        the configuration is applied with a single tcsetattr() call
+     *        when the port is opened:
+     *
+     * @code{.cpp}
+     * using ModbusConfig = SerialConfig<BaudRate::BAUD_19200,
+     *                                   CharacterSize::CHAR_SIZE_8,
+     *                                   Parity::PARITY_EVEN> ;
+     * SerialPort serial_port ;
+     * serial_port.Open("/dev/ttyUSB0", ModbusConfig {}) ;
+     * @endcode
+     *
+     *        The resulting settings are the same as those produced by
+     *        SerialPort::Open() followed by the corresponding Set*() calls,
+     *        i.e. raw mode with VMIN and VTIME at their defaults.
+     */
+    template<BaudRate      BAUD_RATE      = BaudRate::BAUD_DEFAULT,
+             CharacterSize CHARACTER_SIZE = CharacterSize::CHAR_SIZE_DEFAULT,
+             Parity        PARITY         = Parity::PARITY_DEFAULT,
+             StopBits      STOP_BITS      = StopBits::STOP_BITS_DEFAULT,
+             FlowControl   FLOW_CONTROL   = FlowControl::FLOW_CONTROL_DEFAULT>
+    struct SerialConfig
+    {
+        static_assert(GetBitRate(BAUD_RATE) > 0,
+                      "SerialConfig: unsupported baud rate.") ;
+        static_assert(GetDataBits(CHARACTER_SIZE) > 0,
+                      "SerialConfig: invalid character size.") ;
+        static_assert(PARITY == Parity::PARITY_EVEN or
+                      PARITY == Parity::PARITY_ODD or
+                      PARITY == Parity::PARITY_NONE,
+                      "SerialConfig: invalid parity.") ;
+        static_assert(STOP_BITS == StopBits::STOP_BITS_1 or
+                      STOP_BITS == StopBits::STOP_BITS_2,
+                      "SerialConfig: invalid number of stop bits.") ;
+        static_assert(FLOW_CONTROL == FlowControl::FLOW_CONTROL_HARDWARE or
+                      FLOW_CONTROL == FlowControl::FLOW_CONTROL_SOFTWARE or
+                      FLOW_CONTROL == FlowControl::FLOW_CONTROL_NONE,
+                      "SerialConfig: invalid flow control.") ;
+        static_assert(not (CHARACTER_SIZE == CharacterSize::CHAR_SIZE_5 and
+                           STOP_BITS == StopBits::STOP_BITS_2),
+                      "SerialConfig: UARTs send 1.5 stop bits instead of 2 with 5 bit characters.") ;
+
+        /**
+         * @brief The baud rate, character size, parity, stop bits and flow
+         *        control of the configuration.
+         */
+        static constexpr BaudRate      BAUD_RATE_VALUE      = BAUD_RATE ;
+        static constexpr CharacterSize CHARACTER_SIZE_VALUE = CHARACTER_SIZE ;
+        static constexpr Parity        PARITY_VALUE         = PARITY ;
+        static constexpr StopBits      STOP_BITS_VALUE      = STOP_BITS ;
+        static constexpr FlowControl   FLOW_CONTROL_VALUE   = FLOW_CONTROL ;
+
+        /**
+         * @brief The number of bits transmitted per second.
+         */
+        static constexpr int BIT_RATE = GetBitRate(BAUD_RATE) ;
+
+        /**
+         * @brief The number of bits in a character frame: the start bit, the
+         *        data bits, the parity bit and the stop bits.
+         */
+        static constexpr int BITS_PER_CHARACTER =
+            1 +
+            GetDataBits(CHARACTER_SIZE) +
+            (PARITY == Parity::PARITY_NONE ? 0 : 1) +
+            (STOP_BITS == StopBits::STOP_BITS_2 ? 2 : 1) ;
+
+        /**
+         * @brief The time (us) needed to transmit one character, rounded up.
+         */
+        static constexpr size_t CHARACTER_TIME_US =
+            (static_cast<size_t>(BITS_PER_CHARACTER) * MICROSECONDS_PER_SEC + BIT_RATE - 1) / BIT_RATE ;
+
+        /**
+         * @brief The silent interval (us) of 1.5 character times after which
+         *        a frame is considered interrupted, (e.g. Modbus RTU t1.5).
+         */
+        static constexpr size_t INTER_CHARACTER_TIMEOUT_US = (3 * CHARACTER_TIME_US + 1) / 2 ;
+
+        /**
+         * @brief The silent interval (us) of 3.5 character times that
+         *        separates frames, (e.g. Modbus RTU t3.5).
+         */
+        static constexpr size_t INTER_FRAME_TIMEOUT_US = (7 * CHARACTER_TIME_US + 1) / 2 ;
+
+        /**
+         * @brief The input mode flags (c_iflag).
+         */
+        static constexpr tcflag_t INPUT_FLAGS =
+            IGNBRK |
+            (PARITY == Parity::PARITY_NONE ? IGNPAR : INPCK) |
+            (CHARACTER_SIZE == CharacterSize::CHAR_SIZE_8 ? 0 : ISTRIP) |
+            (FLOW_CONTROL == FlowControl::FLOW_CONTROL_SOFTWARE ? (IXON | IXOFF) : 0) ;
+
+        /**
+         * @brief The output mode flags (c_oflag).
+         */
+        static constexpr tcflag_t OUTPUT_FLAGS = 0 ;
+
+        /**
+         * @brief The control mode flags (c_cflag) owned by the configuration.
+         *        Other control mode bits, (e.g. HUPCL), are left unchanged.
+         */
+        static constexpr tcflag_t CONTROL_FLAGS_MASK =
+            CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS | CREAD | CLOCAL ;
+
+        /**
+         * @brief The control mode flags (c_cflag).
+         */
+        static constexpr tcflag_t CONTROL_FLAGS =
+            CREAD | CLOCAL |
+            static_cast<tcflag_t>(CHARACTER_SIZE) |
+            (PARITY == Parity::PARITY_NONE ? 0 : PARENB) |
+            (PARITY == Parity::PARITY_ODD ? PARODD : 0) |
+            (STOP_BITS == StopBits::STOP_BITS_2 ? CSTOPB : 0) |
+            (FLOW_CONTROL == FlowControl::FLOW_CONTROL_HARDWARE ? CRTSCTS : 0) ;
+
+        /**
+         * @brief The local mode flags (c_lflag).
+         */
+        static constexpr tcflag_t LOCAL_FLAGS = 0 ;
+
+        /**
+         * @brief Gets the time (us) needed to transmit a number of bytes.
+         * @param numberOfBytes The number of bytes.
+         * @return Returns the transmission time in microseconds.
+         */
+        static constexpr size_t GetTransmitTimeUs(const size_t numberOfBytes)
+        {
+            return numberOfBytes * CHARACTER_TIME_US ;
+        }
+
+        /**
+         * @brief Gets the time (ms) needed to transmit a number of bytes,
+         *        rounded up, (e.g. as the minimum read timeout of a reply).
+         * @param numberOfBytes The number of bytes.
+         * @return Returns the transmission time in milliseconds.
+         */
+        static constexpr size_t GetTransmitTimeMs(const size_t numberOfBytes)
+        {
+            return (GetTransmitTimeUs(numberOfBytes) + MICROSECONDS_PER_MS - 1) / MICROSECONDS_PER_MS ;
+        }
+
+        /**
+         * @brief Applies the configuration to termios settings. Only the
+         *        speed has to be set through a library call; no value is
+         *        validated at runtime.
+         * @param portSettings The settings to modify.
+         */
+        static void ApplyTo(termios& portSettings) noexcept ;
+
+    } ; // struct SerialConfig
+
+    /**
+     * @brief The settings applied by SerialPort::Open(), i.e. 115200 8N1
+     *        without flow control.
+     */
+    using DefaultSerialConfig = SerialConfig<> ;
+
+    // Definitions of the static data members, required when they are odr-used.
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr BaudRate SerialConfig<B, C, P, S, F>::BAUD_RATE_VALUE ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr CharacterSize SerialConfig<B, C, P, S, F>::CHARACTER_SIZE_VALUE ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr Parity SerialConfig<B, C, P, S, F>::PARITY_VALUE ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr StopBits SerialConfig<B, C, P, S, F>::STOP_BITS_VALUE ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr FlowControl SerialConfig<B, C, P, S, F>::FLOW_CONTROL_VALUE ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr int SerialConfig<B, C, P, S, F>::BIT_RATE ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr int SerialConfig<B, C, P, S, F>::BITS_PER_CHARACTER ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr size_t SerialConfig<B, C, P, S, F>::CHARACTER_TIME_US ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr size_t SerialConfig<B, C, P, S, F>::INTER_CHARACTER_TIMEOUT_US ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr size_t SerialConfig<B, C, P, S, F>::INTER_FRAME_TIMEOUT_US ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr tcflag_t SerialConfig<B, C, P, S, F>::INPUT_FLAGS ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr tcflag_t SerialConfig<B, C, P, S, F>::OUTPUT_FLAGS ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr tcflag_t SerialConfig<B, C, P, S, F>::CONTROL_FLAGS_MASK ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr tcflag_t SerialConfig<B, C, P, S, F>::CONTROL_FLAGS ;
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    constexpr tcflag_t SerialConfig<B, C, P, S, F>::LOCAL_FLAGS ;
+
+    /** ------------------------------------------------------------ */
+    template<BaudRate B, CharacterSize C, Parity P, StopBits S, FlowControl F>
+    inline
+    void
+    SerialConfig<B, C, P, S, F>::ApplyTo(termios& portSettings) noexcept
+    {
+#ifdef __linux__
+        portSettings.c_line = '\0' ;
+#endif
+        portSettings.c_iflag = INPUT_FLAGS ;
+        portSettings.c_oflag = OUTPUT_FLAGS ;
+        portSettings.c_cflag = (portSettings.c_cflag & ~CONTROL_FLAGS_MASK) | CONTROL_FLAGS ;  // NOLINT (hicpp-signed-bitwise)
+        portSettings.c_lflag = LOCAL_FLAGS ;
+
+        portSettings.c_cc[VMIN]  = static_cast<cc_t>(VMIN_DEFAULT) ;
+        portSettings.c_cc[VTIME] = static_cast<cc_t>(VTIME_DEFAULT) ;
+
+        if (F == FlowControl::FLOW_CONTROL_SOFTWARE)
+        {
+            portSettings.c_cc[VSTART] = CTRL_Q ;
+            portSettings.c_cc[VSTOP]  = CTRL_S ;
+        }
+        else if (F == FlowControl::FLOW_CONTROL_HARDWARE)
+        {
+            portSettings.c_cc[VSTART] = _POSIX_VDISABLE ;
+            portSettings.c_cc[VSTOP]  = _POSIX_VDISABLE ;
+        }
+
+        // The baud rate is valid, so cfsetspeed() cannot fail.
+        cfsetspeed(&portSettings, static_cast<speed_t>(B)) ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,190 @@
+/******************************************************************************
+ * @file SerialDeviceMonitor.h                                                *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPortEnumerator.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief The types of serial device hotplug events.
+     */
+    enum class SerialDeviceEventType
+    {
+        DEVICE_ADDED,   // !< A serial device has been plugged in.
+        DEVICE_REMOVED  // !< A serial device has been unplugged.
+    } ;
+
+    /**
+     * @brief Describes a serial device hotplug event.
+     */
+    struct SerialDeviceEvent
+    {
+        /**
+         * @brief Whether the device has been added or removed.
+         */
+        SerialDeviceEventType eventType {SerialDeviceEventType::DEVICE_ADDED} ;
+
+        /**
+         * @brief The metadata of the device. For removed devices this is the
+         *        metadata recorded when the device was last seen.
+         */
+        SerialPortInfo serialPortInfo {} ;
+    } ;
+
+    /**
+     * @brief SerialDeviceMonitor reports serial devices being plugged in and
+     *        unplugged. It subscribes to kernel uevents through a netlink
+     *        socket and falls back to watching the /dev directory with
+     *        inotify when netlink is unavailable. The file descriptor of the
+     *        monitor can be added to a poll()/epoll() based event loop and
+     *        ProcessEvents() called whenever it becomes readable.
+     */
+    class SerialDeviceMonitor
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param sysfsRoot The mount point of the sysfs file system.
+         * @param devRoot The directory containing the device files.
+         */
+        explicit SerialDeviceMonitor(const std::string& sysfsRoot = SYSFS_ROOT_DEFAULT,
+                                     const std::string& devRoot   = DEV_ROOT_DEFAULT) ;
+
+        /**
+         * @brief Default Destructor. Closes the monitor if it is open.
+         */
+        virtual ~SerialDeviceMonitor() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialDeviceMonitor(const SerialDeviceMonitor& otherSerialDeviceMonitor) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialDeviceMonitor(SerialDeviceMonitor&& otherSerialDeviceMonitor) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialDeviceMonitor& operator=(const SerialDeviceMonitor& otherSerialDeviceMonitor) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialDeviceMonitor& operator=(SerialDeviceMonitor&& otherSerialDeviceMonitor) ;
+
+        /**
+         * @brief Starts monitoring. The serial devices already present are
+         *        recorded so that their removal can be reported, but no
+         *        events are generated for them.
+         * @param useNetlink If false, the inotify fallback is used even if
+         *        kernel uevents are available.
+         */
+        void Open(const bool useNetlink = true) ;
+
+        /**
+         * @brief Stops monitoring and closes the file descriptor.
+         */
+        void Close() ;
+
+        /**
+         * @brief Determines if the monitor is open.
+         * @return Returns true iff the monitor is open.
+         */
+        bool IsOpen() const ;
+
+        /**
+         * @brief Determines if kernel uevents are being used, as opposed to
+         *        the inotify fallback.
+         * @return Returns true iff the monitor uses a netlink socket.
+         */
+        bool IsUsingNetlink() const ;
+
+        /**
+         * @brief Gets the file descriptor to be watched for readability.
+         * @return Returns the file descriptor of the netlink socket or of
+         *         the inotify instance.
+         */
+        int GetFileDescriptor() const ;
+
+        /**
+         * @brief Enables resolution of the /dev/serial/by-id paths of
+         *        added devices. Note that udev may create the by-id link
+         *        after the kernel has announced the device.
+         * @param resolveByIdPaths True to resolve by-id paths.
+         */
+        void SetResolveByIdPaths(const bool resolveByIdPaths) ;
+
+        /**
+         * @brief Reads all pending notifications without blocking.
+         * @return Returns the serial device events, in order of arrival.
+         */
+        std::vector<SerialDeviceEvent> ProcessEvents() ;
+
+        /**
+         * @brief Processes a single kernel uevent message as received from
+         *        the netlink socket, (e.g. "add@/devices/...\0ACTION=add\0...").
+         *        This allows synthetic messages to be injected for testing.
+         * @param message The uevent message.
+         * @param messageSize The size of the message in bytes.
+         * @return Returns the resulting serial device events, if any.
+         */
+        std::vector<SerialDeviceEvent> ProcessUeventMessage(const char*  message,
+                                                            const size_t messageSize) ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialDeviceMonitor
+
+} // namespace LibSerial
@@ -0,0 +1,227 @@
+/******************************************************************************
+ * @file SerialFileTransfer.h                                                 *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace LibSerial
+{
+    /**
+     * @brief The default time in milliseconds a SerialFileTransfer waits
+     *        for the remote side before retrying.
+     */
+    constexpr size_t FILE_TRANSFER_TIMEOUT_DEFAULT_MS = 10000 ;
+
+    /**
+     * @brief The default number of consecutive errors after which a
+     *        SerialFileTransfer gives up.
+     */
+    constexpr size_t FILE_TRANSFER_RETRIES_DEFAULT = 10 ;
+
+    /**
+     * @brief The file transfer protocols supported by SerialFileTransfer.
+     */
+    enum class FileTransferProtocol
+    {
+        XMODEM,     // !< XMODEM-CRC with 128 byte blocks.
+        XMODEM_1K,  // !< XMODEM-CRC with 1024 byte blocks.
+        YMODEM,     // !< YMODEM batch with 1024 byte blocks, one file.
+        ZMODEM      // !< ZMODEM streaming with CRC-32, one file.
+    } ;
+
+    /**
+     * @brief Type of the function called as a file transfer progresses,
+     *        with the number of bytes transferred and the size of the file,
+     *        which is 0 while it is not known.
+     */
+    using FileTransferProgressCallback = std::function<void(size_t bytesTransferred, size_t fileSize)> ;
+
+    /**
+     * @brief The options of a SerialFileTransfer.
+     */
+    struct FileTransferOptions
+    {
+        /**
+         * @brief The time in milliseconds to wait for the remote side
+         *        before retrying.
+         */
+        size_t msTimeout {FILE_TRANSFER_TIMEOUT_DEFAULT_MS} ;
+
+        /**
+         * @brief The number of consecutive errors after which the transfer
+         *        is aborted.
+         */
+        size_t maximumRetries {FILE_TRANSFER_RETRIES_DEFAULT} ;
+
+        /**
+         * @brief The number of bytes a ZMODEM sender may send ahead of the
+         *        last acknowledgement, or 0 to stream the whole file
+         *        without waiting. A window limits the data that has to be
+         *        repeated after an error on links that lose data.
+         */
+        size_t zmodemWindowSize {0} ;
+
+        /**
+         * @brief The function called as the transfer progresses, if any.
+         */
+        FileTransferProgressCallback progressCallback {} ;
+    } ;
+
+    /**
+     * @brief Describes a completed file transfer.
+     */
+    struct FileTransferResult
+    {
+        /**
+         * @brief The path of the file that was sent or received.
+         */
+        std::string filePath {} ;
+
+        /**
+         * @brief The size of the file in bytes.
+         */
+        size_t fileSize {0} ;
+
+        /**
+         * @brief The number of blocks or subpackets that were repeated
+         *        after an error.
+         */
+        size_t retransmissions {0} ;
+
+        /**
+         * @brief The duration of the transfer in microseconds.
+         */
+        size_t durationUs {0} ;
+    } ;
+
+    /**
+     * @brief SerialFileTransfer sends and receives files over a SerialPort
+     *        with the XMODEM, YMODEM or ZMODEM protocols spoken by boot
+     *        loaders and by the lrzsz tools, so that no external program
+     *        has to take over the port.
+     *
+     *        XMODEM and YMODEM wait for an acknowledgement of each block.
+     *        ZMODEM streams the file in subpackets protected by CRC-32 and
+     *        only returns to an earlier position when the receiver reports
+     *        an error, so that the full capacity of the link is used. The
+     *        CRC-16 and CRC-32 checksums are computed with the table driven
+     *        functions of SerialChecksum.h.
+     *
+     *        A transfer can be interrupted from another thread with
+     *        SerialPort::Cancel(). On errors, the remote side is notified
+     *        with CAN characters and an exception is thrown. The serial port
+     *        must not be used by other code while a transfer is in progress.
+     */
+    class SerialFileTransfer
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param serialPort The open serial port used for the transfers,
+         *        which must outlive the SerialFileTransfer.
+         * @param fileTransferProtocol The protocol of the transfers.
+         * @param fileTransferOptions The options of the transfers.
+         */
+        SerialFileTransfer(SerialPort&                serialPort,
+                           const FileTransferProtocol fileTransferProtocol,
+                           const FileTransferOptions& fileTransferOptions = FileTransferOptions()) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialFileTransfer() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialFileTransfer(const SerialFileTransfer& otherSerialFileTransfer) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialFileTransfer(SerialFileTransfer&& otherSerialFileTransfer) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialFileTransfer& operator=(const SerialFileTransfer& otherSerialFileTransfer) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialFileTransfer& operator=(SerialFileTransfer&& otherSerialFileTransfer) ;
+
+        /**
+         * @brief Sends a file, waiting for the receiver to start the
+         *        transfer. YMODEM and ZMODEM also send the name and size of
+         *        the file.
+         * @param filePath The path of the file to be sent.
+         * @return Returns the description of the transfer.
+         */
+        FileTransferResult Send(const std::string& filePath) ;
+
+        /**
+         * @brief Receives a file. For XMODEM, the path is that of the file
+         *        to be written, which is padded to a multiple of the block
+         *        size. For YMODEM and ZMODEM, the path is the directory the
+         *        file is written to under the name sent by the sender, and
+         *        further files offered by the sender are declined.
+         * @param path The path of the file or directory.
+         * @return Returns the description of the transfer.
+         */
+        FileTransferResult Receive(const std::string& path) ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialFileTransfer
+
+} // namespace LibSerial
@@ -33,8 +33,11 @@
 
 #pragma once
 
+#include <libserial/SerialCapture.h>
+#include <libserial/SerialConfig.h>
 #include <libserial/SerialPortConstants.h>
 
+#include <functional>
 #include <ios>
 #include <memory>
 
@@ -43,6 +46,44 @@
  */
 namespace LibSerial
 {
+    /**
+     * @brief Type of the function called when a SerialPort in auto-reconnect
+     *        mode loses or regains its device.
+     */
+    using ConnectionEventCallback = std::function<void(ConnectionEvent)> ;
+
+    /**
+     * @brief Type of the function a SerialPort passes the contents of its
+     *        flight recorder to when a FlightRecorderTrigger occurs.
+     */
+    using FlightRecorderCallback = std::function<void(FlightRecorderTrigger,
+                                                      const std::vector<CaptureRecord>&)> ;
+
+    /**
+     * @brief Type of the function SerialPort::SendFile() reports its
+     *        progress to, with the number of bytes written so far and the
+     *        size of the file.
+     */
+    using SendFileProgressCallback = std::function<void(size_t, size_t)> ;
+
+    /**
+     * @brief Options of SerialPort::SendFile().
+     */
+    struct SendFileOptions
+    {
+        /**
+         * @brief The number of bytes mapped and written at a time, rounded
+         *        up to a multiple of the page size.
+         */
+        size_t chunkSize {SEND_FILE_CHUNK_SIZE_DEFAULT} ;
+
+        /**
+         * @brief The function called after each chunk has been written, if
+         *        any. An exception it throws ends the transfer.
+         */
+        SendFileProgressCallback progressCallback {} ;
+    } ;
+
     /**
      * @brief SerialPort allows an object oriented approach to serial port
      *        communication.  A serial port object can be created to
@@ -51,6 +92,9 @@ namespace LibSerial
      *        access the most commonly utilized parameters associated
      *        with serial port communication.
      *
+     *        By default, a SerialPort must not be used from more than one
+     *        thread at a time. See SetThreadSafe() for full-duplex use from
+     *        a reader and a writer thread.
      */
     class SerialPort
     {
@@ -116,6 +160,24 @@ namespace LibSerial
         void Open(const std::string& fileName,
                   const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
 
+        /**
+         * @brief Opens the serial port and applies a compile-time
+         *        configuration with a single tcsetattr() call instead of
+         *        applying the defaults and then each setting separately.
+         * @param fileName The file name of the serial port.
+         * @param serialConfig The configuration, see SerialConfig.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        template<BaudRate      BAUD_RATE,
+                 CharacterSize CHARACTER_SIZE,
+                 Parity        PARITY,
+                 StopBits      STOP_BITS,
+                 FlowControl   FLOW_CONTROL>
+        void Open(const std::string& fileName,
+                  const SerialConfig<BAUD_RATE, CHARACTER_SIZE, PARITY, STOP_BITS, FLOW_CONTROL>& serialConfig,
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
         /**
          * @brief Closes the serial port. All settings of the serial port will be
          *        lost and no more I/O can be performed on the serial port.
@@ -127,6 +189,22 @@ namespace LibSerial
          */
         void DrainWriteBuffer() ;
 
+        /**
+         * @brief Waits until the write buffer is drained or the specified
+         *        number of milliseconds (msTimeout) has elapsed. The method
+         *        sleeps for the time the queued bytes need to be transmitted
+         *        at the current baud rate, then checks the output queue again.
+         *        The data collected by write coalescing is written within the
+         *        same deadline, and the transmitter of a UART is polled until
+         *        it is empty where the driver reports its status. If msTimeout
+         *        is 0, then this method will block until the write buffer is
+         *        drained.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns true iff the write buffer was drained before the
+         *         timeout elapsed.
+         */
+        bool DrainWriteBuffer(size_t msTimeout) ;
+
         /**
          * @brief Flushes the serial port input buffer.
          */
@@ -297,15 +375,304 @@ namespace LibSerial
          */
         int GetNumberOfBytesAvailable() ;
 
+        /**
+         * @brief Gets the number of bytes written to the serial port that are
+         *        still queued by the kernel for transmission.
+         * @return Returns the number of bytes in the output queue.
+         */
+        int GetNumberOfBytesQueuedForOutput() ;
+
 #ifdef __linux__
         /**
-         * @brief Gets a list of available serial ports.
+         * @brief Gets a list of available serial ports. The list is read
+         *        from sysfs without opening the devices, use
+         *        SerialPortEnumerator to obtain per-port metadata.
          * @return Returns a std::vector of std::strings with the name of
          *         each available serial port.
          */
         std::vector<std::string> GetAvailableSerialPorts() const ;
+
+        /**
+         * @brief Enables or disables low latency mode. This sets or clears
+         *        ASYNC_LOW_LATENCY using TIOCGSERIAL/TIOCSSERIAL and, for
+         *        USB-serial adapters that provide one (e.g. FTDI), adjusts the
+         *        driver's sysfs latency_timer. Mechanisms not supported by the
+         *        device are skipped. The original settings are restored when
+         *        the serial port is closed.
+         * @param lowLatency True to enable low latency mode, false to
+         *        restore the original behavior.
+         * @return Returns a LowLatencyStatus describing which mechanisms were
+         *         applied.
+         */
+        LowLatencyStatus SetLowLatency(const bool lowLatency = true) ;
+
+        /**
+         * @brief Sets the root of the sysfs file system used to locate
+         *        device attributes such as the USB-serial latency_timer.
+         *        This is intended for testing without hardware.
+         * @param sysfsRoot The sysfs mount point, "/sys" by default.
+         */
+        void SetSysfsRoot(const std::string& sysfsRoot) ;
 #endif
 
+        /**
+         * @brief Enables or disables auto-reconnect mode. In this mode a
+         *        hang-up of the device, (e.g. an unplugged USB-serial
+         *        adapter), does not make Read() and Write() methods throw.
+         *        Instead, the device is reopened with an exponential backoff,
+         *        preferring its stable /dev/serial/by-id path, and the port
+         *        settings in effect before the hang-up are restored with a
+         *        single tcsetattr() call. The file descriptor returned by
+         *        GetFileDescriptor() remains the same across reconnections.
+         *        While the device is absent, Read() methods wait until their
+         *        timeout expires and Write() methods discard their data.
+         * @param autoReconnect True to enable auto-reconnect mode.
+         * @param msInitialBackoff The delay in milliseconds before the first
+         *        attempt to reopen the device.
+         * @param msMaximumBackoff The maximum delay in milliseconds between
+         *        two attempts to reopen the device.
+         */
+        void SetAutoReconnect(const bool   autoReconnect,
+                              const size_t msInitialBackoff = RECONNECT_BACKOFF_INITIAL_MS,
+                              const size_t msMaximumBackoff = RECONNECT_BACKOFF_MAXIMUM_MS) ;
+
+        /**
+         * @brief Determines if auto-reconnect mode is enabled.
+         * @return Returns true iff auto-reconnect mode is enabled.
+         */
+        bool GetAutoReconnect() const ;
+
+        /**
+         * @brief Determines if the device of an open serial port is present.
+         * @return Returns false iff the port is in auto-reconnect mode and
+         *         the device has hung up and not been reopened yet.
+         */
+        bool IsConnected() const ;
+
+        /**
+         * @brief Sets the function called when the device hangs up or is
+         *        reopened in auto-reconnect mode. The function is called on
+         *        the thread performing the I/O that detected the change,
+         *        once that I/O call has released its locks, so it may call
+         *        other methods of the serial port, e.g. GetStatistics().
+         *        Exceptions it throws are ignored.
+         * @param connectionEventCallback The function to be called.
+         */
+        void SetConnectionEventCallback(const ConnectionEventCallback& connectionEventCallback) ;
+
+        /**
+         * @brief Enables or disables write pacing, which throttles Write()
+         *        methods for devices with small receive buffers and no flow
+         *        control. The data is limited by a token bucket that fills at
+         *        bytesPerSecond up to maximumBurst bytes, and each Write*()
+         *        call starts at least usInterFrameGap microseconds after the
+         *        previous one has been transmitted at the current baud rate.
+         *        The waits are timed by a timerfd and can be cancelled. Their
+         *        number and duration are reported by GetStatistics().
+         * @param bytesPerSecond The average number of bytes written per
+         *        second, or 0 for no rate limit.
+         * @param maximumBurst The maximum number of bytes written at once.
+         * @param usInterFrameGap The minimum idle time of the line in
+         *        microseconds between two Write*() calls, or 0 for no gap.
+         *        Write pacing is disabled if this and bytesPerSecond are 0.
+         */
+        void SetWritePacing(const size_t bytesPerSecond,
+                            const size_t maximumBurst = WRITE_PACING_BURST_DEFAULT,
+                            const size_t usInterFrameGap = 0) ;
+
+        /**
+         * @brief Determines if write pacing is enabled.
+         * @return Returns true iff write pacing is enabled.
+         */
+        bool GetWritePacing() const ;
+
+        /**
+         * @brief Enables or disables write coalescing. Data written by
+         *        Write*() methods is then collected in a buffer of bufferSize
+         *        bytes, so that e.g. WriteByte() calls in a loop do not make
+         *        one system call per byte. The buffer is written to the serial
+         *        port when it is full, by Flush() and DrainWriteBuffer(), and
+         *        usFlushDelay microseconds after the oldest byte was added.
+         *        Close() writes what the port accepts without waiting and
+         *        discards the rest. Writes larger than the buffer bypass it.
+         *
+         *        The delayed write is performed by a background thread and
+         *        requires thread-safe mode. An error or a cancellation that
+         *        occurs in the background thread is thrown by the next
+         *        Write*() or Flush() call.
+         * @param bufferSize The size of the buffer in bytes, or 0 to disable
+         *        write coalescing after writing the pending data.
+         * @param usFlushDelay The maximum time in microseconds data stays in
+         *        the buffer, or 0 to only write it as described above.
+         * @throw std::logic_error if usFlushDelay is not 0 and thread-safe
+         *        mode is disabled.
+         */
+        void SetWriteCoalescing(const size_t bufferSize,
+                                const size_t usFlushDelay = 0) ;
+
+        /**
+         * @brief Determines if write coalescing is enabled.
+         * @return Returns true iff write coalescing is enabled.
+         */
+        bool GetWriteCoalescing() const ;
+
+        /**
+         * @brief Writes the data collected by write coalescing to the serial
+         *        port. Unlike FlushOutputBuffer(), no data is discarded.
+         */
+        void Flush() ;
+
+        /**
+         * @brief Enables or disables traffic capture. Every chunk of data
+         *        read from or written to the device is then appended to the
+         *        capture with its timestamp, direction and portId. Recording
+         *        copies the chunk into a memory-mapped segment and makes no
+         *        system call. Several serial ports may share a capture. If
+         *        recording fails, e.g. because no new segment can be
+         *        allocated, the data is still read or written, the capture
+         *        stops and the error is thrown by the next Read*() or
+         *        Write*() call.
+         * @param serialCaptureWriter The capture, or nullptr to disable
+         *        traffic capture.
+         * @param portId The id recorded with the chunks of this serial port.
+         */
+        void SetCapture(const std::shared_ptr<SerialCaptureWriter>& serialCaptureWriter,
+                        const uint32_t                              portId = 0) ;
+
+        /**
+         * @brief Enables or disables the flight recorder, which keeps the
+         *        last bufferSize bytes read from and the last bufferSize
+         *        bytes written to the device in memory, see
+         *        SerialFlightRecorder. Recording a chunk
+         *        costs one copy and takes no lock.
+         * @param bufferSize The number of bytes kept, or 0 to disable the
+         *        flight recorder and discard its contents.
+         * @throw std::invalid_argument if bufferSize is neither 0 nor at
+         *        least FLIGHT_RECORDER_SIZE_MINIMUM.
+         */
+        void SetFlightRecorder(const size_t bufferSize = FLIGHT_RECORDER_SIZE_DEFAULT) ;
+
+        /**
+         * @brief Gets the contents of the flight recorder.
+         * @return Returns the chunks held by the flight recorder, oldest
+         *         first, or no chunks if it is disabled.
+         */
+        std::vector<CaptureRecord> DumpFlightRecorder() const ;
+
+        /**
+         * @brief Sets the function the contents of the flight recorder are
+         *        passed to when a Read*() method throws ReadTimeout, the
+         *        device hangs up, or ReportParseError() is called. The
+         *        records are taken when the event occurs. The function is
+         *        called on the thread that detected the event, once the
+         *        call that detected it has released its locks, so it may
+         *        call other methods of the serial port. Exceptions it
+         *        throws are ignored.
+         * @param flightRecorderCallback The function to be called.
+         */
+        void SetFlightRecorderCallback(const FlightRecorderCallback& flightRecorderCallback) ;
+
+        /**
+         * @brief Reports that the application could not parse the data read,
+         *        which passes the contents of the flight recorder to the
+         *        flight recorder callback.
+         */
+        void ReportParseError() ;
+
+        /**
+         * @brief Copies the data read from the device to a file or pipe, e.g.
+         *        for archival, in addition to returning it from the Read*()
+         *        methods. Where the device supports it, the data is moved by
+         *        splice() and duplicated by tee() within the kernel, so the
+         *        copy to fileDescriptor does not pass through user space.
+         *        Otherwise, and for files opened with O_APPEND, the data read
+         *        is written to fileDescriptor. Reads wait while
+         *        fileDescriptor does not accept more data, but no longer
+         *        than their timeout and only until Cancel() is called. The
+         *        data that could not be copied is then dropped from the copy
+         *        but still returned. An error writing to fileDescriptor, and
+         *        such a dropped copy, is thrown by the next Read*() call.
+         * @param fileDescriptor The file or pipe the data is copied to, or
+         *        -1 to stop copying. It is not closed by the serial port.
+         * @throw std::runtime_error if fileDescriptor is not a valid file
+         *        descriptor.
+         */
+        void SetInputTee(const int fileDescriptor) ;
+
+        /**
+         * @brief Gets the file descriptor the data read is copied to.
+         * @return Returns the file descriptor, or -1 if the data read is not
+         *         copied.
+         */
+        int GetInputTee() const ;
+
+        /**
+         * @brief Gets the counters maintained by the serial port.
+         * @return Returns a copy of the counters.
+         */
+        SerialPortStatistics GetStatistics() const ;
+
+        /**
+         * @brief Resets the counters maintained by the serial port to zero.
+         */
+        void ResetStatistics() ;
+
+        /**
+         * @brief Enables or disables thread-safe mode. In thread-safe mode,
+         *        one thread may read while another thread writes, without
+         *        the two directions waiting for each other:
+         *
+         *        - Concurrent Read*() calls are serialized, as are
+         *          concurrent Write*() and DrainWriteBuffer() calls.
+         *        - Methods that change the settings or the state of the
+         *          port, (e.g. SetBaudRate(), Flush*(), Close()), wait for
+         *          the system call in progress in each direction, but not for
+         *          a Read*() or Write*() that is waiting for the device. Such a
+         *          call continues with the new settings, or throws NotOpen if
+         *          the port has been closed.
+         *        - Getters may be called from any thread.
+         *
+         *        The mode must be selected before the serial port is shared
+         *        between threads. It is disabled by default, in which case no
+         *        locks are taken.
+         * @param threadSafe True to enable thread-safe mode.
+         * @throw std::logic_error if thread-safe mode is disabled while write
+         *        coalescing has a flush delay.
+         */
+        void SetThreadSafe(const bool threadSafe) ;
+
+        /**
+         * @brief Determines if thread-safe mode is enabled.
+         * @return Returns true iff thread-safe mode is enabled.
+         */
+        bool GetThreadSafe() const ;
+
+        /**
+         * @brief Cancels the blocking operations of the serial port. Read*(),
+         *        Write*() and DrainWriteBuffer() calls waiting in other
+         *        threads wake up promptly and throw OperationCancelled, as do
+         *        subsequent calls, until ResetCancel() is called or the port is
+         *        reopened. Data already read or written by a cancelled call is
+         *        not returned or recalled.
+         *
+         *        This method may be called from any thread, (or a signal
+         *        handler), regardless of the thread-safe mode.
+         */
+        void Cancel() noexcept ;
+
+        /**
+         * @brief Leaves the cancelled state entered by Cancel().
+         */
+        void ResetCancel() noexcept ;
+
+        /**
+         * @brief Determines if the blocking operations of the serial port are
+         *        cancelled.
+         * @return Returns true iff Cancel() has been called since the port
+         *         was opened or ResetCancel() was last called.
+         */
+        bool IsCancelled() const noexcept ;
+
         /**
          * @brief Reads the specified number of bytes from the serial port.
          *        The method will timeout if no data is received in the
@@ -385,12 +752,82 @@ namespace LibSerial
                       char         lineTerminator = '\n',
                       size_t       msTimeout = 0) ;
 
+        /**
+         * @brief Reads up to bufferSize bytes from the serial port directly
+         *        into a caller supplied buffer. The method waits up to
+         *        msTimeout milliseconds for data to arrive and then returns
+         *        the data that is available without waiting any further. If
+         *        msTimeout is zero, then the method will block until at least
+         *        one byte is received.
+         * @param dataBuffer The buffer to place data into.
+         * @param bufferSize The size of the buffer in bytes.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes read, zero if no data arrived
+         *         within msTimeout milliseconds.
+         */
+        size_t ReadInto(char*  dataBuffer,
+                        size_t bufferSize,
+                        size_t msTimeout = 0) ;
+
         /**
          * @brief Writes a DataBuffer to the serial port.
          * @param dataBuffer The DataBuffer to write to the serial port.
          */
         void Write(const DataBuffer& dataBuffer) ;
 
+        /**
+         * @brief Writes the contents of a caller supplied buffer to the
+         *        serial port without copying it into a container first.
+         * @param dataBuffer The data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void Write(const char* dataBuffer,
+                   size_t      numberOfBytes) ;
+
+        /**
+         * @brief Writes as much of a caller supplied buffer as the serial port
+         *        accepts without waiting, for callers that wait for the port
+         *        to become writable themselves, e.g. an event loop. The data
+         *        is written like Write() does, observing write pacing,
+         *        capture, the flight recorder and Cancel(). Data collected by
+         *        write coalescing is written first. Each call counts as one
+         *        frame for the inter-frame gap of write pacing.
+         * @param dataBuffer The data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         * @return Returns the number of bytes written, zero if the port does
+         *         not accept data or write pacing holds it back. In the latter
+         *         case, GetWritePacingDelay() tells when to try again.
+         */
+        size_t TryWrite(const char* dataBuffer,
+                        size_t      numberOfBytes) ;
+
+        /**
+         * @brief Gets the time until write pacing lets TryWrite() write the
+         *        specified number of bytes, up to the maximum burst.
+         * @param numberOfBytes The number of bytes that remain to be written.
+         * @return Returns the time in microseconds, zero if the bytes can be
+         *         written now or write pacing is disabled.
+         */
+        size_t GetWritePacingDelay(size_t numberOfBytes) ;
+
+        /**
+         * @brief Writes the contents of a file to the serial port without
+         *        loading it into memory. The file is memory-mapped one chunk
+         *        at a time, and the kernel is asked to read the next chunk
+         *        ahead while the current one is written, so that reading the
+         *        file overlaps with the transmission. The chunks are written
+         *        like Write() does, observing flow control, write pacing and
+         *        Cancel(). The file must not be truncated during the transfer.
+         * @param filePath The path of the file to be sent.
+         * @param sendFileOptions The chunk size and progress callback.
+         * @throw std::invalid_argument if the chunk size is 0 or the file
+         *        is not a regular file.
+         * @throw std::runtime_error if the file cannot be opened or mapped.
+         * @throw OperationCancelled if Cancel() is called.
+         */
+        void SendFile(const std::string&     filePath,
+                      const SendFileOptions& sendFileOptions = SendFileOptions()) ;
+
         /**
          * @brief Writes a std::string to the serial port.
          * @param dataString The data string to write to the serial port.
@@ -444,6 +881,21 @@ namespace LibSerial
     protected:
 
     private:
+        /**
+         * @brief Opens the serial port and applies the settings produced by
+         *        applySerialConfig with a single tcsetattr() call.
+         * @param fileName The file name of the serial port.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         * @param applySerialConfig Applies the configuration to the
+         *        settings of the serial port, see SerialConfig::ApplyTo().
+         * @param characterTimeUs The time (us) needed to transmit a character.
+         */
+        void OpenWithConfig(const std::string& fileName,
+                            const std::ios_base::openmode& openMode,
+                            void (*applySerialConfig)(termios&),
+                            size_t characterTimeUs) ;
+
         /**
          * @brief Forward declaration of the Implementation class folowing
          *        the PImpl idiom.
@@ -457,6 +909,25 @@ namespace LibSerial
 
     } ; // class SerialPort
 
+    /** ------------------------------------------------------------ */
+    template<BaudRate      BAUD_RATE,
+             CharacterSize CHARACTER_SIZE,
+             Parity        PARITY,
+             StopBits      STOP_BITS,
+             FlowControl   FLOW_CONTROL>
+    inline
+    void
+    SerialPort::Open(const std::string& fileName,
+                     const SerialConfig<BAUD_RATE, CHARACTER_SIZE, PARITY, STOP_BITS, FLOW_CONTROL>& /* serialConfig */,
+                     const std::ios_base::openmode& openMode)
+    {
+        using Config = SerialConfig<BAUD_RATE, CHARACTER_SIZE, PARITY, STOP_BITS, FLOW_CONTROL> ;
+        this->OpenWithConfig(fileName,
+                             openMode,
+                             &Config::ApplyTo,
+                             Config::CHARACTER_TIME_US) ;
+    }
+
     /**
      * Type-safe and portable equivalent of TEMP_FAILURE_RETRY macro that is
      * provided gcc. See
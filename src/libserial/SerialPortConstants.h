@@ -50,9 +50,12 @@ namespace LibSerial
     const std::string ERR_MSG_INVALID_PARITY         = "Invalid parity setting.";
     const std::string ERR_MSG_INVALID_STOP_BITS      = "Invalid number of stop bits.";
     const std::string ERR_MSG_READ_TIMEOUT           = "Read timeout";
+    const std::string ERR_MSG_OPERATION_CANCELLED    = "Operation cancelled." ;
     const std::string ERR_MSG_PORT_ALREADY_OPEN      = "Serial port already open.";
     const std::string ERR_MSG_PORT_NOT_OPEN          = "Serial port not open.";
     const std::string ERR_MSG_INVALID_MODEM_LINE     = "Invalid modem line." ;
+    const std::string ERR_MSG_MONITOR_ALREADY_OPEN   = "Serial device monitor already open." ;
+    const std::string ERR_MSG_MONITOR_NOT_OPEN       = "Serial device monitor not open." ;
 
     /**
      * @brief Time conversion constants.
@@ -88,11 +91,128 @@ namespace LibSerial
      */
     constexpr char CTRL_S = 0x13 ;
 
+    /**
+     * @brief Default mount point of the sysfs file system.
+     */
+    constexpr const char* SYSFS_ROOT_DEFAULT = "/sys" ;
+
+    /**
+     * @brief The USB-serial latency_timer value (ms) used in low latency mode.
+     */
+    constexpr int LATENCY_TIMER_LOW_LATENCY_MS = 1 ;
+
+    /**
+     * @brief The USB-serial latency_timer value (ms) restored when leaving
+     *        low latency mode if the original value is not known.
+     */
+    constexpr int LATENCY_TIMER_DEFAULT_MS = 16 ;
+
+    /**
+     * @brief The default delay (ms) before the first attempt to reopen a
+     *        serial port device that has disappeared.
+     */
+    constexpr size_t RECONNECT_BACKOFF_INITIAL_MS = 100 ;
+
+    /**
+     * @brief The default upper bound (ms) of the exponentially growing delay
+     *        between attempts to reopen a serial port device.
+     */
+    constexpr size_t RECONNECT_BACKOFF_MAXIMUM_MS = 5000 ;
+
+    /**
+     * @brief The default maximum burst (bytes) written to a serial port at
+     *        the line rate when write pacing is enabled.
+     */
+    constexpr size_t WRITE_PACING_BURST_DEFAULT = 1 ;
+
+    /**
+     * @brief The default size (bytes) of the chunks SerialPort::SendFile()
+     *        maps and writes at a time.
+     */
+    constexpr size_t SEND_FILE_CHUNK_SIZE_DEFAULT = 256 * 1024 ;
+
+    /**
+     * @brief The default size (bytes) of each of the get and put areas
+     *        of a SerialStreamBuf.
+     */
+    constexpr size_t STREAM_BUFFER_SIZE_DEFAULT = 512 ;
+
     /**
      * @brief Type used to receive and return raw data to/from methods.
      */
     using DataBuffer =  std::vector<uint8_t> ;
 
+    /**
+     * @brief Reports which mechanisms were applied by a call to
+     *        SerialPort::SetLowLatency().
+     */
+    struct LowLatencyStatus
+    {
+        /**
+         * @brief True iff ASYNC_LOW_LATENCY was updated via TIOCSSERIAL.
+         */
+        bool asyncLowLatency {false} ;
+
+        /**
+         * @brief True iff the driver's sysfs latency_timer was updated.
+         */
+        bool latencyTimer {false} ;
+
+        /**
+         * @brief The latency_timer value (ms) now in effect, or -1 if the
+         *        driver does not provide a latency_timer.
+         */
+        int latencyTimerMs {-1} ;
+    } ;
+
+    /**
+     * @brief Connection state changes reported by a SerialPort in
+     *        auto-reconnect mode.
+     */
+    enum class ConnectionEvent
+    {
+        DISCONNECTED, // !< The device hung up, (e.g. it was unplugged).
+        RECONNECTED   // !< The device was reopened and its settings restored.
+    } ;
+
+    /**
+     * @brief Counters maintained by a SerialPort instance.
+     */
+    struct SerialPortStatistics
+    {
+        /**
+         * @brief The number of times the device hung up.
+         */
+        size_t disconnectCount {0} ;
+
+        /**
+         * @brief The number of times the device was successfully reopened.
+         */
+        size_t reconnectCount {0} ;
+
+        /**
+         * @brief The number of attempts made to reopen the device.
+         */
+        size_t reconnectAttempts {0} ;
+
+        /**
+         * @brief The number of bytes discarded by Write() methods while the
+         *        device was disconnected.
+         */
+        size_t bytesDiscarded {0} ;
+
+        /**
+         * @brief The number of times Write() methods waited for write pacing.
+         */
+        size_t pacingDelayCount {0} ;
+
+        /**
+         * @brief The total time in microseconds Write() methods waited for
+         *        write pacing.
+         */
+        size_t pacingDelayUs {0} ;
+    } ;
+
 
     /**
      * @note - For reference, below is a list of std::exception types:
@@ -180,6 +300,23 @@ namespace LibSerial
         }
     } ;
 
+    /**
+     * @brief Exception error thrown when a blocking read, write or drain of
+     *        the serial port has been cancelled by another thread.
+     */
+    class OperationCancelled : public std::runtime_error
+    {
+    public:
+        /**
+         * @brief Exception error thrown when a blocking read, write or drain
+         *        of the serial port has been cancelled by another thread.
+         */
+        explicit OperationCancelled(const std::string& whatArg [[maybe_unused]])
+            : runtime_error(whatArg)
+        {
+        }
+    } ;
+
     /**
      * @brief The baud rates currently supported by the Single Unix
      *        Specification V3 general terminal interface specification.
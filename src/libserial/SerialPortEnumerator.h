@@ -0,0 +1,209 @@
+/******************************************************************************
+ * @file SerialPortEnumerator.h                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPortConstants.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief Default directory containing the device files.
+     */
+    constexpr const char* const DEV_ROOT_DEFAULT = "/dev" ;
+
+    /**
+     * @brief Describes a serial port device found by SerialPortEnumerator.
+     *        Fields that do not apply to a device are left empty or zero.
+     */
+    struct SerialPortInfo
+    {
+        /**
+         * @brief The kernel name of the device, e.g. ttyUSB0.
+         */
+        std::string name {} ;
+
+        /**
+         * @brief The path of the device file, e.g. /dev/ttyUSB0.
+         */
+        std::string devicePath {} ;
+
+        /**
+         * @brief The stable /dev/serial/by-id path of the device, if it has
+         *        one and by-id path resolution is enabled.
+         */
+        std::string byIdPath {} ;
+
+        /**
+         * @brief The resolved sysfs directory of the underlying device.
+         */
+        std::string sysfsPath {} ;
+
+        /**
+         * @brief The name of the kernel driver, e.g. ftdi_sio or serial8250.
+         */
+        std::string driver {} ;
+
+        /**
+         * @brief The bus subsystem of the device, e.g. usb-serial or platform.
+         */
+        std::string subsystem {} ;
+
+        /**
+         * @brief True iff the device is attached through USB.
+         */
+        bool isUsbDevice {false} ;
+
+        /**
+         * @brief The USB vendor ID of the device.
+         */
+        uint16_t usbVendorId {0} ;
+
+        /**
+         * @brief The USB product ID of the device.
+         */
+        uint16_t usbProductId {0} ;
+
+        /**
+         * @brief The USB serial number of the device.
+         */
+        std::string usbSerialNumber {} ;
+
+        /**
+         * @brief The USB manufacturer string of the device.
+         */
+        std::string manufacturer {} ;
+
+        /**
+         * @brief The USB product string of the device.
+         */
+        std::string product {} ;
+    } ;
+
+    /**
+     * @brief SerialPortEnumerator lists the serial ports of the system by
+     *        walking /sys/class/tty/(name)/device instead of trying to open
+     *        every candidate device file. By default, the enumeration only
+     *        reads sysfs and never touches the device files in /dev. The
+     *        sysfs and /dev roots can be overridden for testing.
+     */
+    class SerialPortEnumerator
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param sysfsRoot The mount point of the sysfs file system.
+         * @param devRoot The directory containing the device files.
+         */
+        explicit SerialPortEnumerator(const std::string& sysfsRoot = SYSFS_ROOT_DEFAULT,
+                                      const std::string& devRoot   = DEV_ROOT_DEFAULT) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialPortEnumerator() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialPortEnumerator(const SerialPortEnumerator& otherSerialPortEnumerator) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialPortEnumerator(SerialPortEnumerator&& otherSerialPortEnumerator) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialPortEnumerator& operator=(const SerialPortEnumerator& otherSerialPortEnumerator) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialPortEnumerator& operator=(SerialPortEnumerator&& otherSerialPortEnumerator) ;
+
+        /**
+         * @brief Enables resolution of the stable /dev/serial/by-id paths
+         *        of the serial ports. This reads the symbolic links in /dev
+         *        but does not open any device.
+         * @param resolveByIdPaths True to resolve by-id paths.
+         */
+        void SetResolveByIdPaths(const bool resolveByIdPaths) ;
+
+        /**
+         * @brief Enables probing of the device files. Each serial port is
+         *        opened and queried with TIOCGSERIAL and only ports that
+         *        respond are reported. This is slow for legacy ports and is
+         *        disabled by default.
+         * @param probeDevices True to probe the device files.
+         */
+        void SetProbeDevices(const bool probeDevices) ;
+
+        /**
+         * @brief Gets the serial ports present in the system, sorted by name.
+         * @return Returns a std::vector with the metadata of each serial port.
+         */
+        std::vector<SerialPortInfo> GetSerialPorts() const ;
+
+        /**
+         * @brief Gets the metadata of a single serial port.
+         * @param name The kernel name of the serial port, e.g. ttyUSB0.
+         * @param serialPortInfo The metadata of the serial port.
+         * @return Returns true iff name refers to a serial port device.
+         */
+        bool GetSerialPortInfo(const std::string& name,
+                               SerialPortInfo&    serialPortInfo) const ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialPortEnumerator
+
+} // namespace LibSerial
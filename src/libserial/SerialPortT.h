@@ -0,0 +1,1508 @@
+/******************************************************************************
+ * @file SerialPortT.h                                                        *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+
+#pragma once
+
+#include <libserial/SerialConfig.h>
+#include <libserial/SerialPort.h>
+#include <libserial/SerialPortConstants.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <ios>
+#include <poll.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <utility>
+
+namespace LibSerial
+{
+    /**
+     * @brief PosixIoBackend is the default I/O backend of SerialPortT. It
+     *        owns a non-blocking file descriptor and performs I/O with POSIX
+     *        system calls. Errors are reported C-style by returning -1 and
+     *        leaving the reason in errno; SerialPortT hands them on to its
+     *        ErrorPolicy.
+     */
+    class PosixIoBackend
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        PosixIoBackend() = default ;
+
+        /**
+         * @brief Destructor. Closes the file descriptor if it is open.
+         */
+        ~PosixIoBackend() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        PosixIoBackend(const PosixIoBackend& otherPosixIoBackend) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        PosixIoBackend(PosixIoBackend&& otherPosixIoBackend) noexcept ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        PosixIoBackend& operator=(const PosixIoBackend& otherPosixIoBackend) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        PosixIoBackend& operator=(PosixIoBackend&& otherPosixIoBackend) noexcept ;
+
+        /**
+         * @brief Opens the device in non-blocking mode for exclusive use.
+         * @param fileName The file name of the serial port.
+         * @param flags The O_RDONLY, O_WRONLY or O_RDWR access mode.
+         * @return Returns 0 on success or -1 with errno set.
+         */
+        int Open(const std::string& fileName,
+                 int                flags) ;
+
+        /**
+         * @brief Closes the file descriptor.
+         * @return Returns 0 on success or -1 with errno set.
+         */
+        int Close() noexcept ;
+
+        /**
+         * @brief Determines if the file descriptor is open.
+         * @return Returns true iff the file descriptor is open.
+         */
+        bool IsOpen() const noexcept ;
+
+        /**
+         * @brief Gets the file descriptor.
+         * @return Returns the file descriptor, or -1 if it is not open.
+         */
+        int GetFileDescriptor() const noexcept ;
+
+        /**
+         * @brief Reads at most numberOfBytes without blocking.
+         * @return Returns the number of bytes read, 0 on hang-up, or -1
+         *         with errno set (EAGAIN if no data is available).
+         */
+        ssize_t Read(char*  dataBuffer,
+                     size_t numberOfBytes) noexcept ;
+
+        /**
+         * @brief Writes at most numberOfBytes without blocking.
+         * @return Returns the number of bytes written or -1 with errno set.
+         */
+        ssize_t Write(const char* dataBuffer,
+                      size_t      numberOfBytes) noexcept ;
+
+        /**
+         * @brief Waits for the requested events on the file descriptor.
+         * @param events The poll() events to wait for.
+         * @param msTimeout The timeout in milliseconds, -1 to wait forever.
+         * @return Returns a positive value if ready, 0 on timeout, or -1
+         *         with errno set.
+         */
+        int Wait(short events,
+                 int   msTimeout) noexcept ;
+
+        /**
+         * @brief Gets the number of bytes waiting in the input queue.
+         * @return Returns the number of bytes, or -1 with errno set.
+         */
+        int GetNumberOfBytesAvailable() noexcept ;
+
+        /**
+         * @brief Gets the termios settings of the device.
+         * @return Returns 0 on success or -1 with errno set.
+         */
+        int GetPortSettings(termios& portSettings) noexcept ;
+
+        /**
+         * @brief Applies the termios settings to the device immediately.
+         * @return Returns 0 on success or -1 with errno set.
+         */
+        int SetPortSettings(const termios& portSettings) noexcept ;
+
+        /**
+         * @brief Waits until all output written has been transmitted.
+         * @return Returns 0 on success or -1 with errno set.
+         */
+        int Drain() noexcept ;
+
+        /**
+         * @brief Discards the data in the kernel input and/or output queues.
+         * @param queueSelector One of TCIFLUSH, TCOFLUSH or TCIOFLUSH.
+         * @return Returns 0 on success or -1 with errno set.
+         */
+        int Flush(int queueSelector) noexcept ;
+
+    private:
+
+        /**
+         * @brief The file descriptor, -1 when closed.
+         */
+        int mFileDescriptor {-1} ;
+
+    } ; // class PosixIoBackend
+
+    /**
+     * @brief The default TimeoutPolicy of SerialPortT. An instance is created
+     *        for every blocking operation and waits with poll() until the
+     *        requested number of milliseconds have elapsed in total. As with
+     *        SerialPort::Read(), a timeout of zero waits indefinitely.
+     */
+    class PollTimeout
+    {
+    public:
+
+        /**
+         * @brief Constructor. Starts the timeout period.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        explicit PollTimeout(size_t msTimeout) noexcept ;
+
+        /**
+         * @brief Gets the time remaining in the timeout period.
+         * @return Returns the remaining milliseconds, rounded up, as a
+         *         poll() timeout: -1 to wait forever or 0 once expired.
+         */
+        int GetRemaining() const noexcept ;
+
+    private:
+
+        /**
+         * @brief True if the timeout period is unbounded.
+         */
+        bool mWaitForever ;
+
+        /**
+         * @brief The end of the timeout period.
+         */
+        std::chrono::steady_clock::time_point mDeadline ;
+
+    } ; // class PollTimeout
+
+    /**
+     * @brief A TimeoutPolicy that never waits: reads only return data that
+     *        has already arrived and writes only what the kernel accepts
+     *        immediately. The requested timeout is ignored.
+     */
+    class NoWaitTimeout
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         */
+        explicit NoWaitTimeout(size_t /* msTimeout */) noexcept
+        {
+            /* Empty */
+        }
+
+        /**
+         * @brief Gets the time remaining in the timeout period.
+         * @return Always returns 0.
+         */
+        int GetRemaining() const noexcept
+        {
+            return 0 ;
+        }
+    } ; // class NoWaitTimeout
+
+    /**
+     * @brief The kinds of error reported to the ErrorPolicy of SerialPortT.
+     */
+    enum class SerialPortError
+    {
+        NONE,
+        NOT_OPEN,
+        ALREADY_OPEN,
+        OPEN_FAILED,
+        READ_TIMEOUT,
+        SYSTEM_ERROR
+    } ;
+
+    /**
+     * @brief The default ErrorPolicy of SerialPortT. Errors are reported by
+     *        throwing the same exceptions as SerialPort.
+     */
+    class ThrowOnError
+    {
+    protected:
+
+        /**
+         * @brief Throws the exception corresponding to the error.
+         * @param serialPortError The kind of error.
+         * @param errorNumber The errno value describing the error.
+         */
+        [[noreturn]] void OnError(SerialPortError serialPortError,
+                                  int             errorNumber) const ;
+    } ; // class ThrowOnError
+
+    /**
+     * @brief An ErrorPolicy that records the last error instead of throwing.
+     *        The failing SerialPortT method returns false and the error can
+     *        be inspected with GetLastError() and GetLastErrorNumber().
+     */
+    class ReturnErrorCode
+    {
+    public:
+
+        /**
+         * @brief Gets the kind of the last error.
+         * @return Returns the last error, or SerialPortError::NONE.
+         */
+        SerialPortError GetLastError() const noexcept ;
+
+        /**
+         * @brief Gets the errno value of the last error.
+         * @return Returns the errno value, or 0.
+         */
+        int GetLastErrorNumber() const noexcept ;
+
+        /**
+         * @brief Forgets the last error.
+         */
+        void ClearError() noexcept ;
+
+    protected:
+
+        /**
+         * @brief Records the error.
+         * @param serialPortError The kind of error.
+         * @param errorNumber The errno value describing the error.
+         */
+        void OnError(SerialPortError serialPortError,
+                     int             errorNumber) noexcept ;
+
+    private:
+
+        /**
+         * @brief The kind of the last error.
+         */
+        SerialPortError mLastError {SerialPortError::NONE} ;
+
+        /**
+         * @brief The errno value of the last error.
+         */
+        int mLastErrorNumber {0} ;
+
+    } ; // class ReturnErrorCode
+
+    /**
+     * @brief SerialPortT is a non-virtual, header-only serial port whose
+     *        behavior is selected at compile time. Unlike SerialPort, it
+     *        has no PImpl indirection: the hot paths IsOpen(), ReadByte()
+     *        from the get buffer and WriteByte() into the put buffer are
+     *        small inline functions that only fall back to system calls when
+     *        the buffers run empty or full.
+     *
+     *        Output is buffered until the put buffer fills, Sync() is called,
+     *        or a read has to wait for input. The port is opened with the
+     *        same settings as SerialPort::Open() (115200 8N1, no flow control,
+     *        raw mode) or with a SerialConfig, and the previous settings are
+     *        restored by Close().
+     *
+     * @tparam IoBackend Performs the system calls, see PosixIoBackend.
+     * @tparam TimeoutPolicy Decides how long to wait, see PollTimeout and
+     *         NoWaitTimeout.
+     * @tparam ErrorPolicy Reports errors, see ThrowOnError and
+     *         ReturnErrorCode. It is a base class so that its public
+     *         methods are available on the serial port.
+     * @tparam BufferSize The size in bytes of each of the get and put buffers.
+     */
+    template<typename IoBackend     = PosixIoBackend,
+             typename TimeoutPolicy = PollTimeout,
+             typename ErrorPolicy   = ThrowOnError,
+             size_t   BufferSize    = STREAM_BUFFER_SIZE_DEFAULT>
+    class SerialPortT : public ErrorPolicy
+    {
+        static_assert(BufferSize > 0, "SerialPortT requires a non-empty buffer.") ;
+
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        SerialPortT() = default ;
+
+        /**
+         * @brief Constructor that opens the serial port.
+         * @param fileName The file name of the serial port.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        explicit SerialPortT(const std::string& fileName,
+                             const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
+        /**
+         * @brief Destructor. Writes any buffered output and closes the
+         *        serial port. Errors are ignored.
+         */
+        ~SerialPortT() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialPortT(const SerialPortT& otherSerialPortT) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialPortT(SerialPortT&& otherSerialPortT) = default ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialPortT& operator=(const SerialPortT& otherSerialPortT) = delete ;
+
+        /**
+         * @brief Move assignment is allowed. The serial port assigned to is
+         *        closed first, like by the destructor.
+         */
+        SerialPortT& operator=(SerialPortT&& otherSerialPortT) ;
+
+        /**
+         * @brief Opens the serial port associated with the specified
+         *        file name and the specified mode.
+         * @param fileName The file name of the serial port.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         * @return Returns true on success.
+         */
+        bool Open(const std::string& fileName,
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
+        /**
+         * @brief Opens the serial port and applies a compile-time
+         *        configuration with a single tcsetattr() call.
+         * @param fileName The file name of the serial port.
+         * @param serialConfig The configuration, see SerialConfig.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         * @return Returns true on success.
+         */
+        template<BaudRate      BAUD_RATE,
+                 CharacterSize CHARACTER_SIZE,
+                 Parity        PARITY,
+                 StopBits      STOP_BITS,
+                 FlowControl   FLOW_CONTROL>
+        bool Open(const std::string& fileName,
+                  const SerialConfig<BAUD_RATE, CHARACTER_SIZE, PARITY, STOP_BITS, FLOW_CONTROL>& serialConfig,
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
+        /**
+         * @brief Writes any buffered output, restores the previous settings
+         *        and closes the serial port.
+         * @return Returns true on success.
+         */
+        bool Close() ;
+
+        /**
+         * @brief Determines if the serial port is open.
+         * @return Returns true iff the serial port is open.
+         */
+        bool IsOpen() const noexcept ;
+
+        /**
+         * @brief Gets the serial port file descriptor.
+         * @return Returns the file descriptor, or -1 if the port is closed.
+         */
+        int GetFileDescriptor() const noexcept ;
+
+        /**
+         * @brief Gets the I/O backend, e.g. to issue ioctl() calls that
+         *        SerialPortT does not wrap.
+         * @return Returns a reference to the I/O backend.
+         */
+        IoBackend& GetIoBackend() noexcept ;
+
+        /**
+         * @brief Gets the current termios settings of the serial port.
+         * @param portSettings The termios structure to fill.
+         * @return Returns true on success.
+         */
+        bool GetPortSettings(termios& portSettings) ;
+
+        /**
+         * @brief Applies termios settings to the serial port with a single
+         *        tcsetattr() call.
+         * @param portSettings The settings to apply.
+         * @return Returns true on success.
+         */
+        bool SetPortSettings(const termios& portSettings) ;
+
+        /**
+         * @brief Reads a single byte. The byte is taken from the get buffer
+         *        if possible; otherwise the get buffer is refilled with as
+         *        much data as is available, waiting according to the
+         *        TimeoutPolicy.
+         * @param charBuffer The character read from the serial port.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns true on success.
+         */
+        bool ReadByte(char&  charBuffer,
+                      size_t msTimeout = 0) ;
+
+        /**
+         * @brief Reads the specified number of bytes from the serial port,
+         *        waiting according to the TimeoutPolicy for at most msTimeout
+         *        milliseconds in total. If numberOfBytes is zero, the data
+         *        that is already available is read without waiting. Any data
+         *        received remains available in the dataBuffer on timeout.
+         * @param dataBuffer The data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns true on success.
+         */
+        bool Read(DataBuffer& dataBuffer,
+                  size_t      numberOfBytes = 0,
+                  size_t      msTimeout = 0) ;
+
+        /**
+         * @brief Reads the specified number of bytes from the serial port.
+         *        See Read(DataBuffer&, size_t, size_t).
+         * @param dataString The string to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns true on success.
+         */
+        bool Read(std::string& dataString,
+                  size_t       numberOfBytes = 0,
+                  size_t       msTimeout = 0) ;
+
+        /**
+         * @brief Writes a single byte into the put buffer, writing the buffer
+         *        to the serial port first if it is full.
+         * @param charBuffer The byte to be written to the serial port.
+         * @return Returns true on success.
+         */
+        bool WriteByte(char charBuffer) ;
+
+        /**
+         * @brief Writes a DataBuffer to the serial port. Data that does not
+         *        fit in the put buffer is written directly.
+         * @param dataBuffer The DataBuffer to write to the serial port.
+         * @return Returns true on success.
+         */
+        bool Write(const DataBuffer& dataBuffer) ;
+
+        /**
+         * @brief Writes a std::string to the serial port. Data that does not
+         *        fit in the put buffer is written directly.
+         * @param dataString The std::string to write to the serial port.
+         * @return Returns true on success.
+         */
+        bool Write(const std::string& dataString) ;
+
+        /**
+         * @brief Writes the contents of the put buffer to the serial port.
+         *        Unlike FlushOutputBuffer(), no data is discarded.
+         * @return Returns true on success.
+         */
+        bool Sync() ;
+
+        /**
+         * @brief Writes the contents of the put buffer and waits until all
+         *        output has been transmitted.
+         * @return Returns true on success.
+         */
+        bool DrainWriteBuffer() ;
+
+        /**
+         * @brief Discards the get buffer and the kernel input queue.
+         * @return Returns true on success.
+         */
+        bool FlushInputBuffer() ;
+
+        /**
+         * @brief Discards the put buffer and the kernel output queue.
+         * @return Returns true on success.
+         */
+        bool FlushOutputBuffer() ;
+
+        /**
+         * @brief Gets the number of bytes that can be read without waiting,
+         *        including the bytes in the get buffer.
+         * @return Returns the number of bytes available, or 0 on error.
+         */
+        size_t GetNumberOfBytesAvailable() ;
+
+        /**
+         * @brief Checks if data can be read without waiting.
+         * @return Returns true iff data is available.
+         */
+        bool IsDataAvailable() ;
+
+    private:
+
+        /**
+         * @brief Reports an error to the ErrorPolicy.
+         * @return Returns false if the ErrorPolicy returns.
+         */
+        bool Fail(SerialPortError serialPortError,
+                  int             errorNumber) ;
+
+        /**
+         * @brief Refills the empty get buffer, the slow path of ReadByte().
+         * @param timeout The timeout of the current operation.
+         * @return Returns true if at least one byte was read.
+         */
+        bool FillGetBuffer(const TimeoutPolicy& timeout) ;
+
+        /**
+         * @brief Appends data to the put buffer, writing the buffer and then
+         *        the data directly to the serial port if it does not fit.
+         * @return Returns true on success.
+         */
+        bool WriteData(const char* dataBuffer,
+                       size_t      numberOfBytes) ;
+
+        /**
+         * @brief Writes data to the serial port, waiting for it to become
+         *        writable whenever the kernel output queue is full.
+         * @return Returns true on success.
+         */
+        bool WriteToPort(const char* dataBuffer,
+                         size_t      numberOfBytes) ;
+
+        /**
+         * @brief Reads up to numberOfBytes into a DataBuffer or std::string.
+         */
+        template<typename Container>
+        bool ReadData(Container& container,
+                      size_t     numberOfBytes,
+                      size_t     msTimeout) ;
+
+        /**
+         * @brief Discards the contents of the get buffer.
+         */
+        void ResetGetBuffer() noexcept ;
+
+        /**
+         * @brief The I/O backend.
+         */
+        IoBackend mIoBackend {} ;
+
+        /**
+         * @brief The settings of the serial port before it was opened.
+         */
+        termios mOldPortSettings {} ;
+
+        /**
+         * @brief The get buffer and the range [mGetPosition, mGetEnd) of
+         *        bytes that have not been read yet.
+         */
+        std::array<char, BufferSize> mGetBuffer {} ;
+        size_t mGetPosition {0} ;
+        size_t mGetEnd {0} ;
+
+        /**
+         * @brief The put buffer and the number of bytes pending in it.
+         */
+        std::array<char, BufferSize> mPutBuffer {} ;
+        size_t mPutEnd {0} ;
+
+    } ; // class SerialPortT
+
+    /** ------------------------------------------------------------ */
+    inline
+    PosixIoBackend::~PosixIoBackend()
+    {
+        this->Close() ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    PosixIoBackend::PosixIoBackend(PosixIoBackend&& otherPosixIoBackend) noexcept
+        : mFileDescriptor(otherPosixIoBackend.mFileDescriptor)
+    {
+        otherPosixIoBackend.mFileDescriptor = -1 ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    PosixIoBackend&
+    PosixIoBackend::operator=(PosixIoBackend&& otherPosixIoBackend) noexcept
+    {
+        if (this != &otherPosixIoBackend)
+        {
+            this->Close() ;
+            mFileDescriptor = otherPosixIoBackend.mFileDescriptor ;
+            otherPosixIoBackend.mFileDescriptor = -1 ;
+        }
+        return *this ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::Open(const std::string& fileName,
+                         const int          flags)
+    {
+        const auto fd = call_with_retry(open,
+                                        fileName.c_str(),
+                                        flags | O_NOCTTY | O_NONBLOCK) ;
+        if (fd < 0)
+        {
+            return -1 ;
+        }
+
+        // Prevent other processes from opening the device.
+        if (call_with_retry(ioctl, fd, TIOCEXCL) < 0)
+        {
+            const auto error_number = errno ;
+            close(fd) ;
+            errno = error_number ;
+            return -1 ;
+        }
+
+        mFileDescriptor = fd ;
+        return 0 ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::Close() noexcept
+    {
+        if (mFileDescriptor < 0)
+        {
+            return 0 ;
+        }
+
+        // Do not retry close() on EINTR: the descriptor is released either way.
+        const auto result = close(mFileDescriptor) ;
+        mFileDescriptor = -1 ;
+        return result ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    bool
+    PosixIoBackend::IsOpen() const noexcept
+    {
+        return mFileDescriptor >= 0 ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::GetFileDescriptor() const noexcept
+    {
+        return mFileDescriptor ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    ssize_t
+    PosixIoBackend::Read(char* const  dataBuffer,
+                         const size_t numberOfBytes) noexcept
+    {
+        return call_with_retry(read, mFileDescriptor, dataBuffer, numberOfBytes) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    ssize_t
+    PosixIoBackend::Write(const char* const dataBuffer,
+                          const size_t      numberOfBytes) noexcept
+    {
+        return call_with_retry(write, mFileDescriptor, dataBuffer, numberOfBytes) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::Wait(const short events,
+                         const int   msTimeout) noexcept
+    {
+        pollfd poll_fd {mFileDescriptor, events, 0} ;
+        return call_with_retry(poll, &poll_fd, 1, msTimeout) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::GetNumberOfBytesAvailable() noexcept
+    {
+        int number_of_bytes_available = 0 ;
+        if (call_with_retry(ioctl,
+                            mFileDescriptor,
+                            FIONREAD,
+                            &number_of_bytes_available) < 0)
+        {
+            return -1 ;
+        }
+        return number_of_bytes_available ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::GetPortSettings(termios& portSettings) noexcept
+    {
+        return tcgetattr(mFileDescriptor, &portSettings) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::SetPortSettings(const termios& portSettings) noexcept
+    {
+        return call_with_retry(tcsetattr, mFileDescriptor, TCSANOW, &portSettings) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::Drain() noexcept
+    {
+        return call_with_retry(tcdrain, mFileDescriptor) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PosixIoBackend::Flush(const int queueSelector) noexcept
+    {
+        return tcflush(mFileDescriptor, queueSelector) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    PollTimeout::PollTimeout(const size_t msTimeout) noexcept
+        : mWaitForever(msTimeout == 0)
+        , mDeadline(std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(msTimeout))
+    {
+        /* Empty */
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    PollTimeout::GetRemaining() const noexcept
+    {
+        if (mWaitForever)
+        {
+            return -1 ;
+        }
+
+        const auto remaining = mDeadline - std::chrono::steady_clock::now() ;
+        if (remaining <= std::chrono::steady_clock::duration::zero())
+        {
+            return 0 ;
+        }
+
+        // Round up so that poll() does not return just before the deadline.
+        const auto us_remaining =
+            std::chrono::duration_cast<std::chrono::microseconds>(remaining).count() ;
+        const auto ms_remaining = (us_remaining + MICROSECONDS_PER_MS - 1) / MICROSECONDS_PER_MS ;
+        return static_cast<int>(std::min<decltype(ms_remaining)>(ms_remaining, INT_MAX)) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    void
+    ThrowOnError::OnError(const SerialPortError serialPortError,
+                          const int             errorNumber) const
+    {
+        switch (serialPortError)
+        {
+        case SerialPortError::NOT_OPEN:
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        case SerialPortError::ALREADY_OPEN:
+            throw AlreadyOpen(ERR_MSG_PORT_ALREADY_OPEN) ;
+        case SerialPortError::OPEN_FAILED:
+            throw OpenFailed(std::strerror(errorNumber)) ;
+        case SerialPortError::READ_TIMEOUT:
+            throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+        default:
+            throw std::runtime_error(std::strerror(errorNumber)) ;
+        }
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    SerialPortError
+    ReturnErrorCode::GetLastError() const noexcept
+    {
+        return mLastError ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    int
+    ReturnErrorCode::GetLastErrorNumber() const noexcept
+    {
+        return mLastErrorNumber ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    void
+    ReturnErrorCode::ClearError() noexcept
+    {
+        mLastError = SerialPortError::NONE ;
+        mLastErrorNumber = 0 ;
+    }
+
+    /** ------------------------------------------------------------ */
+    inline
+    void
+    ReturnErrorCode::OnError(const SerialPortError serialPortError,
+                             const int             errorNumber) noexcept
+    {
+        mLastError = serialPortError ;
+        mLastErrorNumber = errorNumber ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::SerialPortT(const std::string& fileName,
+                                                                               const std::ios_base::openmode& openMode)
+    {
+        this->Open(fileName, openMode) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::~SerialPortT()
+    {
+        if (this->IsOpen())
+        {
+            try
+            {
+                this->Close() ;
+            }
+            catch (...)
+            {
+                //
+                // :IMPORTANT: We do not let any exceptions escape the
+                // destructor.
+                //
+            }
+        }
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>&
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::operator=(SerialPortT&& otherSerialPortT)
+    {
+        if (this == &otherSerialPortT)
+        {
+            return *this ;
+        }
+
+        // Write the pending output and restore the old settings before the
+        // backend is replaced. Errors are ignored, as in the destructor.
+        if (this->IsOpen())
+        {
+            try
+            {
+                this->Close() ;
+            }
+            catch (...)
+            {
+                // Empty
+            }
+        }
+
+        ErrorPolicy::operator=(std::move(otherSerialPortT)) ;
+        mIoBackend = std::move(otherSerialPortT.mIoBackend) ;
+        mOldPortSettings = otherSerialPortT.mOldPortSettings ;
+        mGetBuffer = otherSerialPortT.mGetBuffer ;
+        mGetPosition = otherSerialPortT.mGetPosition ;
+        mGetEnd = otherSerialPortT.mGetEnd ;
+        mPutBuffer = otherSerialPortT.mPutBuffer ;
+        mPutEnd = otherSerialPortT.mPutEnd ;
+
+        otherSerialPortT.ResetGetBuffer() ;
+        otherSerialPortT.mPutEnd = 0 ;
+
+        return *this ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Open(const std::string& fileName,
+                                                                        const std::ios_base::openmode& openMode)
+    {
+        return this->Open(fileName, DefaultSerialConfig {}, openMode) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    template<BaudRate      BAUD_RATE,
+             CharacterSize CHARACTER_SIZE,
+             Parity        PARITY,
+             StopBits      STOP_BITS,
+             FlowControl   FLOW_CONTROL>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Open(const std::string& fileName,
+                                                                        const SerialConfig<BAUD_RATE, CHARACTER_SIZE, PARITY, STOP_BITS, FLOW_CONTROL>& /* serialConfig */,
+                                                                        const std::ios_base::openmode& openMode)
+    {
+        if (this->IsOpen())
+        {
+            return this->Fail(SerialPortError::ALREADY_OPEN, EBUSY) ;
+        }
+
+        int flags = O_RDWR ;
+        if (openMode == std::ios_base::in)
+        {
+            flags = O_RDONLY ;
+        }
+        else if (openMode == std::ios_base::out)
+        {
+            flags = O_WRONLY ;
+        }
+
+        if (mIoBackend.Open(fileName, flags) < 0 or
+            mIoBackend.GetPortSettings(mOldPortSettings) < 0)
+        {
+            const auto error_number = errno ;
+            mIoBackend.Close() ;
+            return this->Fail(SerialPortError::OPEN_FAILED, error_number) ;
+        }
+
+        // Apply the configuration with a single tcsetattr().
+        termios port_settings = mOldPortSettings ;
+        SerialConfig<BAUD_RATE, CHARACTER_SIZE, PARITY, STOP_BITS, FLOW_CONTROL>::ApplyTo(port_settings) ;
+
+        if (mIoBackend.SetPortSettings(port_settings) < 0 or
+            mIoBackend.Flush(TCIOFLUSH) < 0)
+        {
+            const auto error_number = errno ;
+            mIoBackend.Close() ;
+            return this->Fail(SerialPortError::OPEN_FAILED, error_number) ;
+        }
+
+        this->ResetGetBuffer() ;
+        mPutEnd = 0 ;
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Close()
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        // Close the port even if the pending output cannot be written or
+        // the old settings cannot be restored, e.g. because the device has
+        // been removed. Report the first error afterwards.
+        int error_number = 0 ;
+        if (not this->Sync())
+        {
+            error_number = EIO ;
+        }
+        mPutEnd = 0 ;
+
+        if (mIoBackend.SetPortSettings(mOldPortSettings) < 0 and error_number == 0)
+        {
+            error_number = errno ;
+        }
+
+        if (mIoBackend.Close() < 0 and error_number == 0)
+        {
+            error_number = errno ;
+        }
+
+        this->ResetGetBuffer() ;
+
+        if (error_number != 0)
+        {
+            return this->Fail(SerialPortError::SYSTEM_ERROR, error_number) ;
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    inline
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::IsOpen() const noexcept
+    {
+        return mIoBackend.IsOpen() ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    inline
+    int
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::GetFileDescriptor() const noexcept
+    {
+        return mIoBackend.GetFileDescriptor() ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    inline
+    IoBackend&
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::GetIoBackend() noexcept
+    {
+        return mIoBackend ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::GetPortSettings(termios& portSettings)
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        if (mIoBackend.GetPortSettings(portSettings) < 0)
+        {
+            return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::SetPortSettings(const termios& portSettings)
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        if (mIoBackend.SetPortSettings(portSettings) < 0)
+        {
+            return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    inline
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::ReadByte(char&        charBuffer,
+                                                                            const size_t msTimeout)
+    {
+        // Fast path: the byte is already in the get buffer.
+        if (mGetPosition != mGetEnd)
+        {
+            charBuffer = mGetBuffer[mGetPosition++] ;
+            return true ;
+        }
+
+        if (not this->FillGetBuffer(TimeoutPolicy(msTimeout)))
+        {
+            return false ;
+        }
+
+        charBuffer = mGetBuffer[mGetPosition++] ;
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Read(DataBuffer&  dataBuffer,
+                                                                        const size_t numberOfBytes,
+                                                                        const size_t msTimeout)
+    {
+        return this->ReadData(dataBuffer, numberOfBytes, msTimeout) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Read(std::string& dataString,
+                                                                        const size_t numberOfBytes,
+                                                                        const size_t msTimeout)
+    {
+        return this->ReadData(dataString, numberOfBytes, msTimeout) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    inline
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::WriteByte(const char charBuffer)
+    {
+        // Fast path: there is room in the put buffer of an open port.
+        if (mPutEnd != BufferSize and this->IsOpen())
+        {
+            mPutBuffer[mPutEnd++] = charBuffer ;
+            return true ;
+        }
+
+        return this->WriteData(&charBuffer, 1) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Write(const DataBuffer& dataBuffer)
+    {
+        return this->WriteData(reinterpret_cast<const char*>(dataBuffer.data()),
+                               dataBuffer.size()) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Write(const std::string& dataString)
+    {
+        return this->WriteData(dataString.data(), dataString.size()) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Sync()
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        if (mPutEnd == 0)
+        {
+            return true ;
+        }
+
+        const auto number_of_bytes = mPutEnd ;
+        mPutEnd = 0 ;
+        return this->WriteToPort(mPutBuffer.data(), number_of_bytes) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::DrainWriteBuffer()
+    {
+        if (not this->Sync())
+        {
+            return false ;
+        }
+
+        if (mIoBackend.Drain() < 0)
+        {
+            return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::FlushInputBuffer()
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        this->ResetGetBuffer() ;
+        if (mIoBackend.Flush(TCIFLUSH) < 0)
+        {
+            return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::FlushOutputBuffer()
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        mPutEnd = 0 ;
+        if (mIoBackend.Flush(TCOFLUSH) < 0)
+        {
+            return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    size_t
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::GetNumberOfBytesAvailable()
+    {
+        if (not this->IsOpen())
+        {
+            this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+            return 0 ;
+        }
+
+        const auto number_of_bytes_queued = mIoBackend.GetNumberOfBytesAvailable() ;
+        if (number_of_bytes_queued < 0)
+        {
+            this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+            return 0 ;
+        }
+
+        return (mGetEnd - mGetPosition) + static_cast<size_t>(number_of_bytes_queued) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::IsDataAvailable()
+    {
+        return this->GetNumberOfBytesAvailable() > 0 ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    inline
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::Fail(const SerialPortError serialPortError,
+                                                                        const int             errorNumber)
+    {
+        ErrorPolicy::OnError(serialPortError, errorNumber) ;
+        return false ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::FillGetBuffer(const TimeoutPolicy& timeout)
+    {
+        // Write pending output first: the other end may be waiting for it
+        // before it replies.
+        if (not this->Sync())
+        {
+            return false ;
+        }
+
+        while (true)
+        {
+            const auto result = mIoBackend.Read(mGetBuffer.data(), BufferSize) ;
+            if (result > 0)
+            {
+                mGetPosition = 0 ;
+                mGetEnd = static_cast<size_t>(result) ;
+                return true ;
+            }
+
+            // A non-blocking read returns 0 only if the device hung up.
+            if (result == 0)
+            {
+                return this->Fail(SerialPortError::SYSTEM_ERROR, EIO) ;
+            }
+
+            if (errno != EAGAIN)
+            {
+                return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+            }
+
+            const auto poll_result = mIoBackend.Wait(POLLIN, timeout.GetRemaining()) ;
+            if (poll_result == 0)
+            {
+                return this->Fail(SerialPortError::READ_TIMEOUT, ETIMEDOUT) ;
+            }
+
+            if (poll_result < 0)
+            {
+                return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+            }
+        }
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::WriteData(const char* const dataBuffer,
+                                                                             const size_t      numberOfBytes)
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        if (numberOfBytes <= BufferSize - mPutEnd)
+        {
+            std::copy(dataBuffer, dataBuffer + numberOfBytes, mPutBuffer.data() + mPutEnd) ;
+            mPutEnd += numberOfBytes ;
+            return true ;
+        }
+
+        if (not this->Sync())
+        {
+            return false ;
+        }
+
+        // Buffer what fits and write large blocks without copying them.
+        if (numberOfBytes < BufferSize)
+        {
+            std::copy(dataBuffer, dataBuffer + numberOfBytes, mPutBuffer.data()) ;
+            mPutEnd = numberOfBytes ;
+            return true ;
+        }
+
+        return this->WriteToPort(dataBuffer, numberOfBytes) ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::WriteToPort(const char* const dataBuffer,
+                                                                               const size_t      numberOfBytes)
+    {
+        size_t number_of_bytes_written = 0 ;
+        while (number_of_bytes_written < numberOfBytes)
+        {
+            const auto result = mIoBackend.Write(dataBuffer + number_of_bytes_written,
+                                                 numberOfBytes - number_of_bytes_written) ;
+            if (result >= 0)
+            {
+                number_of_bytes_written += static_cast<size_t>(result) ;
+                continue ;
+            }
+
+            if (errno != EAGAIN)
+            {
+                return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+            }
+
+            // The kernel output queue is full. Writes are not subject to the
+            // read timeout, so wait until there is room again.
+            if (mIoBackend.Wait(POLLOUT, -1) < 0)
+            {
+                return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+            }
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    template<typename Container>
+    bool
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::ReadData(Container&   container,
+                                                                            const size_t numberOfBytes,
+                                                                            const size_t msTimeout)
+    {
+        if (not this->IsOpen())
+        {
+            return this->Fail(SerialPortError::NOT_OPEN, EBADF) ;
+        }
+
+        using value_type = typename Container::value_type ;
+
+        // Without a byte count, return whatever can be read without waiting.
+        if (numberOfBytes == 0)
+        {
+            container.clear() ;
+            while (true)
+            {
+                container.insert(container.end(),
+                                 reinterpret_cast<const value_type*>(mGetBuffer.data() + mGetPosition),
+                                 reinterpret_cast<const value_type*>(mGetBuffer.data() + mGetEnd)) ;
+                this->ResetGetBuffer() ;
+
+                const auto result = mIoBackend.Read(mGetBuffer.data(), BufferSize) ;
+                if (result > 0)
+                {
+                    mGetEnd = static_cast<size_t>(result) ;
+                    continue ;
+                }
+
+                if (result < 0 and errno != EAGAIN)
+                {
+                    return this->Fail(SerialPortError::SYSTEM_ERROR, errno) ;
+                }
+                return true ;
+            }
+        }
+
+        // Append the data as it arrives so that the data received so far
+        // remains in the container if the read times out.
+        container.clear() ;
+        container.reserve(numberOfBytes) ;
+
+        const TimeoutPolicy timeout(msTimeout) ;
+        while (container.size() < numberOfBytes)
+        {
+            if (mGetPosition == mGetEnd and not this->FillGetBuffer(timeout))
+            {
+                return false ;
+            }
+
+            const auto number_of_bytes_copied = std::min(mGetEnd - mGetPosition,
+                                                         numberOfBytes - container.size()) ;
+            const auto* const data_begin = mGetBuffer.data() + mGetPosition ;
+            container.insert(container.end(),
+                             reinterpret_cast<const value_type*>(data_begin),
+                             reinterpret_cast<const value_type*>(data_begin + number_of_bytes_copied)) ;
+            mGetPosition += number_of_bytes_copied ;
+        }
+        return true ;
+    }
+
+    /** ------------------------------------------------------------ */
+    template<typename IoBackend, typename TimeoutPolicy, typename ErrorPolicy, size_t BufferSize>
+    inline
+    void
+    SerialPortT<IoBackend, TimeoutPolicy, ErrorPolicy, BufferSize>::ResetGetBuffer() noexcept
+    {
+        mGetPosition = 0 ;
+        mGetEnd = 0 ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,304 @@
+/******************************************************************************
+ * @file SerialReliableLink.h                                                 *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace LibSerial
+{
+    /**
+     * @brief The default number of frames a SerialReliableLink sends before
+     *        waiting for their acknowledgement.
+     */
+    constexpr size_t RELIABLE_LINK_WINDOW_DEFAULT = 16 ;
+
+    /**
+     * @brief The largest window of a SerialReliableLink, which is limited by
+     *        the selective acknowledgements covering 64 frames.
+     */
+    constexpr size_t RELIABLE_LINK_WINDOW_MAXIMUM = 64 ;
+
+    /**
+     * @brief The default maximum number of message bytes a SerialReliableLink
+     *        sends in one frame.
+     */
+    constexpr size_t RELIABLE_LINK_PAYLOAD_DEFAULT = 512 ;
+
+    /**
+     * @brief The largest maximum number of message bytes a SerialReliableLink
+     *        sends in one frame.
+     */
+    constexpr size_t RELIABLE_LINK_PAYLOAD_MAXIMUM = 4096 ;
+
+    /**
+     * @brief The options of a SerialReliableLink.
+     */
+    struct ReliableLinkOptions
+    {
+        /**
+         * @brief The number of frames sent before waiting for their
+         *        acknowledgement, from 1 (stop-and-wait) to
+         *        RELIABLE_LINK_WINDOW_MAXIMUM.
+         */
+        size_t windowSize {RELIABLE_LINK_WINDOW_DEFAULT} ;
+
+        /**
+         * @brief The maximum number of message bytes sent in one frame, from
+         *        1 to RELIABLE_LINK_PAYLOAD_MAXIMUM. Larger messages are split
+         *        into several frames.
+         */
+        size_t maximumPayloadSize {RELIABLE_LINK_PAYLOAD_DEFAULT} ;
+
+        /**
+         * @brief The time in milliseconds a frame is waited for before it is
+         *        sent again, until the round trip time has been measured.
+         */
+        size_t msInitialRetransmitTimeout {1000} ;
+
+        /**
+         * @brief The lower bound of the retransmission timeout in
+         *        milliseconds.
+         */
+        size_t msMinimumRetransmitTimeout {10} ;
+
+        /**
+         * @brief The upper bound of the retransmission timeout in
+         *        milliseconds, which also limits its exponential backoff.
+         */
+        size_t msMaximumRetransmitTimeout {10000} ;
+
+        /**
+         * @brief The number of times a frame is sent again before the peer
+         *        is considered gone.
+         */
+        size_t maximumRetransmissions {20} ;
+    } ;
+
+    /**
+     * @brief The counters maintained by a SerialReliableLink.
+     */
+    struct ReliableLinkStatistics
+    {
+        /**
+         * @brief The number of messages passed to Send().
+         */
+        size_t messagesSent {0} ;
+
+        /**
+         * @brief The number of messages received completely.
+         */
+        size_t messagesReceived {0} ;
+
+        /**
+         * @brief The number of frames written, including acknowledgements
+         *        and retransmissions.
+         */
+        size_t framesSent {0} ;
+
+        /**
+         * @brief The number of frames received intact.
+         */
+        size_t framesReceived {0} ;
+
+        /**
+         * @brief The number of data frames sent again.
+         */
+        size_t retransmissions {0} ;
+
+        /**
+         * @brief The number of frames discarded because of a wrong checksum
+         *        or size.
+         */
+        size_t corruptedFrames {0} ;
+
+        /**
+         * @brief The number of data frames received more than once.
+         */
+        size_t duplicateFrames {0} ;
+
+        /**
+         * @brief The smoothed round trip time in microseconds, which is 0
+         *        until the first measurement.
+         */
+        size_t smoothedRttUs {0} ;
+
+        /**
+         * @brief The current retransmission timeout in microseconds.
+         */
+        size_t retransmitTimeoutUs {0} ;
+    } ;
+
+    /**
+     * @brief SerialReliableLink transfers messages over a SerialPort that
+     *        may lose or corrupt data. Messages are split into frames that
+     *        carry a sequence number and a CRC-32, and up to a window of
+     *        frames is sent before waiting for acknowledgements. The peer
+     *        acknowledges the frames received in sequence and selectively
+     *        those received after a gap, so that only the missing frames are
+     *        sent again (selective repeat). A frame is sent again when later
+     *        frames have been acknowledged before it, or when the
+     *        retransmission timeout, adapted to the measured round trip time
+     *        as in RFC 6298, expires. A frame that is still not acknowledged
+     *        after maximumRetransmissions retransmissions makes the method
+     *        processing events throw std::runtime_error. Both directions are
+     *        independent, and acknowledgements are carried by the data frames
+     *        of the opposite direction when there are any.
+     *
+     *        Frames are delimited by 0x7E and byte stuffed as in HDLC, with
+     *        the XON and XOFF characters escaped as well, so that the link
+     *        resynchronizes after any error and works with software flow
+     *        control.
+     *
+     *        The link performs no I/O on its own: frames are written and read
+     *        by the calls to Send(), Receive(), Flush() and ProcessEvents(),
+     *        the latter of which can be called from a poll()/epoll() based
+     *        event loop whenever the file descriptor of the serial port
+     *        becomes readable. Both sides must keep processing events while
+     *        the other side is sending, so that the data is acknowledged.
+     *        There is no connection set up: both sides must start with new
+     *        SerialReliableLink instances. The link must only be used from
+     *        one thread at a time, and the serial port must not be read by
+     *        other code while the link is in use.
+     */
+    class SerialReliableLink
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param serialPort The open serial port used for the link, which
+         *        must outlive it.
+         * @param reliableLinkOptions The options of the link.
+         */
+        explicit SerialReliableLink(SerialPort&                serialPort,
+                                    const ReliableLinkOptions& reliableLinkOptions = ReliableLinkOptions {}) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialReliableLink() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialReliableLink(const SerialReliableLink& otherSerialReliableLink) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialReliableLink(SerialReliableLink&& otherSerialReliableLink) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialReliableLink& operator=(const SerialReliableLink& otherSerialReliableLink) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialReliableLink& operator=(SerialReliableLink&& otherSerialReliableLink) ;
+
+        /**
+         * @brief Queues a message and writes the frames the window admits.
+         *        Processes events while more than two windows of frames are
+         *        waiting to be acknowledged.
+         * @param message The message, which may be empty.
+         */
+        void Send(const DataBuffer& message) ;
+
+        /**
+         * @brief Receives the next message, processing events until one is
+         *        available.
+         * @param msTimeout The maximum time to wait in milliseconds, or 0 to
+         *        wait indefinitely.
+         * @return Returns the message.
+         */
+        DataBuffer Receive(const size_t msTimeout = 0) ;
+
+        /**
+         * @brief Gets the number of messages received completely that have
+         *        not been returned by Receive() yet.
+         * @return Returns the number of messages available.
+         */
+        size_t GetNumberOfMessagesAvailable() const ;
+
+        /**
+         * @brief Processes events until the peer has acknowledged all the
+         *        messages sent.
+         * @param msTimeout The maximum time to wait in milliseconds, or 0 to
+         *        wait indefinitely.
+         */
+        void Flush(const size_t msTimeout = 0) ;
+
+        /**
+         * @brief Reads the available frames, writes the frames the window
+         *        admits, acknowledgements and retransmissions. Waits until a
+         *        message has been received, or the specified number of
+         *        milliseconds (msTimeout) has elapsed.
+         * @param msTimeout The maximum time to wait in milliseconds, or 0 to
+         *        return without waiting.
+         */
+        void ProcessEvents(const size_t msTimeout = 0) ;
+
+        /**
+         * @brief Gets the counters maintained by the link.
+         * @return Returns a copy of the counters.
+         */
+        ReliableLinkStatistics GetStatistics() const ;
+
+        /**
+         * @brief Resets the counters maintained by the link to zero.
+         */
+        void ResetStatistics() ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialReliableLink
+
+} // namespace LibSerial
@@ -69,6 +69,11 @@ namespace LibSerial
      *        obtained from <a href="http://www.UNIX-systems.org/">
      *        http://www.UNIX-systems.org/</a>. We will refer to this
      *        document as SUS-2.
+     *
+     *        The std::ios_base::unitbuf flag is set so that every output
+     *        operation is written to the serial port with a single write().
+     *        Clear it with std::nounitbuf to collect output in the buffer of
+     *        the underlying SerialStreamBuf until std::flush.
      */
     class SerialStream : public std::iostream
     {
@@ -119,9 +124,11 @@ namespace LibSerial
         SerialStream(const SerialStream& otherSerialStream) = delete;
 
         /**
-         * @brief Move construction is disallowed.
+         * @brief Move construction is allowed. The new stream takes over the
+         *        serial port, the buffered data and the stream state. The
+         *        moved-from stream is left closed.
          */
-        SerialStream(const SerialStream&& otherSerialStream) = delete;
+        SerialStream(SerialStream&& otherSerialStream) ;
 
         /**
          * @brief Prevents copying of objects of this class by declaring the
@@ -130,9 +137,11 @@ namespace LibSerial
         SerialStream& operator=(const SerialStream& otherSerialStream) = delete;
 
         /**
-         * @brief Move assignment is not allowed.
+         * @brief Move assignment is allowed. The serial port previously
+         *        associated with this stream is closed. The moved-from
+         *        stream is left closed.
          */
-        SerialStream& operator=(const SerialStream&& otherSerialStream) = delete;
+        SerialStream& operator=(SerialStream&& otherSerialStream) ;
     
         /**
          * @brief Opens the serial port associated with the specified
@@ -270,6 +279,29 @@ namespace LibSerial
          */
         short GetVTime() ;
 
+        /**
+         * @brief Sets the maximum time to wait for data each time an
+         *        extraction needs more input. When it elapses the extraction
+         *        fails with eofbit set and IsReadTimedOut() returns true,
+         *        while read errors set badbit. A value of 0 waits for as
+         *        long as VMIN and VTIME dictate.
+         * @param msTimeout The read timeout in milliseconds.
+         */
+        void SetReadTimeout(const size_t msTimeout) ;
+
+        /**
+         * @brief Gets the read timeout.
+         * @return Returns the read timeout in milliseconds.
+         */
+        size_t GetReadTimeout() ;
+
+        /**
+         * @brief Determines if the last read from the serial port returned
+         *        no data because the read timeout, or VTIME, elapsed.
+         * @return Returns true iff the last read timed out.
+         */
+        bool IsReadTimedOut() ;
+
         /**
          * @brief Sets the DTR line to the specified value.
          * @param dtrState The line voltage state to be set,
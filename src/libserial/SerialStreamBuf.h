@@ -52,8 +52,19 @@ namespace LibSerial
      *        associated with the serial port and the standard filebuf does not
      *        provide access to it.
      *
-     *        At present, this class uses unbuffered I/O and all calls
-     *        to setbuf() will be ignored.
+     *        Input and output are buffered in separate get and put areas of
+     *        STREAM_BUFFER_SIZE_DEFAULT bytes each, so that a formatted
+     *        insertion or extraction costs one read() or write() instead of
+     *        one per character. Pending output is written by sync() (i.e.
+     *        pubsync() or std::flush), by DrainWriteBuffer() and on Close().
+     *        The buffer sizes can be changed, or buffering disabled, with
+     *        pubsetbuf().
+     *
+     *        Refilling the get area waits for data with poll(), also when
+     *        the serial port is in non-blocking mode, for up to the read
+     *        timeout if one is set. A timeout is reported as eof, with
+     *        IsReadTimedOut() returning true. Read errors are thrown as
+     *        std::runtime_error, which std::istream reports as badbit.
      */
     class SerialStreamBuf : public std::streambuf
     {
@@ -95,9 +106,10 @@ namespace LibSerial
         SerialStreamBuf(const SerialStreamBuf& otherSerialStreamBuf) = delete ;
 
         /**
-         * @brief Move construction is disallowed.
+         * @brief Move construction is allowed. The get and put areas move
+         *        along with the serial port.
          */
-        SerialStreamBuf(const SerialStreamBuf&& otherSerialStreamBuf) = delete ;
+        SerialStreamBuf(SerialStreamBuf&& otherSerialStreamBuf) ;
 
         /**
          * @brief Copy assignment is disallowed.
@@ -105,9 +117,10 @@ namespace LibSerial
         SerialStreamBuf& operator=(const SerialStreamBuf& otherSerialStreamBuf) = delete ;
 
         /**
-         * @brief Move assignment is disallowed.
+         * @brief Move assignment is allowed. The serial port previously
+         *        associated with this streambuf is closed.
          */
-        SerialStreamBuf& operator=(const SerialStreamBuf&& otherSerialStreamBuf) = delete ;
+        SerialStreamBuf& operator=(SerialStreamBuf&& otherSerialStreamBuf) ;
 
         /**
          * @brief Opens the serial port associated with the specified
@@ -126,27 +139,32 @@ namespace LibSerial
         void Close() ;
 
         /**
-         * @brief Waits until the write buffer is drained and then returns.
+         * @brief Writes the put area to the serial port, waits until the
+         *        write buffer is drained and then returns.
          */
         void DrainWriteBuffer() ;
 
         /**
-         * @brief Flushes the serial port input buffer.
+         * @brief Flushes the serial port input buffer and discards the
+         *        unread contents of the get area.
          */
         void FlushInputBuffer() ;
 
         /**
-         * @brief Flushes the serial port output buffer.
+         * @brief Flushes the serial port output buffer and discards the
+         *        unwritten contents of the put area.
          */
         void FlushOutputBuffer() ;
 
         /**
-         * @brief Flushes the serial port input and output buffers.
+         * @brief Flushes the serial port input and output buffers along
+         *        with the get and put areas.
          */
         void FlushIOBuffers() ;
 
         /**
-         * @brief Checks if data is available at the input of the serial port.
+         * @brief Checks if data is available in the get area or at the
+         *        input of the serial port.
          * @return Returns true iff data is available to read.
          */
         bool IsDataAvailable() ;
@@ -250,6 +268,28 @@ namespace LibSerial
          */
         short GetVTime() const ;
 
+        /**
+         * @brief Sets the maximum time to wait for data each time the get
+         *        area needs to be refilled, or each time xsgetn() needs more
+         *        data. A value of 0 waits for as long as VMIN and VTIME
+         *        dictate.
+         * @param msTimeout The read timeout in milliseconds.
+         */
+        void SetReadTimeout(const size_t msTimeout) ;
+
+        /**
+         * @brief Gets the read timeout.
+         * @return Returns the read timeout in milliseconds.
+         */
+        size_t GetReadTimeout() const ;
+
+        /**
+         * @brief Determines if the last read from the serial port returned
+         *        no data because the read timeout, or VTIME, elapsed.
+         * @return Returns true iff the last read timed out.
+         */
+        bool IsReadTimedOut() const ;
+
         /**
          * @brief Sets the DTR line to the specified value.
          * @param dtrState The line voltage state to be set,
@@ -295,7 +335,8 @@ namespace LibSerial
         int GetFileDescriptor() const ;
 
         /**
-         * @brief Gets the number of bytes available in the read buffer.
+         * @brief Gets the number of bytes available in the get area and
+         *        the read buffer of the serial port.
          * @return Returns the number of bytes avilable in the read buffer.
          */
         int GetNumberOfBytesAvailable() ;
@@ -312,24 +353,19 @@ namespace LibSerial
     protected:
 
         /**
-         * @brief Performs an operation that is defined separately for each
-         *        class derived from streambuf. The default behavior is to
-         *        do nothing if gptr() is non-null and gptr()!=egptr().
-         *        Also, setbuf(0, 0) usually means unbuffered I/O and
-         *        setbuf(p, n) means use p[0]...p[n-1] to hold the buffered
-         *        characters. In general, this method implements the
-         *        subclass's notion of getting memory for the buffered
-         *        characters. 
-         *
-         *        In the case of SerialStreamBuffer, we want to keep using
-         *        unbuffered I/O. Hence, using this method has no effect at
-         *        present.
-         *
-         *
-         * @param character Pointer to the character buffer to write to the serial port.
-         * @param numberOfBytes The number of characters to write to the serial port.
-         * @return Returns a pointer to this streambuf object.
-         *
+         * @brief Replaces the get and put areas. Pending output is written
+         *        to the serial port first and unread input is carried over.
+         *          - setbuf(nullptr, 0) selects unbuffered I/O.
+         *          - setbuf(nullptr, n) allocates get and put areas of n
+         *            characters each.
+         *          - setbuf(p, n) uses the first half of p[0]...p[n-1] as
+         *            the get area and the second half as the put area. The
+         *            array must outlive its use by this streambuf.
+         * @param character Pointer to the character buffer or nullptr.
+         * @param numberOfBytes The size of the character buffer.
+         * @return Returns a pointer to this streambuf object, or nullptr if
+         *         pending output could not be written or unread input does
+         *         not fit the new get area.
          */
         virtual std::streambuf* setbuf(char_type* character, 
                                        std::streamsize numberOfBytes) override ;
@@ -357,35 +393,33 @@ namespace LibSerial
                                        std::streamsize numberOfBytes) override ;
 
         /**
-         * @brief Writes the specified character to the associated serial port.
-         * @param character The character to be written to the serial port.
-         * @return Returns the character. 
+         * @brief Writes the contents of the put area to the serial port.
+         * @return Returns 0 on success and -1 on failure.
          */
-        virtual int_type overflow(const int_type character) override ;
+        virtual int sync() override ;
 
         /**
-         * @brief Reads and returns the next character from the associated
-         *        serial port if one otherwise returns traits::eof(). This
-         *        method is used for buffered I/O while uflow() is called
-         *        for unbuffered I/O.
-         * @return Returns the next character from the serial port.
+         * @brief Called when the put area is full. Writes the put area to
+         *        the serial port and then stores the specified character.
+         *        In unbuffered mode the character is written immediately.
+         * @param character The character to be written to the serial port.
+         * @return Returns the character, or eof if the write failed.
          */
-        virtual int_type underflow() override ;
+        virtual int_type overflow(const int_type character) override ;
 
         /**
-         * @brief Reads and returns the next character from the associated
-         *        serial port if one otherwise returns traits::eof(). This
-         *        method is used for unbuffered I/O while underflow() is
-         *        called for unbuffered I/O.
-         * @return Returns the next character from the serial port.  
+         * @brief Called when the get area is empty. Refills the get area
+         *        with a single read() of up to its size from the serial
+         *        port, keeping the last character read for putback.
+         * @return Returns the next character from the serial port, or eof
+         *         if nothing could be read.
          */
-        virtual int_type uflow() override ;
+        virtual int_type underflow() override ;
 
         /**
          * @brief This function is called when a putback of a character
-         *        fails. This must be implemented for unbuffered I/O as all
-         *        streambuf subclasses are required to provide putback of
-         *        at least one character.
+         *        fails, i.e. at the beginning of the get area or when the
+         *        character differs from the one read.
          * @param character The character to putback.
          * @return Returns The character iff successful, otherwise eof to signal an error.
          */
@@ -402,8 +436,10 @@ namespace LibSerial
          *            ...
          *        }
          *        \endcode
-         * @return Returns 1 if characters are available at the serial port,
-         *         0 if no characters are available, and -1 if unsuccessful.
+         *        This is only called once the get area is empty.
+         * @return Returns the number of characters available at the serial
+         *         port, 0 if no characters are available, and -1 if
+         *         unsuccessful.
          */
         virtual std::streamsize showmanyc() override ;
 
@@ -0,0 +1,317 @@
+/******************************************************************************
+ * @file SerialTransactionEngine.h                                            *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief Identifies a transaction submitted to a SerialTransactionEngine.
+     */
+    using TransactionId = uint64_t ;
+
+    /**
+     * @brief Type of the function that delimits replies in the received
+     *        data. It is called with the received data that has not been
+     *        consumed yet and returns the size of the complete reply at its
+     *        start, or 0 if more data is needed.
+     */
+    using ReplyFramer = std::function<size_t(const uint8_t* data, size_t size)> ;
+
+    /**
+     * @brief Type of the function that determines if a reply answers a
+     *        request, (e.g. by comparing an id field or a sequence number).
+     */
+    using ReplyMatcher = std::function<bool(const DataBuffer& request, const DataBuffer& reply)> ;
+
+    /**
+     * @brief The resolution of the deadlines of a SerialTransactionEngine.
+     */
+    constexpr size_t TRANSACTION_TIMER_TICK_MS = 1 ;
+
+    /**
+     * @brief The number of slots of the timer wheel of a
+     *        SerialTransactionEngine. Deadlines further away than one
+     *        revolution of the wheel are kept in their slot for more turns.
+     */
+    constexpr size_t TRANSACTION_TIMER_WHEEL_SLOTS = 256 ;
+
+    /**
+     * @brief The outcomes of a transaction.
+     */
+    enum class TransactionStatus
+    {
+        COMPLETED,  // !< A matching reply has been received.
+        TIMED_OUT   // !< No matching reply arrived before the deadline.
+    } ;
+
+    /**
+     * @brief Describes a finished transaction.
+     */
+    struct SerialTransaction
+    {
+        /**
+         * @brief The id returned by SerialTransactionEngine::Submit().
+         */
+        TransactionId transactionId {0} ;
+
+        /**
+         * @brief Whether a reply was received in time.
+         */
+        TransactionStatus status {TransactionStatus::COMPLETED} ;
+
+        /**
+         * @brief The request written to the serial port.
+         */
+        DataBuffer request {} ;
+
+        /**
+         * @brief The reply, which is empty if the transaction timed out.
+         */
+        DataBuffer reply {} ;
+
+        /**
+         * @brief The time in microseconds from writing the request to
+         *        receiving the reply or reaching the deadline.
+         */
+        size_t latencyUs {0} ;
+    } ;
+
+    /**
+     * @brief The counters maintained by a SerialTransactionEngine.
+     */
+    struct SerialTransactionStatistics
+    {
+        /**
+         * @brief The number of transactions that received a reply.
+         */
+        size_t completedCount {0} ;
+
+        /**
+         * @brief The number of transactions that reached their deadline.
+         */
+        size_t timedOutCount {0} ;
+
+        /**
+         * @brief The number of replies that matched no outstanding request.
+         */
+        size_t unmatchedReplyCount {0} ;
+
+        /**
+         * @brief The smallest latency in microseconds of a completed
+         *        transaction.
+         */
+        size_t minimumLatencyUs {0} ;
+
+        /**
+         * @brief The largest latency in microseconds of a completed
+         *        transaction.
+         */
+        size_t maximumLatencyUs {0} ;
+
+        /**
+         * @brief The sum of the latencies in microseconds of the completed
+         *        transactions.
+         */
+        size_t totalLatencyUs {0} ;
+    } ;
+
+    /**
+     * @brief Creates a ReplyFramer for replies terminated by a character.
+     * @param lineTerminator The last character of each reply.
+     * @return Returns the ReplyFramer.
+     */
+    ReplyFramer MakeLineFramer(const char lineTerminator = '\n') ;
+
+    /**
+     * @brief Creates a ReplyMatcher that compares an id field of the request
+     *        with an id field of the reply.
+     * @param requestOffset The offset of the id field in the request.
+     * @param replyOffset The offset of the id field in the reply.
+     * @param fieldSize The size of the id field in bytes.
+     * @return Returns the ReplyMatcher.
+     */
+    ReplyMatcher MakeFieldMatcher(const size_t requestOffset,
+                                  const size_t replyOffset,
+                                  const size_t fieldSize) ;
+
+    /**
+     * @brief SerialTransactionEngine performs request/response transactions
+     *        over a SerialPort. Several requests may be outstanding at once,
+     *        so that the link is used while the device processes earlier
+     *        requests. Replies are delimited by a ReplyFramer and assigned
+     *        to the oldest outstanding request accepted by a ReplyMatcher.
+     *        The deadline of each request starts when it is written and is
+     *        tracked by a timer wheel.
+     *
+     *        The engine performs no I/O on its own: requests are written and
+     *        replies read by ProcessEvents(), which can be called from a
+     *        poll()/epoll() based event loop whenever the file descriptor of
+     *        the serial port becomes readable. The engine must only be used
+     *        from one thread at a time, and the serial port must not be read
+     *        by other code while the engine is in use.
+     */
+    class SerialTransactionEngine
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param serialPort The open serial port used for the transactions,
+         *        which must outlive the engine.
+         * @param replyFramer The function that delimits replies.
+         * @param replyMatcher The function that matches replies to requests.
+         *        By default, each reply answers the oldest outstanding request.
+         */
+        SerialTransactionEngine(SerialPort&         serialPort,
+                                const ReplyFramer&  replyFramer,
+                                const ReplyMatcher& replyMatcher = ReplyMatcher {}) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialTransactionEngine() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialTransactionEngine(const SerialTransactionEngine& otherSerialTransactionEngine) = delete ;
+
+        /**
+         * @brief Move construction is allowed.
+         */
+        SerialTransactionEngine(SerialTransactionEngine&& otherSerialTransactionEngine) ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialTransactionEngine& operator=(const SerialTransactionEngine& otherSerialTransactionEngine) = delete ;
+
+        /**
+         * @brief Move assignment is allowed.
+         */
+        SerialTransactionEngine& operator=(SerialTransactionEngine&& otherSerialTransactionEngine) ;
+
+        /**
+         * @brief Sets the maximum number of requests awaiting a reply. Further
+         *        requests are queued until an outstanding request finishes.
+         *        Only protocols that tolerate pipelined requests may use more
+         *        than the default of one.
+         * @param maximumOutstanding The maximum number of requests awaiting a
+         *        reply, which must be at least one.
+         */
+        void SetMaximumOutstanding(const size_t maximumOutstanding) ;
+
+        /**
+         * @brief Gets the maximum number of requests awaiting a reply.
+         * @return Returns the maximum number of requests awaiting a reply.
+         */
+        size_t GetMaximumOutstanding() const ;
+
+        /**
+         * @brief Submits a request. The request is written by the next call
+         *        to ProcessEvents() that finds fewer than the maximum number
+         *        of requests outstanding.
+         * @param request The request to be written to the serial port.
+         * @param msTimeout The time in milliseconds allowed for the reply
+         *        after the request has been written.
+         * @return Returns the id of the transaction.
+         */
+        TransactionId Submit(const DataBuffer& request,
+                             const size_t      msTimeout) ;
+
+        /**
+         * @brief Writes queued requests, reads the available replies and
+         *        expires deadlines. Waits until a transaction has finished,
+         *        or the specified number of milliseconds (msTimeout) has
+         *        elapsed.
+         * @param msTimeout The maximum time to wait in milliseconds, or 0 to
+         *        return without waiting.
+         * @return Returns the transactions that have finished, in order of
+         *         completion.
+         */
+        std::vector<SerialTransaction> ProcessEvents(const size_t msTimeout = 0) ;
+
+        /**
+         * @brief Submits a request and processes events until it has finished.
+         *        Other transactions that finish meanwhile are returned by the
+         *        next call to ProcessEvents().
+         * @param request The request to be written to the serial port.
+         * @param msTimeout The time in milliseconds allowed for the reply.
+         * @return Returns the finished transaction.
+         */
+        SerialTransaction Transact(const DataBuffer& request,
+                                   const size_t      msTimeout) ;
+
+        /**
+         * @brief Gets the number of transactions that have been submitted
+         *        and have not finished, whether written or queued.
+         * @return Returns the number of pending transactions.
+         */
+        size_t GetNumberOfPendingTransactions() const ;
+
+        /**
+         * @brief Gets the counters maintained by the engine.
+         * @return Returns a copy of the counters.
+         */
+        SerialTransactionStatistics GetStatistics() const ;
+
+        /**
+         * @brief Resets the counters maintained by the engine to zero.
+         */
+        void ResetStatistics() ;
+
+    private:
+
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialTransactionEngine
+
+} // namespace LibSerial
@@ -34,8 +34,12 @@
 #include "MultiThreadUnitTests.h"
 #include "UnitTests.h"
 
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <iostream>
+#include <poll.h>
+#include <stdexcept>
 #include <thread>
 #include <unistd.h>
 #include <vector>
@@ -295,6 +299,379 @@ TEST_F(MultiThreadUnitTests, testMultiThreadSerialStreamReadWrite)
     }
 }
 
+namespace
+{
+    /**
+     * @brief Gets the byte at the specified position of the test pattern.
+     */
+    unsigned char patternByte(const size_t position)
+    {
+        return static_cast<unsigned char>((position * 7 + position / 256) & 0xFF) ;
+    }
+}
+
+void
+MultiThreadUnitTests::testMultiThreadSerialPortFullDuplex()
+{
+    constexpr size_t data_size = 1 << 16 ;
+    constexpr size_t chunk_size = 1000 ;
+
+    int master_fd = -1 ;
+    SerialPort serial_port {} ;
+    serial_port.SetThreadSafe(true) ;
+    serial_port.Open(openPseudoTerminal(master_fd)) ;
+    ASSERT_TRUE(serial_port.GetThreadSafe()) ;
+
+    std::atomic<bool> done {false} ;
+    std::atomic<size_t> input_errors {0} ;
+    std::atomic<size_t> output_errors {0} ;
+    std::atomic<size_t> bytes_received {0} ;
+
+    // A thread that fails cancels the serial port, so that the others do
+    // not wait for it forever. Its exception is rethrown after the join.
+    std::exception_ptr reader_exception {} ;
+    std::exception_ptr writer_exception {} ;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30) ;
+
+    // The remote device sends the pattern and checks the data it receives.
+    std::thread device_sender([&] {
+        DataBuffer data_buffer(data_size) ;
+        for (size_t i = 0; i < data_size; i++)
+        {
+            data_buffer[i] = patternByte(i) ;
+        }
+
+        size_t offset = 0 ;
+        while ((offset < data_size) and
+               (std::chrono::steady_clock::now() < deadline))
+        {
+            pollfd poll_fd {master_fd, POLLOUT, 0} ;
+            poll(&poll_fd, 1, 100) ;
+            const auto result = write(master_fd,
+                                      &data_buffer[offset],
+                                      std::min(chunk_size, data_size - offset)) ;
+            if (result > 0)
+            {
+                offset += static_cast<size_t>(result) ;
+            }
+        }
+
+        if (offset < data_size)
+        {
+            serial_port.Cancel() ;
+        }
+    }) ;
+
+    std::thread device_receiver([&] {
+        unsigned char buffer[chunk_size] ;
+        size_t offset = 0 ;
+        while ((offset < data_size) and
+               (std::chrono::steady_clock::now() < deadline))
+        {
+            pollfd poll_fd {master_fd, POLLIN, 0} ;
+            if (poll(&poll_fd, 1, 5000) <= 0)
+            {
+                break ;
+            }
+
+            const auto result = read(master_fd, buffer, sizeof(buffer)) ;
+            for (ssize_t i = 0; i < result; i++)
+            {
+                if (buffer[i] != patternByte(offset++))
+                {
+                    output_errors++ ;
+                }
+            }
+        }
+        bytes_received = offset ;
+
+        // Release the writer, which would otherwise wait for space forever.
+        if (offset < data_size)
+        {
+            serial_port.Cancel() ;
+        }
+    }) ;
+
+    // The application reads and writes the serial port concurrently.
+    std::thread port_reader([&] {
+        try
+        {
+            DataBuffer data_buffer {} ;
+            size_t offset = 0 ;
+            while (offset < data_size)
+            {
+                serial_port.Read(data_buffer, std::min(chunk_size, data_size - offset), 5000) ;
+                for (const auto data_byte : data_buffer)
+                {
+                    if (data_byte != patternByte(offset++))
+                    {
+                        input_errors++ ;
+                    }
+                }
+            }
+        }
+        catch (...)
+        {
+            reader_exception = std::current_exception() ;
+            serial_port.Cancel() ;
+        }
+    }) ;
+
+    std::thread port_writer([&] {
+        try
+        {
+            DataBuffer data_buffer {} ;
+            for (size_t offset = 0; offset < data_size; offset += chunk_size)
+            {
+                data_buffer.clear() ;
+                for (size_t i = offset; i < std::min(offset + chunk_size, data_size); i++)
+                {
+                    data_buffer.push_back(patternByte(i)) ;
+                }
+                serial_port.Write(data_buffer) ;
+            }
+            serial_port.DrainWriteBuffer() ;
+        }
+        catch (...)
+        {
+            writer_exception = std::current_exception() ;
+            serial_port.Cancel() ;
+        }
+    }) ;
+
+    // Settings changes and queries interleave with the I/O.
+    std::thread port_configurator([&] {
+        while (not done)
+        {
+            serial_port.SetBaudRate(BaudRate::BAUD_57600) ;
+            serial_port.SetBaudRate(BaudRate::BAUD_115200) ;
+            serial_port.SetVTime(VTIME_DEFAULT) ;
+            serial_port.GetNumberOfBytesAvailable() ;
+            serial_port.GetStatistics() ;
+            std::this_thread::yield() ;
+        }
+    }) ;
+
+    port_writer.join() ;
+    port_reader.join() ;
+    device_sender.join() ;
+    device_receiver.join() ;
+    done = true ;
+    port_configurator.join() ;
+
+    serial_port.Close() ;
+    close(master_fd) ;
+
+    for (const auto& thread_exception : {reader_exception, writer_exception})
+    {
+        if (thread_exception)
+        {
+            std::rethrow_exception(thread_exception) ;
+        }
+    }
+
+    ASSERT_EQ(bytes_received, data_size) ;
+    ASSERT_EQ(input_errors, 0U) ;
+    ASSERT_EQ(output_errors, 0U) ;
+}
+
+void
+MultiThreadUnitTests::testMultiThreadSerialPortConnectionEventCallback()
+{
+    int master_fd = -1 ;
+    SerialPort serial_port {} ;
+    serial_port.SetThreadSafe(true) ;
+    serial_port.SetAutoReconnect(true, 10, 40) ;
+
+    // The callback queries the port while another thread keeps waiting for
+    // exclusive access to the settings.
+    std::atomic<size_t> disconnect_count {0} ;
+    serial_port.SetConnectionEventCallback([&serial_port, &disconnect_count](const ConnectionEvent connectionEvent)
+                                           {
+                                               if ((connectionEvent == ConnectionEvent::DISCONNECTED) and
+                                                   (not serial_port.IsConnected()))
+                                               {
+                                                   disconnect_count = serial_port.GetStatistics().disconnectCount ;
+                                               }
+                                           }) ;
+
+    serial_port.Open(openPseudoTerminal(master_fd)) ;
+
+    std::atomic<bool> done {false} ;
+    std::thread port_configurator([&] {
+        while (not done)
+        {
+            try
+            {
+                serial_port.SetBaudRate(BaudRate::BAUD_57600) ;
+                serial_port.SetBaudRate(BaudRate::BAUD_115200) ;
+            }
+            catch (const std::runtime_error&)
+            {
+                // Until a read detects the hang-up, the settings are applied
+                // to the hung up device, which fails.
+            }
+            std::this_thread::yield() ;
+        }
+    }) ;
+
+    // Closing the master side hangs up the device.
+    close(master_fd) ;
+
+    std::string read_string {} ;
+    EXPECT_THROW(serial_port.Read(read_string, 1, 100), ReadTimeout) ;
+
+    done = true ;
+    port_configurator.join() ;
+    serial_port.Close() ;
+
+    ASSERT_EQ(disconnect_count, 1U) ;
+}
+
+void
+MultiThreadUnitTests::testMultiThreadSerialPortCloseDuringRead()
+{
+    int master_fd = -1 ;
+    SerialPort serial_port {} ;
+    serial_port.SetThreadSafe(true) ;
+    serial_port.Open(openPseudoTerminal(master_fd)) ;
+
+    std::atomic<bool> not_open_thrown {false} ;
+
+    std::thread port_reader([&] {
+        try
+        {
+            char read_byte = 0 ;
+            serial_port.ReadByte(read_byte) ;
+        }
+        catch (const NotOpen&)
+        {
+            not_open_thrown = true ;
+        }
+    }) ;
+
+    // Close() must not wait for the data the reader is waiting for.
+    usleep(readBufferDelay) ;
+    serial_port.Close() ;
+    port_reader.join() ;
+
+    close(master_fd) ;
+    ASSERT_TRUE(not_open_thrown) ;
+}
+
+void
+MultiThreadUnitTests::testMultiThreadSerialPortCancel()
+{
+    int master_fd = -1 ;
+    SerialPort serial_port {} ;
+    serial_port.SetThreadSafe(true) ;
+    serial_port.Open(openPseudoTerminal(master_fd)) ;
+
+    // At the lowest baud rate, a waiting Read() sleeps 160 ms at a time.
+    serial_port.SetBaudRate(BaudRate::BAUD_50) ;
+
+    std::atomic<bool> read_cancelled {false} ;
+    std::atomic<bool> write_cancelled {false} ;
+
+    std::thread port_reader([&] {
+        try
+        {
+            DataBuffer read_buffer {} ;
+            serial_port.Read(read_buffer, 1) ;
+        }
+        catch (const OperationCancelled&)
+        {
+            read_cancelled = true ;
+        }
+    }) ;
+
+    // The master side never reads, so the writer eventually waits for space.
+    std::thread port_writer([&] {
+        try
+        {
+            const DataBuffer write_buffer(1 << 20, 'x') ;
+            serial_port.Write(write_buffer) ;
+        }
+        catch (const OperationCancelled&)
+        {
+            write_cancelled = true ;
+        }
+    }) ;
+
+    usleep(readBufferDelay) ;
+    ASSERT_FALSE(serial_port.IsCancelled()) ;
+
+    const auto cancel_time = std::chrono::steady_clock::now() ;
+    serial_port.Cancel() ;
+    port_reader.join() ;
+    port_writer.join() ;
+
+    const auto cancel_latency = std::chrono::steady_clock::now() - cancel_time ;
+    ASSERT_LT(cancel_latency, std::chrono::milliseconds(100)) ;
+    ASSERT_TRUE(read_cancelled) ;
+    ASSERT_TRUE(write_cancelled) ;
+
+    // Subsequent calls are cancelled as well.
+    ASSERT_TRUE(serial_port.IsCancelled()) ;
+    ASSERT_THROW(serial_port.WriteByte('a'), OperationCancelled) ;
+    ASSERT_THROW(serial_port.DrainWriteBuffer(), OperationCancelled) ;
+
+    // The port is usable again after ResetCancel().
+    serial_port.ResetCancel() ;
+    ASSERT_FALSE(serial_port.IsCancelled()) ;
+    serial_port.FlushIOBuffers() ;
+
+    const unsigned char write_byte = 'z' ;
+    ASSERT_EQ(write(master_fd, &write_byte, 1), 1) ;
+
+    unsigned char read_byte = 0 ;
+    serial_port.ReadByte(read_byte, 1000) ;
+    ASSERT_EQ(read_byte, write_byte) ;
+
+    serial_port.Close() ;
+    close(master_fd) ;
+}
+
+TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortFullDuplex)
+{
+    SCOPED_TRACE("Test Thread-Safe Full-Duplex Serial Port Communication.") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testMultiThreadSerialPortFullDuplex() ;
+    }
+}
+
+TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortConnectionEventCallback)
+{
+    SCOPED_TRACE("Test Thread-Safe Serial Port Connection Event Callback.") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testMultiThreadSerialPortConnectionEventCallback() ;
+    }
+}
+
+TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortCloseDuringRead)
+{
+    SCOPED_TRACE("Test Thread-Safe Serial Port Close() During Read().") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testMultiThreadSerialPortCloseDuringRead() ;
+    }
+}
+
+TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortCancel)
+{
+    SCOPED_TRACE("Test Serial Port Cancel() of Blocked Read() and Write().") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testMultiThreadSerialPortCancel() ;
+    }
+}
+
 TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortReadWrite)
 {
     SCOPED_TRACE("Test Multi-Thread Serial Port Communication.") ;
@@ -91,6 +91,34 @@ namespace LibSerial
          */
         void testMultiThreadSerialPortReadWrite() ;
 
+        /**
+         * @brief Stress test of a serial port in thread-safe mode over a
+         *        pseudo terminal: one thread reads, one thread writes and one
+         *        thread keeps changing the settings, while the data in both
+         *        directions must arrive intact.
+         */
+        void testMultiThreadSerialPortFullDuplex() ;
+
+        /**
+         * @brief Tests that the connection event callback of a serial port in
+         *        thread-safe mode can query the port while another thread
+         *        changes the settings.
+         */
+        void testMultiThreadSerialPortConnectionEventCallback() ;
+
+        /**
+         * @brief Tests that closing a serial port in thread-safe mode makes a
+         *        Read() waiting in another thread throw NotOpen.
+         */
+        void testMultiThreadSerialPortCloseDuringRead() ;
+
+        /**
+         * @brief Tests that Cancel() promptly wakes a Read() and a Write()
+         *        waiting in other threads, which throw OperationCancelled, and
+         *        that the port is usable again after ResetCancel().
+         */
+        void testMultiThreadSerialPortCancel() ;
+
         /**
          * @param C++11 thread std::mutex for locking parameters in the threaded unit tests.
          */
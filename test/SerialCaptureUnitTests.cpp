@@ -0,0 +1,601 @@
+/******************************************************************************
+ * @file SerialCaptureUnitTests.cpp                                           *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialCaptureUnitTests.h"
+#include "UnitTests.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace LibSerial;
+
+SerialCaptureUnitTests::SerialCaptureUnitTests()
+{
+    captureDirectory = createTemporaryDirectory() ;
+    capturePath = captureDirectory + "/capture" ;
+}
+
+SerialCaptureUnitTests::~SerialCaptureUnitTests()
+{
+    removeDirectory(captureDirectory) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureWriteRead()
+{
+    ASSERT_THROW(SerialCaptureWriter(capturePath, CAPTURE_SEGMENT_SIZE_MINIMUM - 1), std::invalid_argument) ;
+    ASSERT_THROW(SerialCaptureReader {capturePath + "-missing"}, std::runtime_error) ;
+
+    // A record larger than a segment is split across segments.
+    const std::string large_data(2 * CAPTURE_SEGMENT_SIZE_MINIMUM, 'L') ;
+    constexpr size_t NUMBER_OF_RECORDS = 200 ;
+
+    {
+        SerialCaptureWriter serial_capture_writer {capturePath, CAPTURE_SEGMENT_SIZE_MINIMUM} ;
+
+        for (size_t i = 0; i < NUMBER_OF_RECORDS; i++)
+        {
+            const auto data = std::to_string(i) ;
+            serial_capture_writer.Record(static_cast<uint32_t>(i % 3),
+                                         (i % 2 == 0) ? CaptureDirection::RECEIVED : CaptureDirection::TRANSMITTED,
+                                         data.data(),
+                                         data.size()) ;
+        }
+
+        serial_capture_writer.Record(9, CaptureDirection::TRANSMITTED, large_data.data(), large_data.size()) ;
+        serial_capture_writer.Flush() ;
+        ASSERT_GT(serial_capture_writer.GetNumberOfSegments(), 3U) ;
+        ASSERT_EQ(access((capturePath + ".000001").c_str(), F_OK), 0) ;
+
+        // Records are discarded once the capture is closed.
+        serial_capture_writer.Close() ;
+        serial_capture_writer.Record(0, CaptureDirection::RECEIVED, "x", 1) ;
+    }
+
+    SerialCaptureReader serial_capture_reader {capturePath} ;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        CaptureRecord capture_record {} ;
+        uint64_t previous_timestamp_ns = 0 ;
+
+        for (size_t i = 0; i < NUMBER_OF_RECORDS; i++)
+        {
+            ASSERT_TRUE(serial_capture_reader.ReadNext(capture_record)) ;
+            ASSERT_EQ(std::string(capture_record.data.begin(), capture_record.data.end()), std::to_string(i)) ;
+            ASSERT_EQ(capture_record.portId, i % 3) ;
+            ASSERT_EQ(capture_record.direction,
+                      (i % 2 == 0) ? CaptureDirection::RECEIVED : CaptureDirection::TRANSMITTED) ;
+            ASSERT_GE(capture_record.timestampNs, previous_timestamp_ns) ;
+            previous_timestamp_ns = capture_record.timestampNs ;
+        }
+
+        std::string received_large_data {} ;
+
+        while (serial_capture_reader.ReadNext(capture_record))
+        {
+            ASSERT_EQ(capture_record.portId, 9U) ;
+            received_large_data.append(capture_record.data.begin(), capture_record.data.end()) ;
+        }
+
+        ASSERT_EQ(received_large_data, large_data) ;
+        serial_capture_reader.Rewind() ;
+    }
+
+    // A new capture replaces all segments of the previous one.
+    {
+        SerialCaptureWriter serial_capture_writer {capturePath, CAPTURE_SEGMENT_SIZE_MINIMUM} ;
+        ASSERT_EQ(serial_capture_writer.GetNumberOfSegments(), 1U) ;
+    }
+
+    ASSERT_NE(access((capturePath + ".000001").c_str(), F_OK), 0) ;
+
+    CaptureRecord capture_record {} ;
+    SerialCaptureReader empty_capture_reader {capturePath} ;
+    ASSERT_FALSE(empty_capture_reader.ReadNext(capture_record)) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureLiveReader()
+{
+    SerialCaptureWriter serial_capture_writer {capturePath, CAPTURE_SEGMENT_SIZE_MINIMUM} ;
+    SerialCaptureReader serial_capture_reader {capturePath} ;
+
+    CaptureRecord capture_record {} ;
+    ASSERT_FALSE(serial_capture_reader.ReadNext(capture_record)) ;
+
+    // A next segment that is still being created has no data yet.
+    writeFile(capturePath + ".000001", "") ;
+    ASSERT_FALSE(serial_capture_reader.ReadNext(capture_record)) ;
+    writeFile(capturePath + ".000001", std::string(CAPTURE_SEGMENT_SIZE_MINIMUM, '\0')) ;
+    ASSERT_FALSE(serial_capture_reader.ReadNext(capture_record)) ;
+
+    // Records appended later are found, also in new segments.
+    const std::string data(1000, 'D') ;
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        serial_capture_writer.Record(1, CaptureDirection::RECEIVED, data.data(), data.size()) ;
+        ASSERT_TRUE(serial_capture_reader.ReadNext(capture_record)) ;
+        ASSERT_EQ(capture_record.data.size(), data.size()) ;
+        ASSERT_FALSE(serial_capture_reader.ReadNext(capture_record)) ;
+    }
+
+    ASSERT_GT(serial_capture_writer.GetNumberOfSegments(), 1U) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureSerialPort()
+{
+    auto serial_capture_writer = std::make_shared<SerialCaptureWriter>(capturePath) ;
+
+    int master_fd = -1 ;
+    SerialPort serial_port {} ;
+    serial_port.Open(openPseudoTerminal(master_fd)) ;
+    serial_port.SetCapture(serial_capture_writer, 7) ;
+
+    serial_port.Write("request") ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "request") ;
+
+    const std::string reply = "reply" ;
+    ASSERT_EQ(write(master_fd, reply.data(), reply.size()), static_cast<ssize_t>(reply.size())) ;
+
+    std::string read_string {} ;
+    serial_port.Read(read_string, reply.size(), 1000) ;
+    ASSERT_EQ(read_string, reply) ;
+
+    // Nothing is recorded once traffic capture is disabled.
+    serial_port.SetCapture(nullptr) ;
+    serial_port.Write("ignored") ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "ignored") ;
+
+    serial_port.Close() ;
+    close(master_fd) ;
+
+    SerialCaptureReader serial_capture_reader {capturePath} ;
+    CaptureRecord capture_record {} ;
+
+    ASSERT_TRUE(serial_capture_reader.ReadNext(capture_record)) ;
+    ASSERT_EQ(capture_record.portId, 7U) ;
+    ASSERT_EQ(capture_record.direction, CaptureDirection::TRANSMITTED) ;
+    ASSERT_EQ(std::string(capture_record.data.begin(), capture_record.data.end()), "request") ;
+
+    const auto request_timestamp_ns = capture_record.timestampNs ;
+    std::string received_string {} ;
+
+    while (serial_capture_reader.ReadNext(capture_record))
+    {
+        ASSERT_EQ(capture_record.direction, CaptureDirection::RECEIVED) ;
+        ASSERT_GE(capture_record.timestampNs, request_timestamp_ns) ;
+        received_string.append(capture_record.data.begin(), capture_record.data.end()) ;
+    }
+
+    ASSERT_EQ(received_string, reply) ;
+}
+
+void
+SerialCaptureUnitTests::writeReplayCapture()
+{
+    SerialCaptureWriter serial_capture_writer {capturePath, CAPTURE_SEGMENT_SIZE_MINIMUM} ;
+
+    serial_capture_writer.Record(1, CaptureDirection::RECEIVED, "first ", 6) ;
+    serial_capture_writer.Record(1, CaptureDirection::TRANSMITTED, "request", 7) ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+    serial_capture_writer.Record(2, CaptureDirection::RECEIVED, "other", 5) ;
+    serial_capture_writer.Record(1, CaptureDirection::RECEIVED, "second ", 7) ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+    serial_capture_writer.Record(1, CaptureDirection::RECEIVED, "third", 5) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureSerialPortFailure()
+{
+    // The second segment cannot be created, since its path is taken.
+    makeDirectory(capturePath + ".000001") ;
+    auto serial_capture_writer = std::make_shared<SerialCaptureWriter>(capturePath, CAPTURE_SEGMENT_SIZE_MINIMUM) ;
+
+    int master_fd = -1 ;
+    SerialPort serial_port {} ;
+    serial_port.Open(openPseudoTerminal(master_fd)) ;
+    serial_port.SetCapture(serial_capture_writer) ;
+
+    // The data is written although it cannot be recorded, and the error is
+    // thrown by the next call.
+    const std::string data(200, 'F') ;
+    size_t number_of_writes = 0 ;
+    bool is_thrown = false ;
+
+    while ((not is_thrown) and
+           (number_of_writes < CAPTURE_SEGMENT_SIZE_MINIMUM / data.size()))
+    {
+        try
+        {
+            serial_port.Write(data) ;
+            ASSERT_EQ(readPseudoTerminal(master_fd, 1000), data) ;
+            number_of_writes++ ;
+        }
+        catch (const std::runtime_error&)
+        {
+            is_thrown = true ;
+        }
+    }
+
+    ASSERT_TRUE(is_thrown) ;
+    ASSERT_TRUE(readPseudoTerminal(master_fd, 10).empty()) ;
+
+    // The capture stays stopped, and reading and writing continue.
+    serial_port.Write(data) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), data) ;
+
+    const std::string reply = "reply" ;
+    ASSERT_EQ(write(master_fd, reply.data(), reply.size()), static_cast<ssize_t>(reply.size())) ;
+
+    std::string read_string {} ;
+    serial_port.Read(read_string, reply.size(), 1000) ;
+    ASSERT_EQ(read_string, reply) ;
+
+    serial_port.Close() ;
+    close(master_fd) ;
+    removeDirectory(capturePath + ".000001") ;
+
+    // The data of the last write was not recorded.
+    SerialCaptureReader serial_capture_reader {capturePath} ;
+    CaptureRecord capture_record {} ;
+    size_t number_of_bytes_recorded = 0 ;
+
+    while (serial_capture_reader.ReadNext(capture_record))
+    {
+        ASSERT_EQ(capture_record.direction, CaptureDirection::TRANSMITTED) ;
+        number_of_bytes_recorded += capture_record.data.size() ;
+    }
+
+    ASSERT_EQ(number_of_bytes_recorded, (number_of_writes - 1) * data.size()) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureReplayerSpeed()
+{
+    writeReplayCapture() ;
+
+    SerialCaptureReplayer serial_capture_replayer {capturePath} ;
+    ASSERT_THROW(serial_capture_replayer.SetSpeed(-1.0), std::invalid_argument) ;
+    ASSERT_THROW(serial_capture_replayer.Replay(), std::logic_error) ;
+
+    SerialPort serial_port {} ;
+    serial_port.Open(serial_capture_replayer.OpenPseudoTerminal()) ;
+    ASSERT_THROW(serial_capture_replayer.OpenPseudoTerminal(), std::logic_error) ;
+
+    const std::string expected_data = "first second third" ;
+    serial_capture_replayer.SetFilter(CaptureDirection::RECEIVED, 1) ;
+
+    const auto read_replay = [&serial_port, &expected_data]()
+    {
+        std::string read_string {} ;
+        serial_port.Read(read_string, expected_data.size(), 1000) ;
+        return read_string ;
+    } ;
+
+    // The records keep their original spacing of about 100 ms in total. The
+    // upper bounds only catch gross errors, since a loaded machine may wake
+    // the replayer late.
+    auto replay_statistics = serial_capture_replayer.Replay() ;
+    ASSERT_EQ(read_replay(), expected_data) ;
+    ASSERT_EQ(replay_statistics.recordCount, 3U) ;
+    ASSERT_EQ(replay_statistics.byteCount, expected_data.size()) ;
+    ASSERT_GE(replay_statistics.durationUs, 99000U) ;
+    ASSERT_LT(replay_statistics.durationUs, 1000000U) ;
+    ASSERT_LT(replay_statistics.maximumLatenessUs, 500000U) ;
+    const auto original_duration_us = replay_statistics.durationUs ;
+
+    serial_capture_replayer.SetSpeed(10.0) ;
+    replay_statistics = serial_capture_replayer.Replay() ;
+    ASSERT_EQ(read_replay(), expected_data) ;
+    ASSERT_GE(replay_statistics.durationUs, 9900U) ;
+    ASSERT_LT(replay_statistics.durationUs, original_duration_us) ;
+    const auto faster_duration_us = replay_statistics.durationUs ;
+
+    serial_capture_replayer.SetSpeed(REPLAY_SPEED_AS_FAST_AS_POSSIBLE) ;
+    replay_statistics = serial_capture_replayer.Replay() ;
+    ASSERT_EQ(read_replay(), expected_data) ;
+    ASSERT_LT(replay_statistics.durationUs, faster_duration_us) ;
+
+    // All ports, and the other direction.
+    serial_capture_replayer.SetFilter(CaptureDirection::RECEIVED) ;
+    replay_statistics = serial_capture_replayer.Replay() ;
+    ASSERT_EQ(replay_statistics.recordCount, 4U) ;
+    std::string read_string {} ;
+    serial_port.Read(read_string, replay_statistics.byteCount, 1000) ;
+    ASSERT_EQ(read_string, "first othersecond third") ;
+
+    serial_capture_replayer.SetFilter(CaptureDirection::TRANSMITTED) ;
+    replay_statistics = serial_capture_replayer.Replay() ;
+    serial_port.Read(read_string, replay_statistics.byteCount, 1000) ;
+    ASSERT_EQ(read_string, "request") ;
+
+    serial_port.Close() ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureReplayerCancel()
+{
+    writeReplayCapture() ;
+
+    // At a hundredth of the original speed the replay would take 10 s.
+    SerialCaptureReplayer serial_capture_replayer {capturePath} ;
+    serial_capture_replayer.OpenPseudoTerminal() ;
+    serial_capture_replayer.SetSpeed(0.01) ;
+
+    std::thread cancel_thread {[&serial_capture_replayer]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+        serial_capture_replayer.Cancel() ;
+    }} ;
+
+    const auto start_time = std::chrono::steady_clock::now() ;
+    ASSERT_THROW(serial_capture_replayer.Replay(), OperationCancelled) ;
+    ASSERT_LT(std::chrono::steady_clock::now() - start_time, std::chrono::milliseconds(500)) ;
+    cancel_thread.join() ;
+
+    ASSERT_THROW(serial_capture_replayer.Replay(), OperationCancelled) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialFlightRecorder()
+{
+    ASSERT_THROW(SerialFlightRecorder {FLIGHT_RECORDER_SIZE_MINIMUM - 1}, std::invalid_argument) ;
+
+    SerialFlightRecorder serial_flight_recorder {FLIGHT_RECORDER_SIZE_MINIMUM} ;
+    ASSERT_EQ(serial_flight_recorder.GetBufferSize(), FLIGHT_RECORDER_SIZE_MINIMUM) ;
+    ASSERT_TRUE(serial_flight_recorder.Dump().empty()) ;
+
+    serial_flight_recorder.Record(CaptureDirection::TRANSMITTED, "request", 7) ;
+    serial_flight_recorder.Record(CaptureDirection::RECEIVED, "reply", 5) ;
+
+    auto capture_records = serial_flight_recorder.Dump() ;
+    ASSERT_EQ(capture_records.size(), 2U) ;
+    ASSERT_EQ(capture_records[0].direction, CaptureDirection::TRANSMITTED) ;
+    ASSERT_EQ(std::string(capture_records[0].data.begin(), capture_records[0].data.end()), "request") ;
+    ASSERT_EQ(capture_records[1].direction, CaptureDirection::RECEIVED) ;
+    ASSERT_EQ(std::string(capture_records[1].data.begin(), capture_records[1].data.end()), "reply") ;
+    ASSERT_LE(capture_records[0].timestampNs, capture_records[1].timestampNs) ;
+
+    // Exactly the last bytes received are kept once the buffer has wrapped
+    // around, the oldest chunk being truncated.
+    std::string recorded_string {} ;
+
+    for (size_t i = 0 ; i < 50 ; i++)
+    {
+        const std::string chunk = std::to_string(i) + std::string(17, static_cast<char>('a' + i % 26)) ;
+        serial_flight_recorder.Record(CaptureDirection::RECEIVED, chunk.data(), chunk.size()) ;
+        recorded_string += chunk ;
+    }
+
+    std::string dumped_string {} ;
+
+    for (const auto& capture_record : serial_flight_recorder.Dump())
+    {
+        if (capture_record.direction == CaptureDirection::RECEIVED)
+        {
+            dumped_string.append(capture_record.data.begin(), capture_record.data.end()) ;
+        }
+    }
+
+    ASSERT_EQ(dumped_string, recorded_string.substr(recorded_string.size() - FLIGHT_RECORDER_SIZE_MINIMUM)) ;
+
+    // Only the tail of a chunk larger than the buffer is kept.
+    const std::string large_chunk = std::string(FLIGHT_RECORDER_SIZE_MINIMUM, 'x') + "tail" ;
+    serial_flight_recorder.Record(CaptureDirection::TRANSMITTED, large_chunk.data(), large_chunk.size()) ;
+
+    capture_records = serial_flight_recorder.Dump() ;
+    ASSERT_EQ(capture_records.back().direction, CaptureDirection::TRANSMITTED) ;
+    ASSERT_EQ(std::string(capture_records.back().data.begin(), capture_records.back().data.end()),
+              large_chunk.substr(large_chunk.size() - FLIGHT_RECORDER_SIZE_MINIMUM)) ;
+    ASSERT_EQ(capture_records.end()[-2].direction, CaptureDirection::RECEIVED) ;
+
+    // The reading and the writing thread of a port record concurrently,
+    // each direction keeping its last bytes.
+    auto record_chunks = [&serial_flight_recorder](const CaptureDirection direction, const char fill)
+    {
+        const std::string chunk(29, fill) ;
+
+        for (size_t i = 0 ; i < 10000 ; i++)
+        {
+            serial_flight_recorder.Record(direction, chunk.data(), chunk.size()) ;
+        }
+    } ;
+
+    std::thread receive_thread {record_chunks, CaptureDirection::RECEIVED, 'r'} ;
+    std::thread transmit_thread {record_chunks, CaptureDirection::TRANSMITTED, 't'} ;
+    receive_thread.join() ;
+    transmit_thread.join() ;
+
+    size_t number_of_bytes = 0 ;
+
+    for (const auto& capture_record : serial_flight_recorder.Dump())
+    {
+        const auto fill = (capture_record.direction == CaptureDirection::RECEIVED) ? 'r' : 't' ;
+        ASSERT_EQ(std::string(capture_record.data.begin(), capture_record.data.end()),
+                  std::string(capture_record.data.size(), fill)) ;
+        number_of_bytes += capture_record.data.size() ;
+    }
+
+    ASSERT_EQ(number_of_bytes, 2 * FLIGHT_RECORDER_SIZE_MINIMUM) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialFlightRecorderSerialPort()
+{
+    std::vector<FlightRecorderTrigger> triggers {} ;
+    std::string dumped_string {} ;
+
+    int master_fd = -1 ;
+    SerialPort serial_port {} ;
+    serial_port.Open(openPseudoTerminal(master_fd)) ;
+
+    // The callback runs after the locks of the port are released, so it
+    // may change the settings even in thread-safe mode.
+    serial_port.SetThreadSafe(true) ;
+
+    // Without a flight recorder, nothing is recorded or reported.
+    serial_port.SetFlightRecorderCallback([&serial_port, &triggers, &dumped_string](const FlightRecorderTrigger         trigger,
+                                                                                    const std::vector<CaptureRecord>& captureRecords)
+    {
+        triggers.push_back(trigger) ;
+        dumped_string.clear() ;
+
+        for (const auto& capture_record : captureRecords)
+        {
+            dumped_string += (capture_record.direction == CaptureDirection::RECEIVED) ? '<' : '>' ;
+            dumped_string.append(capture_record.data.begin(), capture_record.data.end()) ;
+        }
+
+        serial_port.FlushInputBuffer() ;
+    }) ;
+
+    serial_port.ReportParseError() ;
+    ASSERT_TRUE(triggers.empty()) ;
+    ASSERT_TRUE(serial_port.DumpFlightRecorder().empty()) ;
+
+    serial_port.SetFlightRecorder(4096) ;
+    serial_port.Write("request") ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "request") ;
+
+    const std::string reply = "reply" ;
+    ASSERT_EQ(write(master_fd, reply.data(), reply.size()), static_cast<ssize_t>(reply.size())) ;
+
+    // The timeout reports the reply, which arrives in a single chunk as it
+    // was written before the read.
+    std::string read_string {} ;
+    ASSERT_THROW(serial_port.Read(read_string, reply.size() + 1, 50), ReadTimeout) ;
+    ASSERT_EQ(triggers, std::vector<FlightRecorderTrigger> {FlightRecorderTrigger::READ_TIMEOUT}) ;
+    ASSERT_EQ(dumped_string, ">request<reply") ;
+
+    serial_port.ReportParseError() ;
+    ASSERT_EQ(triggers.back(), FlightRecorderTrigger::PARSE_ERROR) ;
+    ASSERT_EQ(dumped_string, ">request<reply") ;
+    ASSERT_EQ(serial_port.DumpFlightRecorder().size(), 2U) ;
+
+    // The hang-up of the device is reported as well.
+    close(master_fd) ;
+    ASSERT_THROW(serial_port.Read(read_string, 1, 1000), std::runtime_error) ;
+    ASSERT_EQ(triggers.back(), FlightRecorderTrigger::DISCONNECTED) ;
+
+    serial_port.SetFlightRecorder(0) ;
+    ASSERT_TRUE(serial_port.DumpFlightRecorder().empty()) ;
+
+    serial_port.Close() ;
+    serial_port.SetThreadSafe(false) ;
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureWriteRead)
+{
+    SCOPED_TRACE("Serial Capture Write and Read Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureWriteRead() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureLiveReader)
+{
+    SCOPED_TRACE("Serial Capture Live Reader Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureLiveReader() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureSerialPort)
+{
+    SCOPED_TRACE("Serial Capture SerialPort::SetCapture() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureSerialPort() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureSerialPortFailure)
+{
+    SCOPED_TRACE("Serial Capture SerialPort::SetCapture() Failure Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureSerialPortFailure() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureReplayerSpeed)
+{
+    SCOPED_TRACE("Serial Capture Replayer Speed Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureReplayerSpeed() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureReplayerCancel)
+{
+    SCOPED_TRACE("Serial Capture Replayer Cancel() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureReplayerCancel() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialFlightRecorder)
+{
+    SCOPED_TRACE("Serial Flight Recorder Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialFlightRecorder() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialFlightRecorderSerialPort)
+{
+    SCOPED_TRACE("Serial Flight Recorder SerialPort::SetFlightRecorder() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialFlightRecorderSerialPort() ;
+    }
+}
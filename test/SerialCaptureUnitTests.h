@@ -0,0 +1,126 @@
+/******************************************************************************
+ * @file SerialCaptureUnitTests.h                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialCapture.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialCaptureUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialCaptureUnitTests() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialCaptureUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests that records written to several segments are read
+         *        back in order, including records split across segments.
+         */
+        void testSerialCaptureWriteRead() ;
+
+        /**
+         * @brief Tests that a reader finds records appended after it
+         *        reached the end of the capture.
+         */
+        void testSerialCaptureLiveReader() ;
+
+        /**
+         * @brief Tests for correct functionality of the SerialPort::SetCapture() method.
+         */
+        void testSerialCaptureSerialPort() ;
+
+        /**
+         * @brief Tests that a failure to record stops the capture of a
+         *        serial port without losing the data read or written.
+         */
+        void testSerialCaptureSerialPortFailure() ;
+
+        /**
+         * @brief Tests that SerialCaptureReplayer reproduces the spacing of
+         *        the records at different speeds through a pseudo terminal.
+         */
+        void testSerialCaptureReplayerSpeed() ;
+
+        /**
+         * @brief Tests for correct functionality of the SerialCaptureReplayer::Cancel() method.
+         */
+        void testSerialCaptureReplayerCancel() ;
+
+        /**
+         * @brief Tests that SerialFlightRecorder keeps the last bytes
+         *        recorded, including chunks recorded concurrently.
+         */
+        void testSerialFlightRecorder() ;
+
+        /**
+         * @brief Tests for correct functionality of the SerialPort::SetFlightRecorder() method.
+         */
+        void testSerialFlightRecorderSerialPort() ;
+
+        /**
+         * @brief Writes a capture of three received records 50 ms apart
+         *        and one transmitted record to capturePath.
+         */
+        void writeReplayCapture() ;
+
+        /**
+         * @param Directory containing the capture files.
+         */
+        std::string captureDirectory {} ;
+
+        /**
+         * @param Path of the capture segment files without the suffix.
+         */
+        std::string capturePath {} ;
+
+    } ; // class SerialCaptureUnitTests
+
+} // namespace LibSerial
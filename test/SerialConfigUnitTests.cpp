@@ -0,0 +1,195 @@
+/******************************************************************************
+ * @file SerialConfigUnitTests.cpp                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+
+#include "SerialConfigUnitTests.h"
+#include "UnitTests.h"
+#include "libserial/SerialPortT.h"
+
+#include <unistd.h>
+
+using namespace LibSerial;
+
+namespace
+{
+    /**
+     * @brief The configuration of a Modbus RTU link: 19200 8E1.
+     */
+    using ModbusConfig = SerialConfig<BaudRate::BAUD_19200,
+                                      CharacterSize::CHAR_SIZE_8,
+                                      Parity::PARITY_EVEN> ;
+
+    /**
+     * @brief A 7 bit configuration with software flow control: 9600 7O2.
+     */
+    using TerminalConfig = SerialConfig<BaudRate::BAUD_9600,
+                                        CharacterSize::CHAR_SIZE_7,
+                                        Parity::PARITY_ODD,
+                                        StopBits::STOP_BITS_2,
+                                        FlowControl::FLOW_CONTROL_SOFTWARE> ;
+
+    // The derived values are constant expressions.
+    static_assert(ModbusConfig::BITS_PER_CHARACTER == 11, "8E1 frames have 11 bits.") ;
+    static_assert(TerminalConfig::BITS_PER_CHARACTER == 11, "7O2 frames have 11 bits.") ;
+    static_assert(DefaultSerialConfig::BITS_PER_CHARACTER == 10, "8N1 frames have 10 bits.") ;
+}
+
+SerialConfigUnitTests::SerialConfigUnitTests()
+{
+    slaveFileName1 = openPseudoTerminal(masterFileDescriptor1) ;
+    slaveFileName2 = openPseudoTerminal(masterFileDescriptor2) ;
+}
+
+SerialConfigUnitTests::~SerialConfigUnitTests()
+{
+    close(masterFileDescriptor1) ;
+    close(masterFileDescriptor2) ;
+}
+
+void
+SerialConfigUnitTests::testSerialConfigConstants()
+{
+    ASSERT_EQ(ModbusConfig::BIT_RATE, 19200) ;
+    ASSERT_EQ(GetBitRate(BaudRate::BAUD_INVALID), 0) ;
+
+    // 11 bits at 19200 bps take 572.9 us.
+    ASSERT_EQ(ModbusConfig::CHARACTER_TIME_US, 573U) ;
+    ASSERT_EQ(ModbusConfig::INTER_CHARACTER_TIMEOUT_US, 860U) ;
+    ASSERT_EQ(ModbusConfig::INTER_FRAME_TIMEOUT_US, 2006U) ;
+    ASSERT_EQ(ModbusConfig::GetTransmitTimeUs(256), 256U * 573U) ;
+    ASSERT_EQ(ModbusConfig::GetTransmitTimeMs(256), 147U) ;
+
+    ASSERT_EQ(DefaultSerialConfig::CHARACTER_TIME_US, 87U) ;
+
+    ASSERT_EQ(ModbusConfig::CONTROL_FLAGS & CSIZE, static_cast<tcflag_t>(CS8)) ;
+    ASSERT_NE(ModbusConfig::CONTROL_FLAGS & PARENB, 0U) ;
+    ASSERT_EQ(ModbusConfig::CONTROL_FLAGS & PARODD, 0U) ;
+    ASSERT_EQ(ModbusConfig::CONTROL_FLAGS & CSTOPB, 0U) ;
+    ASSERT_NE(ModbusConfig::INPUT_FLAGS & INPCK, 0U) ;
+    ASSERT_EQ(ModbusConfig::INPUT_FLAGS & ISTRIP, 0U) ;
+
+    ASSERT_EQ(TerminalConfig::CONTROL_FLAGS & CSIZE, static_cast<tcflag_t>(CS7)) ;
+    ASSERT_NE(TerminalConfig::CONTROL_FLAGS & PARODD, 0U) ;
+    ASSERT_NE(TerminalConfig::CONTROL_FLAGS & CSTOPB, 0U) ;
+    ASSERT_NE(TerminalConfig::INPUT_FLAGS & ISTRIP, 0U) ;
+    ASSERT_NE(TerminalConfig::INPUT_FLAGS & IXON, 0U) ;
+
+    termios port_settings {} ;
+    port_settings.c_cflag = HUPCL ;
+    TerminalConfig::ApplyTo(port_settings) ;
+    ASSERT_EQ(cfgetospeed(&port_settings), static_cast<speed_t>(B9600)) ;
+    ASSERT_EQ(cfgetispeed(&port_settings), static_cast<speed_t>(B9600)) ;
+    ASSERT_NE(port_settings.c_cflag & HUPCL, 0U) ;
+    ASSERT_EQ(port_settings.c_cc[VSTART], CTRL_Q) ;
+    ASSERT_EQ(port_settings.c_cc[VSTOP], CTRL_S) ;
+    ASSERT_EQ(port_settings.c_cc[VMIN], VMIN_DEFAULT) ;
+}
+
+void
+SerialConfigUnitTests::testSerialPortOpenWithSerialConfig()
+{
+    SerialPort configured_serial_port {} ;
+    configured_serial_port.Open(slaveFileName1, TerminalConfig {}) ;
+
+    SerialPort serial_port {} ;
+    serial_port.Open(slaveFileName2) ;
+    serial_port.SetBaudRate(BaudRate::BAUD_9600) ;
+    serial_port.SetCharacterSize(CharacterSize::CHAR_SIZE_7) ;
+    serial_port.SetParity(Parity::PARITY_ODD) ;
+    serial_port.SetStopBits(StopBits::STOP_BITS_2) ;
+    serial_port.SetFlowControl(FlowControl::FLOW_CONTROL_SOFTWARE) ;
+
+    // Whatever the device accepts, both ways of configuring it agree.
+    termios configured_settings {} ;
+    termios port_settings {} ;
+    ASSERT_EQ(tcgetattr(configured_serial_port.GetFileDescriptor(), &configured_settings), 0) ;
+    ASSERT_EQ(tcgetattr(serial_port.GetFileDescriptor(), &port_settings), 0) ;
+
+    // SetParity() leaves IGNPAR set by the defaults, which would make the
+    // port ignore the parity errors it now checks for. SerialConfig does not.
+    ASSERT_EQ(configured_settings.c_iflag, port_settings.c_iflag & ~static_cast<tcflag_t>(IGNPAR)) ;
+    ASSERT_EQ(configured_settings.c_oflag, port_settings.c_oflag) ;
+    ASSERT_EQ(configured_settings.c_cflag, port_settings.c_cflag) ;
+    ASSERT_EQ(configured_settings.c_lflag, port_settings.c_lflag) ;
+    ASSERT_EQ(configured_settings.c_cc[VMIN], port_settings.c_cc[VMIN]) ;
+    ASSERT_EQ(configured_settings.c_cc[VTIME], port_settings.c_cc[VTIME]) ;
+    ASSERT_EQ(configured_serial_port.GetBaudRate(), BaudRate::BAUD_9600) ;
+    ASSERT_EQ(configured_serial_port.GetFlowControl(), FlowControl::FLOW_CONTROL_SOFTWARE) ;
+
+    ASSERT_THROW(configured_serial_port.Open(slaveFileName1, ModbusConfig {}), AlreadyOpen) ;
+    configured_serial_port.Close() ;
+    ASSERT_THROW(configured_serial_port.Open("/dev/libserial-does-not-exist", ModbusConfig {}), OpenFailed) ;
+}
+
+void
+SerialConfigUnitTests::testSerialPortTOpenWithSerialConfig()
+{
+    SerialPortT<> serial_port {} ;
+    ASSERT_TRUE(serial_port.Open(slaveFileName1, ModbusConfig {})) ;
+
+    termios port_settings {} ;
+    ASSERT_TRUE(serial_port.GetPortSettings(port_settings)) ;
+    ASSERT_EQ(cfgetospeed(&port_settings), static_cast<speed_t>(B19200)) ;
+    ASSERT_EQ(port_settings.c_iflag, ModbusConfig::INPUT_FLAGS) ;
+    ASSERT_EQ(port_settings.c_lflag, ModbusConfig::LOCAL_FLAGS) ;
+}
+
+TEST_F(SerialConfigUnitTests, testSerialConfigConstants)
+{
+    SCOPED_TRACE("SerialConfig Constants Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialConfigConstants() ;
+    }
+}
+
+TEST_F(SerialConfigUnitTests, testSerialPortOpenWithSerialConfig)
+{
+    SCOPED_TRACE("SerialPort Open() with SerialConfig Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortOpenWithSerialConfig() ;
+    }
+}
+
+TEST_F(SerialConfigUnitTests, testSerialPortTOpenWithSerialConfig)
+{
+    SCOPED_TRACE("SerialPortT Open() with SerialConfig Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortTOpenWithSerialConfig() ;
+    }
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * @file SerialConfigUnitTests.h                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialConfig.h"
+
+#include <gtest/gtest.h>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialConfigUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialConfigUnitTests() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialConfigUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests the character time, timeouts and termios flags
+         *        computed at compile time.
+         */
+        void testSerialConfigConstants() ;
+
+        /**
+         * @brief Tests that opening a SerialPort with a SerialConfig yields
+         *        the same settings as opening it and calling the setters.
+         */
+        void testSerialPortOpenWithSerialConfig() ;
+
+        /**
+         * @brief Tests that a SerialPortT opened with a SerialConfig uses
+         *        its settings.
+         */
+        void testSerialPortTOpenWithSerialConfig() ;
+
+        /**
+         * @brief File descriptors of the master sides of the pseudo terminals.
+         */
+        int masterFileDescriptor1 {-1} ;
+        int masterFileDescriptor2 {-1} ;
+
+        /**
+         * @brief File names of the slave sides of the pseudo terminals.
+         */
+        std::string slaveFileName1 {} ;
+        std::string slaveFileName2 {} ;
+
+    } ; // class SerialConfigUnitTests
+
+} // namespace LibSerial
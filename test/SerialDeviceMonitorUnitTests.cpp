@@ -0,0 +1,275 @@
+/******************************************************************************
+ * @file SerialDeviceMonitorUnitTests.cpp                                     *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialDeviceMonitorUnitTests.h"
+#include "UnitTests.h"
+
+#include <poll.h>
+#include <vector>
+
+using namespace LibSerial;
+
+namespace
+{
+    /**
+     * @brief Sysfs directory of the emulated USB devices.
+     */
+    constexpr const char* const USB_DEVICE_PATH = "/devices/pci0000:00/0000:00:14.0/usb1/1-3" ;
+}
+
+SerialDeviceMonitorUnitTests::SerialDeviceMonitorUnitTests()
+{
+    sysfsRoot = createTemporaryDirectory() ;
+    devRoot = createTemporaryDirectory() ;
+
+    makeDirectory(sysfsRoot + "/class/tty") ;
+}
+
+SerialDeviceMonitorUnitTests::~SerialDeviceMonitorUnitTests()
+{
+    removeDirectory(sysfsRoot) ;
+    removeDirectory(devRoot) ;
+}
+
+void
+SerialDeviceMonitorUnitTests::plugUsbDevice(const std::string& name)
+{
+    const auto usb_device_path = sysfsRoot + USB_DEVICE_PATH ;
+    const auto usb_tty_path = usb_device_path + "/1-3:1.0/" + name ;
+
+    makeDirectory(usb_tty_path) ;
+    writeFile(usb_device_path + "/idVendor", "2341\n") ;
+    writeFile(usb_device_path + "/idProduct", "0043\n") ;
+    writeFile(usb_device_path + "/serial", "85439313230351F0E1C0\n") ;
+
+    makeDirectory(sysfsRoot + "/class/tty/" + name) ;
+    makeSymbolicLink(usb_tty_path, sysfsRoot + "/class/tty/" + name + "/device") ;
+}
+
+void
+SerialDeviceMonitorUnitTests::unplugUsbDevice(const std::string& name)
+{
+    removeDirectory(sysfsRoot + "/class/tty/" + name) ;
+    removeDirectory(sysfsRoot + USB_DEVICE_PATH) ;
+}
+
+std::string
+SerialDeviceMonitorUnitTests::makeUeventMessage(const std::string& action,
+                                                const std::string& name,
+                                                const std::string& subsystem)
+{
+    const auto device_path = std::string(USB_DEVICE_PATH) + "/1-3:1.0/tty/" + name ;
+
+    std::string message {} ;
+    message += action + "@" + device_path + '\0' ;
+    message += "ACTION=" + action + '\0' ;
+    message += "DEVPATH=" + device_path + '\0' ;
+    message += "SUBSYSTEM=" + subsystem + '\0' ;
+    message += "MAJOR=166" + std::string(1, '\0') ;
+    message += "MINOR=0" + std::string(1, '\0') ;
+    message += "DEVNAME=" + name + '\0' ;
+    message += "SEQNUM=4711" + std::string(1, '\0') ;
+    return message ;
+}
+
+void
+SerialDeviceMonitorUnitTests::testSerialDeviceMonitorUeventMessages()
+{
+    SerialDeviceMonitor serial_device_monitor {sysfsRoot, devRoot} ;
+
+    plugUsbDevice("ttyACM0") ;
+    auto message = makeUeventMessage("add", "ttyACM0") ;
+    auto events = serial_device_monitor.ProcessUeventMessage(message.data(), message.size()) ;
+
+    ASSERT_EQ(events.size(), 1U) ;
+    ASSERT_EQ(events[0].eventType, SerialDeviceEventType::DEVICE_ADDED) ;
+    ASSERT_EQ(events[0].serialPortInfo.name, "ttyACM0") ;
+    ASSERT_EQ(events[0].serialPortInfo.devicePath, devRoot + "/ttyACM0") ;
+    ASSERT_TRUE(events[0].serialPortInfo.isUsbDevice) ;
+    ASSERT_EQ(events[0].serialPortInfo.usbVendorId, 0x2341) ;
+    ASSERT_EQ(events[0].serialPortInfo.usbProductId, 0x0043) ;
+
+    // The kernel removes the sysfs entries before announcing the removal,
+    // so the metadata recorded on insertion is reported.
+    unplugUsbDevice("ttyACM0") ;
+    message = makeUeventMessage("remove", "ttyACM0") ;
+    events = serial_device_monitor.ProcessUeventMessage(message.data(), message.size()) ;
+
+    ASSERT_EQ(events.size(), 1U) ;
+    ASSERT_EQ(events[0].eventType, SerialDeviceEventType::DEVICE_REMOVED) ;
+    ASSERT_EQ(events[0].serialPortInfo.name, "ttyACM0") ;
+    ASSERT_EQ(events[0].serialPortInfo.usbSerialNumber, "85439313230351F0E1C0") ;
+
+    // A second removal of the same device is not reported.
+    events = serial_device_monitor.ProcessUeventMessage(message.data(), message.size()) ;
+    ASSERT_TRUE(events.empty()) ;
+}
+
+void
+SerialDeviceMonitorUnitTests::testSerialDeviceMonitorIgnoredUeventMessages()
+{
+    SerialDeviceMonitor serial_device_monitor {sysfsRoot, devRoot} ;
+    plugUsbDevice("ttyACM0") ;
+
+    const std::vector<std::string> messages {
+        makeUeventMessage("add", "ttyACM0", "usb"),
+        makeUeventMessage("change", "ttyACM0"),
+        makeUeventMessage("add", "ttyACM1"),
+        makeUeventMessage("remove", "ttyACM1"),
+        std::string("libudev\0\xfe\xed\xca\xfe", 12) + makeUeventMessage("add", "ttyACM0"),
+        std::string("add@/devices/virtual/tty/tty1\0ACTION=add", 40),
+        std::string {}
+    } ;
+
+    for (const auto& message : messages)
+    {
+        const auto events = serial_device_monitor.ProcessUeventMessage(message.data(),
+                                                                       message.size()) ;
+        ASSERT_TRUE(events.empty()) ;
+    }
+
+    unplugUsbDevice("ttyACM0") ;
+}
+
+void
+SerialDeviceMonitorUnitTests::testSerialDeviceMonitorOpenClose()
+{
+    SerialDeviceMonitor serial_device_monitor {sysfsRoot, devRoot} ;
+
+    ASSERT_FALSE(serial_device_monitor.IsOpen()) ;
+    ASSERT_THROW(serial_device_monitor.GetFileDescriptor(), NotOpen) ;
+    ASSERT_THROW(serial_device_monitor.ProcessEvents(), NotOpen) ;
+    ASSERT_THROW(serial_device_monitor.Close(), NotOpen) ;
+
+    // Devices present when monitoring starts are reported when removed.
+    plugUsbDevice("ttyACM0") ;
+    serial_device_monitor.Open() ;
+
+    ASSERT_TRUE(serial_device_monitor.IsOpen()) ;
+    ASSERT_GE(serial_device_monitor.GetFileDescriptor(), 0) ;
+    ASSERT_THROW(serial_device_monitor.Open(), AlreadyOpen) ;
+    ASSERT_NO_THROW(serial_device_monitor.ProcessEvents()) ;
+
+    unplugUsbDevice("ttyACM0") ;
+    const auto message = makeUeventMessage("remove", "ttyACM0") ;
+    const auto events = serial_device_monitor.ProcessUeventMessage(message.data(), message.size()) ;
+
+    ASSERT_EQ(events.size(), 1U) ;
+    ASSERT_EQ(events[0].eventType, SerialDeviceEventType::DEVICE_REMOVED) ;
+    ASSERT_EQ(events[0].serialPortInfo.usbVendorId, 0x2341) ;
+
+    serial_device_monitor.Close() ;
+    ASSERT_FALSE(serial_device_monitor.IsOpen()) ;
+}
+
+void
+SerialDeviceMonitorUnitTests::testSerialDeviceMonitorInotifyFallback()
+{
+    SerialDeviceMonitor serial_device_monitor {sysfsRoot, devRoot} ;
+    serial_device_monitor.Open(false) ;
+
+    ASSERT_TRUE(serial_device_monitor.IsOpen()) ;
+    ASSERT_FALSE(serial_device_monitor.IsUsingNetlink()) ;
+
+    const auto wait_for_events = [&serial_device_monitor]()
+    {
+        pollfd poll_fd {serial_device_monitor.GetFileDescriptor(), POLLIN, 0} ;
+        return poll(&poll_fd, 1, 1000) ;
+    } ;
+
+    // Device files of unknown devices are ignored.
+    writeFile(devRoot + "/ttyACM1", "") ;
+    ASSERT_EQ(wait_for_events(), 1) ;
+    ASSERT_TRUE(serial_device_monitor.ProcessEvents().empty()) ;
+
+    plugUsbDevice("ttyACM0") ;
+    writeFile(devRoot + "/ttyACM0", "") ;
+    ASSERT_EQ(wait_for_events(), 1) ;
+
+    auto events = serial_device_monitor.ProcessEvents() ;
+    ASSERT_EQ(events.size(), 1U) ;
+    ASSERT_EQ(events[0].eventType, SerialDeviceEventType::DEVICE_ADDED) ;
+    ASSERT_EQ(events[0].serialPortInfo.name, "ttyACM0") ;
+
+    unplugUsbDevice("ttyACM0") ;
+    ASSERT_EQ(unlink((devRoot + "/ttyACM0").c_str()), 0) ;
+    ASSERT_EQ(wait_for_events(), 1) ;
+
+    events = serial_device_monitor.ProcessEvents() ;
+    ASSERT_EQ(events.size(), 1U) ;
+    ASSERT_EQ(events[0].eventType, SerialDeviceEventType::DEVICE_REMOVED) ;
+    ASSERT_EQ(events[0].serialPortInfo.usbVendorId, 0x2341) ;
+
+    ASSERT_EQ(unlink((devRoot + "/ttyACM1").c_str()), 0) ;
+    serial_device_monitor.Close() ;
+}
+
+TEST_F(SerialDeviceMonitorUnitTests, testSerialDeviceMonitorUeventMessages)
+{
+    SCOPED_TRACE("Serial Device Monitor ProcessUeventMessage() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialDeviceMonitorUeventMessages() ;
+    }
+}
+
+TEST_F(SerialDeviceMonitorUnitTests, testSerialDeviceMonitorIgnoredUeventMessages)
+{
+    SCOPED_TRACE("Serial Device Monitor Ignored Uevent Messages Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialDeviceMonitorIgnoredUeventMessages() ;
+    }
+}
+
+TEST_F(SerialDeviceMonitorUnitTests, testSerialDeviceMonitorOpenClose)
+{
+    SCOPED_TRACE("Serial Device Monitor Open() and Close() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialDeviceMonitorOpenClose() ;
+    }
+}
+
+TEST_F(SerialDeviceMonitorUnitTests, testSerialDeviceMonitorInotifyFallback)
+{
+    SCOPED_TRACE("Serial Device Monitor inotify Fallback Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialDeviceMonitorInotifyFallback() ;
+    }
+}
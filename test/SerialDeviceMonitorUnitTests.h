@@ -0,0 +1,119 @@
+/******************************************************************************
+ * @file SerialDeviceMonitorUnitTests.h                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialDeviceMonitor.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialDeviceMonitorUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialDeviceMonitorUnitTests() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialDeviceMonitorUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests that synthetic uevent messages for serial devices
+         *        produce add and remove events carrying the device metadata.
+         */
+        void testSerialDeviceMonitorUeventMessages() ;
+
+        /**
+         * @brief Tests that uevent messages unrelated to serial devices are ignored.
+         */
+        void testSerialDeviceMonitorIgnoredUeventMessages() ;
+
+        /**
+         * @brief Tests for correct functionality of the Open() and Close() methods.
+         */
+        void testSerialDeviceMonitorOpenClose() ;
+
+        /**
+         * @brief Tests the inotify fallback used when netlink is unavailable.
+         */
+        void testSerialDeviceMonitorInotifyFallback() ;
+
+        /**
+         * @brief Emulates the sysfs entries of a USB-serial adapter.
+         * @param name The kernel name of the device.
+         */
+        void plugUsbDevice(const std::string& name) ;
+
+        /**
+         * @brief Removes the sysfs entries of an emulated device.
+         * @param name The kernel name of the device.
+         */
+        void unplugUsbDevice(const std::string& name) ;
+
+        /**
+         * @brief Builds a kernel uevent message for a tty device.
+         * @param action The uevent action, (e.g. "add").
+         * @param name The kernel name of the device.
+         * @param subsystem The subsystem of the device.
+         * @return Returns the message, including the embedded null characters.
+         */
+        std::string makeUeventMessage(const std::string& action,
+                                      const std::string& name,
+                                      const std::string& subsystem = "tty") ;
+
+        /**
+         * @param Root of the emulated sysfs tree.
+         */
+        std::string sysfsRoot {} ;
+
+        /**
+         * @param Root of the emulated /dev tree.
+         */
+        std::string devRoot {} ;
+
+    } ; // class SerialDeviceMonitorUnitTests
+
+} // namespace LibSerial
@@ -0,0 +1,345 @@
+/******************************************************************************
+ * @file SerialFileTransferUnitTests.cpp                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialFileTransferUnitTests.h"
+#include "UnitTests.h"
+#include "libserial/SerialChecksum.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+using namespace LibSerial;
+
+SerialFileTransferUnitTests::SerialFileTransferUnitTests()
+{
+    temporaryDirectory = createTemporaryDirectory() ;
+}
+
+SerialFileTransferUnitTests::~SerialFileTransferUnitTests()
+{
+    removeDirectory(temporaryDirectory) ;
+}
+
+FileTransferResult
+SerialFileTransferUnitTests::transferFile(const FileTransferProtocol fileTransferProtocol,
+                                          const FileTransferOptions& fileTransferOptions,
+                                          const std::string&         filePath,
+                                          const std::string&         receivePath,
+                                          FileTransferResult&        receiveResult)
+{
+    FileTransferResult send_result {} ;
+
+    runTransfer([&]
+                {
+                    SerialFileTransfer serial_file_transfer {firstPort, fileTransferProtocol, fileTransferOptions} ;
+                    send_result = serial_file_transfer.Send(filePath) ;
+                },
+                [&](const std::atomic<bool>& /* isSent */)
+                {
+                    SerialFileTransfer serial_file_transfer {secondPort, fileTransferProtocol, fileTransferOptions} ;
+                    receiveResult = serial_file_transfer.Receive(receivePath) ;
+                }) ;
+
+    return send_result ;
+}
+
+std::string
+SerialFileTransferUnitTests::readFile(const std::string& path)
+{
+    std::ifstream file {path, std::ios::binary} ;
+    std::ostringstream contents {} ;
+    contents << file.rdbuf() ;
+    return contents.str() ;
+}
+
+void
+SerialFileTransferUnitTests::testSerialChecksums()
+{
+    const std::string check_data {"123456789"} ;
+
+    ASSERT_EQ(ComputeCrc16(check_data.data(), check_data.size()), 0x31C3) ;
+    ASSERT_EQ(ComputeCrc32(check_data.data(), check_data.size()), 0xCBF43926U) ;
+    ASSERT_EQ(ComputeCrc16(nullptr, 0), 0) ;
+    ASSERT_EQ(ComputeCrc32(nullptr, 0), 0U) ;
+
+    // Data checksummed in pieces yields the same result.
+    const auto data = makeTestData(1000) ;
+
+    for (const size_t split : {0, 1, 7, 8, 9, 500, 1000})
+    {
+        ASSERT_EQ(ComputeCrc16(data.data() + split,
+                               data.size() - split,
+                               ComputeCrc16(data.data(), split)),
+                  ComputeCrc16(data.data(), data.size())) ;
+
+        ASSERT_EQ(ComputeCrc32(data.data() + split,
+                               data.size() - split,
+                               ComputeCrc32(data.data(), split)),
+                  ComputeCrc32(data.data(), data.size())) ;
+    }
+}
+
+void
+SerialFileTransferUnitTests::testSerialFileTransferRoundTrip()
+{
+    ASSERT_THROW(SerialFileTransfer(firstPort,
+                                    FileTransferProtocol::XMODEM,
+                                    FileTransferOptions {0}),
+                 std::invalid_argument) ;
+
+    for (const auto protocol : {FileTransferProtocol::XMODEM,
+                                FileTransferProtocol::XMODEM_1K,
+                                FileTransferProtocol::YMODEM,
+                                FileTransferProtocol::ZMODEM})
+    {
+        for (const size_t file_size : {0, 1, 1024, 20000})
+        {
+            const auto file_path = temporaryDirectory + "/send.bin" ;
+            const auto receive_directory = temporaryDirectory + "/received" ;
+            const auto data = makeTestData(file_size) ;
+
+            writeFile(file_path, data) ;
+            makeDirectory(receive_directory) ;
+
+            // The callback is called by the sender and the receiver.
+            std::mutex progress_mutex {} ;
+            size_t number_of_callbacks = 0 ;
+            size_t bytes_transferred = 0 ;
+
+            FileTransferOptions file_transfer_options {} ;
+            file_transfer_options.progressCallback = [&](const size_t bytesTransferred,
+                                                         const size_t /* fileSize */)
+            {
+                std::lock_guard<std::mutex> progress_lock {progress_mutex} ;
+                number_of_callbacks++ ;
+                bytes_transferred = std::max(bytes_transferred, bytesTransferred) ;
+            } ;
+
+            const auto is_batch = (protocol == FileTransferProtocol::YMODEM) or
+                                  (protocol == FileTransferProtocol::ZMODEM) ;
+
+            FileTransferResult receive_result {} ;
+            const auto send_result = transferFile(protocol,
+                                                  file_transfer_options,
+                                                  file_path,
+                                                  is_batch ? receive_directory : receive_directory + "/xmodem.bin",
+                                                  receive_result) ;
+
+            ASSERT_EQ(send_result.filePath, file_path) ;
+            ASSERT_EQ(send_result.fileSize, file_size) ;
+            ASSERT_EQ(send_result.retransmissions, 0U) ;
+            ASSERT_EQ(receive_result.retransmissions, 0U) ;
+            ASSERT_GE(bytes_transferred, file_size) ;
+            ASSERT_GE(number_of_callbacks, (file_size + 1023) / 1024) ;
+
+            const auto received_data = readFile(receive_result.filePath) ;
+
+            if (is_batch)
+            {
+                // The file name and exact size are sent along.
+                ASSERT_EQ(receive_result.filePath, receive_directory + "/send.bin") ;
+                ASSERT_EQ(received_data, data) ;
+            }
+            else
+            {
+                // XMODEM pads the file to a whole block, which is 128 bytes
+                // for the remainder of an XMODEM-1K transfer up to that size.
+                const size_t block_size = (protocol == FileTransferProtocol::XMODEM) ? 128 : 1024 ;
+                ASSERT_EQ(received_data.size() % 128, 0U) ;
+                ASSERT_GE(received_data.size(), file_size) ;
+                ASSERT_LT(received_data.size(), file_size + block_size) ;
+                ASSERT_EQ(received_data.substr(0, file_size), data) ;
+                ASSERT_EQ(received_data.find_first_not_of('\x1A', file_size), std::string::npos) ;
+            }
+
+            removeDirectory(receive_directory) ;
+        }
+    }
+}
+
+void
+SerialFileTransferUnitTests::testSerialFileTransferErrorRecovery()
+{
+    const auto file_path = temporaryDirectory + "/send.bin" ;
+    const auto data = makeTestData(70000) ;
+    writeFile(file_path, data) ;
+
+    // ZMODEM is run streaming and with a window, which makes the receiver
+    // acknowledge every quarter window.
+    for (const auto& protocol_window : {std::make_pair(FileTransferProtocol::XMODEM_1K, 0),
+                                        std::make_pair(FileTransferProtocol::YMODEM, 0),
+                                        std::make_pair(FileTransferProtocol::ZMODEM, 0),
+                                        std::make_pair(FileTransferProtocol::ZMODEM, 4096)})
+    {
+        const auto protocol = protocol_window.first ;
+        const auto receive_directory = temporaryDirectory + "/received" ;
+        makeDirectory(receive_directory) ;
+
+        FileTransferOptions file_transfer_options {} ;
+        file_transfer_options.msTimeout = 1000 ;
+        file_transfer_options.zmodemWindowSize = protocol_window.second ;
+
+        // A byte in the middle of the file is corrupted on its way.
+        relay->corruptByte(30000) ;
+
+        FileTransferResult receive_result {} ;
+        const auto send_result = transferFile(protocol,
+                                              file_transfer_options,
+                                              file_path,
+                                              (protocol == FileTransferProtocol::XMODEM_1K) ? receive_directory + "/xmodem.bin" : receive_directory,
+                                              receive_result) ;
+
+        ASSERT_FALSE(relay->isCorruptionPending()) ;
+        ASSERT_GE(send_result.retransmissions, 1U) ;
+        ASSERT_GE(receive_result.retransmissions, 1U) ;
+        ASSERT_EQ(readFile(receive_result.filePath).substr(0, data.size()), data) ;
+
+        removeDirectory(receive_directory) ;
+    }
+
+    // A transfer without a remote side gives up after the retries.
+    FileTransferOptions file_transfer_options {} ;
+    file_transfer_options.msTimeout = 10 ;
+    file_transfer_options.maximumRetries = 2 ;
+
+    SerialFileTransfer serial_file_transfer {firstPort, FileTransferProtocol::ZMODEM, file_transfer_options} ;
+    ASSERT_THROW(serial_file_transfer.Send(file_path), std::runtime_error) ;
+    ASSERT_THROW(serial_file_transfer.Send(temporaryDirectory + "/missing.bin"), std::runtime_error) ;
+
+    // The receiver sees the CAN characters sent by the failed sender.
+    SerialFileTransfer cancelled_file_transfer {secondPort, FileTransferProtocol::ZMODEM, file_transfer_options} ;
+    ASSERT_THROW(cancelled_file_transfer.Receive(temporaryDirectory), std::runtime_error) ;
+
+    // Discard the remaining CAN characters before the next transfer.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+    secondPort.FlushIOBuffers() ;
+    firstPort.FlushIOBuffers() ;
+}
+
+void
+SerialFileTransferUnitTests::testSerialFileTransferThroughput()
+{
+    const auto file_path = temporaryDirectory + "/send.bin" ;
+    const auto data = makeTestData(LINE_RATE / 4) ;
+    writeFile(file_path, data) ;
+
+    // The link transfers LINE_RATE bytes per second in each direction and
+    // delays them by 2 ms.
+    firstPort.SetWritePacing(LINE_RATE, 256) ;
+    secondPort.SetWritePacing(LINE_RATE, 256) ;
+    relay->setLatency(2) ;
+
+    // Plain writes of the file under the same pacing, latency and load of
+    // the machine show what the link actually carries.
+    const auto line_rate = measureLineRate(data) ;
+
+    std::map<FileTransferProtocol, double> throughputs {} ;
+
+    for (const auto protocol : {FileTransferProtocol::ZMODEM,
+                                FileTransferProtocol::XMODEM_1K})
+    {
+        const auto receive_directory = temporaryDirectory + "/received" ;
+        makeDirectory(receive_directory) ;
+
+        FileTransferResult receive_result {} ;
+        const auto send_result = transferFile(protocol,
+                                              FileTransferOptions(),
+                                              file_path,
+                                              (protocol == FileTransferProtocol::ZMODEM) ? receive_directory : receive_directory + "/xmodem.bin",
+                                              receive_result) ;
+
+        throughputs[protocol] = static_cast<double>(send_result.fileSize) * 1e6 / static_cast<double>(send_result.durationUs) ;
+
+        ASSERT_EQ(readFile(receive_result.filePath).substr(0, data.size()), data) ;
+        ASSERT_LE(throughputs[protocol], line_rate * 1.05) ;
+
+        removeDirectory(receive_directory) ;
+    }
+
+    relay->setLatency(0) ;
+    firstPort.SetWritePacing(0, 1, 0) ;
+    secondPort.SetWritePacing(0, 1, 0) ;
+
+    // ZMODEM streams the file close to the rate of plain writes, leaving
+    // room for its headers and escaped bytes, while XMODEM waits a round
+    // trip for the acknowledgement of each block.
+    ASSERT_GE(throughputs[FileTransferProtocol::ZMODEM], line_rate * 0.8) ;
+    ASSERT_GE(throughputs[FileTransferProtocol::ZMODEM], throughputs[FileTransferProtocol::XMODEM_1K] * 1.3) ;
+}
+
+TEST_F(SerialFileTransferUnitTests, testSerialChecksums)
+{
+    SCOPED_TRACE("Serial Checksums Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialChecksums() ;
+    }
+}
+
+TEST_F(SerialFileTransferUnitTests, testSerialFileTransferRoundTrip)
+{
+    SCOPED_TRACE("Serial File Transfer Round Trip Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialFileTransferRoundTrip() ;
+    }
+}
+
+TEST_F(SerialFileTransferUnitTests, testSerialFileTransferErrorRecovery)
+{
+    SCOPED_TRACE("Serial File Transfer Error Recovery Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialFileTransferErrorRecovery() ;
+    }
+}
+
+TEST_F(SerialFileTransferUnitTests, testSerialFileTransferThroughput)
+{
+    SCOPED_TRACE("Serial File Transfer Throughput Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialFileTransferThroughput() ;
+    }
+}
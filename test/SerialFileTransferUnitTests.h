@@ -0,0 +1,114 @@
+/******************************************************************************
+ * @file SerialFileTransferUnitTests.h                                        *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialFileTransfer.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialFileTransferUnitTests : public RelayedLinkUnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialFileTransferUnitTests() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialFileTransferUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests the checksums against their published check values.
+         */
+        void testSerialChecksums() ;
+
+        /**
+         * @brief Tests that files of several sizes are transferred intact
+         *        with each protocol.
+         */
+        void testSerialFileTransferRoundTrip() ;
+
+        /**
+         * @brief Tests that data corrupted on the link is repeated.
+         */
+        void testSerialFileTransferErrorRecovery() ;
+
+        /**
+         * @brief Compares the throughput of the protocols with the rate of
+         *        plain writes on a paced link.
+         */
+        void testSerialFileTransferThroughput() ;
+
+        /**
+         * @brief Sends a file from firstPort to secondPort.
+         * @param fileTransferProtocol The protocol of the transfer.
+         * @param fileTransferOptions The options of the transfer.
+         * @param filePath The path of the file to be sent.
+         * @param receivePath The path passed to Receive().
+         * @param receiveResult Set to the result of the receiver.
+         * @return Returns the result of the sender.
+         */
+        FileTransferResult transferFile(const FileTransferProtocol fileTransferProtocol,
+                                        const FileTransferOptions& fileTransferOptions,
+                                        const std::string&         filePath,
+                                        const std::string&         receivePath,
+                                        FileTransferResult&        receiveResult) ;
+
+        /**
+         * @brief Reads a file.
+         * @param path The path of the file.
+         * @return Returns the contents of the file.
+         */
+        std::string readFile(const std::string& path) ;
+
+        /**
+         * @brief Directory holding the files of a test.
+         */
+        std::string temporaryDirectory {} ;
+
+    } ; // class SerialFileTransferUnitTests
+
+} // namespace LibSerial
@@ -0,0 +1,234 @@
+/******************************************************************************
+ * @file SerialPortEnumeratorUnitTests.cpp                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialPortEnumeratorUnitTests.h"
+#include "UnitTests.h"
+
+#include <unistd.h>
+#include <vector>
+
+using namespace LibSerial;
+
+namespace
+{
+    /**
+     * @brief Sysfs directory of the emulated USB device.
+     */
+    constexpr const char* const USB_DEVICE_PATH = "/devices/pci0000:00/0000:00:14.0/usb1/1-2" ;
+
+    /**
+     * @brief Name of the emulated /dev/serial/by-id link.
+     */
+    constexpr const char* const BY_ID_NAME = "usb-FTDI_FT232R_USB_UART_A10K3XYZ-if00-port0" ;
+}
+
+SerialPortEnumeratorUnitTests::SerialPortEnumeratorUnitTests()
+{
+    // Emulate the sysfs and /dev layout of one FTDI USB-serial adapter, two
+    // detected 16550A UARTs, one undetected legacy port and one virtual
+    // terminal.
+    sysfsRoot = createTemporaryDirectory() ;
+    devRoot = createTemporaryDirectory() ;
+
+    const auto usb_device_path = sysfsRoot + USB_DEVICE_PATH ;
+    const auto usb_tty_path = usb_device_path + "/1-2:1.0/ttyUSB0" ;
+    const auto platform_path = sysfsRoot + "/devices/platform/serial8250" ;
+
+    makeDirectory(sysfsRoot + "/bus/usb-serial/drivers/ftdi_sio") ;
+    makeDirectory(sysfsRoot + "/bus/platform/drivers/serial8250") ;
+    makeDirectory(usb_tty_path) ;
+    makeDirectory(platform_path) ;
+
+    writeFile(usb_device_path + "/idVendor", "0403\n") ;
+    writeFile(usb_device_path + "/idProduct", "6001\n") ;
+    writeFile(usb_device_path + "/serial", "A10K3XYZ\n") ;
+    writeFile(usb_device_path + "/manufacturer", "FTDI\n") ;
+    writeFile(usb_device_path + "/product", "FT232R USB UART\n") ;
+
+    makeSymbolicLink(sysfsRoot + "/bus/usb-serial/drivers/ftdi_sio", usb_tty_path + "/driver") ;
+    makeSymbolicLink(sysfsRoot + "/bus/usb-serial", usb_tty_path + "/subsystem") ;
+    makeSymbolicLink(sysfsRoot + "/bus/platform/drivers/serial8250", platform_path + "/driver") ;
+    makeSymbolicLink(sysfsRoot + "/bus/platform", platform_path + "/subsystem") ;
+
+    makeDirectory(sysfsRoot + "/class/tty/ttyUSB0") ;
+    makeSymbolicLink(usb_tty_path, sysfsRoot + "/class/tty/ttyUSB0/device") ;
+
+    for (const auto& legacy_port : {std::make_pair("ttyS0", "0"),
+                                    std::make_pair("ttyS2", "4"),
+                                    std::make_pair("ttyS10", "4")})
+    {
+        const auto class_path = sysfsRoot + "/class/tty/" + legacy_port.first ;
+        makeDirectory(class_path) ;
+        makeSymbolicLink(platform_path, class_path + "/device") ;
+        writeFile(class_path + "/type", std::string(legacy_port.second) + "\n") ;
+    }
+
+    makeDirectory(sysfsRoot + "/class/tty/tty0") ;
+
+    for (const auto& device_name : {"ttyUSB0", "ttyS0", "ttyS2", "ttyS10", "tty0"})
+    {
+        writeFile(devRoot + "/" + device_name, "") ;
+    }
+
+    makeDirectory(devRoot + "/serial/by-id") ;
+    makeSymbolicLink("../../ttyUSB0", devRoot + "/serial/by-id/" + BY_ID_NAME) ;
+}
+
+SerialPortEnumeratorUnitTests::~SerialPortEnumeratorUnitTests()
+{
+    removeDirectory(sysfsRoot) ;
+    removeDirectory(devRoot) ;
+}
+
+void
+SerialPortEnumeratorUnitTests::testSerialPortEnumeratorGetSerialPorts()
+{
+    const SerialPortEnumerator serial_port_enumerator {sysfsRoot, devRoot} ;
+    const auto serial_ports = serial_port_enumerator.GetSerialPorts() ;
+
+    // The undetected ttyS0 and the virtual terminal tty0 are not listed and
+    // numeric suffixes are ordered by value.
+    ASSERT_EQ(serial_ports.size(), 3U) ;
+    ASSERT_EQ(serial_ports[0].name, "ttyS2") ;
+    ASSERT_EQ(serial_ports[1].name, "ttyS10") ;
+    ASSERT_EQ(serial_ports[2].name, "ttyUSB0") ;
+
+    ASSERT_EQ(serial_ports[0].devicePath, devRoot + "/ttyS2") ;
+    ASSERT_EQ(serial_ports[0].driver, "serial8250") ;
+    ASSERT_EQ(serial_ports[0].subsystem, "platform") ;
+    ASSERT_FALSE(serial_ports[0].isUsbDevice) ;
+
+    const auto& usb_port = serial_ports[2] ;
+    ASSERT_EQ(usb_port.devicePath, devRoot + "/ttyUSB0") ;
+    ASSERT_EQ(usb_port.driver, "ftdi_sio") ;
+    ASSERT_EQ(usb_port.subsystem, "usb-serial") ;
+    ASSERT_TRUE(usb_port.isUsbDevice) ;
+    ASSERT_EQ(usb_port.usbVendorId, 0x0403) ;
+    ASSERT_EQ(usb_port.usbProductId, 0x6001) ;
+    ASSERT_EQ(usb_port.usbSerialNumber, "A10K3XYZ") ;
+    ASSERT_EQ(usb_port.manufacturer, "FTDI") ;
+    ASSERT_EQ(usb_port.product, "FT232R USB UART") ;
+
+    // By-id paths are only resolved on request.
+    ASSERT_TRUE(usb_port.byIdPath.empty()) ;
+
+    // A missing sysfs tree yields no serial ports.
+    const SerialPortEnumerator missing_enumerator {sysfsRoot + "/missing", devRoot} ;
+    ASSERT_TRUE(missing_enumerator.GetSerialPorts().empty()) ;
+}
+
+void
+SerialPortEnumeratorUnitTests::testSerialPortEnumeratorGetSerialPortInfo()
+{
+    const SerialPortEnumerator serial_port_enumerator {sysfsRoot, devRoot} ;
+
+    SerialPortInfo serial_port_info {} ;
+    ASSERT_TRUE(serial_port_enumerator.GetSerialPortInfo("ttyUSB0", serial_port_info)) ;
+    ASSERT_EQ(serial_port_info.name, "ttyUSB0") ;
+    ASSERT_EQ(serial_port_info.usbVendorId, 0x0403) ;
+
+    ASSERT_FALSE(serial_port_enumerator.GetSerialPortInfo("ttyS0", serial_port_info)) ;
+    ASSERT_FALSE(serial_port_enumerator.GetSerialPortInfo("tty0", serial_port_info)) ;
+    ASSERT_FALSE(serial_port_enumerator.GetSerialPortInfo("ttyACM0", serial_port_info)) ;
+
+    // The metadata is left untouched when no serial port is found.
+    ASSERT_EQ(serial_port_info.name, "ttyUSB0") ;
+}
+
+void
+SerialPortEnumeratorUnitTests::testSerialPortEnumeratorResolveByIdPaths()
+{
+    SerialPortEnumerator serial_port_enumerator {sysfsRoot, devRoot} ;
+    serial_port_enumerator.SetResolveByIdPaths(true) ;
+
+    SerialPortInfo serial_port_info {} ;
+    ASSERT_TRUE(serial_port_enumerator.GetSerialPortInfo("ttyUSB0", serial_port_info)) ;
+    ASSERT_EQ(serial_port_info.byIdPath, devRoot + "/serial/by-id/" + BY_ID_NAME) ;
+
+    ASSERT_TRUE(serial_port_enumerator.GetSerialPortInfo("ttyS2", serial_port_info)) ;
+    ASSERT_TRUE(serial_port_info.byIdPath.empty()) ;
+}
+
+void
+SerialPortEnumeratorUnitTests::testSerialPortEnumeratorProbeDevices()
+{
+    SerialPortEnumerator serial_port_enumerator {sysfsRoot, devRoot} ;
+    serial_port_enumerator.SetProbeDevices(true) ;
+
+    // The emulated device files are regular files and do not respond to
+    // TIOCGSERIAL.
+    ASSERT_TRUE(serial_port_enumerator.GetSerialPorts().empty()) ;
+
+    serial_port_enumerator.SetProbeDevices(false) ;
+    ASSERT_EQ(serial_port_enumerator.GetSerialPorts().size(), 3U) ;
+}
+
+TEST_F(SerialPortEnumeratorUnitTests, testSerialPortEnumeratorGetSerialPorts)
+{
+    SCOPED_TRACE("Serial Port Enumerator GetSerialPorts() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortEnumeratorGetSerialPorts() ;
+    }
+}
+
+TEST_F(SerialPortEnumeratorUnitTests, testSerialPortEnumeratorGetSerialPortInfo)
+{
+    SCOPED_TRACE("Serial Port Enumerator GetSerialPortInfo() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortEnumeratorGetSerialPortInfo() ;
+    }
+}
+
+TEST_F(SerialPortEnumeratorUnitTests, testSerialPortEnumeratorResolveByIdPaths)
+{
+    SCOPED_TRACE("Serial Port Enumerator SetResolveByIdPaths() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortEnumeratorResolveByIdPaths() ;
+    }
+}
+
+TEST_F(SerialPortEnumeratorUnitTests, testSerialPortEnumeratorProbeDevices)
+{
+    SCOPED_TRACE("Serial Port Enumerator SetProbeDevices() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortEnumeratorProbeDevices() ;
+    }
+}
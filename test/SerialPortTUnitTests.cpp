@@ -0,0 +1,265 @@
+/******************************************************************************
+ * @file SerialPortTUnitTests.cpp                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+
+#include "SerialPortTUnitTests.h"
+#include "UnitTests.h"
+
+#include <string>
+#include <unistd.h>
+
+using namespace LibSerial;
+
+SerialPortTUnitTests::SerialPortTUnitTests()
+{
+    slaveFileName = openPseudoTerminal(masterFileDescriptor) ;
+}
+
+SerialPortTUnitTests::~SerialPortTUnitTests()
+{
+    close(masterFileDescriptor) ;
+}
+
+void
+SerialPortTUnitTests::testSerialPortTOpenClose()
+{
+    SerialPortT<> serial_port {} ;
+    ASSERT_FALSE(serial_port.IsOpen()) ;
+    ASSERT_EQ(serial_port.GetFileDescriptor(), -1) ;
+    ASSERT_THROW(serial_port.Close(), NotOpen) ;
+
+    ASSERT_TRUE(serial_port.Open(slaveFileName)) ;
+    ASSERT_TRUE(serial_port.IsOpen()) ;
+    ASSERT_GE(serial_port.GetFileDescriptor(), 0) ;
+    ASSERT_THROW(serial_port.Open(slaveFileName), AlreadyOpen) ;
+
+    // The port is opened in raw mode at the default baud rate.
+    termios port_settings {} ;
+    ASSERT_TRUE(serial_port.GetPortSettings(port_settings)) ;
+    ASSERT_EQ(port_settings.c_lflag, 0U) ;
+    ASSERT_EQ(cfgetospeed(&port_settings), static_cast<speed_t>(BaudRate::BAUD_DEFAULT)) ;
+
+    ASSERT_TRUE(serial_port.Close()) ;
+    ASSERT_FALSE(serial_port.IsOpen()) ;
+    ASSERT_THROW(serial_port.Open("/dev/libserial-does-not-exist"), OpenFailed) ;
+
+    // The port is closed by the destructor of the instance it is moved to.
+    SerialPortT<> moved_serial_port {slaveFileName} ;
+    serial_port = std::move(moved_serial_port) ;
+    ASSERT_TRUE(serial_port.IsOpen()) ;
+    ASSERT_FALSE(moved_serial_port.IsOpen()) ; // NOLINT (bugprone-use-after-move)
+
+    // Assigning to an open port writes its pending output and restores the
+    // settings of its device.
+    int other_master_fd = -1 ;
+    SerialPortT<> other_serial_port {openPseudoTerminal(other_master_fd)} ;
+    other_serial_port.WriteByte('a') ;
+
+    termios other_port_settings {} ;
+    ASSERT_EQ(tcgetattr(other_master_fd, &other_port_settings), 0) ;
+    ASSERT_EQ(other_port_settings.c_lflag, 0U) ;
+
+    other_serial_port = std::move(serial_port) ;
+    ASSERT_TRUE(other_serial_port.IsOpen()) ;
+    ASSERT_EQ(readPseudoTerminal(other_master_fd, 1000), "a") ;
+    ASSERT_EQ(tcgetattr(other_master_fd, &other_port_settings), 0) ;
+    ASSERT_NE(other_port_settings.c_lflag, 0U) ;
+
+    close(other_master_fd) ;
+}
+
+void
+SerialPortTUnitTests::testSerialPortTReadWrite()
+{
+    SerialPortT<> serial_port {slaveFileName} ;
+
+    // Output stays in the put buffer until Sync().
+    serial_port.WriteByte('a') ;
+    serial_port.Write(std::string("bc")) ;
+    serial_port.Write(DataBuffer {'d'}) ;
+    ASSERT_EQ(readPseudoTerminal(masterFileDescriptor, 50), "") ;
+    ASSERT_TRUE(serial_port.Sync()) ;
+    ASSERT_EQ(readPseudoTerminal(masterFileDescriptor, 1000), "abcd") ;
+
+    // A read that has to wait writes the pending output first.
+    serial_port.Write(std::string("ping")) ;
+    char read_byte = 0 ;
+    ASSERT_THROW(serial_port.ReadByte(read_byte, 10), ReadTimeout) ;
+    ASSERT_EQ(readPseudoTerminal(masterFileDescriptor, 1000), "ping") ;
+
+    const std::string pong = "pong!" ;
+    ASSERT_EQ(write(masterFileDescriptor, pong.data(), pong.size()), 5) ;
+
+    ASSERT_TRUE(serial_port.ReadByte(read_byte, 1000)) ;
+    ASSERT_EQ(read_byte, 'p') ;
+
+    std::string data_string {} ;
+    ASSERT_TRUE(serial_port.Read(data_string, 3, 1000)) ;
+    ASSERT_EQ(data_string, "ong") ;
+    ASSERT_TRUE(serial_port.IsDataAvailable()) ;
+    ASSERT_EQ(serial_port.GetNumberOfBytesAvailable(), 1U) ;
+
+    // On timeout, the data received so far is returned.
+    DataBuffer data_buffer {} ;
+    ASSERT_THROW(serial_port.Read(data_buffer, 2, 50), ReadTimeout) ;
+    ASSERT_EQ(data_buffer, DataBuffer {'!'}) ;
+    ASSERT_FALSE(serial_port.IsDataAvailable()) ;
+
+    // Without a byte count, Read() returns what is available.
+    ASSERT_EQ(write(masterFileDescriptor, pong.data(), pong.size()), 5) ;
+    usleep(readBufferDelay) ;
+    ASSERT_TRUE(serial_port.Read(data_string)) ;
+    ASSERT_EQ(data_string, pong) ;
+
+    // Flushing the input discards the get buffer too.
+    ASSERT_EQ(write(masterFileDescriptor, pong.data(), pong.size()), 5) ;
+    ASSERT_TRUE(serial_port.ReadByte(read_byte, 1000)) ;
+    usleep(readBufferDelay) ;
+    ASSERT_TRUE(serial_port.FlushInputBuffer()) ;
+    ASSERT_EQ(serial_port.GetNumberOfBytesAvailable(), 0U) ;
+
+    // Close() writes pending output.
+    serial_port.Write(std::string("bye")) ;
+    ASSERT_TRUE(serial_port.Close()) ;
+    ASSERT_EQ(readPseudoTerminal(masterFileDescriptor, 1000), "bye") ;
+    ASSERT_THROW(serial_port.WriteByte('x'), NotOpen) ;
+    ASSERT_THROW(serial_port.ReadByte(read_byte), NotOpen) ;
+}
+
+void
+SerialPortTUnitTests::testSerialPortTPolicies()
+{
+    using NonThrowingSerialPort = SerialPortT<PosixIoBackend, NoWaitTimeout, ReturnErrorCode> ;
+
+    NonThrowingSerialPort serial_port {} ;
+    ASSERT_FALSE(serial_port.Open("/dev/libserial-does-not-exist")) ;
+    ASSERT_EQ(serial_port.GetLastError(), SerialPortError::OPEN_FAILED) ;
+    ASSERT_EQ(serial_port.GetLastErrorNumber(), ENOENT) ;
+
+    char read_byte = 0 ;
+    ASSERT_FALSE(serial_port.ReadByte(read_byte)) ;
+    ASSERT_EQ(serial_port.GetLastError(), SerialPortError::NOT_OPEN) ;
+
+    serial_port.ClearError() ;
+    ASSERT_TRUE(serial_port.Open(slaveFileName)) ;
+    ASSERT_EQ(serial_port.GetLastError(), SerialPortError::NONE) ;
+
+    // NoWaitTimeout ignores the requested timeout.
+    const auto start_time = getTimeInMilliSeconds() ;
+    ASSERT_FALSE(serial_port.ReadByte(read_byte, 1000)) ;
+    ASSERT_LT(getTimeInMilliSeconds() - start_time, 500U) ;
+    ASSERT_EQ(serial_port.GetLastError(), SerialPortError::READ_TIMEOUT) ;
+
+    ASSERT_EQ(write(masterFileDescriptor, "z", 1), 1) ;
+    usleep(readBufferDelay) ;
+    ASSERT_TRUE(serial_port.ReadByte(read_byte)) ;
+    ASSERT_EQ(read_byte, 'z') ;
+
+    // A hang-up of the other end is reported as an error.
+    close(masterFileDescriptor) ;
+    masterFileDescriptor = -1 ;
+    ASSERT_FALSE(serial_port.ReadByte(read_byte)) ;
+    ASSERT_EQ(serial_port.GetLastError(), SerialPortError::SYSTEM_ERROR) ;
+    ASSERT_EQ(serial_port.GetLastErrorNumber(), EIO) ;
+    slaveFileName = openPseudoTerminal(masterFileDescriptor) ;
+
+    // PollTimeout waits for the requested time.
+    SerialPortT<> throwing_serial_port {slaveFileName} ;
+    const auto poll_start_time = getTimeInMilliSeconds() ;
+    ASSERT_THROW(throwing_serial_port.ReadByte(read_byte, timeOutMilliseconds), ReadTimeout) ;
+    ASSERT_GE(getTimeInMilliSeconds() - poll_start_time, timeOutMilliseconds) ;
+}
+
+void
+SerialPortTUnitTests::testSerialPortTSmallBuffer()
+{
+    SerialPortT<PosixIoBackend, PollTimeout, ThrowOnError, 4> serial_port {slaveFileName} ;
+
+    // The fifth byte does not fit and writes the full put buffer.
+    for (const char character : std::string("abcde"))
+    {
+        serial_port.WriteByte(character) ;
+    }
+    ASSERT_EQ(readPseudoTerminal(masterFileDescriptor, 1000), "abcd") ;
+
+    // Blocks larger than the buffer are written immediately.
+    serial_port.Write(std::string("0123456789")) ;
+    ASSERT_EQ(readPseudoTerminal(masterFileDescriptor, 1000), "e0123456789") ;
+
+    const std::string data = "0123456789" ;
+    ASSERT_EQ(write(masterFileDescriptor, data.data(), data.size()), 10) ;
+
+    std::string data_string {} ;
+    ASSERT_TRUE(serial_port.Read(data_string, data.size(), 1000)) ;
+    ASSERT_EQ(data_string, data) ;
+}
+
+TEST_F(SerialPortTUnitTests, testSerialPortTOpenClose)
+{
+    SCOPED_TRACE("SerialPortT Open() and Close() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortTOpenClose() ;
+    }
+}
+
+TEST_F(SerialPortTUnitTests, testSerialPortTReadWrite)
+{
+    SCOPED_TRACE("SerialPortT Read and Write Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortTReadWrite() ;
+    }
+}
+
+TEST_F(SerialPortTUnitTests, testSerialPortTPolicies)
+{
+    SCOPED_TRACE("SerialPortT Policies Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortTPolicies() ;
+    }
+}
+
+TEST_F(SerialPortTUnitTests, testSerialPortTSmallBuffer)
+{
+    SCOPED_TRACE("SerialPortT Small Buffer Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortTSmallBuffer() ;
+    }
+}
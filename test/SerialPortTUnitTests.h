@@ -0,0 +1,99 @@
+/******************************************************************************
+ * @file SerialPortTUnitTests.h                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialPortT.h"
+
+#include <gtest/gtest.h>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialPortTUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialPortTUnitTests() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialPortTUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests for correct functionality of the Open() and Close() methods.
+         */
+        void testSerialPortTOpenClose() ;
+
+        /**
+         * @brief Tests that WriteByte() and Write() buffer output until Sync()
+         *        or a read that has to wait, and that ReadByte() and Read()
+         *        drain the get buffer before reading the serial port again.
+         */
+        void testSerialPortTReadWrite() ;
+
+        /**
+         * @brief Tests the ThrowOnError and ReturnErrorCode error policies
+         *        and the PollTimeout and NoWaitTimeout timeout policies.
+         */
+        void testSerialPortTPolicies() ;
+
+        /**
+         * @brief Tests that a SerialPortT with a tiny buffer writes data that
+         *        does not fit into its put buffer directly.
+         */
+        void testSerialPortTSmallBuffer() ;
+
+        /**
+         * @brief File descriptor of the master side of the pseudo terminal.
+         */
+        int masterFileDescriptor {-1} ;
+
+        /**
+         * @brief File name of the slave side of the pseudo terminal.
+         */
+        std::string slaveFileName {} ;
+
+    } ; // class SerialPortTUnitTests
+
+} // namespace LibSerial
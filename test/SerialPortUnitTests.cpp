@@ -34,7 +34,10 @@
 #include "SerialPortUnitTests.h"
 #include "UnitTests.h"
 
+#include <array>
 #include <chrono>
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
 #include <thread>
 #include <unistd.h>
@@ -229,6 +232,112 @@ SerialPortUnitTests::testSerialPortDrainWriteBuffer()
     ASSERT_FALSE(serialPort2.IsOpen()) ;
 }
 
+void
+SerialPortUnitTests::testSerialPortDrainWriteBufferTimeout()
+{
+    ASSERT_THROW(serialPort1.DrainWriteBuffer(1), NotOpen) ;
+    ASSERT_THROW(serialPort1.GetNumberOfBytesQueuedForOutput(), NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    serialPort1.FlushIOBuffers() ;
+    serialPort2.FlushIOBuffers() ;
+
+    ASSERT_EQ(serialPort1.GetNumberOfBytesQueuedForOutput(), 0) ;
+
+    serialPort1.Write(writeString1) ;
+
+    ASSERT_LE(serialPort1.GetNumberOfBytesQueuedForOutput(),
+              static_cast<int>(writeString1.size())) ;
+
+    // The string is transmitted well within one second at 115200 baud.
+    ASSERT_TRUE(serialPort1.DrainWriteBuffer(1000)) ;
+    ASSERT_EQ(serialPort1.GetNumberOfBytesQueuedForOutput(), 0) ;
+
+    // Allow time for the read buffers to show that data is available.
+    usleep(readBufferDelay) ;
+
+    ASSERT_TRUE(serialPort2.IsDataAvailable()) ;
+
+    serialPort1.FlushIOBuffers() ;
+    serialPort2.FlushIOBuffers() ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortDrainWriteBufferStalled()
+{
+    int master_fd = -1 ;
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+
+    // Fill the pseudo terminal while its master side is not read, which
+    // stalls the output like flow control does.
+    // The kernel moves the data to the master side in the background, so
+    // fill until no more space becomes free.
+    const std::string fill_data(4096, 'x') ;
+    size_t number_of_bytes_filled = 0 ;
+    size_t previous_number_of_bytes_filled = 0 ;
+
+    do
+    {
+        previous_number_of_bytes_filled = number_of_bytes_filled ;
+
+        for (size_t fill_size = fill_data.size() ; fill_size > 0 ; fill_size /= 2)
+        {
+            ssize_t write_result = 0 ;
+
+            while ((write_result = write(serialPort1.GetFileDescriptor(),
+                                         fill_data.data(),
+                                         fill_size)) > 0)
+            {
+                number_of_bytes_filled += static_cast<size_t>(write_result) ;
+            }
+
+            ASSERT_EQ(errno, EAGAIN) ;
+        }
+
+        usleep(20000) ;
+    }
+    while (number_of_bytes_filled != previous_number_of_bytes_filled) ;
+
+    // The coalesced data cannot be written before the deadline.
+    serialPort1.SetWriteCoalescing(64) ;
+    serialPort1.Write(std::string {"stalled"}) ;
+
+    const auto start_time = std::chrono::steady_clock::now() ;
+    ASSERT_FALSE(serialPort1.DrainWriteBuffer(100)) ;
+    const auto elapsed_time = std::chrono::steady_clock::now() - start_time ;
+
+    ASSERT_GE(elapsed_time, std::chrono::milliseconds(100)) ;
+    ASSERT_LT(elapsed_time, std::chrono::milliseconds(500)) ;
+
+    // Once the master side has been read, the data is written.
+    size_t number_of_bytes_read = 0 ;
+
+    while (number_of_bytes_read < number_of_bytes_filled)
+    {
+        const auto data = readPseudoTerminal(master_fd, 1000) ;
+        ASSERT_FALSE(data.empty()) ;
+        number_of_bytes_read += data.size() ;
+    }
+
+    ASSERT_TRUE(serialPort1.DrainWriteBuffer(1000)) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "stalled") ;
+
+    serialPort1.SetWriteCoalescing(0) ;
+    serialPort1.Close() ;
+    close(master_fd) ;
+}
+
 void
 SerialPortUnitTests::testSerialPortFlushInputBuffer()
 {
@@ -882,8 +991,603 @@ SerialPortUnitTests::testSerialPortGetAvailableSerialPorts()
     ASSERT_FALSE(serialPort1.IsOpen()) ;
     ASSERT_FALSE(serialPort2.IsOpen()) ;
 }
+
+void
+SerialPortUnitTests::testSerialPortSetLowLatency()
+{
+    int master_fd = -1 ;
+    const auto slave_name = openPseudoTerminal(master_fd) ;
+
+    // Emulate the sysfs layout of a USB-serial adapter with a latency_timer.
+    const auto sysfs_root = createTemporaryDirectory() ;
+    const auto device_name = slave_name.substr(slave_name.find_last_of('/') + 1) ;
+    const auto device_path = sysfs_root + "/class/tty/" + device_name + "/device" ;
+    const auto latency_timer_path = device_path + "/latency_timer" ;
+
+    makeDirectory(device_path) ;
+    writeFile(latency_timer_path, "16\n") ;
+
+    const auto read_latency_timer = [&latency_timer_path]()
+    {
+        std::ifstream latency_timer_file {latency_timer_path} ;
+        int latency_timer = -1 ;
+        latency_timer_file >> latency_timer ;
+        return latency_timer ;
+    } ;
+
+    ASSERT_THROW(serialPort1.SetLowLatency(true), NotOpen) ;
+
+    serialPort1.SetSysfsRoot(sysfs_root) ;
+    serialPort1.Open(slave_name) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    // Pseudo terminals do not support TIOCGSERIAL, so only the
+    // latency_timer can be adjusted.
+    auto status = serialPort1.SetLowLatency(true) ;
+    ASSERT_FALSE(status.asyncLowLatency) ;
+    ASSERT_TRUE(status.latencyTimer) ;
+    ASSERT_EQ(status.latencyTimerMs, LATENCY_TIMER_LOW_LATENCY_MS) ;
+    ASSERT_EQ(read_latency_timer(), LATENCY_TIMER_LOW_LATENCY_MS) ;
+
+    status = serialPort1.SetLowLatency(false) ;
+    ASSERT_TRUE(status.latencyTimer) ;
+    ASSERT_EQ(status.latencyTimerMs, 16) ;
+    ASSERT_EQ(read_latency_timer(), 16) ;
+
+    // The original latency_timer is restored when the port is closed.
+    serialPort1.SetLowLatency(true) ;
+    serialPort1.Close() ;
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_EQ(read_latency_timer(), 16) ;
+
+    // Without a latency_timer no mechanism is applied.
+    serialPort1.SetSysfsRoot(sysfs_root + "/missing") ;
+    serialPort1.Open(slave_name) ;
+    status = serialPort1.SetLowLatency(true) ;
+    ASSERT_FALSE(status.asyncLowLatency) ;
+    ASSERT_FALSE(status.latencyTimer) ;
+    ASSERT_EQ(status.latencyTimerMs, -1) ;
+    serialPort1.Close() ;
+
+    close(master_fd) ;
+    removeDirectory(sysfs_root) ;
+}
 #endif
 
+void
+SerialPortUnitTests::testSerialPortAutoReconnect()
+{
+    // A symbolic link stands in for the stable by-id path of the device.
+    const auto link_directory = createTemporaryDirectory() ;
+    const auto link_path = link_directory + "/serial-port" ;
+
+    int master_fd = -1 ;
+    makeSymbolicLink(openPseudoTerminal(master_fd), link_path) ;
+
+    std::vector<ConnectionEvent> connection_events {} ;
+    serialPort1.SetConnectionEventCallback([&connection_events](const ConnectionEvent connectionEvent)
+                                           {
+                                               connection_events.push_back(connectionEvent) ;
+                                           }) ;
+
+    serialPort1.SetAutoReconnect(true, 10, 40) ;
+    serialPort1.Open(link_path) ;
+    serialPort1.SetBaudRate(BaudRate::BAUD_9600) ;
+    serialPort1.SetStopBits(StopBits::STOP_BITS_2) ;
+
+    const auto file_descriptor = serialPort1.GetFileDescriptor() ;
+    ASSERT_TRUE(serialPort1.IsConnected()) ;
+
+    // Closing the master side hangs up the device. Neither reading nor
+    // writing throws while the device is absent.
+    close(master_fd) ;
+
+    std::string read_string {} ;
+    ASSERT_THROW(serialPort1.Read(read_string, 1, 100), ReadTimeout) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort1.IsConnected()) ;
+    ASSERT_NO_THROW(serialPort1.Write(writeString1)) ;
+
+    auto statistics = serialPort1.GetStatistics() ;
+    ASSERT_EQ(statistics.disconnectCount, 1U) ;
+    ASSERT_EQ(statistics.reconnectCount, 0U) ;
+    ASSERT_EQ(statistics.bytesDiscarded, writeString1.size()) ;
+
+    // The backoff doubles from 10 ms up to 40 ms, so only a few attempts
+    // fit in the 100 ms read timeout.
+    ASSERT_GE(statistics.reconnectAttempts, 2U) ;
+    ASSERT_LE(statistics.reconnectAttempts, 5U) ;
+
+    // Settings changed while disconnected are applied on reconnection.
+    serialPort1.SetVTime(7) ;
+    ASSERT_EQ(serialPort1.GetVTime(), 7) ;
+
+    // The device reappears under a different name.
+    ASSERT_EQ(unlink(link_path.c_str()), 0) ;
+    makeSymbolicLink(openPseudoTerminal(master_fd), link_path) ;
+
+    usleep(50000) ;
+    serialPort1.Write(writeString1) ;
+
+    ASSERT_TRUE(serialPort1.IsConnected()) ;
+    ASSERT_EQ(serialPort1.GetFileDescriptor(), file_descriptor) ;
+    ASSERT_EQ(serialPort1.GetBaudRate(), BaudRate::BAUD_9600) ;
+    ASSERT_EQ(serialPort1.GetStopBits(), StopBits::STOP_BITS_2) ;
+    ASSERT_EQ(serialPort1.GetVTime(), 7) ;
+
+    std::string received_string(writeString1.size(), '\0') ;
+    size_t number_of_bytes_received = 0 ;
+    while (number_of_bytes_received < received_string.size())
+    {
+        const auto read_result = read(master_fd,
+                                      &received_string[number_of_bytes_received],
+                                      received_string.size() - number_of_bytes_received) ;
+        ASSERT_GT(read_result, 0) ;
+        number_of_bytes_received += read_result ;
+    }
+    ASSERT_EQ(received_string, writeString1) ;
+
+    ASSERT_EQ(write(master_fd, "X", 1), 1) ;
+    char read_byte = 0 ;
+    serialPort1.ReadByte(read_byte, timeOutMilliseconds) ;
+    ASSERT_EQ(read_byte, 'X') ;
+
+    statistics = serialPort1.GetStatistics() ;
+    ASSERT_EQ(statistics.disconnectCount, 1U) ;
+    ASSERT_EQ(statistics.reconnectCount, 1U) ;
+
+    const std::vector<ConnectionEvent> expected_events {ConnectionEvent::DISCONNECTED,
+                                                        ConnectionEvent::RECONNECTED} ;
+    ASSERT_EQ(connection_events, expected_events) ;
+
+    serialPort1.Close() ;
+    serialPort1.SetAutoReconnect(false) ;
+    serialPort1.SetConnectionEventCallback(nullptr) ;
+    serialPort1.ResetStatistics() ;
+    close(master_fd) ;
+
+    // Without auto-reconnect mode a hang-up throws.
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+    close(master_fd) ;
+    ASSERT_THROW(serialPort1.Read(read_string, 1, 100), std::runtime_error) ;
+    serialPort1.Close() ;
+
+    ASSERT_EQ(serialPort1.GetStatistics().disconnectCount, 0U) ;
+    removeDirectory(link_directory) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortWritePacing()
+{
+    ASSERT_THROW(serialPort1.SetWritePacing(1000, 0), std::invalid_argument) ;
+    ASSERT_FALSE(serialPort1.GetWritePacing()) ;
+
+    int master_fd = -1 ;
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+    serialPort1.ResetStatistics() ;
+
+    // After a burst of 20 bytes, the remaining 200 bytes take 100 ms.
+    serialPort1.SetWritePacing(2000, 20) ;
+    ASSERT_TRUE(serialPort1.GetWritePacing()) ;
+
+    const std::string write_string(220, 'p') ;
+
+    auto start_time = std::chrono::steady_clock::now() ;
+    serialPort1.Write(write_string) ;
+    auto elapsed_time = std::chrono::steady_clock::now() - start_time ;
+
+    ASSERT_GE(elapsed_time, std::chrono::milliseconds(90)) ;
+    ASSERT_LT(elapsed_time, std::chrono::milliseconds(1000)) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, write_string.size(), timeOutMilliseconds), write_string) ;
+
+    auto statistics = serialPort1.GetStatistics() ;
+    ASSERT_GT(statistics.pacingDelayCount, 0U) ;
+    ASSERT_GE(statistics.pacingDelayUs, 80000U) ;
+
+    // Each WriteByte() call waits for the inter-frame gap.
+    serialPort1.SetWritePacing(0, 1, 30000) ;
+    ASSERT_TRUE(serialPort1.GetWritePacing()) ;
+
+    start_time = std::chrono::steady_clock::now() ;
+    serialPort1.WriteByte('a') ;
+    serialPort1.WriteByte('b') ;
+    serialPort1.WriteByte('c') ;
+    elapsed_time = std::chrono::steady_clock::now() - start_time ;
+
+    ASSERT_GE(elapsed_time, std::chrono::milliseconds(60)) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 3, timeOutMilliseconds), "abc") ;
+
+    // A pacing wait can be cancelled.
+    serialPort1.Cancel() ;
+    ASSERT_THROW(serialPort1.WriteByte('d'), OperationCancelled) ;
+    serialPort1.ResetCancel() ;
+
+    serialPort1.SetWritePacing(0) ;
+    ASSERT_FALSE(serialPort1.GetWritePacing()) ;
+
+    serialPort1.Close() ;
+    close(master_fd) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortWriteCoalescing()
+{
+    // A flush delay requires thread-safe mode.
+    ASSERT_THROW(serialPort1.SetWriteCoalescing(16, 1000), std::logic_error) ;
+    ASSERT_FALSE(serialPort1.GetWriteCoalescing()) ;
+
+    int master_fd = -1 ;
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+
+    serialPort1.SetWriteCoalescing(16) ;
+    ASSERT_TRUE(serialPort1.GetWriteCoalescing()) ;
+
+    // Small writes are held until Flush().
+    for (const char write_byte : std::string {"0123456789"})
+    {
+        serialPort1.WriteByte(write_byte) ;
+    }
+    ASSERT_TRUE(readPseudoTerminal(master_fd, 20).empty()) ;
+
+    serialPort1.Flush() ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 10, timeOutMilliseconds), "0123456789") ;
+
+    // A full buffer is written at once.
+    for (const char write_byte : std::string {"abcdefghijklmnop"})
+    {
+        serialPort1.WriteByte(write_byte) ;
+    }
+    ASSERT_EQ(readPseudoTerminal(master_fd, 16, timeOutMilliseconds), "abcdefghijklmnop") ;
+
+    // Pending data is written before data that does not fit.
+    serialPort1.Write(std::string {"xyz"}) ;
+    serialPort1.Write(writeString1) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 3 + writeString1.size(), timeOutMilliseconds), "xyz" + writeString1) ;
+
+    // DrainWriteBuffer() writes the pending data.
+    serialPort1.Write(std::string {"drain"}) ;
+    serialPort1.DrainWriteBuffer() ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 5, timeOutMilliseconds), "drain") ;
+
+    // With a flush delay, a background thread writes the pending data.
+    serialPort1.SetThreadSafe(true) ;
+    serialPort1.SetWriteCoalescing(64, 50000) ;
+    ASSERT_THROW(serialPort1.SetThreadSafe(false), std::logic_error) ;
+
+    const auto start_time = std::chrono::steady_clock::now() ;
+    serialPort1.Write(std::string {"delay"}) ;
+    ASSERT_TRUE(readPseudoTerminal(master_fd, 10).empty()) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 5, timeOutMilliseconds), "delay") ;
+    ASSERT_GE(std::chrono::steady_clock::now() - start_time, std::chrono::milliseconds(45)) ;
+
+    // Disabling write coalescing writes the pending data.
+    serialPort1.Write(std::string {"off"}) ;
+    serialPort1.SetWriteCoalescing(0) ;
+    ASSERT_FALSE(serialPort1.GetWriteCoalescing()) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 3, timeOutMilliseconds), "off") ;
+
+    serialPort1.SetThreadSafe(false) ;
+    serialPort1.Close() ;
+    close(master_fd) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortTryWrite()
+{
+    const std::string write_string(100, 't') ;
+
+    ASSERT_THROW(serialPort1.TryWrite(write_string.data(), write_string.size()), NotOpen) ;
+
+    int master_fd = -1 ;
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+
+    // Without write pacing, the data is written at once.
+    ASSERT_EQ(serialPort1.GetWritePacingDelay(write_string.size()), 0U) ;
+    ASSERT_EQ(serialPort1.TryWrite(write_string.data(), write_string.size()), write_string.size()) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, write_string.size(), timeOutMilliseconds), write_string) ;
+
+    // Write pacing lets the first burst through and holds back the rest
+    // without waiting.
+    serialPort1.SetWritePacing(1000, 10) ;
+
+    ASSERT_EQ(serialPort1.TryWrite(write_string.data(), write_string.size()), 10U) ;
+
+    const auto start_time = std::chrono::steady_clock::now() ;
+    ASSERT_EQ(serialPort1.TryWrite(write_string.data(), write_string.size()), 0U) ;
+    ASSERT_LT(std::chrono::steady_clock::now() - start_time, std::chrono::milliseconds(5)) ;
+
+    const auto pacing_delay_us = serialPort1.GetWritePacingDelay(90) ;
+    ASSERT_GT(pacing_delay_us, 0U) ;
+    ASSERT_LE(pacing_delay_us, 10000U) ;
+
+    usleep(static_cast<useconds_t>(pacing_delay_us)) ;
+    ASSERT_EQ(serialPort1.TryWrite(write_string.data(), 90), 10U) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 20, timeOutMilliseconds), std::string(20, 't')) ;
+
+    serialPort1.SetWritePacing(0) ;
+
+    // Data collected by write coalescing is written first.
+    serialPort1.SetWriteCoalescing(16) ;
+    serialPort1.Write(std::string {"abc"}) ;
+    ASSERT_EQ(serialPort1.TryWrite("def", 3), 3U) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 6, timeOutMilliseconds), "abcdef") ;
+    serialPort1.SetWriteCoalescing(0) ;
+
+    serialPort1.Close() ;
+    close(master_fd) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortReadIntoWriteBuffer()
+{
+    char read_buffer[16] {} ;
+    ASSERT_THROW(serialPort1.ReadInto(read_buffer, sizeof(read_buffer)), NotOpen) ;
+    ASSERT_THROW(serialPort1.Write(read_buffer, sizeof(read_buffer)), NotOpen) ;
+
+    int master_fd = -1 ;
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+
+    // Only the part of the buffer that was written is sent.
+    const std::string write_string = "ReadInto/Write" ;
+    serialPort1.Write(write_string.data(), 4) ;
+    serialPort1.Write(write_string.data(), 0) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "Read") ;
+
+    // The data available is returned without waiting for the buffer to fill.
+    ASSERT_EQ(write(master_fd, write_string.data(), write_string.size()),
+              static_cast<ssize_t>(write_string.size())) ;
+
+    size_t number_of_bytes_read = 0 ;
+
+    while (number_of_bytes_read < write_string.size())
+    {
+        const auto read_result = serialPort1.ReadInto(read_buffer + number_of_bytes_read,
+                                                      sizeof(read_buffer) - number_of_bytes_read,
+                                                      timeOutMilliseconds) ;
+        ASSERT_GT(read_result, 0U) ;
+        number_of_bytes_read += read_result ;
+    }
+
+    ASSERT_EQ(std::string(read_buffer, number_of_bytes_read), write_string) ;
+
+    // A buffer smaller than the available data is filled completely.
+    ASSERT_EQ(write(master_fd, write_string.data(), write_string.size()),
+              static_cast<ssize_t>(write_string.size())) ;
+    ASSERT_EQ(serialPort1.ReadInto(read_buffer, 4, timeOutMilliseconds), 4U) ;
+    ASSERT_EQ(std::string(read_buffer, 4), "Read") ;
+    serialPort1.FlushInputBuffer() ;
+
+    // Without data, the method returns zero once the timeout has elapsed.
+    const auto start_time = std::chrono::steady_clock::now() ;
+    ASSERT_EQ(serialPort1.ReadInto(read_buffer, sizeof(read_buffer), 20), 0U) ;
+    ASSERT_GE(std::chrono::steady_clock::now() - start_time, std::chrono::milliseconds(20)) ;
+    ASSERT_EQ(serialPort1.ReadInto(read_buffer, 0), 0U) ;
+
+    serialPort1.Close() ;
+    close(master_fd) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortInputTee()
+{
+    ASSERT_EQ(serialPort1.GetInputTee(), -1) ;
+    ASSERT_THROW(serialPort1.SetInputTee(INT16_MAX), std::runtime_error) ;
+    ASSERT_EQ(serialPort1.GetInputTee(), -1) ;
+
+    int master_fd = -1 ;
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+
+    const std::string input_string = "archived data" ;
+
+    auto read_input = [this, master_fd, &input_string]()
+    {
+        ASSERT_EQ(write(master_fd, input_string.data(), input_string.size()),
+                  static_cast<ssize_t>(input_string.size())) ;
+
+        std::string read_string {} ;
+        serialPort1.Read(read_string, input_string.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(read_string, input_string) ;
+    } ;
+
+    // A pipe receives the data read.
+    std::array<int, 2> pipe_fds {{-1, -1}} ;
+    ASSERT_EQ(pipe(pipe_fds.data()), 0) ;
+
+    serialPort1.SetInputTee(pipe_fds[1]) ;
+    ASSERT_EQ(serialPort1.GetInputTee(), pipe_fds[1]) ;
+    read_input() ;
+
+    std::string teed_string(input_string.size(), '\0') ;
+    ASSERT_EQ(read(pipe_fds[0], &teed_string[0], teed_string.size()),
+              static_cast<ssize_t>(input_string.size())) ;
+    ASSERT_EQ(teed_string, input_string) ;
+
+    // A full pipe delays a read no longer than its timeout. The data is
+    // returned, and the copy that was dropped is reported by the next read.
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    const auto pipe_flags = fcntl(pipe_fds[1], F_GETFL) ;
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    ASSERT_EQ(fcntl(pipe_fds[1], F_SETFL, pipe_flags | O_NONBLOCK), 0) ;    // NOLINT (hicpp-signed-bitwise)
+
+    const std::string fill_string(4096, 'f') ;
+    while (write(pipe_fds[1], fill_string.data(), fill_string.size()) > 0)
+    {
+        // Keep writing.
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    ASSERT_EQ(fcntl(pipe_fds[1], F_SETFL, pipe_flags), 0) ;
+
+    ASSERT_EQ(write(master_fd, input_string.data(), input_string.size()),
+              static_cast<ssize_t>(input_string.size())) ;
+
+    std::string read_string {} ;
+    const auto start_time = std::chrono::steady_clock::now() ;
+    serialPort1.Read(read_string, input_string.size(), 100) ;
+    ASSERT_LT(std::chrono::steady_clock::now() - start_time, std::chrono::milliseconds(1000)) ;
+    ASSERT_EQ(read_string, input_string) ;
+
+    ASSERT_EQ(write(master_fd, input_string.data(), 1), 1) ;
+    char read_byte = 0 ;
+    ASSERT_THROW(serialPort1.ReadByte(read_byte, timeOutMilliseconds), std::runtime_error) ;
+    serialPort1.ReadByte(read_byte, timeOutMilliseconds) ;
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    ASSERT_EQ(fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK), 0) ;
+    while (read(pipe_fds[0], &teed_string[0], teed_string.size()) > 0)
+    {
+        // Keep reading.
+    }
+
+    // A file receives the data read, also when opened with O_APPEND.
+    const auto temporary_directory = createTemporaryDirectory() ;
+    const auto file_path = temporary_directory + "/input" ;
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    const auto file_fd = open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600) ;
+    ASSERT_GE(file_fd, 0) ;
+
+    serialPort1.SetInputTee(file_fd) ;
+    read_input() ;
+    close(file_fd) ;
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    const auto append_fd = open(file_path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC) ;
+    ASSERT_GE(append_fd, 0) ;
+
+    serialPort1.SetInputTee(append_fd) ;
+    read_input() ;
+
+    // Nothing is copied once the input tee is removed.
+    serialPort1.SetInputTee(-1) ;
+    read_input() ;
+    close(append_fd) ;
+
+    std::ifstream input_file {file_path} ;
+    const std::string file_contents {std::istreambuf_iterator<char>(input_file),
+                                     std::istreambuf_iterator<char>()} ;
+    ASSERT_EQ(file_contents, input_string + input_string) ;
+
+    // A failure to write to the input tee is thrown by the next read, and
+    // does not lose the data read.
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+    const auto read_only_fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC) ;
+    ASSERT_GE(read_only_fd, 0) ;
+
+    serialPort1.SetInputTee(read_only_fd) ;
+    read_input() ;
+    ASSERT_EQ(write(master_fd, input_string.data(), 1), 1) ;
+    ASSERT_THROW(serialPort1.ReadByte(read_byte, timeOutMilliseconds), std::runtime_error) ;
+
+    serialPort1.SetInputTee(-1) ;
+    serialPort1.Close() ;
+    close(read_only_fd) ;
+    close(pipe_fds[0]) ;
+    close(pipe_fds[1]) ;
+    close(master_fd) ;
+    removeDirectory(temporary_directory) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortSendFile()
+{
+    const auto temporary_directory = createTemporaryDirectory() ;
+    const auto file_path = temporary_directory + "/firmware" ;
+
+    std::string file_contents(300 * 1024 + 123, '\0') ;
+
+    for (size_t i = 0 ; i < file_contents.size() ; i++)
+    {
+        file_contents[i] = static_cast<char>(i % 251) ;
+    }
+
+    writeFile(file_path, file_contents) ;
+
+    ASSERT_THROW(serialPort1.SendFile(file_path), NotOpen) ;
+
+    int master_fd = -1 ;
+    serialPort1.Open(openPseudoTerminal(master_fd)) ;
+
+    ASSERT_THROW(serialPort1.SendFile(temporary_directory + "/missing"), std::runtime_error) ;
+    ASSERT_THROW(serialPort1.SendFile(temporary_directory), std::invalid_argument) ;
+
+    SendFileOptions send_file_options {} ;
+    send_file_options.chunkSize = 0 ;
+    ASSERT_THROW(serialPort1.SendFile(file_path, send_file_options), std::invalid_argument) ;
+
+    // The device side reads concurrently, as the file does not fit into
+    // the buffers of the pseudo terminal.
+    std::string received_string {} ;
+
+    std::thread receive_thread {[this, master_fd, &received_string, &file_contents]()
+    {
+        while (received_string.size() < file_contents.size())
+        {
+            const auto data = readPseudoTerminal(master_fd, 1000) ;
+
+            if (data.empty())
+            {
+                return ;
+            }
+
+            received_string += data ;
+        }
+    }} ;
+
+    std::vector<size_t> progress {} ;
+    send_file_options.chunkSize = 64 * 1024 ;
+    send_file_options.progressCallback = [&progress, &file_contents](const size_t numberOfBytesSent,
+                                                                     const size_t fileSize)
+    {
+        ASSERT_EQ(fileSize, file_contents.size()) ;
+        progress.push_back(numberOfBytesSent) ;
+    } ;
+
+    // The thread is joined on every path, as destroying it unjoined would
+    // terminate the test.
+    try
+    {
+        serialPort1.SendFile(file_path, send_file_options) ;
+    }
+    catch (...)
+    {
+        receive_thread.join() ;
+        throw ;
+    }
+
+    receive_thread.join() ;
+
+    ASSERT_EQ(received_string, file_contents) ;
+    ASSERT_EQ(progress.size(), 5U) ;
+    ASSERT_EQ(progress.front(), send_file_options.chunkSize) ;
+    ASSERT_EQ(progress.back(), file_contents.size()) ;
+
+    // A cancellation ends the transfer after the current chunk. The
+    // progress reported includes data held back by write coalescing.
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE)) ;
+    serialPort1.SetWriteCoalescing(2 * page_size) ;
+
+    progress.clear() ;
+    send_file_options.progressCallback = [this, master_fd, &progress](const size_t numberOfBytesSent,
+                                                                      const size_t /* fileSize */)
+    {
+        ASSERT_FALSE(readPseudoTerminal(master_fd, timeOutMilliseconds).empty()) ;
+        progress.push_back(numberOfBytesSent) ;
+        serialPort1.Cancel() ;
+    } ;
+
+    // The chunk size is rounded up to the page size.
+    send_file_options.chunkSize = 1 ;
+    ASSERT_THROW(serialPort1.SendFile(file_path, send_file_options), OperationCancelled) ;
+    ASSERT_EQ(progress, std::vector<size_t> {page_size}) ;
+    serialPort1.ResetCancel() ;
+    serialPort1.SetWriteCoalescing(0) ;
+
+    serialPort1.Close() ;
+    close(master_fd) ;
+    removeDirectory(temporary_directory) ;
+}
+
 void
 SerialPortUnitTests::testSerialPortReadDataBufferWriteDataBuffer()
 {
@@ -1153,6 +1857,26 @@ TEST_F(SerialPortUnitTests, testSerialPortDrainWriteBuffer)
     }
 }
 
+TEST_F(SerialPortUnitTests, testSerialPortDrainWriteBufferTimeout)
+{
+    SCOPED_TRACE("Serial Port DrainWriteBuffer() With Timeout Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortDrainWriteBufferTimeout() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortDrainWriteBufferStalled)
+{
+    SCOPED_TRACE("Serial Port DrainWriteBuffer() With Stalled Output Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortDrainWriteBufferStalled() ;
+    }
+}
+
 TEST_F(SerialPortUnitTests, testSerialPortFlushInputBuffer)
 {
     SCOPED_TRACE("Serial Port FlushInputBuffer() Test") ;
@@ -1343,8 +2067,88 @@ TEST_F(SerialPortUnitTests, testSerialPortGetAvailableSerialPorts)
         testSerialPortGetAvailableSerialPorts() ;
     }
 }
+
+TEST_F(SerialPortUnitTests, testSerialPortSetLowLatency)
+{
+    SCOPED_TRACE("Serial Port SetLowLatency() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortSetLowLatency() ;
+    }
+}
 #endif
 
+TEST_F(SerialPortUnitTests, testSerialPortAutoReconnect)
+{
+    SCOPED_TRACE("Serial Port SetAutoReconnect() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortAutoReconnect() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortWritePacing)
+{
+    SCOPED_TRACE("Serial Port SetWritePacing() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortWritePacing() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortWriteCoalescing)
+{
+    SCOPED_TRACE("Serial Port SetWriteCoalescing() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortWriteCoalescing() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortTryWrite)
+{
+    SCOPED_TRACE("Serial Port TryWrite() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortTryWrite() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortReadIntoWriteBuffer)
+{
+    SCOPED_TRACE("Serial Port ReadInto() and Write(const char*, size_t) Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReadIntoWriteBuffer() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortInputTee)
+{
+    SCOPED_TRACE("Serial Port SetInputTee() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortInputTee() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortSendFile)
+{
+    SCOPED_TRACE("Serial Port SendFile() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortSendFile() ;
+    }
+}
+
 TEST_F(SerialPortUnitTests, testSerialPortReadDataBufferWriteDataBuffer)
 {
     SCOPED_TRACE("Serial Port Read(DataBuffer) and Write(DataBuffer) Test") ;
@@ -86,6 +86,18 @@ namespace LibSerial
          */
         void testSerialPortDrainWriteBuffer() ;
 
+        /**
+         * @brief Tests correct functionality for draining the write buffer
+         *        with a timeout and for querying the output queue depth.
+         */
+        void testSerialPortDrainWriteBufferTimeout() ;
+
+        /**
+         * @brief Tests that draining the write buffer with a timeout returns
+         *        false in time while the output is stalled.
+         */
+        void testSerialPortDrainWriteBufferStalled() ;
+
         /**
          * @brief Tests correct functionality for draining the hardware input (read) buffer using tcflush() ;
          */
@@ -181,8 +193,51 @@ namespace LibSerial
          * @brief Tests for correct functionality of the GetAvailableSerialPorts() method.
          */
         void testSerialPortGetAvailableSerialPorts() ;
+
+        /**
+         * @brief Tests for correct functionality of the SetLowLatency() method.
+         */
+        void testSerialPortSetLowLatency() ;
 #endif
 
+        /**
+         * @brief Tests for correct functionality of the SetAutoReconnect() method.
+         */
+        void testSerialPortAutoReconnect() ;
+
+        /**
+         * @brief Tests for correct functionality of the SetWritePacing() method.
+         */
+        void testSerialPortWritePacing() ;
+
+        /**
+         * @brief Tests for correct functionality of the SetWriteCoalescing() method.
+         */
+        void testSerialPortWriteCoalescing() ;
+
+        /**
+         * @brief Tests for correct functionality of the TryWrite() and
+         *        GetWritePacingDelay() methods.
+         */
+        void testSerialPortTryWrite() ;
+
+        /**
+         * @brief Tests for correct functionality of the ReadInto() and
+         *        Write(const char*, size_t) methods.
+         */
+        void testSerialPortReadIntoWriteBuffer() ;
+
+        /**
+         * @brief Tests that SetInputTee() copies the data read to pipes and
+         *        files, and that the data is still returned by Read*().
+         */
+        void testSerialPortInputTee() ;
+
+        /**
+         * @brief Tests for correct functionality of the SendFile() method.
+         */
+        void testSerialPortSendFile() ;
+
         /**
          * @brief Tests for correct functionality of the ReadDataBuffer() and WriteDataBuffer() methods.
          */
@@ -0,0 +1,363 @@
+/******************************************************************************
+ * @file SerialReliableLinkUnitTests.cpp                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialReliableLinkUnitTests.h"
+#include "UnitTests.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace LibSerial;
+
+namespace
+{
+    /**
+     * @brief The time in milliseconds allowed for a message or a flush.
+     */
+    constexpr size_t TRANSFER_TIMEOUT_MS = 10000 ;
+} // namespace
+
+SerialReliableLinkUnitTests::SerialReliableLinkUnitTests()
+{
+    // Empty
+}
+
+SerialReliableLinkUnitTests::~SerialReliableLinkUnitTests()
+{
+    // Empty
+}
+
+std::vector<DataBuffer>
+SerialReliableLinkUnitTests::transferMessages(SerialReliableLink&            senderLink,
+                                              SerialReliableLink&            receiverLink,
+                                              const std::vector<DataBuffer>& messages)
+{
+    std::vector<DataBuffer> received_messages {} ;
+
+    runTransfer([&]
+                {
+                    for (const auto& message : messages)
+                    {
+                        senderLink.Send(message) ;
+                    }
+
+                    senderLink.Flush(TRANSFER_TIMEOUT_MS) ;
+                },
+                [&](const std::atomic<bool>& isSent)
+                {
+                    for (size_t i = 0 ; i < messages.size() ; i++)
+                    {
+                        received_messages.push_back(receiverLink.Receive(TRANSFER_TIMEOUT_MS)) ;
+                    }
+
+                    // Acknowledge the retransmissions of frames whose
+                    // acknowledgement was lost.
+                    while (not isSent)
+                    {
+                        receiverLink.ProcessEvents(1) ;
+                    }
+                }) ;
+
+    return received_messages ;
+}
+
+DataBuffer
+SerialReliableLinkUnitTests::makeMessage(const size_t size,
+                                         const size_t seed)
+{
+    const auto data = makeTestData(size, seed) ;
+    return DataBuffer(data.begin(), data.end()) ;
+}
+
+void
+SerialReliableLinkUnitTests::resetLink()
+{
+    relay->setErrorRates(0.0, 0.0) ;
+    relay->setLatency(0) ;
+
+    // Discard the data still delayed by the relay as well.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+    firstPort.FlushIOBuffers() ;
+    secondPort.FlushIOBuffers() ;
+}
+
+void
+SerialReliableLinkUnitTests::testSerialReliableLinkRoundTrip()
+{
+    ReliableLinkOptions invalid_options {} ;
+    invalid_options.windowSize = RELIABLE_LINK_WINDOW_MAXIMUM + 1 ;
+    ASSERT_THROW(SerialReliableLink(firstPort, invalid_options), std::invalid_argument) ;
+
+    invalid_options = ReliableLinkOptions {} ;
+    invalid_options.maximumPayloadSize = 0 ;
+    ASSERT_THROW(SerialReliableLink(firstPort, invalid_options), std::invalid_argument) ;
+
+    SerialReliableLink first_link {firstPort} ;
+    SerialReliableLink second_link {secondPort} ;
+
+    std::vector<DataBuffer> messages {} ;
+
+    for (const size_t size : {size_t {0},
+                              size_t {1},
+                              RELIABLE_LINK_PAYLOAD_DEFAULT - 1,
+                              RELIABLE_LINK_PAYLOAD_DEFAULT,
+                              RELIABLE_LINK_PAYLOAD_DEFAULT + 1,
+                              size_t {10000}})
+    {
+        messages.push_back(makeMessage(size, messages.size())) ;
+    }
+
+    ASSERT_EQ(transferMessages(first_link, second_link, messages), messages) ;
+    ASSERT_EQ(transferMessages(second_link, first_link, messages), messages) ;
+
+    for (const auto& link : {&first_link, &second_link})
+    {
+        const auto statistics = link->GetStatistics() ;
+        ASSERT_EQ(statistics.messagesSent, messages.size()) ;
+        ASSERT_EQ(statistics.messagesReceived, messages.size()) ;
+        ASSERT_EQ(statistics.retransmissions, 0U) ;
+        ASSERT_EQ(statistics.corruptedFrames, 0U) ;
+        ASSERT_EQ(statistics.duplicateFrames, 0U) ;
+        ASSERT_GT(statistics.framesReceived, 0U) ;
+        ASSERT_GT(statistics.smoothedRttUs, 0U) ;
+    }
+
+    // Messages are queued until they are received.
+    first_link.Send(messages[1]) ;
+    second_link.ProcessEvents(TRANSFER_TIMEOUT_MS) ;
+    first_link.Flush(TRANSFER_TIMEOUT_MS) ;
+
+    ASSERT_EQ(second_link.GetNumberOfMessagesAvailable(), 1U) ;
+    ASSERT_EQ(second_link.Receive(), messages[1]) ;
+    ASSERT_EQ(second_link.GetNumberOfMessagesAvailable(), 0U) ;
+    ASSERT_THROW(second_link.Receive(10), ReadTimeout) ;
+
+    first_link.ResetStatistics() ;
+    ASSERT_EQ(first_link.GetStatistics().messagesSent, 0U) ;
+
+    resetLink() ;
+}
+
+void
+SerialReliableLinkUnitTests::testSerialReliableLinkErrorRecovery()
+{
+    // About one in 2500 bytes is lost and as many are corrupted, in both
+    // directions, so that data frames as well as acknowledgements are
+    // lost and frames are received out of sequence.
+    relay->setLatency(2) ;
+    relay->setErrorRates(0.0004, 0.0004) ;
+
+    SerialReliableLink first_link {firstPort} ;
+    SerialReliableLink second_link {secondPort} ;
+
+    // A fixed number of messages of about 1000 bytes each bounds the work
+    // independent of how long the recovery takes.
+    std::vector<DataBuffer> messages {} ;
+
+    for (size_t i = 0 ; i < 64 ; i++)
+    {
+        messages.push_back(makeMessage((i * 397) % 2000, i)) ;
+    }
+
+    ASSERT_EQ(transferMessages(first_link, second_link, messages), messages) ;
+
+    const auto sender_statistics = first_link.GetStatistics() ;
+    const auto receiver_statistics = second_link.GetStatistics() ;
+
+    ASSERT_GT(relay->getNumberOfLostBytes(), 0U) ;
+    ASSERT_GT(relay->getNumberOfCorruptedBytes(), 0U) ;
+    ASSERT_GT(sender_statistics.retransmissions, 0U) ;
+    ASSERT_GT(receiver_statistics.corruptedFrames, 0U) ;
+    ASSERT_EQ(receiver_statistics.messagesReceived, messages.size()) ;
+
+    resetLink() ;
+}
+
+void
+SerialReliableLinkUnitTests::testSerialReliableLinkThroughput()
+{
+    // The link transfers LINE_RATE bytes per second in each direction and
+    // delays them by 5 ms.
+    firstPort.SetWritePacing(LINE_RATE, 256) ;
+    secondPort.SetWritePacing(LINE_RATE, 256) ;
+    relay->setLatency(5) ;
+
+    std::vector<DataBuffer> messages {} ;
+
+    for (size_t i = 0 ; i < 25 ; i++)
+    {
+        messages.push_back(makeMessage(LINE_RATE / 200, i)) ;
+    }
+
+    const auto message_bytes = static_cast<double>(messages.size() * messages.front().size()) ;
+
+    // The rate of the same bytes written in one piece is the reference for
+    // the window, as it is paced, delayed and slowed by the load of the
+    // machine just like the frames.
+    std::string message_data {} ;
+
+    for (const auto& message : messages)
+    {
+        message_data.append(message.begin(), message.end()) ;
+    }
+
+    const auto line_rate = measureLineRate(message_data) ;
+
+    ReliableLinkOptions stop_and_wait_options {} ;
+    stop_and_wait_options.windowSize = 1 ;
+
+    double throughputs[2] {} ;
+    size_t index = 0 ;
+
+    for (const auto& reliable_link_options : {ReliableLinkOptions {},
+                                              stop_and_wait_options})
+    {
+        SerialReliableLink first_link {firstPort, reliable_link_options} ;
+        SerialReliableLink second_link {secondPort, reliable_link_options} ;
+
+        const auto start_time = std::chrono::steady_clock::now() ;
+        ASSERT_EQ(transferMessages(first_link, second_link, messages), messages) ;
+        const auto duration = std::chrono::steady_clock::now() - start_time ;
+
+        throughputs[index] = message_bytes / std::chrono::duration<double>(duration).count() ;
+        ASSERT_LE(throughputs[index], line_rate * 1.05) ;
+        index++ ;
+
+        resetLink() ;
+        relay->setLatency(5) ;
+    }
+
+    relay->setLatency(0) ;
+    firstPort.SetWritePacing(0, 1, 0) ;
+    secondPort.SetWritePacing(0, 1, 0) ;
+
+    // The window keeps the link busy. It loses to the frame headers, CRCs
+    // and escaped bytes, and to acknowledgements delayed on a loaded
+    // machine, while stop-and-wait waits a round trip for the
+    // acknowledgement of each frame.
+    ASSERT_GE(throughputs[0], line_rate * 0.6) ;
+    ASSERT_GE(throughputs[0], throughputs[1] * 2) ;
+}
+
+void
+SerialReliableLinkUnitTests::testSerialReliableLinkRetransmitTimeout()
+{
+    relay->setLatency(10) ;
+
+    {
+        // The lower bound leaves room for scheduling delays.
+        ReliableLinkOptions reliable_link_options {} ;
+        reliable_link_options.msMinimumRetransmitTimeout = 100 ;
+
+        SerialReliableLink first_link {firstPort, reliable_link_options} ;
+        SerialReliableLink second_link {secondPort, reliable_link_options} ;
+
+        ASSERT_EQ(first_link.GetStatistics().smoothedRttUs, 0U) ;
+        ASSERT_EQ(first_link.GetStatistics().retransmitTimeoutUs, 1000000U) ;
+
+        for (size_t i = 0 ; i < 10 ; i++)
+        {
+            ASSERT_EQ(transferMessages(first_link, second_link, {makeMessage(10, i)}).size(), 1U) ;
+        }
+
+        // The round trip takes the latency in each direction.
+        const auto statistics = first_link.GetStatistics() ;
+        ASSERT_GE(statistics.smoothedRttUs, 20000U) ;
+        ASSERT_LT(statistics.smoothedRttUs, 200000U) ;
+        ASSERT_GE(statistics.retransmitTimeoutUs, statistics.smoothedRttUs) ;
+        ASSERT_GE(statistics.retransmitTimeoutUs, 100000U) ;
+        ASSERT_LT(statistics.retransmitTimeoutUs, 1000000U) ;
+        ASSERT_EQ(statistics.retransmissions, 0U) ;
+    }
+
+    // Without a peer, the frame is sent again with a backed off timeout
+    // until the link gives up.
+    ReliableLinkOptions reliable_link_options {} ;
+    reliable_link_options.msInitialRetransmitTimeout = 10 ;
+    reliable_link_options.msMaximumRetransmitTimeout = 40 ;
+    reliable_link_options.maximumRetransmissions = 3 ;
+
+    SerialReliableLink first_link {firstPort, reliable_link_options} ;
+    first_link.Send(makeMessage(10, 0)) ;
+
+    ASSERT_THROW(first_link.Flush(5), ReadTimeout) ;
+    ASSERT_THROW(first_link.Flush(), std::runtime_error) ;
+
+    const auto statistics = first_link.GetStatistics() ;
+    ASSERT_EQ(statistics.retransmissions, 3U) ;
+    ASSERT_EQ(statistics.retransmitTimeoutUs, 40000U) ;
+
+    resetLink() ;
+}
+
+TEST_F(SerialReliableLinkUnitTests, testSerialReliableLinkRoundTrip)
+{
+    SCOPED_TRACE("Serial Reliable Link Round Trip Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialReliableLinkRoundTrip() ;
+    }
+}
+
+TEST_F(SerialReliableLinkUnitTests, testSerialReliableLinkErrorRecovery)
+{
+    SCOPED_TRACE("Serial Reliable Link Error Recovery Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialReliableLinkErrorRecovery() ;
+    }
+}
+
+TEST_F(SerialReliableLinkUnitTests, testSerialReliableLinkThroughput)
+{
+    SCOPED_TRACE("Serial Reliable Link Throughput Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialReliableLinkThroughput() ;
+    }
+}
+
+TEST_F(SerialReliableLinkUnitTests, testSerialReliableLinkRetransmitTimeout)
+{
+    SCOPED_TRACE("Serial Reliable Link Retransmit Timeout Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialReliableLinkRetransmitTimeout() ;
+    }
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * @file SerialReliableLinkUnitTests.h                                        *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialReliableLink.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialReliableLinkUnitTests : public RelayedLinkUnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialReliableLinkUnitTests() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialReliableLinkUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests that messages of several sizes are transferred intact
+         *        in both directions.
+         */
+        void testSerialReliableLinkRoundTrip() ;
+
+        /**
+         * @brief Tests that messages are delivered intact and in order over
+         *        a link that loses and corrupts data.
+         */
+        void testSerialReliableLinkErrorRecovery() ;
+
+        /**
+         * @brief Compares the throughput of a sliding window with the line
+         *        rate of a paced link and with stop-and-wait.
+         */
+        void testSerialReliableLinkThroughput() ;
+
+        /**
+         * @brief Tests that the retransmission timeout adapts to the round
+         *        trip time, and that a missing peer is detected.
+         */
+        void testSerialReliableLinkRetransmitTimeout() ;
+
+        /**
+         * @brief Sends messages from one link and receives them with the
+         *        other, which keeps acknowledging until the sender has
+         *        flushed.
+         * @param senderLink The link sending the messages.
+         * @param receiverLink The link receiving the messages.
+         * @param messages The messages to be sent.
+         * @return Returns the messages received.
+         */
+        std::vector<DataBuffer> transferMessages(SerialReliableLink&            senderLink,
+                                                 SerialReliableLink&            receiverLink,
+                                                 const std::vector<DataBuffer>& messages) ;
+
+        /**
+         * @brief Makes a message from the test data of makeTestData().
+         * @param size The size of the message.
+         * @param seed The value the contents are derived from.
+         * @return Returns the message.
+         */
+        DataBuffer makeMessage(const size_t size,
+                               const size_t seed) ;
+
+        /**
+         * @brief Restores an error free link without latency and discards
+         *        the data left on it, so that the next test starts with new
+         *        links.
+         */
+        void resetLink() ;
+
+    } ; // class SerialReliableLinkUnitTests
+
+} // namespace LibSerial
@@ -35,7 +35,9 @@
 #include "UnitTests.h"
 
 #include <chrono>
+#include <fcntl.h>
 #include <iostream>
+#include <poll.h>
 #include <thread>
 #include <unistd.h>
 #include <vector>
@@ -934,6 +936,257 @@ SerialStreamUnitTests::testSerialStreamGetWriteByte()
     ASSERT_FALSE(serialStream2.IsOpen()) ;
 }
 
+void
+SerialStreamUnitTests::testSerialStreamBuffering()
+{
+    int master_fd = -1 ;
+    serialStream1.Open(openPseudoTerminal(master_fd)) ;
+    ASSERT_TRUE(serialStream1.IsOpen()) ;
+
+    // Output reaches the port at the end of each output operation by
+    // default, but is held in the put area until flushed otherwise.
+    serialStream1 << "abc" << 123 ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "abc123") ;
+
+    serialStream1 << std::nounitbuf << "def" ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 50), "") ;
+
+    serialStream1 << std::flush ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "def") ;
+    serialStream1 << std::unitbuf ;
+
+    // A single character extraction fills the get area with all the data
+    // available at the port.
+    ASSERT_EQ(write(master_fd, "xyz123", 6), 6) ;
+    usleep(readBufferDelay) ;
+
+    char read_byte = 0 ;
+    serialStream1.get(read_byte) ;
+    ASSERT_EQ(read_byte, 'x') ;
+    ASSERT_EQ(serialStream1.rdbuf()->in_avail(), 5) ;
+    ASSERT_EQ(serialStream1.GetNumberOfBytesAvailable(), 5) ;
+    ASSERT_TRUE(serialStream1.IsDataAvailable()) ;
+
+    serialStream1.putback(read_byte) ;
+    serialStream1.get(read_byte) ;
+    ASSERT_EQ(read_byte, 'x') ;
+
+    std::string read_string(5, '\0') ;
+    serialStream1.read(&read_string[0], 5) ;
+    ASSERT_EQ(read_string, "yz123") ;
+
+    // The last character read remains available for putback after the
+    // get area is refilled.
+    ASSERT_EQ(write(master_fd, "Q", 1), 1) ;
+    usleep(readBufferDelay) ;
+
+    serialStream1.get(read_byte) ;
+    ASSERT_EQ(read_byte, 'Q') ;
+    serialStream1.unget() ;
+    serialStream1.unget() ;
+    serialStream1.get(read_byte) ;
+    ASSERT_EQ(read_byte, '3') ;
+    serialStream1.get(read_byte) ;
+    ASSERT_EQ(read_byte, 'Q') ;
+    ASSERT_TRUE(serialStream1.good()) ;
+
+    // Flushing the input discards the unread contents of the get area.
+    ASSERT_EQ(write(master_fd, "abc", 3), 3) ;
+    usleep(readBufferDelay) ;
+
+    serialStream1.get(read_byte) ;
+    ASSERT_TRUE(serialStream1.IsDataAvailable()) ;
+    serialStream1.FlushInputBuffer() ;
+    ASSERT_FALSE(serialStream1.IsDataAvailable()) ;
+    ASSERT_EQ(serialStream1.GetNumberOfBytesAvailable(), 0) ;
+
+    // Without buffering, input is read one character at a time.
+    ASSERT_NE(serialStream1.rdbuf()->pubsetbuf(nullptr, 0), nullptr) ;
+    ASSERT_EQ(write(master_fd, "de", 2), 2) ;
+    usleep(readBufferDelay) ;
+
+    serialStream1.get(read_byte) ;
+    ASSERT_EQ(read_byte, 'd') ;
+    ASSERT_EQ(serialStream1.rdbuf()->in_avail(), 1) ;
+    serialStream1.get(read_byte) ;
+    ASSERT_EQ(read_byte, 'e') ;
+
+    serialStream1 << "gh" ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "gh") ;
+
+    serialStream1.Close() ;
+    close(master_fd) ;
+
+    ASSERT_FALSE(serialStream1.IsOpen()) ;
+}
+
+void
+SerialStreamUnitTests::testSerialStreamReadTimeout()
+{
+    int master_fd = -1 ;
+    serialStream1.Open(openPseudoTerminal(master_fd)) ;
+    ASSERT_TRUE(serialStream1.IsOpen()) ;
+    ASSERT_EQ(serialStream1.GetReadTimeout(), 0U) ;
+
+    // An extraction fails with eof once the read timeout elapses.
+    serialStream1.SetReadTimeout(100) ;
+    ASSERT_EQ(serialStream1.GetReadTimeout(), 100U) ;
+
+    char read_byte = 0 ;
+    const auto start_time = std::chrono::steady_clock::now() ;
+    serialStream1.get(read_byte) ;
+    const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time).count() ;
+
+    ASSERT_TRUE(serialStream1.eof()) ;
+    ASSERT_FALSE(serialStream1.bad()) ;
+    ASSERT_TRUE(serialStream1.IsReadTimedOut()) ;
+    ASSERT_GE(elapsed_ms, 100) ;
+    ASSERT_LT(elapsed_ms, 1000) ;
+
+    // Data arriving before the deadline is extracted normally.
+    serialStream1.clear() ;
+
+    std::thread writer([master_fd]()
+                       {
+                           std::this_thread::sleep_for(std::chrono::milliseconds(20)) ;
+                           ASSERT_EQ(write(master_fd, "abc\n", 4), 4) ;
+                       }) ;
+
+    std::string read_string {} ;
+    std::getline(serialStream1, read_string) ;
+    writer.join() ;
+
+    ASSERT_TRUE(serialStream1.good()) ;
+    ASSERT_FALSE(serialStream1.IsReadTimedOut()) ;
+    ASSERT_EQ(read_string, "abc") ;
+
+    // Without a read timeout, a port in non-blocking mode waits for data
+    // instead of failing as soon as none is available.
+    serialStream1.SetReadTimeout(0) ;
+    const auto fd = serialStream1.GetFileDescriptor() ;
+    ASSERT_EQ(fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK), 0) ;
+
+    writer = std::thread([master_fd]()
+                         {
+                             std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+                             ASSERT_EQ(write(master_fd, "de", 2), 2) ;
+                             std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+                             ASSERT_EQ(write(master_fd, "f\n", 2), 2) ;
+                         }) ;
+
+    std::getline(serialStream1, read_string) ;
+    writer.join() ;
+
+    ASSERT_TRUE(serialStream1.good()) ;
+    ASSERT_EQ(read_string, "def") ;
+
+    // Read errors are reported through badbit rather than as a timeout.
+    serialStream1.SetReadTimeout(100) ;
+    close(master_fd) ;
+
+    serialStream1.get(read_byte) ;
+    ASSERT_TRUE(serialStream1.bad()) ;
+    ASSERT_FALSE(serialStream1.IsReadTimedOut()) ;
+
+    serialStream1.Close() ;
+    ASSERT_FALSE(serialStream1.IsOpen()) ;
+}
+
+void
+SerialStreamUnitTests::testSerialStreamMove()
+{
+    constexpr size_t stream_count = 4 ;
+
+    std::vector<int> master_fds(stream_count, -1) ;
+    std::vector<SerialStream> serial_streams {} ;
+
+    for (size_t i = 0; i < stream_count; i++)
+    {
+        SerialStream serial_stream(openPseudoTerminal(master_fds[i])) ;
+        serial_stream.SetReadTimeout(1000) ;
+
+        // Leave unread input in the get area of each stream.
+        const std::string data = std::to_string(i) + "x" ;
+        ASSERT_EQ(write(master_fds[i], data.data(), data.size()), 2) ;
+
+        char read_byte = 0 ;
+        serial_stream.get(read_byte) ;
+        ASSERT_EQ(read_byte, '0' + static_cast<char>(i)) ;
+
+        // Growing the vector moves the streams added previously.
+        serial_streams.push_back(std::move(serial_stream)) ;
+
+        ASSERT_FALSE(serial_stream.IsOpen()) ;  // NOLINT (bugprone-use-after-move)
+        ASSERT_TRUE(serial_stream.bad()) ;      // NOLINT (bugprone-use-after-move)
+    }
+
+    for (size_t i = 0; i < stream_count; i++)
+    {
+        auto& serial_stream = serial_streams[i] ;
+        ASSERT_TRUE(serial_stream.IsOpen()) ;
+        ASSERT_TRUE(serial_stream.good()) ;
+        ASSERT_EQ(serial_stream.GetReadTimeout(), 1000U) ;
+
+        char read_byte = 0 ;
+        serial_stream.get(read_byte) ;
+        ASSERT_EQ(read_byte, 'x') ;
+
+        serial_stream << "stream" << i ;
+        ASSERT_EQ(readPseudoTerminal(master_fds[i], 1000), "stream" + std::to_string(i)) ;
+    }
+
+    // Move assignment closes the serial port of the target stream.
+    serial_streams[0] = std::move(serial_streams[1]) ;
+
+    ASSERT_TRUE(serial_streams[0].IsOpen()) ;
+    ASSERT_FALSE(serial_streams[1].IsOpen()) ;
+    ASSERT_TRUE(serial_streams[1].bad()) ;
+
+    pollfd poll_fd {master_fds[0], POLLIN, 0} ;
+    ASSERT_EQ(poll(&poll_fd, 1, 0), 1) ;
+    ASSERT_NE(poll_fd.revents & POLLHUP, 0) ;
+
+    serial_streams[0] << "moved" ;
+    ASSERT_EQ(readPseudoTerminal(master_fds[1], 1000), "moved") ;
+
+    // A moved-from stream can be opened again.
+    close(master_fds[0]) ;
+    serial_streams[1].Open(openPseudoTerminal(master_fds[0])) ;
+    ASSERT_TRUE(serial_streams[1].good()) ;
+
+    serial_streams[1] << "reopened" ;
+    ASSERT_EQ(readPseudoTerminal(master_fds[0], 1000), "reopened") ;
+
+    // Pending output moves along with a SerialStreamBuf.
+    SerialStreamBuf serial_stream_buf {} ;
+    int master_fd = -1 ;
+    serial_stream_buf.Open(openPseudoTerminal(master_fd)) ;
+    ASSERT_EQ(serial_stream_buf.sputn("ab", 2), 2) ;
+
+    SerialStreamBuf moved_stream_buf(std::move(serial_stream_buf)) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 50), "") ;
+    ASSERT_EQ(moved_stream_buf.pubsync(), 0) ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "ab") ;
+
+    serial_stream_buf = std::move(moved_stream_buf) ;
+    ASSERT_TRUE(serial_stream_buf.IsOpen()) ;
+    ASSERT_EQ(serial_stream_buf.sputn("cd", 2), 2) ;
+    serial_stream_buf.Close() ;
+    ASSERT_EQ(readPseudoTerminal(master_fd, 1000), "cd") ;
+
+    // Moving from a moved-from SerialStreamBuf is harmless.
+    SerialStreamBuf empty_stream_buf(std::move(moved_stream_buf)) ;
+    empty_stream_buf = std::move(moved_stream_buf) ;
+
+    serial_streams.clear() ;
+    close(master_fd) ;
+
+    for (const auto fd : master_fds)
+    {
+        close(fd) ;
+    }
+}
 
 TEST_F(SerialStreamUnitTests, testSerialStreamConstructors)
 {
@@ -1186,3 +1439,33 @@ TEST_F(SerialStreamUnitTests, testSerialStreamGetWriteByte)
         testSerialStreamGetWriteByte() ;
     }
 }
+
+TEST_F(SerialStreamUnitTests, testSerialStreamBuffering)
+{
+    SCOPED_TRACE("Serial Stream Buffering Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialStreamBuffering() ;
+    }
+}
+
+TEST_F(SerialStreamUnitTests, testSerialStreamReadTimeout)
+{
+    SCOPED_TRACE("Serial Stream SetReadTimeout() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialStreamReadTimeout() ;
+    }
+}
+
+TEST_F(SerialStreamUnitTests, testSerialStreamMove)
+{
+    SCOPED_TRACE("Serial Stream Move Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialStreamMove() ;
+    }
+}
@@ -189,6 +189,24 @@ namespace LibSerial
          */
         void testSerialStreamGetWriteByte() ;
 
+        /**
+         * @brief Tests the get and put areas of SerialStreamBuf together with
+         *        putback, in_avail() and the FlushInputBuffer() method.
+         */
+        void testSerialStreamBuffering() ;
+
+        /**
+         * @brief Tests for correct functionality of the SetReadTimeout() and
+         *        IsReadTimedOut() methods, and of reading in non-blocking mode.
+         */
+        void testSerialStreamReadTimeout() ;
+
+        /**
+         * @brief Tests move construction and move assignment of SerialStream
+         *        and SerialStreamBuf objects.
+         */
+        void testSerialStreamMove() ;
+
     } ; // class SerialStreamUnitTests
 
 } // namespace LibSerial
@@ -0,0 +1,258 @@
+/******************************************************************************
+ * @file SerialTransactionEngineUnitTests.cpp                                 *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialTransactionEngineUnitTests.h"
+#include "UnitTests.h"
+
+#include <map>
+#include <string>
+#include <unistd.h>
+
+using namespace LibSerial;
+
+SerialTransactionEngineUnitTests::SerialTransactionEngineUnitTests()
+{
+    serialPort.Open(openPseudoTerminal(masterFileDescriptor)) ;
+}
+
+SerialTransactionEngineUnitTests::~SerialTransactionEngineUnitTests()
+{
+    serialPort.Close() ;
+    close(masterFileDescriptor) ;
+}
+
+std::string
+SerialTransactionEngineUnitTests::readRequests(const size_t numberOfBytes)
+{
+    std::string requests {} ;
+
+    while (requests.size() < numberOfBytes)
+    {
+        const auto data = readPseudoTerminal(masterFileDescriptor, 1000) ;
+
+        if (data.empty())
+        {
+            break ;
+        }
+
+        requests += data ;
+    }
+
+    return requests ;
+}
+
+void
+SerialTransactionEngineUnitTests::writeReply(const std::string& reply)
+{
+    ASSERT_EQ(write(masterFileDescriptor, reply.data(), reply.size()),
+              static_cast<ssize_t>(reply.size())) ;
+}
+
+DataBuffer
+SerialTransactionEngineUnitTests::toDataBuffer(const std::string& data)
+{
+    return DataBuffer(data.begin(), data.end()) ;
+}
+
+void
+SerialTransactionEngineUnitTests::testSerialTransactionEngineTransact()
+{
+    ASSERT_THROW(SerialTransactionEngine(serialPort, ReplyFramer {}), std::invalid_argument) ;
+
+    SerialTransactionEngine serial_transaction_engine {serialPort, MakeLineFramer()} ;
+    ASSERT_EQ(serial_transaction_engine.GetMaximumOutstanding(), 1U) ;
+    ASSERT_THROW(serial_transaction_engine.SetMaximumOutstanding(0), std::invalid_argument) ;
+
+    // The reply is waiting in the input buffer before the request is written.
+    writeReply("OK\n") ;
+    auto serial_transaction = serial_transaction_engine.Transact(toDataBuffer("AT\r"), 1000) ;
+    ASSERT_EQ(serial_transaction.status, TransactionStatus::COMPLETED) ;
+    ASSERT_EQ(serial_transaction.request, toDataBuffer("AT\r")) ;
+    ASSERT_EQ(serial_transaction.reply, toDataBuffer("OK\n")) ;
+    ASSERT_EQ(readRequests(3), "AT\r") ;
+
+    // A reply split across reads is reassembled by the framer.
+    writeReply("ER") ;
+    const auto transaction_id = serial_transaction_engine.Submit(toDataBuffer("AT+X\r"), 1000) ;
+    ASSERT_TRUE(serial_transaction_engine.ProcessEvents(50).empty()) ;
+    ASSERT_EQ(serial_transaction_engine.GetNumberOfPendingTransactions(), 1U) ;
+    ASSERT_EQ(readRequests(5), "AT+X\r") ;
+    writeReply("ROR\n") ;
+
+    const auto serial_transactions = serial_transaction_engine.ProcessEvents(1000) ;
+    ASSERT_EQ(serial_transactions.size(), 1U) ;
+    ASSERT_EQ(serial_transactions[0].transactionId, transaction_id) ;
+    ASSERT_EQ(serial_transactions[0].reply, toDataBuffer("ERROR\n")) ;
+    ASSERT_EQ(serial_transaction_engine.GetNumberOfPendingTransactions(), 0U) ;
+
+    const auto statistics = serial_transaction_engine.GetStatistics() ;
+    ASSERT_EQ(statistics.completedCount, 2U) ;
+    ASSERT_EQ(statistics.timedOutCount, 0U) ;
+    ASSERT_LE(statistics.minimumLatencyUs, statistics.maximumLatencyUs) ;
+    ASSERT_GE(statistics.maximumLatencyUs, 50000U) ;
+    ASSERT_GE(statistics.totalLatencyUs, statistics.maximumLatencyUs) ;
+
+    serial_transaction_engine.ResetStatistics() ;
+    ASSERT_EQ(serial_transaction_engine.GetStatistics().completedCount, 0U) ;
+}
+
+void
+SerialTransactionEngineUnitTests::testSerialTransactionEnginePipelining()
+{
+    // The first byte of each reply echoes the sequence number of its request.
+    SerialTransactionEngine serial_transaction_engine {serialPort,
+                                                       MakeLineFramer(),
+                                                       MakeFieldMatcher(0, 0, 1)} ;
+    serial_transaction_engine.SetMaximumOutstanding(3) ;
+
+    std::map<TransactionId, std::string> requests {} ;
+
+    for (const auto& request : {"1a\n", "2b\n", "3c\n", "4d\n"})
+    {
+        requests[serial_transaction_engine.Submit(toDataBuffer(request), 1000)] = request ;
+    }
+
+    // Only the first three requests are written.
+    ASSERT_TRUE(serial_transaction_engine.ProcessEvents().empty()) ;
+    ASSERT_EQ(readRequests(9), "1a\n2b\n3c\n") ;
+    ASSERT_EQ(serial_transaction_engine.GetNumberOfPendingTransactions(), 4U) ;
+
+    std::map<TransactionId, std::string> replies {} ;
+
+    const auto process_replies = [this, &serial_transaction_engine, &replies](const size_t numberOfReplies)
+    {
+        for (size_t i = 0; (i < TEST_ITERATIONS) and (replies.size() < numberOfReplies); ++i)
+        {
+            for (const auto& serial_transaction : serial_transaction_engine.ProcessEvents(1000))
+            {
+                ASSERT_EQ(serial_transaction.status, TransactionStatus::COMPLETED) ;
+                replies[serial_transaction.transactionId] = std::string(serial_transaction.reply.begin(),
+                                                                        serial_transaction.reply.end()) ;
+            }
+        }
+    } ;
+
+    // Replies arriving out of order complete their own requests and make
+    // room for the fourth request.
+    writeReply("2B\n1A\n") ;
+    process_replies(2) ;
+    ASSERT_EQ(replies.size(), 2U) ;
+    ASSERT_EQ(readRequests(3), "4d\n") ;
+
+    writeReply("9Z\n4D\n3C\n") ;
+    process_replies(4) ;
+    ASSERT_EQ(replies.size(), 4U) ;
+
+    for (const auto& reply : replies)
+    {
+        ASSERT_EQ(reply.second[0], requests[reply.first][0]) ;
+        ASSERT_EQ(reply.second[1], toupper(requests[reply.first][1])) ;
+    }
+
+    const auto statistics = serial_transaction_engine.GetStatistics() ;
+    ASSERT_EQ(statistics.completedCount, 4U) ;
+    ASSERT_EQ(statistics.unmatchedReplyCount, 1U) ;
+    ASSERT_EQ(serial_transaction_engine.GetNumberOfPendingTransactions(), 0U) ;
+}
+
+void
+SerialTransactionEngineUnitTests::testSerialTransactionEngineTimeout()
+{
+    SerialTransactionEngine serial_transaction_engine {serialPort, MakeLineFramer()} ;
+    serial_transaction_engine.SetMaximumOutstanding(2) ;
+
+    const auto transaction_id = serial_transaction_engine.Submit(toDataBuffer("PING\n"), 20) ;
+    serial_transaction_engine.Submit(toDataBuffer("PING\n"), 500) ;
+
+    // The request with the earlier deadline times out first.
+    const auto start_time = getTimeInMilliSeconds() ;
+    auto serial_transactions = serial_transaction_engine.ProcessEvents(1000) ;
+    const auto elapsed_ms = getTimeInMilliSeconds() - start_time ;
+
+    ASSERT_EQ(serial_transactions.size(), 1U) ;
+    ASSERT_EQ(serial_transactions[0].transactionId, transaction_id) ;
+    ASSERT_EQ(serial_transactions[0].status, TransactionStatus::TIMED_OUT) ;
+    ASSERT_TRUE(serial_transactions[0].reply.empty()) ;
+    ASSERT_GE(serial_transactions[0].latencyUs, 20000U) ;
+    ASSERT_GE(elapsed_ms, 19U) ;
+    ASSERT_LT(elapsed_ms, 200U) ;
+
+    // A timed out request is not matched to a late reply.
+    writeReply("PONG\n") ;
+    serial_transactions = serial_transaction_engine.ProcessEvents(1000) ;
+    ASSERT_EQ(serial_transactions.size(), 1U) ;
+    ASSERT_EQ(serial_transactions[0].status, TransactionStatus::COMPLETED) ;
+    ASSERT_NE(serial_transactions[0].transactionId, transaction_id) ;
+
+    writeReply("PONG\n") ;
+    ASSERT_TRUE(serial_transaction_engine.ProcessEvents(50).empty()) ;
+
+    // Transact() returns timed out transactions as well.
+    const auto serial_transaction = serial_transaction_engine.Transact(toDataBuffer("PING\n"), 10) ;
+    ASSERT_EQ(serial_transaction.status, TransactionStatus::TIMED_OUT) ;
+
+    const auto statistics = serial_transaction_engine.GetStatistics() ;
+    ASSERT_EQ(statistics.completedCount, 1U) ;
+    ASSERT_EQ(statistics.timedOutCount, 2U) ;
+    ASSERT_EQ(statistics.unmatchedReplyCount, 1U) ;
+}
+
+TEST_F(SerialTransactionEngineUnitTests, testSerialTransactionEngineTransact)
+{
+    SCOPED_TRACE("Serial Transaction Engine Transact() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialTransactionEngineTransact() ;
+    }
+}
+
+TEST_F(SerialTransactionEngineUnitTests, testSerialTransactionEnginePipelining)
+{
+    SCOPED_TRACE("Serial Transaction Engine Pipelining Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialTransactionEnginePipelining() ;
+    }
+}
+
+TEST_F(SerialTransactionEngineUnitTests, testSerialTransactionEngineTimeout)
+{
+    SCOPED_TRACE("Serial Transaction Engine Timeout Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialTransactionEngineTimeout() ;
+    }
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * @file SerialTransactionEngineUnitTests.h                                   *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialTransactionEngine.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialTransactionEngineUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialTransactionEngineUnitTests() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~SerialTransactionEngineUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests for correct functionality of the Transact() method.
+         */
+        void testSerialTransactionEngineTransact() ;
+
+        /**
+         * @brief Tests that pipelined requests are matched to replies that
+         *        arrive out of order and that unmatched replies are counted.
+         */
+        void testSerialTransactionEnginePipelining() ;
+
+        /**
+         * @brief Tests that requests without a reply time out and that late
+         *        replies are not matched to them.
+         */
+        void testSerialTransactionEngineTimeout() ;
+
+        /**
+         * @brief Reads the requests received by the emulated device.
+         * @param numberOfBytes The number of bytes expected.
+         * @return Returns the data read, shorter if it did not arrive in time.
+         */
+        std::string readRequests(const size_t numberOfBytes) ;
+
+        /**
+         * @brief Writes a reply from the emulated device.
+         * @param reply The reply to be written to the master side.
+         */
+        void writeReply(const std::string& reply) ;
+
+        /**
+         * @brief Converts a string to a DataBuffer.
+         * @param data The string to be converted.
+         * @return Returns the DataBuffer.
+         */
+        DataBuffer toDataBuffer(const std::string& data) ;
+
+        /**
+         * @brief Serial port used by the transaction engine.
+         */
+        SerialPort serialPort {} ;
+
+        /**
+         * @brief File descriptor of the master side of the pseudo terminal.
+         */
+        int masterFileDescriptor {-1} ;
+
+    } ; // class SerialTransactionEngineUnitTests
+
+} // namespace LibSerial
@@ -33,10 +33,21 @@
 
 #include "UnitTests.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fcntl.h>
+#include <fstream>
+#include <ftw.h>
 #include <iostream>
+#include <poll.h>
+#include <random>
+#include <sys/eventfd.h>
 #include <thread>
 #include <unistd.h>
+#include <utility>
 #include <vector>
 
 using namespace LibSerial;
@@ -74,6 +85,410 @@ UnitTests::getTimeInMicroSeconds()
     ) ;
 }
 
+std::string
+UnitTests::openPseudoTerminal(int& masterFileDescriptor)
+{
+    masterFileDescriptor = posix_openpt(O_RDWR | O_NOCTTY) ;
+
+    if ((masterFileDescriptor < 0) or
+        (grantpt(masterFileDescriptor) < 0) or
+        (unlockpt(masterFileDescriptor) < 0))
+    {
+        throw std::runtime_error(std::strerror(errno)) ;
+    }
+
+    // Put the master side in raw mode so that data written by the tests
+    // reaches the slave side unmodified.
+    termios port_settings {} ;
+    tcgetattr(masterFileDescriptor, &port_settings) ;
+    cfmakeraw(&port_settings) ;
+    tcsetattr(masterFileDescriptor, TCSANOW, &port_settings) ;
+
+    return ptsname(masterFileDescriptor) ;
+}
+
+std::string
+UnitTests::readPseudoTerminal(const int masterFileDescriptor,
+                              const int msTimeout)
+{
+    pollfd poll_fd {masterFileDescriptor, POLLIN, 0} ;
+
+    if (poll(&poll_fd, 1, msTimeout) <= 0)
+    {
+        return std::string() ;
+    }
+
+    std::string data(256, '\0') ;
+    const auto result = read(masterFileDescriptor, &data[0], data.size()) ;
+    data.resize(result > 0 ? static_cast<size_t>(result) : 0) ;
+    return data ;
+}
+
+std::string
+UnitTests::readPseudoTerminal(const int    masterFileDescriptor,
+                              const size_t numberOfBytes,
+                              const int    msTimeout)
+{
+    std::string data {} ;
+
+    while (data.size() < numberOfBytes)
+    {
+        const auto read_data = readPseudoTerminal(masterFileDescriptor, msTimeout) ;
+
+        if (read_data.empty())
+        {
+            break ;
+        }
+
+        data += read_data ;
+    }
+
+    return data ;
+}
+
+std::string
+UnitTests::createTemporaryDirectory()
+{
+    std::string path_template {"/tmp/libserial_test_XXXXXX"} ;
+
+    if (mkdtemp(&path_template[0]) == nullptr)
+    {
+        throw std::runtime_error(std::strerror(errno)) ;
+    }
+
+    return path_template ;
+}
+
+void
+UnitTests::removeDirectory(const std::string& path)
+{
+    nftw(path.c_str(),
+         [](const char* filePath, const struct stat*, int, FTW*)
+         {
+             return remove(filePath) ;
+         },
+         16,
+         FTW_DEPTH | FTW_PHYS) ;
+}
+
+void
+UnitTests::makeDirectory(const std::string& path)
+{
+    ASSERT_EQ(system(("mkdir -p '" + path + "'").c_str()), 0) ;
+}
+
+void
+UnitTests::writeFile(const std::string& path,
+                     const std::string& contents)
+{
+    std::ofstream file {path} ;
+    file << contents ;
+    ASSERT_TRUE(file.good()) ;
+}
+
+void
+UnitTests::makeSymbolicLink(const std::string& target,
+                            const std::string& path)
+{
+    ASSERT_EQ(symlink(target.c_str(), path.c_str()), 0) << std::strerror(errno) ;
+}
+
+std::string
+UnitTests::makeTestData(const size_t size,
+                        const size_t seed)
+{
+    std::string data(size, '\0') ;
+    uint32_t state = static_cast<uint32_t>(seed) ;
+
+    for (size_t i = 0 ; i < size ; i++)
+    {
+        state = state * 1103515245 + 12345 ;
+        data[i] = static_cast<char>((i % 2 == 0) ? (state >> 16) : i) ;
+    }
+
+    return data ;
+}
+
+namespace
+{
+    /**
+     * @brief Writes all data to a file descriptor.
+     */
+    void writeAll(const int         fileDescriptor,
+                  const char*       data,
+                  size_t            numberOfBytes)
+    {
+        while (numberOfBytes > 0)
+        {
+            const auto result = write(fileDescriptor, data, numberOfBytes) ;
+
+            if (result <= 0)
+            {
+                return ;
+            }
+
+            data += result ;
+            numberOfBytes -= static_cast<size_t>(result) ;
+        }
+    }
+} // namespace
+
+PseudoTerminalRelay::PseudoTerminalRelay(const int firstMasterFileDescriptor,
+                                         const int secondMasterFileDescriptor)
+    : masterFileDescriptors {{firstMasterFileDescriptor, secondMasterFileDescriptor}}
+{
+    stopFileDescriptor = eventfd(0, EFD_CLOEXEC) ;
+    relayThread = std::thread(&PseudoTerminalRelay::relayLoop, this) ;
+}
+
+PseudoTerminalRelay::~PseudoTerminalRelay()
+{
+    const uint64_t stop = 1 ;
+    writeAll(stopFileDescriptor, reinterpret_cast<const char*>(&stop), sizeof(stop)) ;
+    relayThread.join() ;
+    close(stopFileDescriptor) ;
+}
+
+void
+PseudoTerminalRelay::setLatency(const int msLatency)
+{
+    latencyMs = msLatency ;
+}
+
+void
+PseudoTerminalRelay::setErrorRates(const double lossRate,
+                                   const double corruptionRate)
+{
+    this->lossRate = lossRate ;
+    this->corruptionRate = corruptionRate ;
+}
+
+void
+PseudoTerminalRelay::corruptByte(const size_t offset)
+{
+    corruptionOffset = relayedBytes + offset ;
+}
+
+bool
+PseudoTerminalRelay::isCorruptionPending() const
+{
+    return corruptionOffset != SIZE_MAX ;
+}
+
+size_t
+PseudoTerminalRelay::getNumberOfLostBytes() const
+{
+    return lostBytes ;
+}
+
+size_t
+PseudoTerminalRelay::getNumberOfCorruptedBytes() const
+{
+    return corruptedBytes ;
+}
+
+void
+PseudoTerminalRelay::relayLoop()
+{
+    using Clock = std::chrono::steady_clock ;
+
+    std::array<pollfd, 3> poll_fds {{{masterFileDescriptors[0], POLLIN, 0},
+                                     {masterFileDescriptors[1], POLLIN, 0},
+                                     {stopFileDescriptor, POLLIN, 0}}} ;
+
+    // The data in flight in each direction and the time it is delivered.
+    std::array<std::deque<std::pair<Clock::time_point, std::string>>, 2> in_flight {} ;
+    std::array<char, 4096> buffer {} ;
+
+    // A fixed seed keeps the errors reproducible.
+    std::minstd_rand random_engine {1} ;
+    std::uniform_real_distribution<double> probability {0.0, 1.0} ;
+
+    while (true)
+    {
+        int ms_timeout = -1 ;
+
+        for (const auto& queue : in_flight)
+        {
+            if (not queue.empty())
+            {
+                const auto ms_remaining = std::max<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(queue.front().first - Clock::now()).count() + 1, 0) ;
+                ms_timeout = static_cast<int>((ms_timeout < 0) ? ms_remaining : std::min<int64_t>(ms_timeout, ms_remaining)) ;
+            }
+        }
+
+        if (poll(poll_fds.data(), poll_fds.size(), ms_timeout) < 0)
+        {
+            return ;
+        }
+
+        if (poll_fds[2].revents != 0)
+        {
+            return ;
+        }
+
+        for (size_t direction = 0 ; direction < 2 ; direction++)
+        {
+            if ((poll_fds[direction].revents & POLLIN) == 0)
+            {
+                continue ;
+            }
+
+            const auto result = read(poll_fds[direction].fd, buffer.data(), buffer.size()) ;
+
+            if (result <= 0)
+            {
+                continue ;
+            }
+
+            const auto size = static_cast<size_t>(result) ;
+
+            if (direction == 0)
+            {
+                const auto offset = corruptionOffset.load() ;
+
+                if ((offset >= relayedBytes) and
+                    (offset < relayedBytes + size))
+                {
+                    buffer[offset - relayedBytes] ^= 0x55 ;
+                    corruptionOffset = SIZE_MAX ;
+                    corruptedBytes++ ;
+                }
+
+                relayedBytes += size ;
+            }
+
+            std::string data {} ;
+            data.reserve(size) ;
+
+            const auto loss_rate = lossRate.load() ;
+            const auto corruption_rate = corruptionRate.load() ;
+
+            for (size_t i = 0 ; i < size ; i++)
+            {
+                if ((loss_rate > 0.0) and
+                    (probability(random_engine) < loss_rate))
+                {
+                    lostBytes++ ;
+                    continue ;
+                }
+
+                auto byte = buffer[i] ;
+
+                if ((corruption_rate > 0.0) and
+                    (probability(random_engine) < corruption_rate))
+                {
+                    byte ^= static_cast<char>(1U << (random_engine() % 8)) ;
+                    corruptedBytes++ ;
+                }
+
+                data.push_back(byte) ;
+            }
+
+            in_flight[direction].emplace_back(Clock::now() + std::chrono::milliseconds(latencyMs),
+                                              std::move(data)) ;
+        }
+
+        for (size_t direction = 0 ; direction < 2 ; direction++)
+        {
+            auto& queue = in_flight[direction] ;
+
+            while ((not queue.empty()) and
+                   (queue.front().first <= Clock::now()))
+            {
+                writeAll(masterFileDescriptors[1 - direction], queue.front().second.data(), queue.front().second.size()) ;
+                queue.pop_front() ;
+            }
+        }
+    }
+}
+
+RelayedLinkUnitTests::RelayedLinkUnitTests()
+{
+    firstPort.Open(openPseudoTerminal(firstMasterFileDescriptor)) ;
+    secondPort.Open(openPseudoTerminal(secondMasterFileDescriptor)) ;
+
+    relay.reset(new PseudoTerminalRelay(firstMasterFileDescriptor,
+                                        secondMasterFileDescriptor)) ;
+}
+
+RelayedLinkUnitTests::~RelayedLinkUnitTests()
+{
+    relay.reset() ;
+
+    firstPort.Close() ;
+    secondPort.Close() ;
+    close(firstMasterFileDescriptor) ;
+    close(secondMasterFileDescriptor) ;
+}
+
+void
+RelayedLinkUnitTests::runTransfer(const std::function<void()>&                         sendFunction,
+                                  const std::function<void(const std::atomic<bool>&)>& receiveFunction)
+{
+    std::atomic<bool> is_sent {false} ;
+    std::exception_ptr receive_exception {} ;
+
+    std::thread receiver([&]
+    {
+        try
+        {
+            receiveFunction(is_sent) ;
+        }
+        catch (...)
+        {
+            receive_exception = std::current_exception() ;
+        }
+    }) ;
+
+    std::exception_ptr send_exception {} ;
+
+    try
+    {
+        sendFunction() ;
+    }
+    catch (...)
+    {
+        send_exception = std::current_exception() ;
+    }
+
+    is_sent = true ;
+    receiver.join() ;
+
+    if (send_exception)
+    {
+        std::rethrow_exception(send_exception) ;
+    }
+
+    if (receive_exception)
+    {
+        std::rethrow_exception(receive_exception) ;
+    }
+}
+
+double
+RelayedLinkUnitTests::measureLineRate(const std::string& data)
+{
+    std::string received_data {} ;
+
+    const auto start_time = std::chrono::steady_clock::now() ;
+
+    runTransfer([&]
+                {
+                    firstPort.Write(data) ;
+                },
+                [&](const std::atomic<bool>& /* isSent */)
+                {
+                    secondPort.Read(received_data, data.size(), 10000) ;
+                }) ;
+
+    const auto duration = std::chrono::steady_clock::now() - start_time ;
+
+    EXPECT_EQ(received_data, data) ;
+
+    return static_cast<double>(data.size()) / std::chrono::duration<double>(duration).count() ;
+}
+
 void
 UnitTests::testSerialStreamToSerialPortReadWrite()
 {
@@ -37,10 +37,17 @@
 #include "libserial/SerialPortConstants.h"
 #include "libserial/SerialStream.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <gtest/gtest.h>
+#include <memory>
 #include <mutex>
 #include <stdlib.h>
+#include <string>
 #include <sys/ioctl.h>
+#include <thread>
 
 /**
  * @namespace Libserial
@@ -62,6 +69,12 @@ namespace LibSerial
      */
     constexpr int TEST_ITERATIONS = 10 ;
 
+    /**
+     * @var The line rate in bytes per second of the paced links in the
+     *      throughput tests.
+     */
+    constexpr size_t LINE_RATE = 200000 ;
+
 
     class UnitTests : public ::testing::Test
     {
@@ -89,6 +102,83 @@ namespace LibSerial
          */
         size_t getTimeInMicroSeconds() ;
 
+        /**
+         * @brief Opens a pseudo terminal pair so that tests can run without
+         *        serial port hardware. The slave side behaves like a serial
+         *        port and the master side acts as the remote device.
+         * @param masterFileDescriptor The file descriptor of the master side.
+         * @return Returns the file name of the slave side.
+         */
+        std::string openPseudoTerminal(int& masterFileDescriptor) ;
+
+        /**
+         * @brief Reads the data available at the master side of a pseudo
+         *        terminal, waiting for it to arrive if necessary.
+         * @param masterFileDescriptor The file descriptor of the master side.
+         * @param msTimeout The maximum time to wait for data in milliseconds.
+         * @return Returns the data read, empty if none arrived in time.
+         */
+        std::string readPseudoTerminal(int masterFileDescriptor,
+                                       int msTimeout) ;
+
+        /**
+         * @brief Reads the specified number of bytes from the master side of
+         *        a pseudo terminal, which may arrive in several parts.
+         * @param masterFileDescriptor The file descriptor of the master side.
+         * @param numberOfBytes The number of bytes to be read.
+         * @param msTimeout The maximum time to wait for each part in
+         *        milliseconds.
+         * @return Returns the data read, shorter if no more arrived in time.
+         */
+        std::string readPseudoTerminal(int    masterFileDescriptor,
+                                       size_t numberOfBytes,
+                                       int    msTimeout) ;
+
+        /**
+         * @brief Creates a new, empty temporary directory.
+         * @return Returns the path of the directory.
+         */
+        std::string createTemporaryDirectory() ;
+
+        /**
+         * @brief Recursively removes the specified directory.
+         * @param path The path of the directory to be removed.
+         */
+        void removeDirectory(const std::string& path) ;
+
+        /**
+         * @brief Creates a directory and all of its missing parents.
+         * @param path The path of the directory.
+         */
+        void makeDirectory(const std::string& path) ;
+
+        /**
+         * @brief Creates a file with the specified contents.
+         * @param path The path of the file.
+         * @param contents The contents of the file.
+         */
+        void writeFile(const std::string& path,
+                       const std::string& contents) ;
+
+        /**
+         * @brief Creates a symbolic link.
+         * @param target The target of the link.
+         * @param path The path of the link.
+         */
+        void makeSymbolicLink(const std::string& target,
+                              const std::string& path) ;
+
+        /**
+         * @brief Makes test data containing all byte values, including those
+         *        escaped by the protocols under test. Every other byte counts
+         *        up, the others are pseudo-random.
+         * @param size The size of the data.
+         * @param seed The value the pseudo-random bytes are derived from.
+         * @return Returns the data.
+         */
+        std::string makeTestData(const size_t size,
+                                 const size_t seed = 0) ;
+
     protected:
 
         /**
@@ -184,4 +274,205 @@ namespace LibSerial
     private:
 
     } ;
+
+    /**
+     * @brief Connects the master sides of two pseudo terminals, so that their
+     *        slave sides behave like the two ends of a serial link. The data
+     *        can be delayed, lost and corrupted to emulate slow and noisy
+     *        links.
+     */
+    class PseudoTerminalRelay
+    {
+    public:
+
+        /**
+         * @brief Constructor, which starts relaying the data.
+         * @param firstMasterFileDescriptor The master side of the first
+         *        pseudo terminal.
+         * @param secondMasterFileDescriptor The master side of the second
+         *        pseudo terminal.
+         */
+        PseudoTerminalRelay(const int firstMasterFileDescriptor,
+                            const int secondMasterFileDescriptor) ;
+
+        /**
+         * @brief Destructor, which stops relaying the data.
+         */
+        ~PseudoTerminalRelay() ;
+
+        PseudoTerminalRelay(const PseudoTerminalRelay& otherPseudoTerminalRelay) = delete ;
+        PseudoTerminalRelay& operator=(const PseudoTerminalRelay& otherPseudoTerminalRelay) = delete ;
+
+        /**
+         * @brief Sets the time the data is delayed in each direction.
+         * @param msLatency The latency in milliseconds.
+         */
+        void setLatency(const int msLatency) ;
+
+        /**
+         * @brief Sets the probabilities with which each relayed byte is lost
+         *        or corrupted.
+         * @param lossRate The probability of a byte being lost.
+         * @param corruptionRate The probability of a byte being corrupted.
+         */
+        void setErrorRates(const double lossRate,
+                           const double corruptionRate) ;
+
+        /**
+         * @brief Corrupts one byte relayed from the first to the second
+         *        pseudo terminal.
+         * @param offset The number of bytes relayed before the corrupted one,
+         *        counting from now.
+         */
+        void corruptByte(const size_t offset) ;
+
+        /**
+         * @brief Determines if the byte selected by corruptByte() has not
+         *        been relayed yet.
+         * @return Returns true iff the corruption is pending.
+         */
+        bool isCorruptionPending() const ;
+
+        /**
+         * @brief Gets the number of bytes lost so far.
+         * @return Returns the number of bytes lost.
+         */
+        size_t getNumberOfLostBytes() const ;
+
+        /**
+         * @brief Gets the number of bytes corrupted so far.
+         * @return Returns the number of bytes corrupted.
+         */
+        size_t getNumberOfCorruptedBytes() const ;
+
+    private:
+
+        /**
+         * @brief Relays the data until the stop event is signalled.
+         */
+        void relayLoop() ;
+
+        /**
+         * @brief The master sides of the pseudo terminals.
+         */
+        std::array<int, 2> masterFileDescriptors ;
+
+        /**
+         * @brief Event file descriptor that stops the relay thread.
+         */
+        int stopFileDescriptor {-1} ;
+
+        /**
+         * @brief The latency in milliseconds.
+         */
+        std::atomic<int> latencyMs {0} ;
+
+        /**
+         * @brief The probability of a byte being lost.
+         */
+        std::atomic<double> lossRate {0.0} ;
+
+        /**
+         * @brief The probability of a byte being corrupted.
+         */
+        std::atomic<double> corruptionRate {0.0} ;
+
+        /**
+         * @brief The number of bytes relayed from the first to the second
+         *        pseudo terminal.
+         */
+        std::atomic<size_t> relayedBytes {0} ;
+
+        /**
+         * @brief The value of relayedBytes at which the next relayed byte is
+         *        corrupted, if any.
+         */
+        std::atomic<size_t> corruptionOffset {SIZE_MAX} ;
+
+        /**
+         * @brief The number of bytes lost.
+         */
+        std::atomic<size_t> lostBytes {0} ;
+
+        /**
+         * @brief The number of bytes corrupted.
+         */
+        std::atomic<size_t> corruptedBytes {0} ;
+
+        /**
+         * @brief Thread running relayLoop().
+         */
+        std::thread relayThread {} ;
+    } ;
+
+    /**
+     * @brief Base of the fixtures that test protocols between two serial
+     *        ports whose pseudo terminals are connected by a
+     *        PseudoTerminalRelay.
+     */
+    class RelayedLinkUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Constructor, which opens the ports and starts the relay.
+         */
+        explicit RelayedLinkUnitTests() ;
+
+        /**
+         * @brief Destructor, which stops the relay and closes the ports.
+         */
+        virtual ~RelayedLinkUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Runs the sending side of a transfer on this thread and the
+         *        receiving side on another one. An exception thrown by
+         *        either side is rethrown once both have returned, the one
+         *        of the sending side first.
+         * @param sendFunction The sending side.
+         * @param receiveFunction The receiving side, which is passed a flag
+         *        that is set once the sending side has returned.
+         */
+        void runTransfer(const std::function<void()>&                         sendFunction,
+                         const std::function<void(const std::atomic<bool>&)>& receiveFunction) ;
+
+        /**
+         * @brief Measures the rate at which data written with Write() by
+         *        firstPort arrives at secondPort, with the pacing and latency
+         *        currently set. This is the best any protocol can do on the
+         *        link under the current load of the machine.
+         * @param data The data to be written.
+         * @return Returns the rate in bytes per second.
+         */
+        double measureLineRate(const std::string& data) ;
+
+        /**
+         * @brief Serial port of the first end of the link.
+         */
+        SerialPort firstPort {} ;
+
+        /**
+         * @brief Serial port of the second end of the link.
+         */
+        SerialPort secondPort {} ;
+
+        /**
+         * @brief File descriptor of the master side of the first pseudo
+         *        terminal.
+         */
+        int firstMasterFileDescriptor {-1} ;
+
+        /**
+         * @brief File descriptor of the master side of the second pseudo
+         *        terminal.
+         */
+        int secondMasterFileDescriptor {-1} ;
+
+        /**
+         * @brief Relay connecting the two pseudo terminals.
+         */
+        std::unique_ptr<PseudoTerminalRelay> relay {} ;
+    } ;
 }